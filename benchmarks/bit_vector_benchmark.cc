@@ -0,0 +1,158 @@
+#include "BitVector/bit_vector.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/*
+ * A billion bit filter bitmaps (125 MB each): half set, and a sparse one
+ * with about one bit in 128 set. Bulk ops combine two half set bitmaps in
+ * place; count is against std::count over std::vector<bool>. Rank and
+ * select take 1M random queries on the built index.
+ */
+
+namespace {
+
+constexpr size_t bit_count = size_t{1} << 30;
+constexpr size_t query_count = 1 << 20;
+
+// random words; and-ing sparsity of them together leaves 1 / 2^sparsity set
+rwstd::BitVector random_bits(uint64_t seed, unsigned sparsity) {
+  std::mt19937_64 rng(seed);
+  rwstd::BitVector bits(bit_count);
+  for (size_t w = 0; w < bit_count / 64; ++w) {
+    uint64_t word = rng();
+    for (unsigned i = 1; i < sparsity; ++i)
+      word &= rng();
+    for (; word != 0; word &= word - 1)
+      bits.set(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+  }
+  return bits;
+}
+
+rwstd::BitVector &half_set() {
+  static rwstd::BitVector bits = random_bits(1, 1);
+  return bits;
+}
+
+rwstd::BitVector &other_half_set() {
+  static rwstd::BitVector bits = random_bits(2, 1);
+  return bits;
+}
+
+rwstd::BitVector &sparse() {
+  static rwstd::BitVector bits = random_bits(3, 7);
+  return bits;
+}
+
+void BM_Count(benchmark::State &state) {
+  const auto &bits = half_set();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(bits.count());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(bit_count / 8));
+}
+BENCHMARK(BM_Count)->Unit(benchmark::kMillisecond);
+
+void BM_StdVectorBoolCount(benchmark::State &state) {
+  std::mt19937_64 rng(1);
+  std::vector<bool> bits(bit_count);
+  for (size_t i = 0; i < bit_count; i += 64) {
+    uint64_t word = rng();
+    for (size_t j = 0; j < 64; ++j)
+      bits[i + j] = (word >> j) & 1;
+  }
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::count(bits.begin(), bits.end(), true));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(bit_count / 8));
+}
+BENCHMARK(BM_StdVectorBoolCount)->Unit(benchmark::kMillisecond);
+
+template <typename Op>
+void bulk(benchmark::State &state, Op op) {
+  rwstd::BitVector bits = half_set();
+  const auto &other = other_half_set();
+  for (auto _ : state) {
+    op(bits, other);
+    benchmark::DoNotOptimize(bits.data());
+  }
+  // two bitmaps read, one written
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(3 * bit_count / 8));
+}
+
+void BM_And(benchmark::State &state) {
+  bulk(state, [](auto &a, const auto &b) { a &= b; });
+}
+BENCHMARK(BM_And)->Unit(benchmark::kMillisecond);
+
+void BM_Or(benchmark::State &state) {
+  bulk(state, [](auto &a, const auto &b) { a |= b; });
+}
+BENCHMARK(BM_Or)->Unit(benchmark::kMillisecond);
+
+void BM_Xor(benchmark::State &state) {
+  bulk(state, [](auto &a, const auto &b) { a ^= b; });
+}
+BENCHMARK(BM_Xor)->Unit(benchmark::kMillisecond);
+
+void BM_ForEachSetSparse(benchmark::State &state) {
+  const auto &bits = sparse();
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    bits.for_each_set([&](size_t pos) { sum += pos; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(bit_count / 8));
+}
+BENCHMARK(BM_ForEachSetSparse)->Unit(benchmark::kMillisecond);
+
+void BM_BuildIndex(benchmark::State &state) {
+  auto &bits = half_set();
+  for (auto _ : state)
+    bits.build_index();
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(bit_count / 8));
+}
+BENCHMARK(BM_BuildIndex)->Unit(benchmark::kMillisecond);
+
+void BM_Rank(benchmark::State &state) {
+  auto &bits = half_set();
+  bits.build_index();
+  std::mt19937_64 rng(4);
+  std::vector<size_t> queries(query_count);
+  for (auto &q : queries)
+    q = rng() % bit_count;
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (size_t q : queries)
+      sum += bits.rank(q);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(query_count));
+}
+BENCHMARK(BM_Rank)->Unit(benchmark::kMillisecond);
+
+void BM_Select(benchmark::State &state) {
+  auto &bits = half_set();
+  bits.build_index();
+  std::mt19937_64 rng(5);
+  std::vector<size_t> queries(query_count);
+  for (auto &q : queries)
+    q = rng() % bits.count();
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (size_t q : queries)
+      sum += bits.select(q);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(query_count));
+}
+BENCHMARK(BM_Select)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,97 @@
+#include "BloomFilter/bloom_filter.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/*
+ * find on a 4M entry map, far bigger than the LLC, plain and behind the
+ * filter, with a share of the probes missing. Arg is that share in percent.
+ * A filtered miss is a single block load, a filtered hit pays for that load
+ * on top of the bucket walk, so the filter wins once misses dominate.
+ */
+
+namespace {
+
+constexpr size_t map_size = 1 << 22;
+
+struct Dataset {
+  std::vector<uint64_t> keys;
+  rwstd::UnorderedMap<uint64_t, uint64_t> map;
+  rwstd::FilteredMap<uint64_t, uint64_t> filtered;
+};
+
+Dataset &dataset() {
+  static Dataset *data = [] {
+    auto *d = new Dataset;
+    std::mt19937_64 rng(1);
+    d->map.reserve(map_size);
+    d->filtered.reserve(map_size);
+    while (d->keys.size() < map_size) {
+      // the top bit is kept clear for misses
+      uint64_t key = rng() >> 1;
+      if (d->map.insert({key, key}).second) {
+        d->filtered.insert({key, key});
+        d->keys.push_back(key);
+      }
+    }
+    return d;
+  }();
+  return *data;
+}
+
+std::vector<uint64_t> probes(int64_t miss_percent) {
+  const Dataset &data = dataset();
+  std::mt19937_64 rng(static_cast<uint64_t>(miss_percent));
+  std::vector<uint64_t> out(1 << 20);
+  for (auto &probe : out) {
+    uint64_t key = data.keys[rng() % data.keys.size()];
+    bool miss = static_cast<int64_t>(rng() % 100) < miss_percent;
+    probe = miss ? key | (uint64_t{1} << 63) : key;
+  }
+  return out;
+}
+
+void BM_UnorderedMap_Find(benchmark::State &state) {
+  Dataset &data = dataset();
+  auto queries = probes(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data.map.find(queries[i]) != data.map.end());
+    if (++i == queries.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_UnorderedMap_Find)->Arg(0)->Arg(50)->Arg(95)->Arg(100);
+
+void BM_FilteredMap_Find(benchmark::State &state) {
+  Dataset &data = dataset();
+  auto queries = probes(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data.filtered.contains(queries[i]));
+    if (++i == queries.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_FilteredMap_Find)->Arg(0)->Arg(50)->Arg(95)->Arg(100);
+
+void BM_BloomFilter_Contains(benchmark::State &state) {
+  Dataset &data = dataset();
+  auto queries = probes(state.range(0));
+  const auto &filter = data.filtered.filter();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.contains(queries[i]));
+    if (++i == queries.size())
+      i = 0;
+  }
+  state.counters["bits_per_key"] =
+      static_cast<double>(filter.memory_usage() * 8) /
+      static_cast<double>(map_size);
+}
+BENCHMARK(BM_BloomFilter_Contains)->Arg(95);
+
+} // namespace
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Compare two sets of Google Benchmark JSON reports and flag regressions.
+
+    benchmarks/compare.py BASELINE CONTENDER [--threshold 0.05]
+
+BASELINE and CONTENDER are each a report written with
+--benchmark_out_format=json or a directory of them (what the
+benchmark_json target produces). Benchmarks are matched by name; with
+--benchmark_repetitions the median is used. Anything slower than the
+baseline by more than the threshold is a regression and makes the exit
+status 1, so the script can gate a CI job.
+"""
+
+import argparse
+import json
+import re
+import statistics
+import sys
+from pathlib import Path
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def report_files(path):
+    path = Path(path)
+    if path.is_dir():
+        return sorted(path.glob("*.json"))
+    return [path]
+
+
+def load(path, metric):
+    """name -> time in ns, the median when a benchmark ran several times"""
+    samples = {}
+    medians = {}
+    for file in report_files(path):
+        # a filter that matched nothing leaves an empty report
+        if file.stat().st_size == 0:
+            continue
+        with open(file) as f:
+            report = json.load(f)
+        for bench in report.get("benchmarks", []):
+            if bench.get("error_occurred"):
+                continue
+            time = bench[metric] * TO_NS[bench.get("time_unit", "ns")]
+            if bench.get("run_type") == "aggregate":
+                if bench.get("aggregate_name") == "median":
+                    medians[bench["run_name"]] = time
+            else:
+                name = bench.get("run_name", bench["name"])
+                samples.setdefault(name, []).append(time)
+    times = {name: statistics.median(runs) for name, runs in samples.items()}
+    times.update(medians)
+    return times
+
+
+def format_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown that counts as a regression "
+                             "(default 0.05)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"),
+                        default="cpu_time")
+    parser.add_argument("--filter", default="",
+                        help="only compare benchmarks matching this regex")
+    parser.add_argument("--all", action="store_true",
+                        help="list unchanged benchmarks too")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    contender = load(args.contender, args.metric)
+    pattern = re.compile(args.filter)
+    names = sorted(n for n in baseline.keys() & contender.keys()
+                   if pattern.search(n))
+
+    regressions = 0
+    width = max((len(n) for n in names), default=20)
+    for name in names:
+        old, new = baseline[name], contender[name]
+        change = (new - old) / old if old else 0.0
+        if change > args.threshold:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            verdict = "faster"
+        elif args.all:
+            verdict = ""
+        else:
+            continue
+        print(f"{name:<{width}}  {format_ns(old):>10} -> "
+              f"{format_ns(new):>10}  {change:+7.1%}  {verdict}")
+
+    for label, only in (("baseline", baseline.keys() - contender.keys()),
+                        ("contender", contender.keys() - baseline.keys())):
+        only = sorted(n for n in only if pattern.search(n))
+        if only:
+            print(f"{len(only)} only in the {label}: {', '.join(only)}")
+
+    print(f"{len(names)} compared, {regressions} regressed beyond "
+          f"{args.threshold:.0%} ({args.metric})")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,96 @@
+#include "ConcurrentVector/concurrent_vector.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/*
+ * Multi-producer append throughput: a fixed number of records split across
+ * 1 .. N producer threads, ConcurrentVector vs a mutex around Vector.
+ */
+
+namespace {
+
+constexpr size_t total_records = size_t{1} << 22;
+
+struct TraceRecord {
+  uint64_t timestamp;
+  uint32_t thread;
+  uint32_t event;
+};
+
+std::unique_ptr<rwstd::ConcurrentVector<TraceRecord>> shared_concurrent;
+std::unique_ptr<rwstd::Vector<TraceRecord>> shared_vector;
+std::mutex shared_vector_mutex;
+
+void BM_ConcurrentVector_PushBack(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_concurrent = std::make_unique<rwstd::ConcurrentVector<TraceRecord>>();
+  }
+  size_t per_thread = total_records / static_cast<size_t>(state.threads());
+  auto thread = static_cast<uint32_t>(state.thread_index());
+  for (auto _ : state) {
+    for (size_t i = 0; i < per_thread; ++i) {
+      shared_concurrent->push_back(TraceRecord{i, thread, 1});
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(per_thread));
+  if (state.thread_index() == 0) {
+    shared_concurrent.reset();
+  }
+}
+BENCHMARK(BM_ConcurrentVector_PushBack)
+    ->ThreadRange(1, 64)
+    ->Iterations(1)
+    ->UseRealTime();
+
+void BM_MutexVector_PushBack(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_vector = std::make_unique<rwstd::Vector<TraceRecord>>();
+  }
+  size_t per_thread = total_records / static_cast<size_t>(state.threads());
+  auto thread = static_cast<uint32_t>(state.thread_index());
+  for (auto _ : state) {
+    for (size_t i = 0; i < per_thread; ++i) {
+      std::lock_guard<std::mutex> lock(shared_vector_mutex);
+      shared_vector->push_back(TraceRecord{i, thread, 1});
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(per_thread));
+  if (state.thread_index() == 0) {
+    shared_vector.reset();
+  }
+}
+BENCHMARK(BM_MutexVector_PushBack)
+    ->ThreadRange(1, 64)
+    ->Iterations(1)
+    ->UseRealTime();
+
+// batched appends claim a whole range with one fetch_add
+void BM_ConcurrentVector_GrowBy(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_concurrent = std::make_unique<rwstd::ConcurrentVector<TraceRecord>>();
+  }
+  size_t per_thread = total_records / static_cast<size_t>(state.threads());
+  constexpr size_t batch = 64;
+  TraceRecord record{0, static_cast<uint32_t>(state.thread_index()), 1};
+  for (auto _ : state) {
+    for (size_t i = 0; i < per_thread; i += batch) {
+      shared_concurrent->grow_by(batch, record);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(per_thread));
+  if (state.thread_index() == 0) {
+    shared_concurrent.reset();
+  }
+}
+BENCHMARK(BM_ConcurrentVector_GrowBy)
+    ->ThreadRange(1, 64)
+    ->Iterations(1)
+    ->UseRealTime();
+
+} // namespace
@@ -0,0 +1,177 @@
+#include "FlatMap/flat_map.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+ * FlatMap in both layouts against UnorderedMap and std::map: point lookups
+ * of present keys in shuffled order, range scans of 256 consecutive keys
+ * (UnorderedMap has no order to scan, so it sits that one out) and building
+ * the whole map from an unsorted batch.
+ */
+
+namespace {
+
+using Sorted = rwstd::FlatMap<uint32_t, uint32_t>;
+using Eytzinger = rwstd::EytzingerFlatMap<uint32_t, uint32_t>;
+
+constexpr size_t scan_length = 256;
+
+struct Dataset {
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  std::vector<uint32_t> probes;
+};
+
+const Dataset &dataset(size_t n) {
+  static std::vector<std::pair<size_t, Dataset *>> cache;
+  for (auto &[size, data] : cache) {
+    if (size == n)
+      return *data;
+  }
+  auto *data = new Dataset;
+  std::mt19937 rng(static_cast<uint32_t>(n));
+  // distinct keys spread over the whole 32 bit range
+  for (uint32_t i = 0; i < n; ++i) {
+    uint32_t key = i * 2654435761u;
+    data->pairs.push_back({key, i});
+    data->probes.push_back(key);
+  }
+  std::shuffle(data->pairs.begin(), data->pairs.end(), rng);
+  std::shuffle(data->probes.begin(), data->probes.end(), rng);
+  cache.push_back({n, data});
+  return *data;
+}
+
+template <typename Flat>
+void BM_Flat_Lookup(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  Flat map;
+  map.insert_range(data.pairs);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(data.probes[i])->second);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_Flat_Lookup<Sorted>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_Flat_Lookup<Eytzinger>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+
+void BM_UnorderedMap_Lookup(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  rwstd::UnorderedMap<uint32_t, uint32_t> map;
+  for (const auto &entry : data.pairs)
+    map.insert(entry);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(data.probes[i])->second);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_UnorderedMap_Lookup)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+
+void BM_StdMap_Lookup(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  std::map<uint32_t, uint32_t> map(data.pairs.begin(), data.pairs.end());
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(data.probes[i])->second);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_StdMap_Lookup)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+
+template <typename Flat>
+void BM_Flat_RangeScan(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  Flat map;
+  map.insert_range(data.pairs);
+  size_t i = 0;
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    auto it = map.lower_bound(data.probes[i]);
+    for (size_t k = 0; k < scan_length && it != map.end(); ++k, ++it)
+      sum += it->second;
+    benchmark::DoNotOptimize(sum);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(scan_length));
+}
+BENCHMARK(BM_Flat_RangeScan<Sorted>)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_Flat_RangeScan<Eytzinger>)->Arg(1 << 16)->Arg(1 << 22);
+
+void BM_StdMap_RangeScan(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  std::map<uint32_t, uint32_t> map(data.pairs.begin(), data.pairs.end());
+  size_t i = 0;
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    auto it = map.lower_bound(data.probes[i]);
+    for (size_t k = 0; k < scan_length && it != map.end(); ++k, ++it)
+      sum += it->second;
+    benchmark::DoNotOptimize(sum);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(scan_length));
+}
+BENCHMARK(BM_StdMap_RangeScan)->Arg(1 << 16)->Arg(1 << 22);
+
+template <typename Flat>
+void BM_Flat_Build(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Flat map;
+    map.insert_range(data.pairs);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Flat_Build<Sorted>)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Flat_Build<Eytzinger>)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_UnorderedMap_Build(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    rwstd::UnorderedMap<uint32_t, uint32_t> map;
+    for (const auto &entry : data.pairs)
+      map.insert(entry);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UnorderedMap_Build)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_StdMap_Build(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::map<uint32_t, uint32_t> map(data.pairs.begin(), data.pairs.end());
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdMap_Build)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
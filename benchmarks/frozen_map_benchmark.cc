@@ -0,0 +1,111 @@
+#include "FrozenMap/frozen_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/*
+ * FrozenMap vs the UnorderedMap it is frozen from: build time, bytes per key
+ * and lookup latency. Lookups walk a shuffled list of present keys so every
+ * probe is a cache miss once the table outgrows the LLC.
+ *
+ * UnorderedMap's bytes per key counts nodes (pair + next pointer) and the
+ * bucket array only, malloc headers come on top of that.
+ */
+
+namespace {
+
+using Map = rwstd::UnorderedMap<uint64_t, uint64_t>;
+using Frozen = rwstd::FrozenMap<uint64_t, uint64_t>;
+
+struct Dataset {
+  Map map;
+  std::vector<uint64_t> probes;
+};
+
+const Dataset &dataset(size_t n) {
+  static std::vector<std::pair<size_t, Dataset *>> cache;
+  for (auto &[size, data] : cache) {
+    if (size == n)
+      return *data;
+  }
+  auto *data = new Dataset;
+  std::mt19937_64 rng(n);
+  while (data->map.size() < n) {
+    uint64_t key = rng();
+    data->map.insert({key, key});
+    data->probes.push_back(key);
+  }
+  std::shuffle(data->probes.begin(), data->probes.end(), rng);
+  cache.push_back({n, data});
+  return *data;
+}
+
+double map_bytes_per_key(const Map &map) {
+  double nodes = static_cast<double>(map.size()) *
+                 static_cast<double>(sizeof(std::pair<const uint64_t, uint64_t>) +
+                                     sizeof(void *));
+  double buckets = static_cast<double>(map.bucket_count() * sizeof(void *));
+  return (nodes + buckets) / static_cast<double>(map.size());
+}
+
+void BM_FrozenMap_Build(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto frozen = Frozen::build(data.map);
+    bytes = frozen.memory_usage();
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.counters["bytes_per_key"] =
+      static_cast<double>(bytes) / static_cast<double>(state.range(0));
+  state.counters["map_bytes_per_key"] = map_bytes_per_key(data.map);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrozenMap_Build)
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_UnorderedMap_Lookup(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  auto &map = const_cast<Map &>(data.map);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto it = map.find(data.probes[i]);
+    benchmark::DoNotOptimize(it->second);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_UnorderedMap_Lookup)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+void BM_FrozenMap_Lookup(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  auto frozen = Frozen::build(data.map);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto it = frozen.find(data.probes[i]);
+    benchmark::DoNotOptimize(it->second);
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_FrozenMap_Lookup)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// misses still cost a full probe, but never more than one compare
+void BM_FrozenMap_LookupMiss(benchmark::State &state) {
+  const Dataset &data = dataset(static_cast<size_t>(state.range(0)));
+  auto frozen = Frozen::build(data.map);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frozen.contains(data.probes[i] + 1));
+    if (++i == data.probes.size())
+      i = 0;
+  }
+}
+BENCHMARK(BM_FrozenMap_LookupMiss)->Arg(1 << 20);
+
+} // namespace
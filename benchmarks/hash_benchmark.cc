@@ -0,0 +1,75 @@
+#include "Hash/hash.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+
+/*
+ * Bytes per second hashing one key of Arg bytes, rwstd::hash::hash_bytes
+ * against the standard library's std::hash<std::string_view>. The key
+ * pointer is laundered through DoNotOptimize so neither side folds it.
+ */
+
+namespace {
+
+std::string key_of(int64_t len) {
+  std::mt19937_64 rng(static_cast<uint64_t>(len));
+  std::string key(static_cast<size_t>(len), '\0');
+  for (auto &c : key)
+    c = static_cast<char>(rng());
+  return key;
+}
+
+void BM_HashBytes(benchmark::State &state) {
+  std::string key = key_of(state.range(0));
+  const char *data = key.data();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data);
+    benchmark::DoNotOptimize(rwstd::hash::hash_bytes(data, key.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HashBytes)->RangeMultiplier(4)->Range(4, 1 << 16);
+
+void BM_StdHash(benchmark::State &state) {
+  std::string key = key_of(state.range(0));
+  const char *data = key.data();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data);
+    benchmark::DoNotOptimize(
+        std::hash<std::string_view>{}(std::string_view(data, key.size())));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdHash)->RangeMultiplier(4)->Range(4, 1 << 16);
+
+/*
+ * Inserting and finding 64k keys spaced Arg apart. std::hash is the identity,
+ * so once the stride shares a factor with the bucket count (11 * 2^k) keys
+ * pile into a fraction of the buckets; the mixed hash doesn't care.
+ */
+template <typename H>
+void BM_StridedKeys(benchmark::State &state) {
+  const uint64_t stride = static_cast<uint64_t>(state.range(0));
+  constexpr uint64_t n = 1 << 16;
+  for (auto _ : state) {
+    rwstd::UnorderedMap<uint64_t, uint64_t, H> map;
+    for (uint64_t i = 0; i < n; ++i)
+      map.insert({i * stride, i});
+    uint64_t found = 0;
+    for (uint64_t i = 0; i < n; ++i)
+      found += map.find(i * stride) != map.end();
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_StridedKeys<std::hash<uint64_t>>)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK(BM_StridedKeys<rwstd::hash::Hash<uint64_t>>)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+
+} // namespace
@@ -0,0 +1,109 @@
+#include "IntMap/int_map.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/*
+ * IntMap vs UnorderedMap on three shapes of uint64_t IDs:
+ *
+ *   dense       0..n-1 in shuffled order
+ *   sparse      random 64 bit values
+ *   sequential  0..n-1 inserted and looked up in order
+ *
+ * Insert builds the whole map from empty; lookups cycle through the present
+ * keys in the same order they were inserted in, and misses probe keys that
+ * are never there.
+ *
+ * UnorderedMap's std::hash is the identity, so sequential IDs walk its
+ * buckets in memory order; IntMap's mixer scatters them on purpose and gives
+ * up that locality to stay fast on every other shape.
+ */
+
+namespace {
+
+enum Shape { dense, sparse, sequential };
+
+const std::vector<uint64_t> &ids(Shape shape, size_t n) {
+  static std::vector<std::pair<std::pair<Shape, size_t>, std::vector<uint64_t> *>>
+      cache;
+  for (auto &[key, data] : cache) {
+    if (key.first == shape && key.second == n)
+      return *data;
+  }
+  auto *data = new std::vector<uint64_t>(n);
+  std::mt19937_64 rng(n);
+  for (size_t i = 0; i < n; ++i) {
+    (*data)[i] = shape == sparse ? rng() >> 1 : i;
+  }
+  if (shape == dense)
+    std::shuffle(data->begin(), data->end(), rng);
+  cache.push_back({{shape, n}, data});
+  return *data;
+}
+
+template <typename Map>
+void BM_Insert(benchmark::State &state) {
+  const auto &keys = ids(static_cast<Shape>(state.range(0)),
+                         static_cast<size_t>(state.range(1)));
+  for (auto _ : state) {
+    Map map;
+    for (uint64_t key : keys)
+      map.insert({key, key});
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+template <typename Map>
+void BM_LookupHit(benchmark::State &state) {
+  const auto &keys = ids(static_cast<Shape>(state.range(0)),
+                         static_cast<size_t>(state.range(1)));
+  Map map;
+  for (uint64_t key : keys)
+    map.insert({key, key});
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(keys[i])->second);
+    if (++i == keys.size())
+      i = 0;
+  }
+}
+
+template <typename Map>
+void BM_LookupMiss(benchmark::State &state) {
+  const auto &keys = ids(static_cast<Shape>(state.range(0)),
+                         static_cast<size_t>(state.range(1)));
+  Map map;
+  for (uint64_t key : keys)
+    map.insert({key, key});
+  size_t i = 0;
+  for (auto _ : state) {
+    // the top bit is never set in any shape
+    benchmark::DoNotOptimize(map.find(keys[i] | (uint64_t{1} << 63)));
+    if (++i == keys.size())
+      i = 0;
+  }
+}
+
+using Int = rwstd::IntMap<uint64_t, uint64_t>;
+using Generic = rwstd::UnorderedMap<uint64_t, uint64_t>;
+
+void shapes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"shape", "n"});
+  for (int64_t shape : {dense, sparse, sequential}) {
+    b->Args({shape, 1 << 10});
+    b->Args({shape, 1 << 20});
+  }
+}
+
+BENCHMARK(BM_Insert<Int>)->Apply(shapes);
+BENCHMARK(BM_Insert<Generic>)->Apply(shapes);
+BENCHMARK(BM_LookupHit<Int>)->Apply(shapes);
+BENCHMARK(BM_LookupHit<Generic>)->Apply(shapes);
+BENCHMARK(BM_LookupMiss<Int>)->Apply(shapes);
+BENCHMARK(BM_LookupMiss<Generic>)->Apply(shapes);
+
+} // namespace
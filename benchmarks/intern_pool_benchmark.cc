@@ -0,0 +1,164 @@
+#include "InternPool/intern_pool.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * A metrics style tag stream: every event carries one tag per key below,
+ * values drawn Zipf(1.1) from each key's cardinality, so a few envs and
+ * services dominate while endpoints form a long tail, plus a near uniform
+ * host out of 20k. A million tag occurrences, ~22k distinct tags.
+ *
+ * Store: keeping every occurrence as a std::string against interning it to
+ * a 4 byte Symbol (bytes counter is the footprint either way). Count:
+ * tallying occurrences in a string keyed against a Symbol keyed map.
+ * Intern/threads: the stream split over threads into one 16 shard pool.
+ */
+
+namespace {
+
+struct TagKey {
+  const char *name;
+  size_t cardinality;
+};
+
+constexpr TagKey tag_keys[] = {{"env", 4},          {"region", 12},
+                               {"service", 200},    {"version", 50},
+                               {"endpoint", 2000}};
+constexpr size_t events = 200000;
+
+const std::vector<std::string> &stream() {
+  static auto *tags = [] {
+    auto *out = new std::vector<std::string>;
+    std::mt19937_64 rng(11);
+    std::vector<std::vector<double>> cdfs;
+    for (const auto &key : tag_keys) {
+      std::vector<double> cdf;
+      double total = 0;
+      for (size_t rank = 1; rank <= key.cardinality; ++rank) {
+        total += 1.0 / std::pow(static_cast<double>(rank), 1.1);
+        cdf.push_back(total);
+      }
+      cdfs.push_back(cdf);
+    }
+    for (size_t e = 0; e < events; ++e) {
+      for (size_t k = 0; k < std::size(tag_keys); ++k) {
+        const auto &cdf = cdfs[k];
+        std::uniform_real_distribution<double> uniform(0, cdf.back());
+        auto rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) -
+                    cdf.begin();
+        out->push_back(std::string(tag_keys[k].name) + ":value-" +
+                       std::to_string(rank));
+      }
+      // hosts are near uniform over a large fleet
+      out->push_back("host:ip-10-0-" + std::to_string(rng() % 20000));
+    }
+    return out;
+  }();
+  return *tags;
+}
+
+size_t string_bytes(const std::string &s) {
+  // libstdc++ keeps 15 chars inline, longer ones allocate size + 1
+  return sizeof(std::string) + (s.size() > 15 ? s.size() + 1 : 0);
+}
+
+void BM_StoreStrings(benchmark::State &state) {
+  const auto &tags = stream();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::vector<std::string> stored(tags.begin(), tags.end());
+    bytes = 0;
+    for (const auto &s : stored)
+      bytes += string_bytes(s);
+    benchmark::DoNotOptimize(stored.data());
+  }
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tags.size()));
+}
+BENCHMARK(BM_StoreStrings)->Unit(benchmark::kMillisecond);
+
+void BM_StoreSymbols(benchmark::State &state) {
+  const auto &tags = stream();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    rwstd::InternPool pool;
+    std::vector<rwstd::Symbol> stored;
+    stored.reserve(tags.size());
+    for (const auto &s : tags)
+      stored.push_back(pool.intern(s));
+    bytes = stored.size() * sizeof(rwstd::Symbol) + pool.memory_usage();
+    benchmark::DoNotOptimize(stored.data());
+  }
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tags.size()));
+}
+BENCHMARK(BM_StoreSymbols)->Unit(benchmark::kMillisecond);
+
+void BM_CountByString(benchmark::State &state) {
+  const auto &tags = stream();
+  for (auto _ : state) {
+    rwstd::UnorderedMap<std::string, uint64_t> counts;
+    for (const auto &s : tags)
+      ++counts[s];
+    benchmark::DoNotOptimize(counts.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tags.size()));
+}
+BENCHMARK(BM_CountByString)->Unit(benchmark::kMillisecond);
+
+void BM_CountBySymbol(benchmark::State &state) {
+  const auto &tags = stream();
+  rwstd::InternPool pool;
+  std::vector<rwstd::Symbol> symbols;
+  for (const auto &s : tags)
+    symbols.push_back(pool.intern(s));
+  for (auto _ : state) {
+    rwstd::UnorderedMap<rwstd::Symbol, uint64_t> counts;
+    for (rwstd::Symbol s : symbols)
+      ++counts[s];
+    benchmark::DoNotOptimize(counts.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tags.size()));
+}
+BENCHMARK(BM_CountBySymbol)->Unit(benchmark::kMillisecond);
+
+void BM_ConcurrentIntern(benchmark::State &state) {
+  const auto &tags = stream();
+  const size_t threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    rwstd::InternPool pool(16);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        size_t slice = tags.size() / threads;
+        size_t end = t + 1 == threads ? tags.size() : (t + 1) * slice;
+        for (size_t i = t * slice; i < end; ++i)
+          benchmark::DoNotOptimize(pool.intern(tags[i]));
+      });
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tags.size()));
+}
+BENCHMARK(BM_ConcurrentIntern)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
@@ -0,0 +1,119 @@
+#include "LruCache/lru_cache.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+ * Replays a Zipfian request trace over a million keys through a cache that
+ * holds 1% of them: a hit reads the value, a miss stores it. Reported are
+ * requests per second and the hit rate. The baseline is the hand rolled
+ * pairing this replaces, an UnorderedMap of std::list iterators.
+ *
+ * Arg is the Zipf exponent times 100; 0.8 is a flat web trace, 1.2 a hot
+ * key set.
+ */
+
+namespace {
+
+constexpr size_t universe = 1 << 20;
+constexpr size_t trace_length = 1 << 21;
+constexpr size_t cache_size = universe / 100;
+
+const std::vector<uint64_t> &trace(int64_t skew) {
+  static std::vector<std::pair<int64_t, std::vector<uint64_t> *>> cache;
+  for (auto &[s, data] : cache) {
+    if (s == skew)
+      return *data;
+  }
+  double exponent = static_cast<double>(skew) / 100.0;
+  std::vector<double> cdf(universe);
+  double total = 0;
+  for (size_t rank = 0; rank < universe; ++rank) {
+    total += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+    cdf[rank] = total;
+  }
+  // popular keys scattered over the key space rather than 0, 1, 2, ...
+  std::vector<uint64_t> key_of(universe);
+  for (size_t i = 0; i < universe; ++i)
+    key_of[i] = i;
+  std::mt19937_64 rng(static_cast<uint64_t>(skew));
+  std::shuffle(key_of.begin(), key_of.end(), rng);
+
+  auto *data = new std::vector<uint64_t>(trace_length);
+  std::uniform_real_distribution<double> uniform(0.0, total);
+  for (auto &key : *data) {
+    size_t rank = static_cast<size_t>(
+        std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+    key = key_of[std::min(rank, universe - 1)];
+  }
+  cache.push_back({skew, data});
+  return *data;
+}
+
+template <typename Cache>
+void BM_Replay(benchmark::State &state) {
+  const auto &requests = trace(state.range(0));
+  rwstd::CacheStats stats;
+  for (auto _ : state) {
+    Cache cache(cache_size);
+    for (uint64_t key : requests) {
+      if (uint64_t *value = cache.get(key))
+        benchmark::DoNotOptimize(*value);
+      else
+        cache.put(key, key);
+    }
+    stats = cache.stats();
+  }
+  state.counters["hit_rate"] = stats.hit_rate();
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(requests.size()));
+}
+
+// UnorderedMap + std::list, two allocations per entry
+class ListLru {
+  using Item = std::pair<uint64_t, uint64_t>;
+  std::list<Item> _order;
+  rwstd::UnorderedMap<uint64_t, std::list<Item>::iterator> _index;
+  size_t _capacity;
+  rwstd::CacheStats _stats;
+
+public:
+  explicit ListLru(size_t capacity) : _capacity{capacity} {}
+
+  uint64_t *get(uint64_t key) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+      ++_stats.misses;
+      return nullptr;
+    }
+    ++_stats.hits;
+    _order.splice(_order.begin(), _order, it->second);
+    return &it->second->second;
+  }
+
+  void put(uint64_t key, uint64_t value) {
+    if (_order.size() == _capacity) {
+      _index.erase(_order.back().first);
+      _order.pop_back();
+    }
+    _order.emplace_front(key, value);
+    _index.insert({key, _order.begin()});
+  }
+
+  const rwstd::CacheStats &stats() const { return _stats; }
+};
+
+using Lru = rwstd::LruCache<uint64_t, uint64_t>;
+using Sieve = rwstd::SieveCache<uint64_t, uint64_t>;
+
+BENCHMARK(BM_Replay<Lru>)->Arg(80)->Arg(120)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Replay<Sieve>)->Arg(80)->Arg(120)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Replay<ListLru>)->Arg(80)->Arg(120)->Unit(benchmark::kMillisecond);
+
+} // namespace
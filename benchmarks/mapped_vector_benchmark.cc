@@ -0,0 +1,150 @@
+#include "MappedVector/mapped_vector.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * Startup cost of a 256MB dataset of doubles: mapping the file vs reading it
+ * into a Vector. "Cold" drops the file from the page cache before every
+ * iteration (posix_fadvise DONTNEED, only clean pages go, so this is best
+ * effort without root), "Warm" leaves it cached.
+ *
+ *   Open       - time until the first element can be read
+ *   FirstTouch - open plus one random element
+ *   Scan       - open plus a full sum, what a reader pays when it needs it all
+ */
+
+namespace {
+
+constexpr size_t elements = size_t{1} << 25;
+
+const std::string &dataset() {
+  static const std::string path = [] {
+    std::string p = (std::filesystem::temp_directory_path() /
+                     "rwstd_mapped_vector_benchmark.bin")
+                        .string();
+    auto v = rwstd::MappedVector<double>::create(p, elements);
+    for (size_t i = 0; i < elements; ++i) {
+      v.push_back(static_cast<double>(i) * 0.5);
+    }
+    return p;
+  }();
+  return path;
+}
+
+void drop_cache(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+}
+
+void prepare(benchmark::State &state, bool cold) {
+  if (cold) {
+    state.PauseTiming();
+    drop_cache(dataset());
+    state.ResumeTiming();
+  }
+}
+
+rwstd::Vector<double> read_into_vector(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  rwstd::detail::MappedHeader header{};
+  if (::pread(fd, &header, sizeof(header), 0) != sizeof(header))
+    header.size = 0;
+  rwstd::Vector<double> v(header.size);
+  size_t bytes = header.size * sizeof(double);
+  size_t done = 0;
+  auto *out = reinterpret_cast<char *>(&v[0]);
+  while (done < bytes) {
+    ssize_t got = ::pread(fd, out + done, bytes - done,
+                          static_cast<off_t>(sizeof(header) + done));
+    if (got <= 0)
+      break;
+    done += static_cast<size_t>(got);
+  }
+  ::close(fd);
+  return v;
+}
+
+enum class Access { open, first_touch, scan };
+
+template <typename Container>
+double consume(const Container &c, size_t n, Access access) {
+  if (access == Access::open)
+    return 0;
+  if (access == Access::first_touch)
+    return c[n / 3 * 2];
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += c[i];
+  return sum;
+}
+
+void BM_Mapped(benchmark::State &state, bool cold, Access access) {
+  const std::string &path = dataset();
+  for (auto _ : state) {
+    prepare(state, cold);
+    auto v = rwstd::MappedVector<double>::open(path);
+    benchmark::DoNotOptimize(consume(v, v.size(), access));
+  }
+  if (access == Access::scan)
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(elements * sizeof(double)));
+}
+
+void BM_MappedVerified(benchmark::State &state, bool cold) {
+  const std::string &path = dataset();
+  for (auto _ : state) {
+    prepare(state, cold);
+    auto v = rwstd::MappedVector<double>::open(path);
+    v.verify();
+    benchmark::DoNotOptimize(v[0]);
+  }
+}
+
+void BM_VectorRead(benchmark::State &state, bool cold, Access access) {
+  const std::string &path = dataset();
+  for (auto _ : state) {
+    prepare(state, cold);
+    auto v = read_into_vector(path);
+    benchmark::DoNotOptimize(consume(v, v.size(), access));
+  }
+  if (access == Access::scan)
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(elements * sizeof(double)));
+}
+
+BENCHMARK_CAPTURE(BM_Mapped, Cold_Open, true, Access::open)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Mapped, Cold_FirstTouch, true, Access::first_touch)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Mapped, Cold_Scan, true, Access::scan)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Mapped, Warm_Open, false, Access::open)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Mapped, Warm_FirstTouch, false, Access::first_touch)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Mapped, Warm_Scan, false, Access::scan)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_MappedVerified, Cold, true)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_MappedVerified, Warm, false)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_VectorRead, Cold_FirstTouch, true, Access::first_touch)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_VectorRead, Cold_Scan, true, Access::scan)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_VectorRead, Warm_FirstTouch, false, Access::first_touch)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_VectorRead, Warm_Scan, false, Access::scan)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,163 @@
+#include "PackedVector/packed_vector.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+
+/*
+ * Footprint and decode speed against an uncompressed Vector of the same
+ * values (bytes counter). Small values: 4M uint32_t below 2^bits, summed
+ * from a Vector, by BitPackedVector::unpack in 1024 element batches and
+ * through its iterator. Sorted ids: 4M uint64_t ids with random gaps under
+ * 64, summed from a Vector and from a DeltaVector by unpack and iterator,
+ * then 64K random reads.
+ */
+
+namespace {
+
+constexpr size_t count = 1 << 22;
+constexpr size_t batch = 1024;
+
+template <typename T>
+size_t vector_bytes(const rwstd::Vector<T> &values) {
+  return values.capacity() * sizeof(T);
+}
+
+rwstd::Vector<uint32_t> small_values(unsigned bits) {
+  std::mt19937_64 rng(bits);
+  rwstd::Vector<uint32_t> values;
+  for (size_t i = 0; i < count; ++i)
+    values.push_back(static_cast<uint32_t>(rng() & ((1ull << bits) - 1)));
+  return values;
+}
+
+rwstd::Vector<uint64_t> sorted_ids() {
+  std::mt19937_64 rng(5);
+  rwstd::Vector<uint64_t> ids;
+  uint64_t id = 1ull << 40;
+  for (size_t i = 0; i < count; ++i) {
+    id += 1 + rng() % 64;
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+void BM_VectorSum(benchmark::State &state) {
+  auto values = small_values(static_cast<unsigned>(state.range(0)));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i)
+      sum += values[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytes"] = static_cast<double>(vector_bytes(values));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_VectorSum)->ArgName("bits")->Arg(4)->Arg(12)->Arg(20);
+
+void BM_BitPackedUnpackSum(benchmark::State &state) {
+  auto values = small_values(static_cast<unsigned>(state.range(0)));
+  rwstd::BitPackedVector<uint32_t> packed(
+      static_cast<unsigned>(state.range(0)));
+  for (size_t i = 0; i < count; ++i)
+    packed.push_back(values[i]);
+  packed.shrink_to_fit();
+  uint32_t out[batch];
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t first = 0; first < count; first += batch) {
+      packed.unpack(first, batch, out);
+      for (uint32_t value : out)
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytes"] = static_cast<double>(packed.memory_usage());
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_BitPackedUnpackSum)->ArgName("bits")->Arg(4)->Arg(12)->Arg(20);
+
+void BM_BitPackedIterateSum(benchmark::State &state) {
+  auto values = small_values(static_cast<unsigned>(state.range(0)));
+  rwstd::BitPackedVector<uint32_t> packed(
+      static_cast<unsigned>(state.range(0)));
+  for (size_t i = 0; i < count; ++i)
+    packed.push_back(values[i]);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint32_t value : packed)
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_BitPackedIterateSum)->ArgName("bits")->Arg(4)->Arg(12)->Arg(20);
+
+void BM_VectorIdSum(benchmark::State &state) {
+  auto ids = sorted_ids();
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i)
+      sum += ids[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytes"] = static_cast<double>(vector_bytes(ids));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_VectorIdSum);
+
+rwstd::DeltaVector<uint64_t> packed_ids(const rwstd::Vector<uint64_t> &ids) {
+  rwstd::DeltaVector<uint64_t> packed;
+  for (size_t i = 0; i < count; ++i)
+    packed.push_back(ids[i]);
+  packed.shrink_to_fit();
+  return packed;
+}
+
+void BM_DeltaUnpackSum(benchmark::State &state) {
+  auto packed = packed_ids(sorted_ids());
+  uint64_t out[batch];
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t first = 0; first < count; first += batch) {
+      packed.unpack(first, batch, out);
+      for (uint64_t value : out)
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytes"] = static_cast<double>(packed.memory_usage());
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_DeltaUnpackSum);
+
+void BM_DeltaIterateSum(benchmark::State &state) {
+  auto packed = packed_ids(sorted_ids());
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t value : packed)
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_DeltaIterateSum);
+
+void BM_DeltaRandomAccess(benchmark::State &state) {
+  auto packed = packed_ids(sorted_ids());
+  std::mt19937_64 rng(9);
+  rwstd::Vector<size_t> probes;
+  for (size_t i = 0; i < 65536; ++i)
+    probes.push_back(rng() % count);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < probes.size(); ++i)
+      sum += packed[probes[i]];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(probes.size()));
+}
+BENCHMARK(BM_DeltaRandomAccess);
+
+} // namespace
@@ -0,0 +1,160 @@
+#include "Parallel/parallel.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+
+/*
+ * Strong scaling: a fixed problem size run with 1 .. hardware_concurrency
+ * threads. A pool of t - 1 workers plus the calling thread gives t threads.
+ * Compare each row with the threads:1 row of the same benchmark.
+ */
+
+namespace {
+
+constexpr size_t problem_size = size_t{1} << 24;
+
+void thread_counts(benchmark::internal::Benchmark *b) {
+  int max_threads =
+      static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+  for (int t = 1; t < max_threads; t *= 2) {
+    b->Arg(t);
+  }
+  b->Arg(max_threads);
+  b->ArgName("threads");
+  b->UseRealTime();
+  b->Unit(benchmark::kMillisecond);
+}
+
+rwstd::Vector<double> random_doubles(size_t n) {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  rwstd::Vector<double> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = dist(rng);
+  }
+  return v;
+}
+
+void BM_ForEach(benchmark::State &state) {
+  rwstd::ThreadPool pool(static_cast<size_t>(state.range(0) - 1));
+  rwstd::parallel::Config config{&pool};
+  auto data = random_doubles(problem_size);
+  for (auto _ : state) {
+    rwstd::parallel::for_each(
+        data, [](double &x) { x = std::sqrt(x * x + 1.0); }, config);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_ForEach)->Apply(thread_counts);
+
+void BM_Transform(benchmark::State &state) {
+  rwstd::ThreadPool pool(static_cast<size_t>(state.range(0) - 1));
+  rwstd::parallel::Config config{&pool};
+  auto data = random_doubles(problem_size);
+  rwstd::Vector<double> out(problem_size);
+  for (auto _ : state) {
+    rwstd::parallel::transform(
+        data, out, [](double x) { return std::exp(x); }, config);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_Transform)->Apply(thread_counts);
+
+void BM_Reduce(benchmark::State &state) {
+  rwstd::ThreadPool pool(static_cast<size_t>(state.range(0) - 1));
+  rwstd::parallel::Config config{&pool};
+  auto data = random_doubles(problem_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        rwstd::parallel::reduce(data, 0.0, std::plus<>{}, config));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_Reduce)->Apply(thread_counts);
+
+void BM_InclusiveScan(benchmark::State &state) {
+  rwstd::ThreadPool pool(static_cast<size_t>(state.range(0) - 1));
+  rwstd::parallel::Config config{&pool};
+  auto data = random_doubles(problem_size);
+  rwstd::Vector<double> out(problem_size);
+  for (auto _ : state) {
+    rwstd::parallel::inclusive_scan(data, out, std::plus<>{}, config);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_InclusiveScan)->Apply(thread_counts);
+
+void BM_Sort(benchmark::State &state) {
+  rwstd::ThreadPool pool(static_cast<size_t>(state.range(0) - 1));
+  rwstd::parallel::Config config{&pool};
+  auto source = random_doubles(problem_size);
+  rwstd::Vector<double> data(problem_size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::copy(source.cbegin(), source.cend(), data.begin());
+    state.ResumeTiming();
+    rwstd::parallel::sort(data, std::less<>{}, config);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_Sort)->Apply(thread_counts);
+
+// sequential baselines for the threads:1 rows
+void BM_StdSort(benchmark::State &state) {
+  auto source = random_doubles(problem_size);
+  rwstd::Vector<double> data(problem_size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::copy(source.cbegin(), source.cend(), data.begin());
+    state.ResumeTiming();
+    std::sort(data.begin(), data.end());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_StdSort)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+void BM_StdReduce(benchmark::State &state) {
+  auto data = random_doubles(problem_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::reduce(data.cbegin(), data.cend(), 0.0));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_StdReduce)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// grain size sweep on all threads: too small drowns in task overhead, too big
+// leaves threads idle at the end
+void BM_ForEachGrain(benchmark::State &state) {
+  rwstd::ThreadPool pool;
+  rwstd::parallel::Config config{&pool};
+  config.grain_size = static_cast<size_t>(state.range(0));
+  auto data = random_doubles(problem_size);
+  for (auto _ : state) {
+    rwstd::parallel::for_each(
+        data, [](double &x) { x = std::sqrt(x * x + 1.0); }, config);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(problem_size));
+}
+BENCHMARK(BM_ForEachGrain)
+    ->ArgName("grain")
+    ->RangeMultiplier(4)
+    ->Range(256, 1 << 20)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,102 @@
+#include "PriorityQueue/priority_queue.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/*
+ * PriorityQueue at arity 2, 4 and 8 against std::priority_queue (a binary
+ * heap over std::vector), all min-queues of 64 bit keys from 1K to 100M
+ * elements. PushPop pushes n random keys and pops them all; Hold is the
+ * scheduler pattern, a queue kept at n elements while every step pops the
+ * earliest key and pushes a later one; Heapify builds from a range. The 100M
+ * sizes need about 2GB and minutes per run, filter them out for quick runs.
+ */
+
+namespace {
+
+using Std = std::priority_queue<uint64_t, std::vector<uint64_t>,
+                                std::greater<uint64_t>>;
+template <std::size_t Arity>
+using Dary = rwstd::PriorityQueue<uint64_t, std::greater<uint64_t>, Arity>;
+
+constexpr int64_t hold_steps = 1 << 20;
+
+// xorshift, cheap enough not to show up next to the heap
+uint64_t next_key(uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+void sizes(benchmark::internal::Benchmark *bench) {
+  for (int64_t n : {1'000, 100'000, 10'000'000, 100'000'000})
+    bench->Arg(n);
+  bench->Unit(benchmark::kMillisecond);
+}
+
+template <typename Queue>
+void BM_PushPop(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    Queue queue;
+    uint64_t rng = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+      queue.push(next_key(rng));
+    uint64_t sum = 0;
+    while (!queue.empty()) {
+      sum += queue.top();
+      queue.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+}
+BENCHMARK(BM_PushPop<Std>)->Apply(sizes);
+BENCHMARK(BM_PushPop<Dary<2>>)->Apply(sizes);
+BENCHMARK(BM_PushPop<Dary<4>>)->Apply(sizes);
+BENCHMARK(BM_PushPop<Dary<8>>)->Apply(sizes);
+
+template <typename Queue>
+void BM_Hold(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  Queue queue;
+  uint64_t rng = 88172645463325252ull;
+  for (size_t i = 0; i < n; ++i)
+    queue.push(next_key(rng) >> 32);
+  for (auto _ : state) {
+    for (int64_t step = 0; step < hold_steps; ++step) {
+      uint64_t now = queue.top();
+      queue.pop();
+      queue.push(now + (next_key(rng) >> 40));
+    }
+  }
+  benchmark::DoNotOptimize(queue.top());
+  state.SetItemsProcessed(state.iterations() * hold_steps);
+}
+BENCHMARK(BM_Hold<Std>)->Apply(sizes);
+BENCHMARK(BM_Hold<Dary<2>>)->Apply(sizes);
+BENCHMARK(BM_Hold<Dary<4>>)->Apply(sizes);
+BENCHMARK(BM_Hold<Dary<8>>)->Apply(sizes);
+
+template <typename Queue>
+void BM_Heapify(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  std::vector<uint64_t> keys(n);
+  uint64_t rng = 88172645463325252ull;
+  for (auto &key : keys)
+    key = next_key(rng);
+  for (auto _ : state) {
+    Queue queue(keys.begin(), keys.end(), std::greater<uint64_t>());
+    benchmark::DoNotOptimize(queue.top());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Heapify<Std>)->Apply(sizes);
+BENCHMARK(BM_Heapify<Dary<2>>)->Apply(sizes);
+BENCHMARK(BM_Heapify<Dary<4>>)->Apply(sizes);
+BENCHMARK(BM_Heapify<Dary<8>>)->Apply(sizes);
+
+} // namespace
@@ -0,0 +1,208 @@
+#include "RingBuffer/concurrent_queue.hpp"
+#include "RingBuffer/ring_buffer.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+ * Passing integers between two pinned threads. Throughput: a producer
+ * pushes a million items through a 1024 slot queue to a consumer, for the
+ * SPSC queue (consumer takes batches), the MPMC queue, and what pipelines
+ * do today, a RingBuffer under a mutex. Latency: one item ping-pongs over a
+ * pair of SPSC queues, time is per round trip. Args are the two cores; the
+ * pairs cover the same core, a neighbour, the middle and the last core, so
+ * SMT siblings and sockets show up on machines that have them. MPMC
+ * contention runs n producers against n consumers, unpinned.
+ */
+
+namespace {
+
+constexpr uint64_t items = 1 << 20;
+constexpr size_t capacity = 1024;
+
+bool pin(int core) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<size_t>(core), &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)core;
+  return true;
+#endif
+}
+
+void core_pairs(benchmark::internal::Benchmark *bench) {
+  auto cores =
+      static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<int> seconds = {0, 1, cores / 2, cores - 1};
+  std::sort(seconds.begin(), seconds.end());
+  seconds.erase(std::unique(seconds.begin(), seconds.end()), seconds.end());
+  bench->ArgNames({"producer", "consumer"});
+  for (int second : seconds) {
+    if (second < cores)
+      bench->Args({0, second});
+  }
+}
+
+// runs producer on one core and consumer on another, items per second
+template <typename Producer, typename Consumer>
+void pinned_pair(benchmark::State &state, Producer producer,
+                 Consumer consumer) {
+  auto first = static_cast<int>(state.range(0));
+  auto second = static_cast<int>(state.range(1));
+  for (auto _ : state) {
+    bool pinned = true;
+    std::thread other([&] {
+      pinned = pin(second);
+      consumer();
+    });
+    pinned = pin(first) && pinned;
+    producer();
+    other.join();
+    if (!pinned) {
+      state.SkipWithError("could not pin threads");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(items));
+}
+
+void BM_SPSCThroughput(benchmark::State &state) {
+  rwstd::SPSCQueue<uint64_t> queue(capacity);
+  uint64_t sum = 0;
+  pinned_pair(
+      state,
+      [&] {
+        for (uint64_t i = 0; i < items; ++i)
+          queue.push(i);
+      },
+      [&] {
+        uint64_t seen = 0;
+        for (rwstd::detail::QueueBackoff backoff; seen < items;) {
+          uint64_t took = queue.consume([&](uint64_t value) { sum += value; });
+          seen += took;
+          if (took == 0)
+            backoff.pause();
+          else
+            backoff = {};
+        }
+      });
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_SPSCThroughput)->Apply(core_pairs)->UseRealTime();
+
+void BM_MPMCThroughput(benchmark::State &state) {
+  rwstd::MPMCQueue<uint64_t> queue(capacity);
+  uint64_t sum = 0;
+  pinned_pair(
+      state,
+      [&] {
+        for (uint64_t i = 0; i < items; ++i)
+          queue.push(i);
+      },
+      [&] {
+        for (uint64_t i = 0; i < items; ++i)
+          sum += queue.pop();
+      });
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_MPMCThroughput)->Apply(core_pairs)->UseRealTime();
+
+void BM_MutexRingThroughput(benchmark::State &state) {
+  rwstd::RingBuffer<uint64_t> ring(capacity);
+  std::mutex mutex;
+  uint64_t sum = 0;
+  pinned_pair(
+      state,
+      [&] {
+        rwstd::detail::QueueBackoff backoff;
+        for (uint64_t i = 0; i < items;) {
+          std::unique_lock<std::mutex> lock(mutex);
+          uint64_t start = i;
+          for (; i < items && ring.try_push(i); ++i) {
+          }
+          lock.unlock();
+          if (i == start)
+            backoff.pause();
+        }
+      },
+      [&] {
+        rwstd::detail::QueueBackoff backoff;
+        for (uint64_t seen = 0; seen < items;) {
+          std::unique_lock<std::mutex> lock(mutex);
+          auto [first, second] = ring.spans();
+          for (uint64_t value : first)
+            sum += value;
+          for (uint64_t value : second)
+            sum += value;
+          size_t took = ring.size();
+          ring.clear();
+          lock.unlock();
+          seen += took;
+          if (took == 0)
+            backoff.pause();
+        }
+      });
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_MutexRingThroughput)->Apply(core_pairs)->UseRealTime();
+
+void BM_SPSCRoundTrip(benchmark::State &state) {
+  constexpr uint64_t trips = 1 << 16;
+  rwstd::SPSCQueue<uint64_t> ping(capacity);
+  rwstd::SPSCQueue<uint64_t> pong(capacity);
+  pinned_pair(
+      state,
+      [&] {
+        for (uint64_t i = 0; i < trips; ++i) {
+          ping.push(i);
+          benchmark::DoNotOptimize(pong.pop());
+        }
+      },
+      [&] {
+        for (uint64_t i = 0; i < trips; ++i)
+          pong.push(ping.pop());
+      });
+  // pinned_pair counted items, a round trip is the unit here
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trips));
+}
+BENCHMARK(BM_SPSCRoundTrip)->Apply(core_pairs)->UseRealTime();
+
+void BM_MPMCContended(benchmark::State &state) {
+  const auto pairs = static_cast<uint64_t>(state.range(0));
+  for (auto _ : state) {
+    rwstd::MPMCQueue<uint64_t> queue(capacity);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < pairs; ++t) {
+      threads.emplace_back([&] {
+        for (uint64_t i = 0; i < items / pairs; ++i)
+          queue.push(i);
+      });
+      threads.emplace_back([&] {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < items / pairs; ++i)
+          sum += queue.pop();
+        benchmark::DoNotOptimize(sum);
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(items));
+}
+BENCHMARK(BM_MPMCContended)
+    ->ArgName("pairs")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+} // namespace
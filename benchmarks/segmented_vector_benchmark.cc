@@ -0,0 +1,99 @@
+#include "SegmentedVector/segmented_vector.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+ * Worst case push_back latency and memory overhead, Vector vs SegmentedVector,
+ * filling 16M non-trivially movable records. Every push_back is timed on its
+ * own: Vector's max_ns is the final reallocation moving every element,
+ * SegmentedVector's is one block allocation.
+ */
+
+namespace {
+
+struct Record {
+  std::string name;
+  uint64_t a;
+  uint64_t b;
+};
+
+constexpr int64_t big = int64_t{1} << 24;
+
+template <typename Container>
+void push_back_latency(benchmark::State &state) {
+  size_t n = static_cast<size_t>(state.range(0));
+  double max_ns = 0;
+  double total_ns = 0;
+  size_t capacity = 0;
+  for (auto _ : state) {
+    Container c;
+    for (size_t i = 0; i < n; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      c.push_back(Record{"record", i, i});
+      auto stop = std::chrono::steady_clock::now();
+      double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+      max_ns = std::max(max_ns, ns);
+      total_ns += ns;
+    }
+    capacity = c.capacity();
+    benchmark::DoNotOptimize(c);
+  }
+  state.counters["max_ns"] = max_ns;
+  state.counters["mean_ns"] =
+      total_ns / static_cast<double>(n * static_cast<size_t>(state.iterations()));
+  // allocated element slots per stored element
+  state.counters["overhead"] =
+      static_cast<double>(capacity) / static_cast<double>(n);
+  state.counters["bytes"] =
+      static_cast<double>(capacity * sizeof(Record));
+}
+
+void BM_Vector_PushBackLatency(benchmark::State &state) {
+  push_back_latency<rwstd::Vector<Record>>(state);
+}
+BENCHMARK(BM_Vector_PushBackLatency)
+    ->Arg(1 << 20)
+    ->Arg(big)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SegmentedVector_PushBackLatency(benchmark::State &state) {
+  push_back_latency<rwstd::SegmentedVector<Record>>(state);
+}
+BENCHMARK(BM_SegmentedVector_PushBackLatency)
+    ->Arg(1 << 20)
+    ->Arg(big)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// the price of stable references: indexed reads need the block lookup
+template <typename Container>
+void random_access_sum(benchmark::State &state) {
+  size_t n = static_cast<size_t>(state.range(0));
+  Container c;
+  for (size_t i = 0; i < n; ++i) {
+    c.push_back(Record{"", i, i});
+  }
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i += 7) {
+      sum += c[(i * 2654435761u) % n].a;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void BM_Vector_RandomAccess(benchmark::State &state) {
+  random_access_sum<rwstd::Vector<Record>>(state);
+}
+BENCHMARK(BM_Vector_RandomAccess)->Arg(1 << 20);
+
+void BM_SegmentedVector_RandomAccess(benchmark::State &state) {
+  random_access_sum<rwstd::SegmentedVector<Record>>(state);
+}
+BENCHMARK(BM_SegmentedVector_RandomAccess)->Arg(1 << 20);
+
+} // namespace
@@ -0,0 +1,149 @@
+#include "Serialize/serialize.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/*
+ * Serialization throughput. Vectors go through memory (BytesWriter /
+ * BufferReader) and through a file descriptor, maps are compared against the
+ * element by element rebuild they replace: iterate the source and insert
+ * every pair into a fresh map, paying a hash and a rehash cascade.
+ */
+
+namespace {
+
+struct BytesWriter {
+  std::vector<std::byte> bytes;
+
+  void write(const void *data, std::size_t n) {
+    const auto *p = static_cast<const std::byte *>(data);
+    bytes.insert(bytes.end(), p, p + n);
+  }
+};
+
+rwstd::Vector<uint64_t> make_vector(size_t n) {
+  rwstd::Vector<uint64_t> v;
+  v.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    v.push_back(i * 0x9e3779b97f4a7c15ull);
+  }
+  return v;
+}
+
+using Map = rwstd::UnorderedMap<uint64_t, uint64_t>;
+
+// keys stay in a list so the rebuild baseline doesn't need map iteration
+std::vector<uint64_t> make_keys(size_t n) {
+  std::vector<uint64_t> keys;
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back(i * 0x9e3779b97f4a7c15ull);
+  }
+  return keys;
+}
+
+void BM_VectorWriteBuffer(benchmark::State &state) {
+  auto v = make_vector(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    BytesWriter writer;
+    writer.bytes.reserve(v.size() * sizeof(uint64_t) + 128);
+    rwstd::serialize::write(writer, v);
+    benchmark::DoNotOptimize(writer.bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_VectorWriteBuffer)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
+
+void BM_VectorReadBuffer(benchmark::State &state) {
+  BytesWriter writer;
+  rwstd::serialize::write(writer,
+                          make_vector(static_cast<size_t>(state.range(0))));
+  for (auto _ : state) {
+    rwstd::serialize::BufferReader reader(writer.bytes);
+    auto v = rwstd::serialize::read_vector<uint64_t>(reader);
+    benchmark::DoNotOptimize(v[0]);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_VectorReadBuffer)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
+
+// in place: cost is independent of the element count
+void BM_VectorViewBuffer(benchmark::State &state) {
+  BytesWriter writer;
+  rwstd::serialize::write(writer,
+                          make_vector(static_cast<size_t>(state.range(0))));
+  for (auto _ : state) {
+    rwstd::serialize::BufferReader reader(writer.bytes);
+    auto view = rwstd::serialize::view_vector<uint64_t>(reader);
+    benchmark::DoNotOptimize(view.data());
+  }
+}
+BENCHMARK(BM_VectorViewBuffer)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
+
+void BM_VectorFdRoundTrip(benchmark::State &state) {
+  auto v = make_vector(static_cast<size_t>(state.range(0)));
+  std::FILE *f = std::tmpfile();
+  int fd = fileno(f);
+  for (auto _ : state) {
+    ::lseek(fd, 0, SEEK_SET);
+    {
+      rwstd::serialize::FdWriter writer(fd);
+      rwstd::serialize::write(writer, v);
+    }
+    ::lseek(fd, 0, SEEK_SET);
+    rwstd::serialize::FdReader reader(fd);
+    auto loaded = rwstd::serialize::read_vector<uint64_t>(reader);
+    benchmark::DoNotOptimize(loaded[0]);
+  }
+  std::fclose(f);
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8 * 2);
+}
+BENCHMARK(BM_VectorFdRoundTrip)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_MapWrite(benchmark::State &state) {
+  Map map;
+  for (uint64_t key : make_keys(static_cast<size_t>(state.range(0)))) {
+    map.insert({key, key});
+  }
+  for (auto _ : state) {
+    BytesWriter writer;
+    rwstd::serialize::write(writer, map);
+    benchmark::DoNotOptimize(writer.bytes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MapWrite)->Arg(1 << 10)->Arg(1 << 20);
+
+void BM_MapLoad(benchmark::State &state) {
+  Map map;
+  for (uint64_t key : make_keys(static_cast<size_t>(state.range(0)))) {
+    map.insert({key, key});
+  }
+  BytesWriter writer;
+  rwstd::serialize::write(writer, map);
+  for (auto _ : state) {
+    rwstd::serialize::BufferReader reader(writer.bytes);
+    auto loaded = rwstd::serialize::read_map<Map>(reader);
+    benchmark::DoNotOptimize(loaded.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MapLoad)->Arg(1 << 10)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_MapRebuild(benchmark::State &state) {
+  auto keys = make_keys(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Map map;
+    for (uint64_t key : keys) {
+      map.insert({key, key});
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MapRebuild)
+    ->Arg(1 << 10)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
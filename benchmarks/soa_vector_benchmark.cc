@@ -0,0 +1,140 @@
+#include "SoAVector/soa_vector.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+/*
+ * Vector<Particle> (array of structs) vs SoAVector over the same fields.
+ * Single field scans should favour SoA by roughly sizeof(Particle) /
+ * sizeof(field), full record updates should be close to a wash.
+ */
+
+namespace {
+
+struct Particle {
+  double x, y, z;
+  double vx, vy, vz;
+  float mass;
+  int id;
+};
+
+using Particles = rwstd::SoAVector<double, double, double, double, double,
+                                   double, float, int>;
+
+void sizes(benchmark::internal::Benchmark *b) {
+  b->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+}
+
+rwstd::Vector<Particle> make_aos(size_t n) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  rwstd::Vector<Particle> v;
+  v.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    v.push_back(Particle{dist(rng), dist(rng), dist(rng), dist(rng), dist(rng),
+                         dist(rng), 1.0f, static_cast<int>(i)});
+  }
+  return v;
+}
+
+Particles make_soa(size_t n) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  Particles v;
+  v.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    v.emplace_back(dist(rng), dist(rng), dist(rng), dist(rng), dist(rng),
+                   dist(rng), 1.0f, static_cast<int>(i));
+  }
+  return v;
+}
+
+void BM_AoS_ScanOneField(benchmark::State &state) {
+  auto v = make_aos(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+      sum += v[i].x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_AoS_ScanOneField)->Apply(sizes);
+
+void BM_SoA_ScanOneField(benchmark::State &state) {
+  auto v = make_soa(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (double x : v.column<0>()) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_SoA_ScanOneField)->Apply(sizes);
+
+void BM_AoS_FullRecord(benchmark::State &state) {
+  auto v = make_aos(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (auto &p : v) {
+      p.x += p.vx * 0.01;
+      p.y += p.vy * 0.01;
+      p.z += p.vz * 0.01;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AoS_FullRecord)->Apply(sizes);
+
+void BM_SoA_FullRecordProxy(benchmark::State &state) {
+  auto v = make_soa(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (auto [x, y, z, vx, vy, vz, mass, id] : v) {
+      x += vx * 0.01;
+      y += vy * 0.01;
+      z += vz * 0.01;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoA_FullRecordProxy)->Apply(sizes);
+
+void BM_SoA_FullRecordColumns(benchmark::State &state) {
+  auto v = make_soa(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    double *x = v.data<0>(), *y = v.data<1>(), *z = v.data<2>();
+    const double *vx = v.data<3>(), *vy = v.data<4>(), *vz = v.data<5>();
+    for (size_t i = 0; i < v.size(); ++i) {
+      x[i] += vx[i] * 0.01;
+      y[i] += vy[i] * 0.01;
+      z[i] += vz[i] * 0.01;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoA_FullRecordColumns)->Apply(sizes);
+
+void BM_AoS_PushBack(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(make_aos(static_cast<size_t>(state.range(0))));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AoS_PushBack)->Apply(sizes);
+
+void BM_SoA_PushBack(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(make_soa(static_cast<size_t>(state.range(0))));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoA_PushBack)->Apply(sizes);
+
+} // namespace
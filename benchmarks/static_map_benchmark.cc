@@ -0,0 +1,177 @@
+#include "StaticMap/static_map.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Fixed table lookups three ways: StaticMap, an UnorderedMap filled at
+ * startup, and the hand written alternative - an if chain of string compares
+ * for header names, a switch for sparse opcodes. Queries cycle through every
+ * key so the branch predictor can't learn a single answer.
+ */
+
+namespace {
+
+constexpr std::array<std::pair<std::string_view, int>, 32> header_list = {{
+    {"accept", 0},          {"accept-encoding", 1},  {"accept-language", 2},
+    {"authorization", 3},   {"cache-control", 4},    {"connection", 5},
+    {"content-encoding", 6}, {"content-length", 7},  {"content-type", 8},
+    {"cookie", 9},          {"date", 10},            {"etag", 11},
+    {"expect", 12},         {"expires", 13},         {"forwarded", 14},
+    {"host", 15},           {"if-match", 16},        {"if-modified-since", 17},
+    {"if-none-match", 18},  {"keep-alive", 19},      {"last-modified", 20},
+    {"location", 21},       {"origin", 22},          {"pragma", 23},
+    {"range", 24},          {"referer", 25},         {"server", 26},
+    {"set-cookie", 27},     {"transfer-encoding", 28}, {"upgrade", 29},
+    {"user-agent", 30},     {"vary", 31},
+}};
+
+constexpr auto headers = rwstd::make_static_map(header_list);
+
+int header_if_chain(std::string_view name) {
+  for (const auto &[key, value] : header_list) {
+    if (key == name)
+      return value;
+  }
+  return -1;
+}
+
+// sparse values, the kind a compiler lowers to a branch tree
+constexpr std::array<std::pair<uint32_t, int>, 24> opcode_list = {{
+    {0x01, 0},  {0x03, 1},  {0x07, 2},   {0x0c, 3},   {0x10, 4},
+    {0x1b, 5},  {0x22, 6},  {0x2f, 7},   {0x31, 8},   {0x44, 9},
+    {0x58, 10}, {0x5a, 11}, {0x63, 12},  {0x70, 13},  {0x7f, 14},
+    {0x81, 15}, {0x9c, 16}, {0xa0, 17},  {0xb3, 18},  {0xc4, 19},
+    {0xd0, 20}, {0xe1, 21}, {0xf0, 22},  {0xff, 23},
+}};
+
+constexpr auto opcodes = rwstd::make_static_map(opcode_list);
+
+int opcode_switch(uint32_t op) {
+  switch (op) {
+  case 0x01: return 0;
+  case 0x03: return 1;
+  case 0x07: return 2;
+  case 0x0c: return 3;
+  case 0x10: return 4;
+  case 0x1b: return 5;
+  case 0x22: return 6;
+  case 0x2f: return 7;
+  case 0x31: return 8;
+  case 0x44: return 9;
+  case 0x58: return 10;
+  case 0x5a: return 11;
+  case 0x63: return 12;
+  case 0x70: return 13;
+  case 0x7f: return 14;
+  case 0x81: return 15;
+  case 0x9c: return 16;
+  case 0xa0: return 17;
+  case 0xb3: return 18;
+  case 0xc4: return 19;
+  case 0xd0: return 20;
+  case 0xe1: return 21;
+  case 0xf0: return 22;
+  case 0xff: return 23;
+  default: return -1;
+  }
+}
+
+// runtime strings, so nothing is folded at compile time
+std::vector<std::string> header_queries() {
+  std::vector<std::string> queries;
+  for (int round = 0; round < 4; ++round) {
+    for (size_t i = 0; i < header_list.size(); ++i) {
+      queries.emplace_back(header_list[(i * 7 + static_cast<size_t>(round)) %
+                                       header_list.size()]
+                               .first);
+    }
+  }
+  return queries;
+}
+
+std::vector<uint32_t> opcode_queries() {
+  std::vector<uint32_t> queries;
+  for (size_t i = 0; i < 128; ++i) {
+    queries.push_back(opcode_list[(i * 7) % opcode_list.size()].first);
+  }
+  return queries;
+}
+
+void BM_Header_StaticMap(benchmark::State &state) {
+  auto queries = header_queries();
+  for (auto _ : state) {
+    for (const auto &q : queries)
+      benchmark::DoNotOptimize(headers.value_or(q, -1));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Header_StaticMap);
+
+void BM_Header_UnorderedMap(benchmark::State &state) {
+  auto queries = header_queries();
+  rwstd::UnorderedMap<std::string_view, int> map;
+  for (const auto &[key, value] : header_list)
+    map.insert({key, value});
+  for (auto _ : state) {
+    for (const auto &q : queries)
+      benchmark::DoNotOptimize(map.find(q)->second);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Header_UnorderedMap);
+
+void BM_Header_IfChain(benchmark::State &state) {
+  auto queries = header_queries();
+  for (auto _ : state) {
+    for (const auto &q : queries)
+      benchmark::DoNotOptimize(header_if_chain(q));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Header_IfChain);
+
+void BM_Opcode_StaticMap(benchmark::State &state) {
+  auto queries = opcode_queries();
+  for (auto _ : state) {
+    for (uint32_t q : queries)
+      benchmark::DoNotOptimize(opcodes.value_or(q, -1));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Opcode_StaticMap);
+
+void BM_Opcode_UnorderedMap(benchmark::State &state) {
+  auto queries = opcode_queries();
+  rwstd::UnorderedMap<uint32_t, int> map;
+  for (const auto &[key, value] : opcode_list)
+    map.insert({key, value});
+  for (auto _ : state) {
+    for (uint32_t q : queries)
+      benchmark::DoNotOptimize(map.find(q)->second);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Opcode_UnorderedMap);
+
+void BM_Opcode_Switch(benchmark::State &state) {
+  auto queries = opcode_queries();
+  for (auto _ : state) {
+    for (uint32_t q : queries)
+      benchmark::DoNotOptimize(opcode_switch(q));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_Opcode_Switch);
+
+} // namespace
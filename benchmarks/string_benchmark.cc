@@ -0,0 +1,76 @@
+#include "String/string.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * UnorderedMap keyed by std::string against rwstd::String and HashedString,
+ * each with its default hash. Arg is the key length: 12 fits every SSO, 22
+ * only rwstd's, 40 none. Insert builds the keys from char data and fills
+ * an empty map (rehashes included), find looks up every key again from a
+ * separate copy so pointers never match.
+ */
+
+namespace {
+
+constexpr size_t key_count = 1 << 18;
+
+std::vector<std::string> raw_keys(int64_t len) {
+  std::mt19937_64 rng(static_cast<uint64_t>(len));
+  std::vector<std::string> keys(key_count);
+  for (auto &key : keys) {
+    key.resize(static_cast<size_t>(len));
+    for (auto &c : key)
+      c = static_cast<char>('a' + rng() % 26);
+  }
+  return keys;
+}
+
+template <typename Key>
+Key make_key(const std::string &raw) {
+  return Key(raw.data(), raw.size());
+}
+
+template <typename Key>
+void BM_Insert(benchmark::State &state) {
+  auto raw = raw_keys(state.range(0));
+  for (auto _ : state) {
+    rwstd::UnorderedMap<Key, uint32_t> map;
+    for (uint32_t i = 0; i < key_count; ++i)
+      map.insert({make_key<Key>(raw[i]), i});
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(key_count));
+}
+
+template <typename Key>
+void BM_Find(benchmark::State &state) {
+  auto raw = raw_keys(state.range(0));
+  rwstd::UnorderedMap<Key, uint32_t> map;
+  std::vector<Key> probes;
+  for (uint32_t i = 0; i < key_count; ++i) {
+    map.insert({make_key<Key>(raw[i]), i});
+    probes.push_back(make_key<Key>(raw[i]));
+  }
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const auto &probe : probes)
+      sum += map.find(probe)->second;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(key_count));
+}
+
+BENCHMARK(BM_Insert<std::string>)->Arg(12)->Arg(22)->Arg(40);
+BENCHMARK(BM_Insert<rwstd::String>)->Arg(12)->Arg(22)->Arg(40);
+BENCHMARK(BM_Insert<rwstd::HashedString>)->Arg(12)->Arg(22)->Arg(40);
+BENCHMARK(BM_Find<std::string>)->Arg(12)->Arg(22)->Arg(40);
+BENCHMARK(BM_Find<rwstd::String>)->Arg(12)->Arg(22)->Arg(40);
+BENCHMARK(BM_Find<rwstd::HashedString>)->Arg(12)->Arg(22)->Arg(40);
+
+} // namespace
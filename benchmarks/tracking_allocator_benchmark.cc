@@ -0,0 +1,64 @@
+#include "Allocator/tracking_allocator.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+/*
+ * What tracking costs: allocate and free a small block straight through the
+ * allocator, from one thread and from several (each thread has its own
+ * shard, so this should scale like the untracked rows), then the same
+ * Vector and UnorderedMap workloads over rwstd::Allocator and over a
+ * TrackingAllocator on top of it.
+ */
+
+namespace {
+
+template <typename Alloc>
+void BM_AllocateFree(benchmark::State &state) {
+  Alloc alloc;
+  for (auto _ : state) {
+    uint64_t *p = alloc.allocate(4);
+    benchmark::DoNotOptimize(p);
+    alloc.deallocate(p, 4);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AllocateFree<rwstd::Allocator<uint64_t>>)->ThreadRange(1, 8);
+BENCHMARK(BM_AllocateFree<rwstd::TrackingAllocator<uint64_t>>)
+    ->ThreadRange(1, 8);
+
+template <typename Alloc>
+void BM_VectorPushBack(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    rwstd::Vector<uint64_t, Alloc> vec;
+    for (size_t i = 0; i < n; ++i)
+      vec.push_back(i);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorPushBack<rwstd::Allocator<uint64_t>>)->Arg(1 << 16);
+BENCHMARK(BM_VectorPushBack<rwstd::TrackingAllocator<uint64_t>>)->Arg(1 << 16);
+
+template <typename Alloc>
+void BM_MapInsert(benchmark::State &state) {
+  using Map = rwstd::UnorderedMap<uint64_t, uint64_t, std::hash<uint64_t>,
+                                  std::equal_to<uint64_t>, Alloc>;
+  const auto n = static_cast<uint64_t>(state.range(0));
+  for (auto _ : state) {
+    Map map;
+    for (uint64_t i = 0; i < n; ++i)
+      map.insert({i * 0x9e3779b97f4a7c15ull, i});
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+using Pair = std::pair<const uint64_t, uint64_t>;
+BENCHMARK(BM_MapInsert<rwstd::Allocator<Pair>>)->Arg(1 << 16);
+BENCHMARK(BM_MapInsert<rwstd::TrackingAllocator<Pair>>)->Arg(1 << 16);
+
+} // namespace
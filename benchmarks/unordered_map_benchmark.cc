@@ -0,0 +1,359 @@
+#include "unordered_map.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * Burst then drain: a million sessions arrive, all but 1% leave again, and
+ * the survivors are iterated. Without a shrink policy the iteration walks
+ * the bucket array sized for the burst; with min_load_factor the erases
+ * hand it back as they go, shrink_to_fit does so in one step afterwards.
+ */
+
+namespace {
+
+constexpr int burst = 1 << 20;
+constexpr int survivors = burst / 100;
+
+enum Reclaim { keep, policy, shrink_to_fit };
+
+rwstd::UnorderedMap<uint64_t, uint64_t> drained(Reclaim reclaim) {
+  rwstd::UnorderedMap<uint64_t, uint64_t> map;
+  if (reclaim == policy)
+    map.min_load_factor(0.125f);
+  for (uint64_t i = 0; i < burst; ++i)
+    map.insert({i, i});
+  for (uint64_t i = survivors; i < burst; ++i)
+    map.erase(i);
+  if (reclaim == shrink_to_fit)
+    map.shrink_to_fit();
+  return map;
+}
+
+void BM_DrainedIterate(benchmark::State &state) {
+  auto map = drained(static_cast<Reclaim>(state.range(0)));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto &entry : map)
+      sum += entry.second;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["bytes"] = static_cast<double>(map.memory_usage());
+  state.counters["buckets"] = static_cast<double>(map.bucket_count());
+  state.SetItemsProcessed(state.iterations() * survivors);
+}
+BENCHMARK(BM_DrainedIterate)
+    ->ArgName("reclaim")
+    ->Arg(keep)
+    ->Arg(policy)
+    ->Arg(shrink_to_fit);
+
+// the price of the policy: the drain itself, rehashes included
+void BM_BurstDrain(benchmark::State &state) {
+  for (auto _ : state) {
+    auto map = drained(static_cast<Reclaim>(state.range(0)));
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_BurstDrain)
+    ->ArgName("reclaim")
+    ->Arg(keep)
+    ->Arg(policy)
+    ->Arg(shrink_to_fit)
+    ->Unit(benchmark::kMillisecond);
+
+/*
+ * Building a 4M entry map from a vector of pairs, one insert at a time
+ * (doubling rehashes included) and through bulk_build with a thread count of
+ * Arg. A quarter of the input repeats an earlier key.
+ */
+
+constexpr size_t build_size = 1 << 22;
+
+const std::vector<std::pair<uint64_t, uint64_t>> &build_input() {
+  static auto *input = [] {
+    auto *data = new std::vector<std::pair<uint64_t, uint64_t>>;
+    std::mt19937_64 rng(3);
+    for (uint64_t i = 0; i < build_size; ++i) {
+      uint64_t key = rng();
+      if (i % 4 == 3)
+        key = (*data)[rng() % data->size()].first;
+      data->push_back({key, i});
+    }
+    return data;
+  }();
+  return *input;
+}
+
+void BM_SequentialInsert(benchmark::State &state) {
+  const auto &input = build_input();
+  for (auto _ : state) {
+    rwstd::UnorderedMap<uint64_t, uint64_t> map;
+    for (const auto &entry : input)
+      map.insert(entry);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(build_size));
+}
+BENCHMARK(BM_SequentialInsert)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_BulkBuild(benchmark::State &state) {
+  const auto &input = build_input();
+  for (auto _ : state) {
+    rwstd::UnorderedMap<uint64_t, uint64_t> map;
+    map.bulk_build(input.begin(), input.end(),
+                   static_cast<size_t>(state.range(0)));
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(build_size));
+}
+BENCHMARK(BM_BulkBuild)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/*
+ * Summing the values of a 4M entry map: one forward iterator against split()
+ * into Arg ranges summed on their own threads, the split included.
+ */
+
+const rwstd::UnorderedMap<uint64_t, uint64_t> &aggregate_input() {
+  static auto *map = [] {
+    auto *data = new rwstd::UnorderedMap<uint64_t, uint64_t>;
+    const auto &input = build_input();
+    data->bulk_build(input.begin(), input.end());
+    return data;
+  }();
+  return *map;
+}
+
+void BM_IterateSum(benchmark::State &state) {
+  const auto &map = aggregate_input();
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const auto &entry : map)
+      sum += entry.second;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(map.size()));
+}
+BENCHMARK(BM_IterateSum)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_SplitSum(benchmark::State &state) {
+  const auto &map = aggregate_input();
+  const size_t threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    auto ranges = map.split(threads);
+    std::vector<uint64_t> sums(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        uint64_t sum = 0;
+        for (const auto &entry : ranges[t])
+          sum += entry.second;
+        sums[t] = sum;
+      });
+    }
+    for (auto &worker : workers)
+      worker.join();
+    uint64_t sum = 0;
+    for (uint64_t part : sums)
+      sum += part;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(map.size()));
+}
+BENCHMARK(BM_SplitSum)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/*
+ * The regression suite: the everyday operations against
+ * std::unordered_map, for 64 bit integer keys and 24 to 26 character string
+ * keys (past any small string buffer), at 1K, 64K and 1M entries. Lookups
+ * go in shuffled order; misses use keys never inserted. Erase times
+ * removing every key from a full map, rehash one doubling and one shrink
+ * back, iteration a sum over all values.
+ */
+
+using Rw64 = rwstd::UnorderedMap<uint64_t, uint64_t>;
+using Std64 = std::unordered_map<uint64_t, uint64_t>;
+using RwStr = rwstd::UnorderedMap<std::string, uint64_t>;
+using StdStr = std::unordered_map<std::string, uint64_t>;
+
+template <typename Key>
+Key make_key(uint64_t i) {
+  if constexpr (std::is_same_v<Key, std::string>)
+    return "session:" + std::to_string(i * 0x9e3779b97f4a7c15ull);
+  else
+    return i * 0x9e3779b97f4a7c15ull;
+}
+
+// n keys to insert followed by n that are never inserted, and the first n
+// again shuffled for lookups
+template <typename Key>
+struct Keys {
+  std::vector<Key> keys;
+  std::vector<Key> probes;
+};
+
+template <typename Key>
+const Keys<Key> &keys(size_t n) {
+  static std::vector<std::pair<size_t, Keys<Key> *>> cache;
+  for (auto &[size, data] : cache) {
+    if (size == n)
+      return *data;
+  }
+  auto *data = new Keys<Key>;
+  for (uint64_t i = 0; i < 2 * n; ++i)
+    data->keys.push_back(make_key<Key>(i));
+  data->probes.assign(data->keys.begin(),
+                      data->keys.begin() + static_cast<std::ptrdiff_t>(n));
+  std::mt19937 rng(static_cast<uint32_t>(n));
+  std::shuffle(data->probes.begin(), data->probes.end(), rng);
+  cache.push_back({n, data});
+  return *data;
+}
+
+template <typename Map>
+Map filled(size_t n) {
+  const auto &data = keys<typename Map::key_type>(n);
+  Map map;
+  for (size_t i = 0; i < n; ++i)
+    map.insert({data.keys[i], i});
+  return map;
+}
+
+void suite_sizes(benchmark::internal::Benchmark *bench) {
+  bench->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+}
+
+template <typename Map>
+void BM_Map_Insert(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto &data = keys<typename Map::key_type>(n);
+  for (auto _ : state) {
+    Map map;
+    for (size_t i = 0; i < n; ++i)
+      map.insert({data.keys[i], i});
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Map_Insert<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Insert<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Insert<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Insert<StdStr>)->Apply(suite_sizes);
+
+template <typename Map>
+void BM_Map_FindHit(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto &data = keys<typename Map::key_type>(n);
+  Map map = filled<Map>(n);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(data.probes[i])->second);
+    if (++i == n)
+      i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Map_FindHit<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindHit<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindHit<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindHit<StdStr>)->Apply(suite_sizes);
+
+template <typename Map>
+void BM_Map_FindMiss(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto &data = keys<typename Map::key_type>(n);
+  Map map = filled<Map>(n);
+  size_t i = n;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(data.keys[i]) == map.end());
+    if (++i == 2 * n)
+      i = n;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Map_FindMiss<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindMiss<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindMiss<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_FindMiss<StdStr>)->Apply(suite_sizes);
+
+template <typename Map>
+void BM_Map_Erase(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto &data = keys<typename Map::key_type>(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Map map = filled<Map>(n);
+    state.ResumeTiming();
+    for (const auto &key : data.probes)
+      map.erase(key);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Map_Erase<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Erase<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Erase<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Erase<StdStr>)->Apply(suite_sizes);
+
+template <typename Map>
+void BM_Map_Iterate(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  Map map = filled<Map>(n);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const auto &entry : map)
+      sum += entry.second;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Map_Iterate<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Iterate<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Iterate<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Iterate<StdStr>)->Apply(suite_sizes);
+
+template <typename Map>
+void BM_Map_Rehash(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  Map map = filled<Map>(n);
+  const size_t buckets = map.bucket_count();
+  for (auto _ : state) {
+    map.rehash(buckets * 2);
+    map.rehash(buckets);
+    benchmark::DoNotOptimize(map.bucket_count());
+  }
+  // every element moves twice
+  state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+}
+BENCHMARK(BM_Map_Rehash<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Rehash<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Rehash<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Map_Rehash<StdStr>)->Apply(suite_sizes);
+
+} // namespace
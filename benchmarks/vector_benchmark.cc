@@ -0,0 +1,224 @@
+#include "Vector/vector.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Bulk algorithms over a Vector's iterators against the same call on raw
+ * pointers into it and on a std::vector: std::ranges::copy, std::copy and
+ * std::ranges::fill of 64 bit integers, from L1 sized to DRAM sized. With
+ * contiguous iterators the Vector rows should track the raw pointer rows.
+ */
+
+namespace {
+
+void sizes(benchmark::internal::Benchmark *bench) {
+  bench->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+}
+
+void BM_RangesCopy_Vector(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> src(n, 7);
+  rwstd::Vector<uint64_t> dst(n, 0);
+  for (auto _ : state) {
+    std::ranges::copy(src, dst.begin());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_RangesCopy_Vector)->Apply(sizes);
+
+void BM_RangesCopy_Pointer(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> src(n, 7);
+  rwstd::Vector<uint64_t> dst(n, 0);
+  for (auto _ : state) {
+    std::ranges::copy(src.data(), src.data() + n, dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_RangesCopy_Pointer)->Apply(sizes);
+
+void BM_RangesCopy_StdVector(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  std::vector<uint64_t> src(n, 7);
+  std::vector<uint64_t> dst(n, 0);
+  for (auto _ : state) {
+    std::ranges::copy(src, dst.begin());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_RangesCopy_StdVector)->Apply(sizes);
+
+void BM_StdCopy_Vector(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> src(n, 7);
+  rwstd::Vector<uint64_t> dst(n, 0);
+  for (auto _ : state) {
+    std::copy(src.begin(), src.end(), dst.begin());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_StdCopy_Vector)->Apply(sizes);
+
+void BM_StdCopy_Pointer(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> src(n, 7);
+  rwstd::Vector<uint64_t> dst(n, 0);
+  for (auto _ : state) {
+    std::copy(src.data(), src.data() + n, dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_StdCopy_Pointer)->Apply(sizes);
+
+void BM_RangesFill_Vector(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> dst(n, 0);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    std::ranges::fill(dst, ++value);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_RangesFill_Vector)->Apply(sizes);
+
+void BM_RangesFill_Pointer(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  rwstd::Vector<uint64_t> dst(n, 0);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    std::ranges::fill(dst.data(), dst.data() + n, ++value);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_RangesFill_Pointer)->Apply(sizes);
+
+/*
+ * The regression suite: the everyday operations against std::vector, for
+ * 64 bit integers and 24 to 26 character strings (past any small string
+ * buffer). push_back with and without a reserve up front, inserting at the
+ * front (quadratic, so smaller sizes), copy construction and iteration.
+ */
+
+using Rw64 = rwstd::Vector<uint64_t>;
+using Std64 = std::vector<uint64_t>;
+using RwStr = rwstd::Vector<std::string>;
+using StdStr = std::vector<std::string>;
+
+template <typename T>
+T make_value(uint64_t i) {
+  if constexpr (std::is_same_v<T, std::string>)
+    return "element:" + std::to_string(i * 0x9e3779b97f4a7c15ull);
+  else
+    return i;
+}
+
+template <typename Vec>
+Vec filled(size_t n) {
+  Vec vec;
+  for (size_t i = 0; i < n; ++i)
+    vec.push_back(make_value<typename Vec::value_type>(i));
+  return vec;
+}
+
+void suite_sizes(benchmark::internal::Benchmark *bench) {
+  bench->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+}
+
+template <typename Vec>
+void BM_Vec_PushBack(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Vec values = filled<Vec>(n);
+  for (auto _ : state) {
+    Vec vec;
+    for (const auto &value : values)
+      vec.push_back(value);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec_PushBack<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_PushBack<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_PushBack<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_PushBack<StdStr>)->Apply(suite_sizes);
+
+template <typename Vec>
+void BM_Vec_ReservePushBack(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Vec values = filled<Vec>(n);
+  for (auto _ : state) {
+    Vec vec;
+    vec.reserve(n);
+    for (const auto &value : values)
+      vec.push_back(value);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec_ReservePushBack<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_ReservePushBack<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_ReservePushBack<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_ReservePushBack<StdStr>)->Apply(suite_sizes);
+
+template <typename Vec>
+void BM_Vec_InsertFront(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Vec values = filled<Vec>(n);
+  for (auto _ : state) {
+    Vec vec;
+    for (const auto &value : values)
+      vec.insert(vec.begin(), value);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec_InsertFront<Rw64>)->Arg(1 << 8)->Arg(1 << 12);
+BENCHMARK(BM_Vec_InsertFront<Std64>)->Arg(1 << 8)->Arg(1 << 12);
+BENCHMARK(BM_Vec_InsertFront<RwStr>)->Arg(1 << 8)->Arg(1 << 12);
+BENCHMARK(BM_Vec_InsertFront<StdStr>)->Arg(1 << 8)->Arg(1 << 12);
+
+template <typename Vec>
+void BM_Vec_Copy(benchmark::State &state) {
+  const Vec values = filled<Vec>(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Vec copy(values);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec_Copy<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Copy<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Copy<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Copy<StdStr>)->Apply(suite_sizes);
+
+template <typename Vec>
+void BM_Vec_Iterate(benchmark::State &state) {
+  const Vec values = filled<Vec>(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const auto &value : values) {
+      if constexpr (std::is_same_v<typename Vec::value_type, std::string>)
+        sum += value.size();
+      else
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec_Iterate<Rw64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Iterate<Std64>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Iterate<RwStr>)->Apply(suite_sizes);
+BENCHMARK(BM_Vec_Iterate<StdStr>)->Apply(suite_sizes);
+
+} // namespace
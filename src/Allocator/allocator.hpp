@@ -1,3 +1,5 @@
+#pragma once
+
 #include <cstddef>
 #include <cstdlib>
 #include <limits>
@@ -15,7 +17,7 @@ public:
   constexpr Allocator() noexcept = default;
   constexpr Allocator(const Allocator &other) noexcept = default;
   template <class U>
-  constexpr Allocator(const Allocator<U> &_) noexcept {};
+  constexpr Allocator(const Allocator<U> & /*_*/) noexcept {}
 
   constexpr T *allocate(size_type n) {
     if (std::numeric_limits<size_t>::max() / sizeof(T) < n) {
@@ -30,13 +32,13 @@ public:
 };
 
 template <class T1, class T2>
-constexpr bool operator==(const Allocator<T1> &_,
+constexpr bool operator==(const Allocator<T1> & /*_*/,
                           const Allocator<T2> & /*_*/) noexcept {
   return true;
 }
 
 template <class T1, class T2>
-constexpr bool operator!=(const Allocator<T1> &_,
+constexpr bool operator!=(const Allocator<T1> & /*_*/,
                           const Allocator<T2> & /*_*/) noexcept {
   return false;
 }
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace rwstd {
+
+/*
+ * A copy of the counters of an AllocationStats. The fields are read one
+ * after the other, so while other threads allocate they need not add up
+ * exactly (live_bytes against bytes_allocated - bytes_deallocated, say).
+ */
+struct AllocationSnapshot {
+  // size_histogram[i] counts allocations of [2^(i-1), 2^i) bytes, [0, 1)
+  // for i = 0; the last one takes everything from 2^(histogram_size - 2) up
+  static constexpr std::size_t histogram_size = 32;
+
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t bytes_deallocated = 0;
+  uint64_t live_bytes = 0;
+  uint64_t peak_bytes = 0;
+  std::array<uint64_t, histogram_size> size_histogram{};
+
+  uint64_t live_allocations() const { return allocations - deallocations; }
+
+  // f(name, value) for every counter, for handing to a metrics exporter;
+  // the histogram buckets are named by their upper bound, bytes_le_<n>
+  template <typename F>
+  void for_each(F &&f) const {
+    f(std::string_view("allocations"), allocations);
+    f(std::string_view("deallocations"), deallocations);
+    f(std::string_view("bytes_allocated"), bytes_allocated);
+    f(std::string_view("bytes_deallocated"), bytes_deallocated);
+    f(std::string_view("live_bytes"), live_bytes);
+    f(std::string_view("peak_bytes"), peak_bytes);
+    for (std::size_t i = 0; i + 1 < histogram_size; ++i) {
+      std::string name = std::format("bytes_le_{}", (uint64_t{1} << i) - 1);
+      f(std::string_view(name), size_histogram[i]);
+    }
+    f(std::string_view("bytes_le_inf"), size_histogram[histogram_size - 1]);
+  }
+};
+
+/*
+ * Counters shared by any number of TrackingAllocators, safe to update from
+ * any thread. They are split into cache line sized shards, one per thread:
+ * a thread claims a shard index on its first allocation and gives it back
+ * when it exits, and owns that shard in every AllocationStats in between,
+ * so it updates its counters with plain relaxed loads and stores, no
+ * read-modify-write and no cache line bouncing. Once `shards - 1` threads
+ * hold one, the rest share the last shard with atomic increments.
+ * snapshot() adds the shards up.
+ *
+ * Live bytes are kept per shard too and moved into a shared total once a
+ * shard's share passes 64 KiB either way. Each shard keeps the highest
+ * total it has seen, that shared total plus its own share, so the peak is
+ * exact with one thread and can trail the true high-water mark by up to
+ * 64 KiB per other busy thread.
+ */
+class AllocationStats {
+public:
+  static constexpr std::size_t shards = 32;
+
+private:
+  static constexpr int64_t _flush_bytes = int64_t{64} << 10;
+
+  struct alignas(64) Shard {
+    // allocations are the sum of the histogram
+    std::array<std::atomic<uint64_t>, AllocationSnapshot::histogram_size>
+        histogram{};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_deallocated{0};
+    // live bytes not yet added to _live
+    std::atomic<int64_t> unflushed{0};
+    std::atomic<int64_t> peak{0};
+  };
+
+  // the calling thread's shard index, the same in every AllocationStats
+  class Slot {
+    static inline std::atomic<uint64_t> _taken{0};
+
+  public:
+    std::size_t index = shards - 1;
+    bool owned = false;
+
+    Slot() {
+      uint64_t taken = _taken.load(std::memory_order_relaxed);
+      while (std::countr_one(taken) < static_cast<int>(shards - 1)) {
+        auto free = static_cast<std::size_t>(std::countr_one(taken));
+        if (_taken.compare_exchange_weak(taken, taken | uint64_t{1} << free,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+          index = free;
+          owned = true;
+          return;
+        }
+      }
+    }
+
+    ~Slot() {
+      if (owned)
+        _taken.fetch_and(~(uint64_t{1} << index), std::memory_order_release);
+    }
+
+    Slot(const Slot &) = delete;
+    Slot &operator=(const Slot &) = delete;
+  };
+
+  std::array<Shard, shards> _shards;
+  std::atomic<int64_t> _live{0};
+  std::atomic<int64_t> _peak{0};
+
+  static const Slot &_slot() noexcept {
+    thread_local Slot slot;
+    return slot;
+  }
+
+  template <typename Int>
+  static Int _add(std::atomic<Int> &counter, Int by, bool owned) noexcept {
+    if (!owned)
+      return counter.fetch_add(by, std::memory_order_relaxed) + by;
+    Int value = counter.load(std::memory_order_relaxed) + by;
+    counter.store(value, std::memory_order_relaxed);
+    return value;
+  }
+
+  static std::size_t _histogram_bucket(std::size_t bytes) noexcept {
+    return std::min<std::size_t>(
+        static_cast<std::size_t>(std::bit_width(bytes)),
+        AllocationSnapshot::histogram_size - 1);
+  }
+
+  static void _raise(std::atomic<int64_t> &peak, int64_t live) noexcept {
+    int64_t seen = peak.load(std::memory_order_relaxed);
+    while (live > seen &&
+           !peak.compare_exchange_weak(seen, live, std::memory_order_relaxed))
+      ;
+  }
+
+  void _flush(Shard &shard) noexcept {
+    int64_t delta = shard.unflushed.exchange(0, std::memory_order_relaxed);
+    _raise(_peak, _live.fetch_add(delta, std::memory_order_relaxed) + delta);
+  }
+
+public:
+  AllocationStats() = default;
+  AllocationStats(const AllocationStats &) = delete;
+  AllocationStats &operator=(const AllocationStats &) = delete;
+
+  // what default constructed TrackingAllocators report to
+  static AllocationStats &global() noexcept {
+    static AllocationStats stats;
+    return stats;
+  }
+
+  void record_allocation(std::size_t bytes) noexcept {
+    const Slot &slot = _slot();
+    Shard &shard = _shards[slot.index];
+    _add<uint64_t>(shard.histogram[_histogram_bucket(bytes)], 1, slot.owned);
+    _add<uint64_t>(shard.bytes_allocated, bytes, slot.owned);
+    int64_t pending =
+        _add<int64_t>(shard.unflushed, static_cast<int64_t>(bytes), slot.owned);
+    if (pending >= _flush_bytes) {
+      _flush(shard);
+      return;
+    }
+    int64_t live = _live.load(std::memory_order_relaxed) + pending;
+    if (live > shard.peak.load(std::memory_order_relaxed))
+      _raise(shard.peak, live);
+  }
+
+  void record_deallocation(std::size_t bytes) noexcept {
+    const Slot &slot = _slot();
+    Shard &shard = _shards[slot.index];
+    _add<uint64_t>(shard.deallocations, 1, slot.owned);
+    _add<uint64_t>(shard.bytes_deallocated, bytes, slot.owned);
+    if (_add<int64_t>(shard.unflushed, -static_cast<int64_t>(bytes),
+                      slot.owned) <= -_flush_bytes)
+      _flush(shard);
+  }
+
+  AllocationSnapshot snapshot() const noexcept {
+    AllocationSnapshot snap;
+    int64_t live = _live.load(std::memory_order_relaxed);
+    int64_t peak = _peak.load(std::memory_order_relaxed);
+    for (const Shard &shard : _shards) {
+      for (std::size_t i = 0; i < AllocationSnapshot::histogram_size; ++i) {
+        uint64_t count = shard.histogram[i].load(std::memory_order_relaxed);
+        snap.size_histogram[i] += count;
+        snap.allocations += count;
+      }
+      snap.bytes_allocated +=
+          shard.bytes_allocated.load(std::memory_order_relaxed);
+      snap.deallocations += shard.deallocations.load(std::memory_order_relaxed);
+      snap.bytes_deallocated +=
+          shard.bytes_deallocated.load(std::memory_order_relaxed);
+      live += shard.unflushed.load(std::memory_order_relaxed);
+      peak = std::max(peak, shard.peak.load(std::memory_order_relaxed));
+    }
+    // a block freed on another thread than it was allocated on can show up
+    // in the shards before its allocation is flushed
+    live = std::max<int64_t>(live, 0);
+    snap.live_bytes = static_cast<uint64_t>(live);
+    snap.peak_bytes = static_cast<uint64_t>(std::max(live, peak));
+    return snap;
+  }
+};
+
+/*
+ * Forwards to Upstream and records every allocate and deallocate, in bytes,
+ * with an AllocationStats: the one passed in, or AllocationStats::global().
+ * Copies and rebinds share the stats, and so do containers that copy, move
+ * or swap their allocator, since the stats follow the memory.
+ */
+template <typename T, typename Upstream = rwstd::Allocator<T>>
+class TrackingAllocator {
+  using upstream_traits = std::allocator_traits<Upstream>;
+
+  template <typename, typename>
+  friend class TrackingAllocator;
+
+  Upstream _upstream;
+  AllocationStats *_stats;
+
+public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  template <typename U>
+  struct rebind {
+    typedef TrackingAllocator<
+        U, typename upstream_traits::template rebind_alloc<U>>
+        other;
+  };
+
+  TrackingAllocator() noexcept(noexcept(Upstream()))
+      : _stats{&AllocationStats::global()} {}
+
+  explicit TrackingAllocator(AllocationStats &stats,
+                             const Upstream &upstream = Upstream())
+      : _upstream{upstream}, _stats{&stats} {}
+
+  template <typename U, typename OtherUpstream>
+  TrackingAllocator(const TrackingAllocator<U, OtherUpstream> &other) noexcept
+      : _upstream(other._upstream), _stats{other._stats} {}
+
+  T *allocate(size_type n) {
+    T *ptr = upstream_traits::allocate(_upstream, n);
+    _stats->record_allocation(n * sizeof(T));
+    return ptr;
+  }
+
+  void deallocate(T *p, size_type n) {
+    _stats->record_deallocation(n * sizeof(T));
+    upstream_traits::deallocate(_upstream, p, n);
+  }
+
+  AllocationStats &stats() const noexcept { return *_stats; }
+  const Upstream &upstream() const noexcept { return _upstream; }
+
+  template <typename U, typename OtherUpstream>
+  bool operator==(const TrackingAllocator<U, OtherUpstream> &rhs) const {
+    return _stats == rhs._stats && _upstream == rhs._upstream;
+  }
+};
+} // namespace rwstd
@@ -0,0 +1,519 @@
+#pragma once
+
+#include "Vector/vector.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace rwstd {
+
+namespace detail {
+
+typedef std::uint64_t bit_lanes __attribute__((vector_size(32)));
+
+constexpr std::size_t bit_lane_words = sizeof(bit_lanes) / 8;
+
+inline std::size_t popcount_words(const std::uint64_t *words,
+                                  std::size_t count) {
+  std::size_t total = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  // nibble lookup with vpshufb, byte sums folded into lanes with vpsadbw
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                       1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0f);
+  __m256i sums = _mm256_setzero_si256();
+  for (; i + bit_lane_words <= count; i += bit_lane_words) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+    __m256i bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)),
+        _mm256_shuffle_epi8(lookup,
+                            _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+    sums = _mm256_add_epi64(sums,
+                            _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  std::uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), sums);
+  total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif !defined(__POPCNT__)
+  // no popcnt instruction: the bit trick on four words at once, byte counts
+  // summed for up to 31 rounds before they could overflow
+  const bit_lanes m1 = bit_lanes{} + 0x5555555555555555ull;
+  const bit_lanes m2 = bit_lanes{} + 0x3333333333333333ull;
+  const bit_lanes m4 = bit_lanes{} + 0x0f0f0f0f0f0f0f0full;
+  while (i + bit_lane_words <= count) {
+    bit_lanes bytes{};
+    for (int round = 0; round < 31 && i + bit_lane_words <= count;
+         ++round, i += bit_lane_words) {
+      bit_lanes v;
+      std::memcpy(&v, words + i, sizeof(v));
+      v = v - ((v >> 1) & m1);
+      v = (v & m2) + ((v >> 2) & m2);
+      bytes += (v + (v >> 4)) & m4;
+    }
+    bytes = (bytes & (bit_lanes{} + 0x00ff00ff00ff00ffull)) +
+            ((bytes >> 8) & (bit_lanes{} + 0x00ff00ff00ff00ffull));
+    bytes = (bytes & (bit_lanes{} + 0x0000ffff0000ffffull)) +
+            ((bytes >> 16) & (bit_lanes{} + 0x0000ffff0000ffffull));
+    bytes = (bytes & (bit_lanes{} + 0xffffffffull)) + (bytes >> 32);
+    total += bytes[0] + bytes[1] + bytes[2] + bytes[3];
+  }
+#endif
+  for (; i < count; ++i)
+    total += static_cast<std::size_t>(std::popcount(words[i]));
+  return total;
+}
+
+// position of the k-th (from 0) set bit of word, k < popcount(word)
+inline unsigned select_word(std::uint64_t word, unsigned k) {
+#if defined(__BMI2__)
+  return static_cast<unsigned>(
+      std::countr_zero(_pdep_u64(std::uint64_t{1} << k, word)));
+#else
+  unsigned base = 0;
+  for (;; base += 8, word >>= 8) {
+    auto ones = static_cast<unsigned>(std::popcount(word & 0xff));
+    if (k < ones)
+      break;
+    k -= ones;
+  }
+  for (; k > 0; --k)
+    word &= word - 1;
+  return base + static_cast<unsigned>(std::countr_zero(word));
+#endif
+}
+
+} // namespace detail
+
+/*
+ * Packed bits in 64 bit words, for filter bitmaps and other sets of small
+ * integers. Bulk and/or/xor/flip run 32 bytes at a time, count() is a
+ * vectorized popcount (vpshufb nibble lookup under AVX2) and find_first /
+ * find_next / for_each_set skip zero words.
+ *
+ * build_index() adds a rank/select directory of about 3.5% of the bits: a
+ * 64 bit entry per 2048 bit block holds the ones before the block and the
+ * counts of its first three 512 bit sub-blocks, so rank() is one lookup
+ * plus at most eight word popcounts; select() starts from a sample taken
+ * every 8192 ones and searches the blocks between two samples. Any change
+ * to the bits drops the index, and rank() / select() without one throw
+ * std::logic_error.
+ */
+class BitVector {
+  static constexpr std::size_t _block_bits = 2048;
+  static constexpr std::size_t _sub_bits = 512;
+  static constexpr std::size_t _select_step = 8192;
+
+  rwstd::Vector<std::uint64_t> _words;
+  std::size_t _size = 0;
+
+  // the rank/select directory; counts in _blocks are relative to _upper
+  // entries, which step every 2^32 bits
+  rwstd::Vector<std::uint64_t> _blocks;
+  rwstd::Vector<std::uint64_t> _upper;
+  rwstd::Vector<std::uint32_t> _samples;
+  std::size_t _ones = 0;
+  bool _indexed = false;
+
+  static std::size_t _word_count(std::size_t bits) { return (bits + 63) / 64; }
+
+  // keeps the bits past size() in the last word zero
+  void _trim() {
+    if (_size % 64 != 0)
+      _words[_size / 64] &= (std::uint64_t{1} << (_size % 64)) - 1;
+  }
+
+  void _require_index() const {
+    if (!_indexed)
+      throw std::logic_error("BitVector: rank/select index not built");
+  }
+
+  void _check_sizes(const BitVector &other) const {
+    if (other._size != _size)
+      throw std::invalid_argument(std::format(
+          "BitVector: size mismatch {} != {}", _size, other._size));
+  }
+
+  // op(a, b) updates a in place, a 32 byte vector return would need AVX
+  template <typename Op>
+  BitVector &_combine(const BitVector &other, Op op) {
+    _check_sizes(other);
+    _indexed = false;
+    std::uint64_t *out = _words.data();
+    const std::uint64_t *in = other._words.data();
+    std::size_t count = _words.size();
+    std::size_t i = 0;
+    for (; i + detail::bit_lane_words <= count; i += detail::bit_lane_words) {
+      detail::bit_lanes a;
+      detail::bit_lanes b;
+      std::memcpy(&a, out + i, sizeof(a));
+      std::memcpy(&b, in + i, sizeof(b));
+      op(a, b);
+      std::memcpy(out + i, &a, sizeof(a));
+    }
+    for (; i < count; ++i)
+      op(out[i], in[i]);
+    return *this;
+  }
+
+  std::size_t _block_rank(std::size_t block) const {
+    return _upper[(block * _block_bits) >> 32] + (_blocks[block] & 0xffffffff);
+  }
+
+public:
+  typedef bool value_type;
+  typedef std::size_t size_type;
+
+  class const_iterator {
+    const BitVector *_vec = nullptr;
+    std::size_t _pos = 0;
+
+  public:
+    typedef bool value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::forward_iterator_tag iterator_category;
+
+    const_iterator() = default;
+    const_iterator(const BitVector *vec, std::size_t pos)
+        : _vec{vec}, _pos{pos} {}
+
+    bool operator*() const { return _vec->test(_pos); }
+
+    const_iterator &operator++() {
+      ++_pos;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++_pos;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return _pos == other._pos;
+    }
+  };
+
+  typedef const_iterator iterator;
+
+  BitVector() = default;
+
+  explicit BitVector(std::size_t size, bool value = false) {
+    resize(size, value);
+  }
+
+  /*
+   * Element access
+   */
+
+  bool test(std::size_t pos) const {
+    return (_words[pos / 64] >> pos % 64) & 1;
+  }
+
+  bool operator[](std::size_t pos) const { return test(pos); }
+
+  bool at(std::size_t pos) const {
+    if (pos >= _size)
+      throw std::out_of_range(
+          std::format("BitVector::at pos: {} >= size(): {}", pos, _size));
+    return test(pos);
+  }
+
+  const std::uint64_t *data() const { return _words.data(); }
+  std::size_t word_count() const { return _words.size(); }
+
+  /*
+   * Iterators
+   */
+
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, _size}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+  std::size_t size() const { return _size; }
+
+  void reserve(std::size_t bits) { _words.reserve(_word_count(bits)); }
+
+  // bits plus the rank/select index when one is built
+  std::size_t memory_usage() const {
+    std::size_t total = _words.capacity() * sizeof(std::uint64_t);
+    if (_indexed)
+      total += _blocks.capacity() * sizeof(std::uint64_t) +
+               _upper.capacity() * sizeof(std::uint64_t) +
+               _samples.capacity() * sizeof(std::uint32_t);
+    return total;
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void set(std::size_t pos, bool value = true) {
+    _indexed = false;
+    std::uint64_t bit = std::uint64_t{1} << pos % 64;
+    if (value)
+      _words[pos / 64] |= bit;
+    else
+      _words[pos / 64] &= ~bit;
+  }
+
+  void reset(std::size_t pos) { set(pos, false); }
+
+  void flip(std::size_t pos) {
+    _indexed = false;
+    _words[pos / 64] ^= std::uint64_t{1} << pos % 64;
+  }
+
+  void push_back(bool value) {
+    if (_size % 64 == 0)
+      _words.push_back(0);
+    ++_size;
+    set(_size - 1, value);
+  }
+
+  // new bits take value
+  void resize(std::size_t size, bool value = false) {
+    _indexed = false;
+    std::size_t old = _size;
+    std::size_t words = _word_count(size);
+    if (words > _words.size()) {
+      _words.insert(_words.cend(), words - _words.size(),
+                    value ? ~std::uint64_t{0} : 0);
+    } else {
+      while (_words.size() > words)
+        _words.pop_back();
+    }
+    _size = size;
+    // the old last word's spare bits were zero
+    if (value && old < size && old % 64 != 0)
+      _words[old / 64] |= ~std::uint64_t{0} << old % 64;
+    _trim();
+  }
+
+  void fill(bool value) {
+    _indexed = false;
+    std::fill(_words.data(), _words.data() + _words.size(),
+              value ? ~std::uint64_t{0} : 0);
+    _trim();
+  }
+
+  void clear() {
+    _words.clear();
+    _size = 0;
+    _indexed = false;
+  }
+
+  /*
+   * Bulk operations, both operands the same size
+   */
+
+  BitVector &operator&=(const BitVector &other) {
+    return _combine(other, [](auto &a, const auto &b) { a &= b; });
+  }
+
+  BitVector &operator|=(const BitVector &other) {
+    return _combine(other, [](auto &a, const auto &b) { a |= b; });
+  }
+
+  BitVector &operator^=(const BitVector &other) {
+    return _combine(other, [](auto &a, const auto &b) { a ^= b; });
+  }
+
+  // clears every bit that is set in other
+  BitVector &and_not(const BitVector &other) {
+    return _combine(other, [](auto &a, const auto &b) { a &= ~b; });
+  }
+
+  // complements every bit
+  BitVector &flip() {
+    _combine(*this, [](auto &a, const auto &) { a = ~a; });
+    _trim();
+    return *this;
+  }
+
+  BitVector operator~() const {
+    BitVector out = *this;
+    out.flip();
+    return out;
+  }
+
+  friend BitVector operator&(BitVector lhs, const BitVector &rhs) {
+    return lhs &= rhs;
+  }
+
+  friend BitVector operator|(BitVector lhs, const BitVector &rhs) {
+    return lhs |= rhs;
+  }
+
+  friend BitVector operator^(BitVector lhs, const BitVector &rhs) {
+    return lhs ^= rhs;
+  }
+
+  friend bool operator==(const BitVector &lhs, const BitVector &rhs) {
+    return lhs._size == rhs._size &&
+           std::equal(lhs._words.data(), lhs._words.data() + lhs._words.size(),
+                      rhs._words.data());
+  }
+
+  /*
+   * Queries
+   */
+
+  std::size_t count() const {
+    if (_indexed)
+      return _ones;
+    return detail::popcount_words(_words.data(), _words.size());
+  }
+
+  bool any() const {
+    return std::any_of(_words.data(), _words.data() + _words.size(),
+                       [](std::uint64_t word) { return word != 0; });
+  }
+
+  bool none() const { return !any(); }
+  bool all() const { return count() == _size; }
+
+  // the first set bit, size() if there is none
+  std::size_t find_first() const { return _find_from(0); }
+
+  // the first set bit after pos (like std::bitset's _Find_next), size() if
+  // there is none
+  std::size_t find_next(std::size_t pos) const { return _find_from(pos + 1); }
+
+  // calls f(pos) for every set bit, in order
+  template <typename F>
+  void for_each_set(F f) const {
+    for (std::size_t w = 0; w < _words.size(); ++w) {
+      for (std::uint64_t word = _words[w]; word != 0; word &= word - 1)
+        f(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+    }
+  }
+
+  /*
+   * Rank and select
+   */
+
+  void build_index() {
+    std::size_t block_count = _size / _block_bits + 1;
+    _blocks.clear();
+    _upper.clear();
+    _samples.clear();
+    _blocks.reserve(block_count);
+    _upper.reserve((_size >> 32) + 1);
+
+    std::size_t ones = 0;
+    for (std::size_t block = 0; block < block_count; ++block) {
+      std::size_t first_bit = block * _block_bits;
+      if ((first_bit & 0xffffffff) == 0 && (first_bit >> 32) == _upper.size())
+        _upper.push_back(ones);
+      std::uint64_t entry = ones - _upper.back();
+      std::size_t first_word = first_bit / 64;
+      for (std::size_t sub = 0; sub < _block_bits / _sub_bits; ++sub) {
+        std::size_t begin = std::min(first_word + sub * 8, _words.size());
+        std::size_t end = std::min(begin + 8, _words.size());
+        std::size_t sub_ones = detail::popcount_words(_words.data() + begin,
+                                                      end - begin);
+        if (sub < 3)
+          entry |= std::uint64_t{sub_ones} << (32 + 10 * sub);
+        // a sample for every multiple of _select_step crossed in this block
+        for (std::size_t next = _samples.size() * _select_step;
+             next < ones + sub_ones; next += _select_step)
+          _samples.push_back(static_cast<std::uint32_t>(block));
+        ones += sub_ones;
+      }
+      _blocks.push_back(entry);
+    }
+    _ones = ones;
+    _indexed = true;
+  }
+
+  bool has_index() const { return _indexed; }
+
+  // set bits in [0, pos), pos <= size()
+  std::size_t rank(std::size_t pos) const {
+    _require_index();
+    std::size_t block = pos / _block_bits;
+    std::uint64_t entry = _blocks[block];
+    std::size_t ones = _block_rank(block);
+    std::size_t sub = pos % _block_bits / _sub_bits;
+    for (std::size_t s = 0; s < sub; ++s)
+      ones += (entry >> (32 + 10 * s)) & 1023;
+    std::size_t word = block * (_block_bits / 64) + sub * (_sub_bits / 64);
+    ones += detail::popcount_words(_words.data() + word, pos / 64 - word);
+    if (pos % 64 != 0)
+      ones += static_cast<std::size_t>(std::popcount(
+          _words[pos / 64] & ((std::uint64_t{1} << pos % 64) - 1)));
+    return ones;
+  }
+
+  // position of the k-th (from 0) set bit, size() if count() <= k
+  std::size_t select(std::size_t k) const {
+    _require_index();
+    if (k >= _ones)
+      return _size;
+    // the last block starting at or before the k-th one, between samples
+    std::size_t sample = k / _select_step;
+    std::size_t low = _samples[sample];
+    std::size_t high = sample + 1 < _samples.size() ? _samples[sample + 1]
+                                                    : _blocks.size() - 1;
+    while (low < high) {
+      std::size_t mid = low + (high - low + 1) / 2;
+      if (_block_rank(mid) <= k)
+        low = mid;
+      else
+        high = mid - 1;
+    }
+    std::size_t block = low;
+    k -= _block_rank(block);
+    std::uint64_t entry = _blocks[block];
+    std::size_t word = block * (_block_bits / 64);
+    for (std::size_t s = 0; s < 3; ++s) {
+      std::size_t sub_ones = (entry >> (32 + 10 * s)) & 1023;
+      if (k < sub_ones)
+        break;
+      k -= sub_ones;
+      word += _sub_bits / 64;
+    }
+    for (;; ++word) {
+      auto ones = static_cast<std::size_t>(std::popcount(_words[word]));
+      if (k < ones)
+        break;
+      k -= ones;
+    }
+    return word * 64 +
+           detail::select_word(_words[word], static_cast<unsigned>(k));
+  }
+
+private:
+  std::size_t _find_from(std::size_t pos) const {
+    if (pos >= _size)
+      return _size;
+    std::size_t w = pos / 64;
+    std::uint64_t word = _words[w] & (~std::uint64_t{0} << pos % 64);
+    while (word == 0) {
+      if (++w == _words.size())
+        return _size;
+      word = _words[w];
+    }
+    return w * 64 + static_cast<std::size_t>(std::countr_zero(word));
+  }
+};
+
+} // namespace rwstd
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "UnorderedMap/unordered_map.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+constexpr std::uint64_t bloom_mix(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+typedef std::uint32_t bloom_lanes __attribute__((vector_size(32)));
+
+// odd constants, one per 32 bit word of a block
+inline constexpr bloom_lanes bloom_salts = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+
+// one bit in each of the eight words, picked by the top five bits of
+// hash * salt (an out parameter, a 32 byte vector return would need AVX)
+inline void bloom_mask(std::uint32_t hash, bloom_lanes &mask) {
+  bloom_lanes spread = (bloom_lanes{} + hash) * bloom_salts;
+  mask = (bloom_lanes{} + 1u) << (spread >> 27);
+}
+
+} // namespace detail
+
+/*
+ * Split block Bloom filter: the bit array is cut into 256 bit blocks of
+ * eight 32 bit words, and a key sets one bit in every word of a single
+ * block. Membership is one block load, one vector AND and compare, so a
+ * negative answer costs at most one cache miss no matter how big the filter
+ * is. The eight bit positions come from multiplying the key's hash by eight
+ * salts in one vector multiply (an AVX2 build does all of it in registers).
+ *
+ * contains() has no false negatives; false positives stay near the rate the
+ * filter was sized for until more than the expected number of keys are
+ * inserted. Keys can't be removed - rebuild instead.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class BloomFilter {
+  struct alignas(32) Block {
+    std::uint32_t words[8];
+  };
+
+  std::unique_ptr<Block[]> _blocks;
+  std::size_t _block_count = 0;
+  std::size_t _inserted = 0;
+  Hash _hash;
+
+  std::uint64_t _key_hash(const Key &key) const {
+    return detail::bloom_mix(static_cast<std::uint64_t>(_hash(key)));
+  }
+
+  // high half picks the block, low half the bits inside it
+  std::size_t _index(std::uint64_t h) const {
+    return ((h >> 32) * _block_count) >> 32;
+  }
+
+  // a moved from filter has no blocks and reads as empty
+  const Block &_block(std::uint64_t h) const {
+    static const Block empty{};
+    if (_block_count == 0)
+      return empty;
+    return _blocks[_index(h)];
+  }
+
+public:
+  // bits per key that keep a split block filter at the target rate; the
+  // textbook -ln(p) / ln(2)^2 undershoots since keys cluster into blocks
+  static double bits_per_key(double false_positive_rate) {
+    return -std::log(false_positive_rate) / (std::log(2.0) * std::log(2.0)) *
+           1.25;
+  }
+
+  explicit BloomFilter(std::size_t expected_keys,
+                       double false_positive_rate = 0.01,
+                       const Hash &hash = Hash())
+      : _hash{hash} {
+    if (!(false_positive_rate > 0.0 && false_positive_rate < 1.0))
+      throw std::invalid_argument(
+          "BloomFilter: false positive rate must be in (0, 1)");
+    double bits = static_cast<double>(std::max<std::size_t>(expected_keys, 1)) *
+                  bits_per_key(false_positive_rate);
+    _block_count = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::ceil(bits / 256.0)));
+    if (_block_count > (std::size_t{1} << 32))
+      throw std::length_error("BloomFilter: too many blocks");
+    _blocks = std::make_unique<Block[]>(_block_count);
+  }
+
+  BloomFilter() : BloomFilter(1) {}
+
+  BloomFilter(const BloomFilter &other)
+      : _blocks{std::make_unique<Block[]>(other._block_count)},
+        _block_count{other._block_count}, _inserted{other._inserted},
+        _hash{other._hash} {
+    if (_block_count != 0)
+      std::memcpy(_blocks.get(), other._blocks.get(),
+                  _block_count * sizeof(Block));
+  }
+
+  // leaves other without blocks, see _block
+  BloomFilter(BloomFilter &&other) noexcept
+      : _blocks{std::move(other._blocks)},
+        _block_count{std::exchange(other._block_count, 0)},
+        _inserted{std::exchange(other._inserted, 0)},
+        _hash{std::move(other._hash)} {}
+
+  BloomFilter &operator=(BloomFilter other) noexcept {
+    std::swap(_blocks, other._blocks);
+    std::swap(_block_count, other._block_count);
+    std::swap(_inserted, other._inserted);
+    std::swap(_hash, other._hash);
+    return *this;
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void insert(const Key &key) {
+    if (_block_count == 0) {
+      _blocks = std::make_unique<Block[]>(1);
+      _block_count = 1;
+    }
+    std::uint64_t h = _key_hash(key);
+    Block &block = _blocks[_index(h)];
+    detail::bloom_lanes words;
+    detail::bloom_lanes mask;
+    std::memcpy(&words, block.words, sizeof(words));
+    detail::bloom_mask(static_cast<std::uint32_t>(h), mask);
+    words |= mask;
+    std::memcpy(block.words, &words, sizeof(words));
+    ++_inserted;
+  }
+
+  void clear() {
+    std::fill(_blocks.get(), _blocks.get() + _block_count, Block{});
+    _inserted = 0;
+  }
+
+  /*
+   * Lookup
+   */
+
+  // false: key was never inserted; true: it probably was
+  bool contains(const Key &key) const {
+    std::uint64_t h = _key_hash(key);
+    const Block &block = _block(h);
+    detail::bloom_lanes words;
+    std::memcpy(&words, block.words, sizeof(words));
+    detail::bloom_lanes mask;
+    detail::bloom_mask(static_cast<std::uint32_t>(h), mask);
+    detail::bloom_lanes missing = mask & ~words;
+    std::uint64_t halves[4];
+    std::memcpy(halves, &missing, sizeof(halves));
+    return (halves[0] | halves[1] | halves[2] | halves[3]) == 0;
+  }
+
+  /*
+   * Capacity
+   */
+
+  std::size_t block_count() const { return _block_count; }
+
+  // insert() calls so far, duplicates included
+  std::size_t inserted() const { return _inserted; }
+
+  std::size_t memory_usage() const { return _block_count * sizeof(Block); }
+};
+
+/*
+ * UnorderedMap fronted by a BloomFilter of its keys, for lookups that mostly
+ * miss: a miss the filter catches never touches the bucket array. The filter
+ * is sized for what the map holds before its next rehash and is rebuilt from
+ * the keys whenever the map rehashes, or once erased keys (which a Bloom
+ * filter can't forget) make up a quarter of what it holds.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FilteredMap {
+public:
+  using map_type = rwstd::UnorderedMap<Key, T, Hash, KeyEqual>;
+  using filter_type = BloomFilter<Key, Hash>;
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = typename map_type::value_type;
+  using size_type = std::size_t;
+  using iterator = typename map_type::iterator;
+  using const_iterator = typename map_type::const_iterator;
+
+private:
+  map_type _map;
+  filter_type _filter;
+  double _false_positive_rate;
+  std::size_t _erased = 0;
+
+  std::size_t _filter_capacity() const {
+    return static_cast<std::size_t>(static_cast<float>(_map.bucket_count()) *
+                                    _map.max_load_factor()) +
+           1;
+  }
+
+  void _rebuild_filter() {
+    filter_type filter(_filter_capacity(), _false_positive_rate);
+    for (const auto &entry : _map)
+      filter.insert(entry.first);
+    _filter = std::move(filter);
+    _erased = 0;
+  }
+
+  // after an insert: the map may have rehashed, else only the new key is due
+  void _track_insert(const Key &key, std::size_t buckets_before) {
+    if (_map.bucket_count() != buckets_before)
+      _rebuild_filter();
+    else
+      _filter.insert(key);
+  }
+
+public:
+  explicit FilteredMap(double false_positive_rate = 0.01)
+      : _filter{1, false_positive_rate},
+        _false_positive_rate{false_positive_rate} {
+    _rebuild_filter();
+  }
+
+  /*
+   * Lookup
+   */
+
+  iterator find(const Key &key) {
+    if (!_filter.contains(key))
+      return _map.end();
+    return _map.find(key);
+  }
+
+  const_iterator find(const Key &key) const {
+    if (!_filter.contains(key))
+      return _map.end();
+    return _map.find(key);
+  }
+
+  bool contains(const Key &key) const { return find(key) != _map.cend(); }
+
+  size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+  T &operator[](const Key &key) {
+    std::size_t buckets = _map.bucket_count();
+    T &value = _map[key];
+    _track_insert(key, buckets);
+    return value;
+  }
+
+  /*
+   * Modifiers
+   */
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    std::size_t buckets = _map.bucket_count();
+    auto result = _map.insert(value);
+    if (result.second)
+      _track_insert(value.first, buckets);
+    return result;
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    std::size_t buckets = _map.bucket_count();
+    Key key = value.first;
+    auto result = _map.insert(std::move(value));
+    if (result.second)
+      _track_insert(key, buckets);
+    return result;
+  }
+
+  size_type erase(const Key &key) {
+    if (!_filter.contains(key))
+      return 0;
+    size_type erased = _map.erase(key);
+    _erased += erased;
+    if (_erased * 4 > _map.size() + _erased)
+      _rebuild_filter();
+    return erased;
+  }
+
+  void clear() {
+    _map.clear();
+    _filter.clear();
+    _erased = 0;
+  }
+
+  void reserve(size_type count) {
+    std::size_t buckets = _map.bucket_count();
+    _map.reserve(count);
+    if (_map.bucket_count() != buckets)
+      _rebuild_filter();
+  }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return _map.begin(); }
+  iterator end() { return _map.end(); }
+  const_iterator begin() const { return _map.begin(); }
+  const_iterator end() const { return _map.end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _map.empty(); }
+
+  size_type size() const { return _map.size(); }
+
+  const map_type &map() const { return _map; }
+
+  const filter_type &filter() const { return _filter; }
+};
+
+} // namespace rwstd
@@ -0,0 +1,516 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+/*
+ * Append-only vector that many threads can push into at once without a lock.
+ *
+ * Storage is the same geometric segment table as SegmentedVector (segment k
+ * holds first_segment_size << k slots), but the table entries are atomics.
+ * push_back/emplace_back/grow_by claim slot indices with one fetch_add on the
+ * size, install a missing segment with a CAS (the loser frees its copy), then
+ * construct the element and publish it with a release store on the slot's
+ * ready flag. Nothing ever moves, so references stay valid.
+ *
+ * Reading from other threads:
+ *  - an index returned by push_back & co is yours, the pushing thread can use
+ *    it straight away
+ *  - any other index may still be under construction. Use try_get(), which
+ *    returns nullptr until the element is published and synchronises with
+ *    the writer, or only read after joining the writers
+ *
+ * If constructing an element throws, its slot has been claimed and stays an
+ * unpublished hole: size() still counts it, try_get() returns nullptr for
+ * it, and iteration steps over it.
+ *
+ * clear(), copy/move, and iteration are not safe against concurrent pushes.
+ */
+template <typename T, typename Allocator = rwstd::Allocator<T>>
+class ConcurrentVector {
+private:
+  struct Slot {
+    alignas(T) unsigned char storage[sizeof(T)];
+    std::atomic<bool> ready{false};
+
+    T *get() { return std::launder(reinterpret_cast<T *>(storage)); }
+    const T *get() const {
+      return std::launder(reinterpret_cast<const T *>(storage));
+    }
+  };
+
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  static constexpr std::size_t first_segment_shift = 5;
+  static constexpr std::size_t first_segment_size = std::size_t{1}
+                                                    << first_segment_shift;
+  static constexpr std::size_t max_segments = 64 - first_segment_shift;
+
+private:
+  using slot_alloc_type = typename alloc_traits::template rebind_alloc<Slot>;
+  using slot_alloc_traits =
+      typename alloc_traits::template rebind_traits<Slot>;
+
+  allocator_type _alloc;
+  slot_alloc_type _slot_alloc;
+  std::atomic<Slot *> _segments[max_segments] = {};
+  // every claimed slot, published or not
+  alignas(64) std::atomic<std::size_t> _size{0};
+  // claimed slots whose constructor threw
+  std::atomic<std::size_t> _holes{0};
+
+  static constexpr std::size_t _segment_size(std::size_t segment) {
+    return first_segment_size << segment;
+  }
+
+  static constexpr std::size_t _segment_start(std::size_t segment) {
+    return ((std::size_t{1} << segment) - 1) << first_segment_shift;
+  }
+
+  static constexpr std::pair<std::size_t, std::size_t>
+  _locate(std::size_t pos) {
+    std::size_t segment =
+        static_cast<std::size_t>(
+            std::bit_width((pos >> first_segment_shift) + 1)) -
+        1;
+    return {segment, pos - _segment_start(segment)};
+  }
+
+  Slot *_new_segment(std::size_t segment) {
+    std::size_t n = _segment_size(segment);
+    Slot *slots = slot_alloc_traits::allocate(_slot_alloc, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      ::new (static_cast<void *>(slots + i)) Slot;
+    }
+    return slots;
+  }
+
+  void _free_segment(Slot *slots, std::size_t segment) {
+    std::size_t n = _segment_size(segment);
+    for (std::size_t i = 0; i < n; ++i) {
+      if (slots[i].ready.load(std::memory_order_relaxed)) {
+        alloc_traits::destroy(_alloc, slots[i].get());
+      }
+      slots[i].~Slot();
+    }
+    slot_alloc_traits::deallocate(_slot_alloc, slots, n);
+  }
+
+  // the segment, installing it first if nobody has yet
+  Slot *_segment(std::size_t segment) {
+    Slot *slots = _segments[segment].load(std::memory_order_acquire);
+    if (slots != nullptr)
+      return slots;
+
+    Slot *fresh = _new_segment(segment);
+    if (_segments[segment].compare_exchange_strong(
+            slots, fresh, std::memory_order_acq_rel,
+            std::memory_order_acquire)) {
+      return fresh;
+    }
+    // another thread won, slots now holds its segment
+    _free_segment(fresh, segment);
+    return slots;
+  }
+
+  Slot *_slot(std::size_t pos) const {
+    auto [segment, offset] = _locate(pos);
+    Slot *slots = _segments[segment].load(std::memory_order_acquire);
+    return slots == nullptr ? nullptr : slots + offset;
+  }
+
+  // a claim past max_size() is taken back before throwing; n itself is
+  // checked first, so the size cannot wrap around meanwhile
+  std::size_t _claim(std::size_t n) {
+    if (n > max_size()) {
+      throw std::length_error(
+          std::format("{}: Size is too big for ConcurrentVector", n));
+    }
+    std::size_t first = _size.fetch_add(n, std::memory_order_relaxed);
+    if (first + n > max_size()) {
+      _size.fetch_sub(n, std::memory_order_relaxed);
+      throw std::length_error(std::format(
+          "{} + {}: Size is too big for ConcurrentVector", first, n));
+    }
+    return first;
+  }
+
+  template <typename... Args>
+  void _construct_at(std::size_t pos, Args &&...args) {
+    auto [segment, offset] = _locate(pos);
+    Slot &slot = _segment(segment)[offset];
+    alloc_traits::construct(_alloc, slot.get(), std::forward<Args>(args)...);
+    slot.ready.store(true, std::memory_order_release);
+  }
+
+  // constructs [pos, pos + n) with construct(slot); when one throws, it and
+  // the rest of the run are left as holes
+  template <typename Construct>
+  void _construct_run(std::size_t pos, std::size_t n, Construct construct) {
+    std::size_t i = 0;
+    try {
+      for (; i < n; ++i) {
+        construct(pos + i);
+      }
+    } catch (...) {
+      _holes.fetch_add(n - i, std::memory_order_relaxed);
+      throw;
+    }
+  }
+
+  bool _hole(std::size_t pos) const { return try_get(pos) == nullptr; }
+
+  void _destroy_all() {
+    for (std::size_t s = 0; s < max_segments; ++s) {
+      Slot *slots = _segments[s].exchange(nullptr, std::memory_order_relaxed);
+      if (slots != nullptr) {
+        _free_segment(slots, s);
+      }
+    }
+    _size.store(0, std::memory_order_relaxed);
+    _holes.store(0, std::memory_order_relaxed);
+  }
+
+public:
+  ConcurrentVector() noexcept(noexcept(Allocator()))
+      : ConcurrentVector(Allocator()) {}
+
+  explicit ConcurrentVector(const allocator_type &alloc) noexcept
+      : _alloc{alloc}, _slot_alloc{alloc} {}
+
+  ConcurrentVector(const ConcurrentVector &other)
+      : _alloc{alloc_traits::select_on_container_copy_construction(
+            other._alloc)},
+        _slot_alloc{_alloc} {
+    std::size_t n = other.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      if (const T *value = other.try_get(i)) {
+        push_back(*value);
+      }
+    }
+  }
+
+  ConcurrentVector(ConcurrentVector &&other) noexcept
+      : _alloc{std::move(other._alloc)}, _slot_alloc{_alloc} {
+    for (std::size_t s = 0; s < max_segments; ++s) {
+      _segments[s].store(
+          other._segments[s].exchange(nullptr, std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    _size.store(other._size.exchange(0, std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    _holes.store(other._holes.exchange(0, std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+  }
+
+  ConcurrentVector &operator=(ConcurrentVector other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~ConcurrentVector() { _destroy_all(); }
+
+  // not thread safe
+  void swap(ConcurrentVector &other) noexcept {
+    for (std::size_t s = 0; s < max_segments; ++s) {
+      Slot *mine = _segments[s].load(std::memory_order_relaxed);
+      _segments[s].store(other._segments[s].load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+      other._segments[s].store(mine, std::memory_order_relaxed);
+    }
+    std::size_t size = _size.load(std::memory_order_relaxed);
+    _size.store(other._size.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    other._size.store(size, std::memory_order_relaxed);
+    std::size_t holes = _holes.load(std::memory_order_relaxed);
+    _holes.store(other._holes.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    other._holes.store(holes, std::memory_order_relaxed);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      using std::swap;
+      swap(_alloc, other._alloc);
+      swap(_slot_alloc, other._slot_alloc);
+    }
+  }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+  /*
+   * Element access
+   */
+
+  // nullptr while the slot is unclaimed or still being constructed
+  const T *try_get(std::size_t pos) const {
+    if (pos >= _size.load(std::memory_order_relaxed))
+      return nullptr;
+    Slot *slot = _slot(pos);
+    if (slot == nullptr || !slot->ready.load(std::memory_order_acquire))
+      return nullptr;
+    return slot->get();
+  }
+
+  T *try_get(std::size_t pos) {
+    return const_cast<T *>(std::as_const(*this).try_get(pos));
+  }
+
+  bool is_published(std::size_t pos) const { return try_get(pos) != nullptr; }
+
+  // pos must be published, see the class comment; a hole never is
+  T &operator[](std::size_t pos) { return *_slot(pos)->get(); }
+  const T &operator[](std::size_t pos) const { return *_slot(pos)->get(); }
+
+  T &at(std::size_t pos) {
+    T *value = try_get(pos);
+    if (value == nullptr) {
+      throw std::out_of_range(std::format(
+          "concurrent_vector::range_check pos: {} is not published, size(): {}",
+          pos, size()));
+    }
+    return *value;
+  }
+
+  const T &at(std::size_t pos) const {
+    const T *value = try_get(pos);
+    if (value == nullptr) {
+      throw std::out_of_range(std::format(
+          "concurrent_vector::range_check pos: {} is not published, size(): {}",
+          pos, size()));
+    }
+    return *value;
+  }
+
+  /*
+   * Iterators - only once the writers are done. Without holes they are plain
+   * index arithmetic; with holes every step skips them, so +, - and [] walk
+   * and count published elements instead of adding indices
+   */
+
+  template <bool Const>
+  class ConcurrentIterator {
+  public:
+    typedef ConcurrentVector::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::conditional_t<Const, const T *, T *> pointer;
+    typedef std::conditional_t<Const, const T &, T &> reference;
+    typedef std::random_access_iterator_tag iterator_category;
+
+  private:
+    using container =
+        std::conditional_t<Const, const ConcurrentVector, ConcurrentVector>;
+    container *_vec = nullptr;
+    difference_type _idx = 0;
+
+    friend class ConcurrentVector;
+    ConcurrentIterator(container *vec, difference_type idx)
+        : _vec{vec}, _idx{idx} {}
+
+    bool _walks() const {
+      return _vec != nullptr &&
+             _vec->_holes.load(std::memory_order_relaxed) != 0;
+    }
+
+    bool _hole_at(difference_type idx) const {
+      return _vec->_hole(static_cast<std::size_t>(idx));
+    }
+
+    void _advance(difference_type n) {
+      if (!_walks()) {
+        _idx += n;
+        return;
+      }
+      auto end = static_cast<difference_type>(_vec->size());
+      for (; n > 0; --n) {
+        do {
+          ++_idx;
+        } while (_idx < end && _hole_at(_idx));
+      }
+      for (; n < 0; ++n) {
+        do {
+          --_idx;
+        } while (_idx > 0 && _hole_at(_idx));
+      }
+    }
+
+  public:
+    ConcurrentIterator() = default;
+
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    ConcurrentIterator(const ConcurrentIterator<WasConst> &other)
+        : _vec{other._vec}, _idx{other._idx} {}
+
+    reference operator*() const {
+      return (*_vec)[static_cast<std::size_t>(_idx)];
+    }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    ConcurrentIterator &operator++() {
+      _advance(1);
+      return *this;
+    }
+    ConcurrentIterator operator++(int) {
+      auto tmp = *this;
+      _advance(1);
+      return tmp;
+    }
+    ConcurrentIterator &operator--() {
+      _advance(-1);
+      return *this;
+    }
+    ConcurrentIterator operator--(int) {
+      auto tmp = *this;
+      _advance(-1);
+      return tmp;
+    }
+    ConcurrentIterator &operator+=(difference_type n) {
+      _advance(n);
+      return *this;
+    }
+    ConcurrentIterator &operator-=(difference_type n) {
+      _advance(-n);
+      return *this;
+    }
+    ConcurrentIterator operator+(difference_type n) const {
+      auto tmp = *this;
+      tmp._advance(n);
+      return tmp;
+    }
+    friend ConcurrentIterator operator+(difference_type n,
+                                        const ConcurrentIterator &it) {
+      return it + n;
+    }
+    ConcurrentIterator operator-(difference_type n) const {
+      return *this + -n;
+    }
+    difference_type operator-(const ConcurrentIterator &other) const {
+      if (!_walks())
+        return _idx - other._idx;
+      difference_type lo = std::min(_idx, other._idx);
+      difference_type hi = std::max(_idx, other._idx);
+      difference_type published = 0;
+      for (difference_type i = lo; i < hi; ++i) {
+        published += !_hole_at(i);
+      }
+      return _idx < other._idx ? -published : published;
+    }
+    bool operator==(const ConcurrentIterator &rhs) const {
+      return _idx == rhs._idx;
+    }
+    auto operator<=>(const ConcurrentIterator &rhs) const {
+      return _idx <=> rhs._idx;
+    }
+
+    template <bool>
+    friend class ConcurrentIterator;
+  };
+
+  typedef ConcurrentIterator<false> iterator;
+  typedef ConcurrentIterator<true> const_iterator;
+
+  // starts one before and steps onto the first published element
+  iterator begin() { return iterator(this, -1) + 1; }
+  iterator end() {
+    return iterator(this, static_cast<difference_type>(size()));
+  }
+  const_iterator begin() const { return const_iterator(this, -1) + 1; }
+  const_iterator end() const {
+    return const_iterator(this, static_cast<difference_type>(size()));
+  }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  // claimed slots, including ones still being constructed and holes
+  std::size_t size() const { return _size.load(std::memory_order_acquire); }
+
+  bool empty() const { return size() == 0; }
+
+  std::size_t capacity() const {
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < max_segments; ++s) {
+      if (_segments[s].load(std::memory_order_relaxed) != nullptr)
+        total += _segment_size(s);
+    }
+    return total;
+  }
+
+  std::size_t max_size() const {
+    return std::min(slot_alloc_traits::max_size(_slot_alloc),
+                    _segment_start(max_segments - 1));
+  }
+
+  // thread safe, allocates segments ahead of time so pushes skip the CAS
+  void reserve(std::size_t n) {
+    if (n == 0)
+      return;
+    if (n > max_size())
+      throw std::length_error(
+          std::format("{}: Size is too big for ConcurrentVector", n));
+    std::size_t last = _locate(n - 1).first;
+    for (std::size_t s = 0; s <= last; ++s) {
+      _segment(s);
+    }
+  }
+
+  /*
+   * Modifiers - all thread safe except clear
+   */
+
+  template <class... Args>
+  std::size_t emplace_back(Args &&...args) {
+    std::size_t pos = _claim(1);
+    _construct_run(pos, 1, [&](std::size_t at) {
+      _construct_at(at, std::forward<Args>(args)...);
+    });
+    return pos;
+  }
+
+  std::size_t push_back(const T &value) { return emplace_back(value); }
+
+  std::size_t push_back(T &&value) { return emplace_back(std::move(value)); }
+
+  // claims n consecutive slots, copies value into each, returns the first index
+  std::size_t grow_by(std::size_t n, const T &value = T()) {
+    std::size_t first = _claim(n);
+    _construct_run(first, n, [&](std::size_t at) { _construct_at(at, value); });
+    return first;
+  }
+
+  // the range is measured before claiming and then walked, so it has to be
+  // multi-pass
+  template <std::forward_iterator ForwardIt>
+  std::size_t grow_by(ForwardIt first, ForwardIt last) {
+    std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    std::size_t pos = _claim(n);
+    _construct_run(pos, n,
+                   [&](std::size_t at) { _construct_at(at, *first++); });
+    return pos;
+  }
+
+  // not thread safe
+  void clear() { _destroy_all(); }
+};
+} // namespace rwstd
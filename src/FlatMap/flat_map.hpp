@@ -0,0 +1,489 @@
+#pragma once
+
+#include "Vector/vector.hpp"
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace rwstd {
+
+// how FlatMap lays out the keys it searches
+enum class FlatLayout {
+  sorted,   // plain binary search over the sorted keys
+  eytzinger // an extra BFS ordered copy of the keys, see FlatMap
+};
+
+/*
+ * Proxy iterator over the parallel key and value arrays of a FlatMap.
+ * Dereferencing yields a pair of references, so structured bindings and
+ * it->second work as they do for node based maps.
+ */
+template <typename Key, typename T, bool Const>
+class FlatMapIterator {
+  template <typename, typename, bool> friend class FlatMapIterator;
+
+  using _mapped = std::conditional_t<Const, const T, T>;
+
+  const Key *_key = nullptr;
+  _mapped *_value = nullptr;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::pair<Key, T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const Key &, _mapped &>;
+
+  struct pointer {
+    reference ref;
+    reference *operator->() { return &ref; }
+  };
+
+  FlatMapIterator() = default;
+  FlatMapIterator(const Key *key, _mapped *value) : _key{key}, _value{value} {}
+
+  // iterator to const_iterator
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  FlatMapIterator(const FlatMapIterator<Key, T, OtherConst> &other)
+      : _key{other._key}, _value{other._value} {}
+
+  reference operator*() const { return {*_key, *_value}; }
+  pointer operator->() const { return pointer{**this}; }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  const Key &key() const { return *_key; }
+  _mapped &value() const { return *_value; }
+
+  FlatMapIterator &operator++() {
+    ++_key;
+    ++_value;
+    return *this;
+  }
+  FlatMapIterator operator++(int) {
+    FlatMapIterator old = *this;
+    ++*this;
+    return old;
+  }
+  FlatMapIterator &operator--() {
+    --_key;
+    --_value;
+    return *this;
+  }
+  FlatMapIterator operator--(int) {
+    FlatMapIterator old = *this;
+    --*this;
+    return old;
+  }
+
+  FlatMapIterator &operator+=(difference_type n) {
+    _key += n;
+    _value += n;
+    return *this;
+  }
+  FlatMapIterator &operator-=(difference_type n) { return *this += -n; }
+
+  friend FlatMapIterator operator+(FlatMapIterator it, difference_type n) {
+    return it += n;
+  }
+  friend FlatMapIterator operator+(difference_type n, FlatMapIterator it) {
+    return it += n;
+  }
+  friend FlatMapIterator operator-(FlatMapIterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const FlatMapIterator &l,
+                                   const FlatMapIterator &r) {
+    return l._key - r._key;
+  }
+
+  friend bool operator==(const FlatMapIterator &l, const FlatMapIterator &r) {
+    return l._key == r._key;
+  }
+  friend std::strong_ordering operator<=>(const FlatMapIterator &l,
+                                          const FlatMapIterator &r) {
+    return l._key <=> r._key;
+  }
+};
+
+/*
+ * Ordered map over two parallel rwstd::Vectors, one of sorted keys and one
+ * of the values at the same positions. Lookups touch only the key array and
+ * range scans are linear reads, at the cost of O(n) point inserts and erases.
+ * Build in bulk with insert_range, which sorts the new entries and merges
+ * them with the existing ones in a single pass.
+ *
+ * With FlatLayout::eytzinger the map also keeps the keys in BFS order of an
+ * implicit binary tree (children of node k at 2k and 2k+1). Searching it is
+ * branchless and the next four levels sit in one prefetched cache line, which
+ * pays off once the keys no longer fit in cache. The copy is rebuilt after
+ * every modification and doubles the key memory; should that fail, lookups
+ * binary search the sorted keys until the next successful rebuild.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          FlatLayout Layout = FlatLayout::sorted>
+class FlatMap {
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using key_compare = Compare;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = FlatMapIterator<Key, T, false>;
+  using const_iterator = FlatMapIterator<Key, T, true>;
+
+private:
+  rwstd::Vector<Key> _keys;
+  rwstd::Vector<T> _values;
+  // eytzinger layout only: 1 based tree of keys and each node's sorted index
+  rwstd::Vector<Key> _tree;
+  rwstd::Vector<size_t> _rank;
+  Compare _comp;
+
+  // index of the first key not ordered before key (Upper: after key)
+  template <bool Upper>
+  size_t _search(const Key &key) const {
+    auto goes_right = [&](const Key &candidate) {
+      if constexpr (Upper) {
+        return !_comp(key, candidate);
+      } else {
+        return _comp(candidate, key);
+      }
+    };
+    size_t n = _keys.size();
+    // without a tree (a rebuild failed) the eytzinger layout falls back to
+    // the sorted keys
+    if constexpr (Layout == FlatLayout::eytzinger) {
+      if (_tree.size() == n + 1) {
+        const Key *tree = _tree.data();
+        // four levels down is 16 nodes in, a cache line for small keys
+        constexpr size_t ahead = 16;
+        size_t k = 1;
+        while (k <= n) {
+          __builtin_prefetch(reinterpret_cast<const void *>(
+              reinterpret_cast<uintptr_t>(tree) + k * ahead * sizeof(Key)));
+          k = 2 * k + static_cast<size_t>(goes_right(tree[k]));
+        }
+        // undo the trailing right turns and the final left one
+        k >>= std::countr_one(k) + 1;
+        return k == 0 ? n : _rank[k];
+      }
+    }
+    if (n == 0)
+      return 0;
+    const Key *base = _keys.data();
+    while (n > 1) {
+      size_t half = n / 2;
+      base += goes_right(base[half]) ? half : 0;
+      n -= half;
+    }
+    return static_cast<size_t>(base - _keys.data()) +
+           static_cast<size_t>(goes_right(*base));
+  }
+
+  size_t _find_index(const Key &key) const {
+    size_t i = _search<false>(key);
+    if (i < _keys.size() && !_comp(key, _keys[i]))
+      return i;
+    return _keys.size();
+  }
+
+  // the tree only speeds up lookups, so if building it throws (allocation,
+  // a Key copy) it is dropped instead of left stale and _search goes back to
+  // the sorted keys until the next modification
+  void _rebuild_tree() noexcept {
+    if constexpr (Layout == FlatLayout::eytzinger) {
+      try {
+        _build_tree();
+      } catch (...) {
+        _tree.clear();
+        _rank.clear();
+      }
+    }
+  }
+
+  void _build_tree() {
+    if constexpr (Layout == FlatLayout::eytzinger) {
+      size_t n = _keys.size();
+      rwstd::Vector<size_t> rank(n + 1);
+      // in order walk of the implicit tree hands out sorted positions
+      size_t next = 0;
+      auto walk = [&](auto &self, size_t k) -> void {
+        if (k > n)
+          return;
+        self(self, 2 * k);
+        rank[k] = next++;
+        self(self, 2 * k + 1);
+      };
+      walk(walk, 1);
+
+      rwstd::Vector<Key> tree;
+      tree.reserve(n + 1);
+      if (n > 0) {
+        // slot 0 is never searched, it only keeps the tree 1 based
+        tree.push_back(_keys[0]);
+      }
+      for (size_t k = 1; k <= n; ++k) {
+        tree.push_back(_keys[rank[k]]);
+      }
+      _tree = std::move(tree);
+      _rank = std::move(rank);
+    }
+  }
+
+  // either inserts or, on a throw, leaves the entries as they were (given
+  // Key and T move without throwing, the rotates rely on it)
+  template <typename V>
+  std::pair<iterator, bool> _insert_at(size_t i, const Key &key, V &&value) {
+    size_t n = _keys.size();
+    _keys.push_back(key);
+    try {
+      _values.emplace_back(std::forward<V>(value));
+    } catch (...) {
+      _keys.pop_back();
+      throw;
+    }
+    std::rotate(_keys.data() + i, _keys.data() + n, _keys.data() + n + 1);
+    std::rotate(_values.data() + i, _values.data() + n, _values.data() + n + 1);
+    _rebuild_tree();
+    return {_iterator_at(i), true};
+  }
+
+  // the merge in insert_range only moves out of the map when nothing in it
+  // can throw, a failure halfway would otherwise leave the old arrays gutted
+  static constexpr bool _merge_moves =
+      std::is_nothrow_move_constructible_v<Key> &&
+      std::is_nothrow_move_constructible_v<T>;
+
+  template <typename U>
+  static decltype(auto) _merge_take(U &value) {
+    if constexpr (_merge_moves || !std::is_copy_constructible_v<U>)
+      return std::move(value);
+    else
+      return std::as_const(value);
+  }
+
+  iterator _iterator_at(size_t i) {
+    return iterator(_keys.data() + i, _values.data() + i);
+  }
+  const_iterator _iterator_at(size_t i) const {
+    return const_iterator(_keys.data() + i, _values.data() + i);
+  }
+
+public:
+  FlatMap() = default;
+
+  explicit FlatMap(const Compare &comp) : _comp{comp} {}
+
+  template <std::input_iterator InputIt>
+  FlatMap(InputIt first, InputIt last, const Compare &comp = Compare())
+      : _comp{comp} {
+    insert_range(first, last);
+  }
+
+  FlatMap(std::initializer_list<value_type> init,
+          const Compare &comp = Compare())
+      : FlatMap(init.begin(), init.end(), comp) {}
+
+  /*
+   * Element access
+   */
+
+  T &at(const Key &key) {
+    size_t i = _find_index(key);
+    if (i == _keys.size())
+      throw std::out_of_range("FlatMap::at: key not found");
+    return _values[i];
+  }
+
+  const T &at(const Key &key) const {
+    size_t i = _find_index(key);
+    if (i == _keys.size())
+      throw std::out_of_range("FlatMap::at: key not found");
+    return _values[i];
+  }
+
+  T &operator[](const Key &key) {
+    size_t i = _search<false>(key);
+    if (i < _keys.size() && !_comp(key, _keys[i]))
+      return _values[i];
+    return _insert_at(i, key, T{}).first.value();
+  }
+
+  // the sorted arrays themselves, for scans that only need one side
+  const rwstd::Vector<Key> &keys() const { return _keys; }
+  const rwstd::Vector<T> &values() const { return _values; }
+
+  /*
+   * Iterators - ascending key order
+   */
+
+  iterator begin() { return _iterator_at(0); }
+  iterator end() { return _iterator_at(_keys.size()); }
+
+  const_iterator begin() const { return _iterator_at(0); }
+  const_iterator end() const { return _iterator_at(_keys.size()); }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _keys.empty(); }
+
+  size_type size() const { return _keys.size(); }
+
+  void reserve(size_type n) {
+    _keys.reserve(n);
+    _values.reserve(n);
+  }
+
+  /*
+   * Modifiers
+   */
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    size_t i = _search<false>(value.first);
+    if (i < _keys.size() && !_comp(value.first, _keys[i]))
+      return {_iterator_at(i), false};
+    return _insert_at(i, value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &value) {
+    size_t i = _search<false>(key);
+    if (i < _keys.size() && !_comp(key, _keys[i])) {
+      _values[i] = value;
+      return {_iterator_at(i), false};
+    }
+    return _insert_at(i, key, value);
+  }
+
+  /*
+   * Adds every entry of [first, last) whose key is not in the map yet; within
+   * the range the first occurrence of a key wins. The new entries are sorted
+   * on their own and merged with the current arrays into fresh ones, so a
+   * batch costs O(m log m + n) instead of m shifting inserts.
+   */
+  template <std::input_iterator InputIt>
+  void insert_range(InputIt first, InputIt last) {
+    std::vector<value_type> incoming(first, last);
+    if (incoming.empty())
+      return;
+    std::stable_sort(incoming.begin(), incoming.end(),
+                     [&](const value_type &l, const value_type &r) {
+                       return _comp(l.first, r.first);
+                     });
+    auto unique_end = std::unique(
+        incoming.begin(), incoming.end(),
+        [&](const value_type &l, const value_type &r) {
+          return !_comp(l.first, r.first);
+        });
+
+    size_t n = _keys.size();
+    size_t m = static_cast<size_t>(unique_end - incoming.begin());
+    rwstd::Vector<Key> keys;
+    rwstd::Vector<T> values;
+    keys.reserve(n + m);
+    values.reserve(n + m);
+
+    size_t i = 0;
+    auto next = incoming.begin();
+    while (i < n || next != unique_end) {
+      bool take_existing =
+          next == unique_end || (i < n && !_comp(next->first, _keys[i]));
+      if (take_existing) {
+        // an incoming duplicate of this key is dropped
+        if (next != unique_end && !_comp(_keys[i], next->first))
+          ++next;
+        keys.emplace_back(_merge_take(_keys[i]));
+        values.emplace_back(_merge_take(_values[i]));
+        ++i;
+      } else {
+        keys.emplace_back(std::move(next->first));
+        values.emplace_back(std::move(next->second));
+        ++next;
+      }
+    }
+    _keys = std::move(keys);
+    _values = std::move(values);
+    _rebuild_tree();
+  }
+
+  template <std::ranges::input_range R>
+  void insert_range(R &&range) {
+    insert_range(std::ranges::begin(range), std::ranges::end(range));
+  }
+
+  size_type erase(const Key &key) {
+    size_t i = _find_index(key);
+    if (i == _keys.size())
+      return 0;
+    erase(_iterator_at(i));
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) {
+    size_t i = static_cast<size_t>(pos - cbegin());
+    std::move(_keys.data() + i + 1, _keys.data() + _keys.size(),
+              _keys.data() + i);
+    std::move(_values.data() + i + 1, _values.data() + _values.size(),
+              _values.data() + i);
+    _keys.pop_back();
+    _values.pop_back();
+    _rebuild_tree();
+    return _iterator_at(i);
+  }
+
+  void clear() {
+    _keys.clear();
+    _values.clear();
+    _rebuild_tree();
+  }
+
+  /*
+   * Lookup
+   */
+
+  iterator find(const Key &key) { return _iterator_at(_find_index(key)); }
+  const_iterator find(const Key &key) const {
+    return _iterator_at(_find_index(key));
+  }
+
+  bool contains(const Key &key) const {
+    return _find_index(key) != _keys.size();
+  }
+
+  size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+  iterator lower_bound(const Key &key) {
+    return _iterator_at(_search<false>(key));
+  }
+  const_iterator lower_bound(const Key &key) const {
+    return _iterator_at(_search<false>(key));
+  }
+
+  iterator upper_bound(const Key &key) {
+    return _iterator_at(_search<true>(key));
+  }
+  const_iterator upper_bound(const Key &key) const {
+    return _iterator_at(_search<true>(key));
+  }
+
+  key_compare key_comp() const { return _comp; }
+};
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using EytzingerFlatMap = FlatMap<Key, T, Compare, FlatLayout::eytzinger>;
+
+} // namespace rwstd
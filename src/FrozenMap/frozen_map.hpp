@@ -0,0 +1,570 @@
+#pragma once
+
+#include "UnorderedMap/unordered_map.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rwstd {
+
+namespace detail {
+
+// splitmix64 finalizer, a bijection on 64 bit values
+constexpr std::uint64_t frozen_mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+// maps the high 32 bits of h onto [0, range), range < 2^32
+constexpr std::uint64_t frozen_reduce(std::uint64_t h, std::uint64_t range) {
+  return ((h >> 32) * range) >> 32;
+}
+
+struct FrozenHeader {
+  static constexpr char expected_magic[8] = {'R', 'W', 'S', 'T',
+                                             'D', 'F', 'M', '\0'};
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t native_endian_tag = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian_tag;
+  std::uint32_t key_size;
+  std::uint32_t mapped_size;
+  std::uint32_t entry_size;
+  std::uint32_t reserved;
+  std::uint64_t size;
+  std::uint64_t bucket_count;
+  std::uint64_t table_size;
+  std::uint64_t seed;
+};
+static_assert(sizeof(FrozenHeader) == 64);
+
+inline std::size_t frozen_align(std::size_t bytes) {
+  return (bytes + 63) & ~std::size_t{63};
+}
+
+} // namespace detail
+
+/*
+ * Read-only hash map over a flat entry array, indexed by a minimal perfect
+ * hash (PTHash style: keys are grouped into buckets, every bucket gets a
+ * "pilot" that sends all its keys to free slots). A lookup is one hash, one
+ * pilot load, at most one remap load and one key compare - no chains, no
+ * probing, no per-node allocations.
+ *
+ * The whole map is a single position independent image:
+ *
+ *   [ FrozenHeader | pilots u32[buckets] | remap u32[table - size] | entries ]
+ *
+ * each section 64 byte aligned. write() streams the image, view() and open()
+ * use one in place (e.g. straight out of mmap) without deserializing. Key and
+ * T must be trivially copyable, and Hash has to give the same values in the
+ * process that reads the image as in the one that built it.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FrozenMap {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<T>,
+                "FrozenMap stores trivially copyable keys and values");
+
+public:
+  struct value_type {
+    Key first;
+    T second;
+  };
+
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using const_iterator = const value_type *;
+  using iterator = const_iterator;
+
+  // average keys per bucket and the fraction of table slots in use while
+  // searching pilots, the usual PTHash trade off between space and build time
+  static constexpr double keys_per_bucket = 5.0;
+  static constexpr double table_load = 0.97;
+
+private:
+  struct _AlignedDelete {
+    void operator()(std::byte *p) const {
+      ::operator delete(p, std::align_val_t{64});
+    }
+  };
+
+  std::unique_ptr<std::byte, _AlignedDelete> _owned;
+  void *_map = nullptr;
+  std::size_t _map_bytes = 0;
+
+  std::span<const std::byte> _image;
+  const std::uint32_t *_pilots = nullptr;
+  const std::uint32_t *_remap = nullptr;
+  const value_type *_entries = nullptr;
+  std::size_t _size = 0;
+  std::size_t _bucket_count = 0;
+  std::size_t _table_size = 0;
+  std::uint64_t _seed = 0;
+
+  Hash _hash;
+  KeyEqual _equal;
+
+  static constexpr std::size_t _max_pilot_tries = std::size_t{1} << 20;
+  static constexpr std::uint64_t _max_seeds = 16;
+
+  std::uint64_t _hash_of(const Key &key) const {
+    return detail::frozen_mix(static_cast<std::uint64_t>(_hash(key)) ^ _seed);
+  }
+
+  static std::uint64_t _position(std::uint64_t h, std::uint32_t pilot,
+                                 std::size_t table_size) {
+    return detail::frozen_reduce(
+        detail::frozen_mix(h ^ (pilot * 0x9e3779b97f4a7c15ull)), table_size);
+  }
+
+  struct _Layout {
+    std::size_t pilots;
+    std::size_t remap;
+    std::size_t entries;
+    std::size_t total;
+  };
+
+  static _Layout _layout(std::size_t size, std::size_t bucket_count,
+                         std::size_t table_size) {
+    _Layout l;
+    l.pilots = sizeof(detail::FrozenHeader);
+    l.remap = l.pilots +
+              detail::frozen_align(bucket_count * sizeof(std::uint32_t));
+    l.entries = l.remap + detail::frozen_align((table_size - size) *
+                                               sizeof(std::uint32_t));
+    l.total = l.entries + size * sizeof(value_type);
+    return l;
+  }
+
+  void _attach(std::span<const std::byte> image) {
+    if (image.size() < sizeof(detail::FrozenHeader))
+      throw std::runtime_error("FrozenMap: image is too small for a header");
+    if (reinterpret_cast<std::uintptr_t>(image.data()) % alignof(value_type))
+      throw std::runtime_error("FrozenMap: image is misaligned");
+
+    detail::FrozenHeader h;
+    std::memcpy(&h, image.data(), sizeof(h));
+    if (std::memcmp(h.magic, detail::FrozenHeader::expected_magic, 8) != 0)
+      throw std::runtime_error("FrozenMap: not a FrozenMap image");
+    if (h.endian_tag != detail::FrozenHeader::native_endian_tag)
+      throw std::runtime_error("FrozenMap: image has a foreign byte order");
+    if (h.version != detail::FrozenHeader::current_version) {
+      throw std::runtime_error(
+          std::format("FrozenMap: unsupported version {}", h.version));
+    }
+    if (h.key_size != sizeof(Key) || h.mapped_size != sizeof(T) ||
+        h.entry_size != sizeof(value_type)) {
+      throw std::runtime_error(std::format(
+          "FrozenMap: image holds {}/{} byte entries, expected {}/{}",
+          h.key_size, h.mapped_size, sizeof(Key), sizeof(T)));
+    }
+    if (h.table_size < h.size || h.table_size > 0xffffffffull ||
+        (h.size != 0 && h.bucket_count == 0) ||
+        h.bucket_count > h.table_size + 1) {
+      throw std::runtime_error("FrozenMap: corrupt header");
+    }
+
+    auto size = static_cast<std::size_t>(h.size);
+    auto bucket_count = static_cast<std::size_t>(h.bucket_count);
+    auto table_size = static_cast<std::size_t>(h.table_size);
+    _Layout l = _layout(size, bucket_count, table_size);
+    if (image.size() < l.total)
+      throw std::runtime_error("FrozenMap: image is truncated");
+
+    // find() indexes the entries with these unchecked
+    const auto *remap =
+        reinterpret_cast<const std::uint32_t *>(image.data() + l.remap);
+    for (std::size_t i = 0; i < table_size - size; ++i) {
+      if (remap[i] >= size)
+        throw std::runtime_error("FrozenMap: corrupt remap table");
+    }
+
+    _image = image.first(l.total);
+    _pilots = reinterpret_cast<const std::uint32_t *>(image.data() + l.pilots);
+    _remap = remap;
+    _entries = reinterpret_cast<const value_type *>(image.data() + l.entries);
+    _size = size;
+    _bucket_count = bucket_count;
+    _table_size = table_size;
+    _seed = h.seed;
+  }
+
+  struct _Item {
+    std::uint64_t hash;
+    std::size_t index;
+    std::size_t bucket;
+  };
+
+  // one attempt at placing every bucket, false if some bucket ran out of
+  // pilots and the caller should try the next seed
+  static bool _search(const std::vector<_Item> &items,
+                      std::size_t bucket_count, std::size_t table_size,
+                      std::vector<std::uint32_t> &pilots,
+                      std::vector<std::uint64_t> &positions) {
+    // counting sort by bucket, then visit the biggest buckets first
+    std::vector<std::size_t> start(bucket_count + 1, 0);
+    for (const _Item &item : items)
+      start[item.bucket + 1]++;
+    for (std::size_t b = 0; b < bucket_count; ++b)
+      start[b + 1] += start[b];
+    std::vector<std::size_t> order(items.size());
+    {
+      std::vector<std::size_t> fill(start.begin(), start.end() - 1);
+      for (std::size_t i = 0; i < items.size(); ++i)
+        order[fill[items[i].bucket]++] = i;
+    }
+    std::vector<std::size_t> buckets(bucket_count);
+    for (std::size_t b = 0; b < bucket_count; ++b)
+      buckets[b] = b;
+    std::stable_sort(buckets.begin(), buckets.end(),
+                     [&](std::size_t a, std::size_t b) {
+                       return start[a + 1] - start[a] > start[b + 1] - start[b];
+                     });
+
+    std::vector<std::uint64_t> taken((table_size + 63) / 64, 0);
+    auto is_taken = [&](std::uint64_t p) {
+      return (taken[p / 64] >> (p % 64)) & 1;
+    };
+    std::vector<std::uint64_t> trial;
+
+    for (std::size_t b : buckets) {
+      std::size_t first = start[b];
+      std::size_t last = start[b + 1];
+      if (first == last)
+        break; // sorted by size, the rest are empty too
+
+      bool placed = false;
+      for (std::size_t pilot = 0; pilot < _max_pilot_tries; ++pilot) {
+        trial.clear();
+        bool ok = true;
+        for (std::size_t k = first; k < last && ok; ++k) {
+          std::uint64_t p = _position(items[order[k]].hash,
+                                      static_cast<std::uint32_t>(pilot),
+                                      table_size);
+          ok = !is_taken(p) &&
+               std::find(trial.begin(), trial.end(), p) == trial.end();
+          trial.push_back(p);
+        }
+        if (!ok)
+          continue;
+        for (std::size_t k = first; k < last; ++k) {
+          std::uint64_t p = trial[k - first];
+          taken[p / 64] |= std::uint64_t{1} << (p % 64);
+          positions[items[order[k]].index] = p;
+        }
+        pilots[b] = static_cast<std::uint32_t>(pilot);
+        placed = true;
+        break;
+      }
+      if (!placed)
+        return false;
+    }
+    return true;
+  }
+
+  FrozenMap(const Hash &hash, const KeyEqual &equal)
+      : _hash{hash}, _equal{equal} {}
+
+public:
+  FrozenMap() = default;
+
+  FrozenMap(const FrozenMap &) = delete;
+  FrozenMap &operator=(const FrozenMap &) = delete;
+
+  FrozenMap(FrozenMap &&other) noexcept { swap(other); }
+
+  FrozenMap &operator=(FrozenMap &&other) noexcept {
+    FrozenMap tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  ~FrozenMap() {
+    if (_map != nullptr)
+      ::munmap(_map, _map_bytes);
+  }
+
+  void swap(FrozenMap &other) noexcept {
+    using std::swap;
+    swap(_owned, other._owned);
+    swap(_map, other._map);
+    swap(_map_bytes, other._map_bytes);
+    swap(_image, other._image);
+    swap(_pilots, other._pilots);
+    swap(_remap, other._remap);
+    swap(_entries, other._entries);
+    swap(_size, other._size);
+    swap(_bucket_count, other._bucket_count);
+    swap(_table_size, other._table_size);
+    swap(_seed, other._seed);
+    swap(_hash, other._hash);
+    swap(_equal, other._equal);
+  }
+
+  /*
+   * Construction
+   */
+
+  // builds from (key, value) pairs, duplicate keys are an error
+  template <std::input_iterator InputIt>
+  static FrozenMap build(InputIt first, InputIt last, const Hash &hash = Hash(),
+                         const KeyEqual &equal = KeyEqual()) {
+    FrozenMap fm(hash, equal);
+
+    std::vector<value_type> input;
+    for (; first != last; ++first)
+      input.push_back(value_type{first->first, first->second});
+
+    std::size_t n = input.size();
+    std::size_t table_size =
+        n == 0 ? 0
+               : std::max(n, static_cast<std::size_t>(
+                                 static_cast<double>(n) / table_load) +
+                                 1);
+    std::size_t bucket_count =
+        n == 0 ? 0
+               : static_cast<std::size_t>(static_cast<double>(n) /
+                                          keys_per_bucket) +
+                     1;
+    if (table_size > 0xffffffffull) {
+      throw std::length_error(
+          std::format("{}: Size is too big for FrozenMap", n));
+    }
+
+    std::vector<std::uint32_t> pilots(bucket_count, 0);
+    std::vector<std::uint64_t> positions(n, 0);
+    std::vector<_Item> items(n);
+
+    bool built = n == 0;
+    for (std::uint64_t attempt = 0; !built && attempt < _max_seeds;
+         ++attempt) {
+      fm._seed = detail::frozen_mix(attempt + 1);
+      for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t h = fm._hash_of(input[i].first);
+        items[i] = _Item{h, i, detail::frozen_reduce(h, bucket_count)};
+      }
+      // the mix is a bijection, so equal hashes mean equal Hash values,
+      // which no pilot can ever separate
+      if (attempt == 0) {
+        std::vector<std::pair<std::uint64_t, std::size_t>> sorted(n);
+        for (std::size_t i = 0; i < n; ++i)
+          sorted[i] = {items[i].hash, i};
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t i = 1; i < n; ++i) {
+          if (sorted[i].first != sorted[i - 1].first)
+            continue;
+          if (equal(input[sorted[i].second].first,
+                    input[sorted[i - 1].second].first))
+            throw std::invalid_argument("FrozenMap::build: duplicate key");
+          throw std::invalid_argument(
+              "FrozenMap::build: two keys have the same hash value");
+        }
+      }
+      built = _search(items, bucket_count, table_size, pilots, positions);
+    }
+    if (!built)
+      throw std::runtime_error("FrozenMap::build: no perfect hash found");
+
+    // slots past size() are folded back onto the free slots below it
+    std::vector<std::uint32_t> remap(table_size - n, 0);
+    {
+      std::vector<bool> used(n, false);
+      for (std::uint64_t p : positions) {
+        if (p < n)
+          used[p] = true;
+      }
+      std::size_t free_slot = 0;
+      std::vector<std::uint64_t> high;
+      for (std::uint64_t p : positions) {
+        if (p >= n)
+          high.push_back(p);
+      }
+      std::sort(high.begin(), high.end());
+      for (std::uint64_t p : high) {
+        while (used[free_slot])
+          ++free_slot;
+        used[free_slot] = true;
+        remap[p - n] = static_cast<std::uint32_t>(free_slot);
+      }
+    }
+
+    _Layout l = _layout(n, bucket_count, table_size);
+    fm._owned.reset(static_cast<std::byte *>(
+        ::operator new(l.total, std::align_val_t{64})));
+    std::byte *image = fm._owned.get();
+    std::memset(image, 0, l.total);
+
+    detail::FrozenHeader h{};
+    std::memcpy(h.magic, detail::FrozenHeader::expected_magic, 8);
+    h.version = detail::FrozenHeader::current_version;
+    h.endian_tag = detail::FrozenHeader::native_endian_tag;
+    h.key_size = sizeof(Key);
+    h.mapped_size = sizeof(T);
+    h.entry_size = sizeof(value_type);
+    h.size = n;
+    h.bucket_count = bucket_count;
+    h.table_size = table_size;
+    h.seed = fm._seed;
+    std::memcpy(image, &h, sizeof(h));
+    if (bucket_count != 0) {
+      std::memcpy(image + l.pilots, pilots.data(),
+                  bucket_count * sizeof(std::uint32_t));
+    }
+    if (!remap.empty()) {
+      std::memcpy(image + l.remap, remap.data(),
+                  remap.size() * sizeof(std::uint32_t));
+    }
+    auto *entries = reinterpret_cast<value_type *>(image + l.entries);
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint64_t p = positions[i];
+      std::size_t slot = p < n ? p : remap[p - n];
+      entries[slot] = input[i];
+    }
+
+    fm._attach(std::span<const std::byte>(image, l.total));
+    return fm;
+  }
+
+  template <typename MapHash, typename MapEqual, typename MapAlloc>
+  static FrozenMap build(
+      const rwstd::UnorderedMap<Key, T, MapHash, MapEqual, MapAlloc> &map,
+      const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual()) {
+    return build(map.begin(), map.end(), hash, equal);
+  }
+
+  // uses an image in place, the memory has to outlive the map
+  static FrozenMap view(std::span<const std::byte> image,
+                        const Hash &hash = Hash(),
+                        const KeyEqual &equal = KeyEqual()) {
+    FrozenMap fm(hash, equal);
+    fm._attach(image);
+    return fm;
+  }
+
+  // maps an image written by write() read-only
+  static FrozenMap open(const std::string &path, const Hash &hash = Hash(),
+                        const KeyEqual &equal = KeyEqual()) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              std::format("FrozenMap open: {}", path));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(),
+                              std::format("FrozenMap fstat: {}", path));
+    }
+    auto bytes = static_cast<std::size_t>(st.st_size);
+    if (bytes == 0) {
+      ::close(fd);
+      throw std::runtime_error(
+          std::format("FrozenMap: {} is too small for a header", path));
+    }
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED) {
+      throw std::system_error(err, std::generic_category(),
+                              std::format("FrozenMap mmap: {}", path));
+    }
+
+    FrozenMap fm(hash, equal);
+    fm._map = map;
+    fm._map_bytes = bytes;
+    fm._attach(std::span<const std::byte>(static_cast<std::byte *>(map),
+                                          bytes));
+    return fm;
+  }
+
+  // streams the image to anything with write(const void *, size_t), e.g. the
+  // rwstd::serialize writers
+  template <typename Writer>
+  void write(Writer &writer) const {
+    writer.write(_image.data(), _image.size());
+  }
+
+  std::span<const std::byte> image() const { return _image; }
+
+  /*
+   * Lookup
+   */
+
+  const_iterator find(const Key &key) const {
+    if (_size == 0)
+      return end();
+    std::uint64_t h = _hash_of(key);
+    std::uint32_t pilot = _pilots[detail::frozen_reduce(h, _bucket_count)];
+    std::uint64_t p = _position(h, pilot, _table_size);
+    if (p >= _size)
+      p = _remap[p - _size];
+    const value_type *entry = _entries + p;
+    return _equal(entry->first, key) ? entry : end();
+  }
+
+  bool contains(const Key &key) const { return find(key) != end(); }
+
+  size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+  const T &at(const Key &key) const {
+    const_iterator it = find(key);
+    if (it == end())
+      throw std::out_of_range("FrozenMap::at: key not found");
+    return it->second;
+  }
+
+  /*
+   * Iterators - in slot order
+   */
+
+  const_iterator begin() const { return _entries; }
+  const_iterator end() const { return _entries + _size; }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+
+  size_type size() const { return _size; }
+
+  size_type bucket_count() const { return _bucket_count; }
+
+  // bytes of the image, header and alignment padding included
+  size_type memory_usage() const { return _image.size(); }
+};
+} // namespace rwstd
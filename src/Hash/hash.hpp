@@ -0,0 +1,347 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace rwstd {
+namespace hash {
+
+namespace detail {
+
+__extension__ typedef unsigned __int128 uint128;
+
+constexpr std::uint64_t splitmix(std::uint64_t &state) {
+  std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// 25 lanes: stripe keys slide over 0..22, 16..23 scramble the accumulators
+// and 17..24 key the last stripe
+inline constexpr std::size_t secret_lanes = 25;
+
+constexpr std::array<std::uint64_t, secret_lanes> make_secret() {
+  std::array<std::uint64_t, secret_lanes> secret{};
+  std::uint64_t state = 0x2d358dccaa6c78a5ull;
+  for (auto &lane : secret)
+    lane = splitmix(state) | 1;
+  return secret;
+}
+
+inline constexpr std::array<std::uint64_t, secret_lanes> secret = make_secret();
+
+// full 64x64 -> 128 bit product folded back to 64 bits
+inline std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+  uint128 product = static_cast<uint128>(a) * b;
+  return static_cast<std::uint64_t>(product) ^
+         static_cast<std::uint64_t>(product >> 64);
+}
+
+inline std::uint64_t read8(const unsigned char *p) {
+  std::uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline std::uint64_t read4(const unsigned char *p) {
+  std::uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+// 1 to 3 bytes: first, middle and last byte
+inline std::uint64_t read_small(const unsigned char *p, std::size_t len) {
+  return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[len >> 1]} << 8) |
+         p[len - 1];
+}
+
+#if defined(__AVX2__)
+// past this many bytes AVX2 builds take the stripe loop; without AVX2 the
+// three multiply chains in hash_bytes beat emulated vector multiplies, so
+// baseline x86-64 builds hash long inputs to different values
+inline constexpr std::size_t stripe_threshold = 1024;
+
+// acc += swapped(data) + lo32(data ^ key) * hi32(data ^ key), lane by lane
+inline __m256i accumulate(__m256i acc, const unsigned char *p,
+                          const std::uint64_t *key) {
+  __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  __m256i keyed = _mm256_xor_si256(
+      data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key)));
+  __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+  __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+  return _mm256_add_epi64(acc, _mm256_add_epi64(swapped, product));
+}
+
+// acc = (acc ^ acc >> 47 ^ key) * a 32 bit prime, as two 32x32 multiplies
+inline __m256i scramble(__m256i acc, const std::uint64_t *key) {
+  const __m256i prime = _mm256_set1_epi64x(0x9e3779b1);
+  acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+  acc = _mm256_xor_si256(
+      acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key)));
+  __m256i low = _mm256_mul_epu32(acc, prime);
+  __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+  return _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+}
+
+/*
+ * Long inputs: eight 64 bit accumulators in two AVX2 registers take one 64
+ * byte stripe per step through packed 32x32 bit multiplies. Every stripe of
+ * a 16 stripe block gets its own key window, so reordering stripes changes
+ * the result, and a multiplicative scramble between blocks keeps whole
+ * blocks from commuting.
+ */
+inline std::uint64_t hash_long(const unsigned char *p, std::size_t len,
+                               std::uint64_t seed) {
+  std::uint64_t key[secret_lanes];
+  for (std::size_t i = 0; i < secret_lanes; ++i)
+    key[i] = (i & 1) ? secret[i] - seed : secret[i] + seed;
+
+  __m256i acc0 = _mm256_setr_epi64x(
+      static_cast<long long>(0xc2b2ae3d27d4eb4full),
+      static_cast<long long>(0x9e3779b185ebca87ull),
+      static_cast<long long>(0xc2b2ae3d27d4eb4full),
+      static_cast<long long>(0x165667b19e3779f9ull));
+  __m256i acc1 = _mm256_setr_epi64x(
+      static_cast<long long>(0x85ebca77c2b2ae63ull),
+      static_cast<long long>(0x27d4eb2f165667c5ull),
+      static_cast<long long>(0x9e3779b97f4a7c15ull),
+      static_cast<long long>(0x94d049bb133111ebull));
+
+  std::size_t stripes = (len - 1) / 64;
+  for (std::size_t s = 0; s < stripes; ++s) {
+    const std::uint64_t *window = key + (s & 15);
+    acc0 = accumulate(acc0, p + s * 64, window);
+    acc1 = accumulate(acc1, p + s * 64 + 32, window + 4);
+    if ((s & 15) == 15) {
+      acc0 = scramble(acc0, key + 16);
+      acc1 = scramble(acc1, key + 20);
+    }
+  }
+  acc0 = accumulate(acc0, p + len - 64, key + 17);
+  acc1 = accumulate(acc1, p + len - 32, key + 21);
+
+  std::uint64_t merged[8];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(merged), acc0);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(merged + 4), acc1);
+  std::uint64_t result = len * 0x9e3779b185ebca87ull ^ seed;
+  for (std::size_t i = 0; i < 4; ++i)
+    result += mum(merged[2 * i] ^ key[2 * i + 3],
+                  merged[2 * i + 1] ^ key[2 * i + 4]);
+  return result;
+}
+#endif
+
+} // namespace detail
+
+/*
+ * 64 bit hash of len bytes. Short inputs take one or two 128 bit multiplies
+ * (wyhash style), longer ones three independent multiply chains that consume
+ * 48 bytes per round, or on AVX2 builds the vectorized stripe loop past 1 KiB.
+ * The seed keys every path.
+ */
+inline std::uint64_t hash_bytes(const void *data, std::size_t len,
+                                std::uint64_t seed = 0) {
+  using detail::mum;
+  using detail::read4;
+  using detail::read8;
+  using detail::secret;
+  const auto *p = static_cast<const unsigned char *>(data);
+
+  seed ^= mum(seed ^ secret[0], secret[1]);
+  std::uint64_t a;
+  std::uint64_t b;
+  if (len <= 16) {
+    if (len >= 4) {
+      std::size_t mid = (len >> 3) << 2;
+      a = (read4(p) << 32) | read4(p + mid);
+      b = (read4(p + len - 4) << 32) | read4(p + len - 4 - mid);
+    } else if (len > 0) {
+      a = detail::read_small(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    std::size_t i = len;
+#if defined(__AVX2__)
+    if (len > detail::stripe_threshold) {
+      seed = detail::hash_long(p, len, seed);
+      p += len - 16;
+      i = 16;
+    }
+#endif
+    if (i > 48) {
+      std::uint64_t see1 = seed;
+      std::uint64_t see2 = seed;
+      do {
+        seed = mum(read8(p) ^ secret[2], read8(p + 8) ^ seed);
+        see1 = mum(read8(p + 16) ^ secret[3], read8(p + 24) ^ see1);
+        see2 = mum(read8(p + 32) ^ secret[4], read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mum(read8(p) ^ secret[2], read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= secret[2];
+  b ^= seed;
+  detail::uint128 product = static_cast<detail::uint128>(a) * b;
+  a = static_cast<std::uint64_t>(product);
+  b = static_cast<std::uint64_t>(product >> 64);
+  return mum(a ^ secret[0] ^ len, b ^ secret[2]);
+}
+
+// one integer: the 128 bit product of two keyed copies (one rotated so the
+// high bits meet the low ones), its halves multiplied again
+inline std::uint64_t hash_int(std::uint64_t value, std::uint64_t seed = 0) {
+  detail::uint128 product =
+      static_cast<detail::uint128>(value ^ seed ^ detail::secret[0]) *
+      (std::rotl(value, 32) ^ detail::secret[1]);
+  return detail::mum(static_cast<std::uint64_t>(product) ^ detail::secret[2],
+                     static_cast<std::uint64_t>(product >> 64) ^
+                         detail::secret[3]);
+}
+
+/*
+ * Incremental hasher for composite keys: add() folds in integers, floats,
+ * pointers, strings, pairs, tuples and ranges one after another, finish()
+ * returns the result. The order of the parts matters, ("ab", "c") and
+ * ("a", "bc") differ because strings are added with their length. Types it
+ * doesn't know fall back to std::hash, remixed.
+ */
+class Hasher {
+  std::uint64_t _state;
+
+  void _add_word(std::uint64_t word) {
+    _state = detail::mum(_state ^ word ^ detail::secret[5],
+                         detail::secret[6] ^ 0xe7037ed1a0b428dbull);
+  }
+
+public:
+  explicit Hasher(std::uint64_t seed = 0) : _state{seed} {}
+
+  Hasher &add_bytes(const void *data, std::size_t len) {
+    _state = hash_bytes(data, len, _state);
+    return *this;
+  }
+
+  template <typename T>
+  Hasher &add(const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      _add_word(value ? 1 : 0);
+    } else if constexpr (std::is_integral_v<T>) {
+      _add_word(static_cast<std::uint64_t>(value));
+    } else if constexpr (std::is_enum_v<T>) {
+      add(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      // -0.0 == 0.0 must hash the same
+      T normalized = value == T{} ? T{} : value;
+      add_bytes(&normalized, sizeof(T));
+    } else if constexpr (std::is_pointer_v<T>) {
+      _add_word(reinterpret_cast<std::uintptr_t>(value));
+    } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+      std::string_view view = value;
+      add_bytes(view.data(), view.size());
+    } else if constexpr (requires { std::tuple_size<T>::value; }) {
+      std::apply([this](const auto &...parts) { (add(parts), ...); }, value);
+    } else if constexpr (std::ranges::input_range<const T>) {
+      std::uint64_t count = 0;
+      for (const auto &element : value) {
+        add(element);
+        ++count;
+      }
+      _add_word(count);
+    } else {
+      _add_word(static_cast<std::uint64_t>(std::hash<T>{}(value)));
+    }
+    return *this;
+  }
+
+  std::uint64_t finish() const { return _state; }
+};
+
+/*
+ * Drop-in Hash parameter, as in
+ * UnorderedMap<std::string, int, Hash<std::string>>.
+ * Integers go through hash_int, so sequential or strided keys spread over
+ * the buckets, strings through hash_bytes (string_view and const char *
+ * lookups hash the same, hence is_transparent), everything else through
+ * Hasher.
+ */
+template <typename T>
+struct Hash {
+  using is_transparent = void;
+
+  std::uint64_t seed = 0;
+
+  std::size_t operator()(const T &value) const {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+      return static_cast<std::size_t>(
+          hash_int(static_cast<std::uint64_t>(value), seed));
+    else
+      return static_cast<std::size_t>(Hasher(seed).add(value).finish());
+  }
+
+  template <typename U>
+    requires(!std::is_same_v<std::remove_cvref_t<U>, T> &&
+             std::is_convertible_v<const T &, std::string_view> &&
+             std::is_convertible_v<const U &, std::string_view>)
+  std::size_t operator()(const U &value) const {
+    // as a view, Hasher would take a const char * for a pointer to hash
+    return static_cast<std::size_t>(
+        Hasher(seed).add(std::string_view(value)).finish());
+  }
+};
+
+// a seed per call, from the random device once and a counter after that
+inline std::uint64_t random_seed() {
+  static const std::uint64_t base = [] {
+    std::random_device device;
+    std::uint64_t seed = (std::uint64_t{device()} << 32) | device();
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    return seed ^ static_cast<std::uint64_t>(now);
+  }();
+  static std::atomic<std::uint64_t> counter{0};
+  std::uint64_t state = base + counter.fetch_add(1, std::memory_order_relaxed);
+  return detail::splitmix(state);
+}
+
+/*
+ * Hash with a random seed per instance, for keys an attacker can choose:
+ * without the seed nobody can precompute a set of keys that share a bucket.
+ * Two maps built with different instances order their buckets differently,
+ * copies of one map share its seed.
+ */
+template <typename T>
+struct SeededHash : Hash<T> {
+  SeededHash() : Hash<T>{random_seed()} {}
+  explicit SeededHash(std::uint64_t value) : Hash<T>{value} {}
+};
+
+} // namespace hash
+} // namespace rwstd
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+// murmur3's 64 bit finalizer, every input bit reaches every output bit
+constexpr std::uint64_t int_mix(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+// keys compared per 16 byte probe
+template <typename Key>
+inline constexpr std::size_t int_group = 16 / sizeof(Key);
+
+// probing a vector of keys at a time only beats the scalar loop with at least
+// four lanes; two 64 bit lanes measured slower even with SSE4.1's pcmpeqq
+template <typename Key>
+inline constexpr bool int_simd =
+#if defined(__SSE2__)
+    sizeof(Key) <= 4;
+#else
+    false;
+#endif
+
+#if defined(__SSE2__)
+/*
+ * Compares the int_group<Key> keys at p with key at once. Lane i of the
+ * result is sizeof(Key) set bits starting at bit i * sizeof(Key), the layout
+ * of a byte movemask, so the first match is countr_zero / sizeof(Key).
+ */
+template <typename Key>
+inline std::uint32_t int_match(const Key *p, Key key) {
+  using lane_type = std::make_unsigned_t<Key>;
+  typedef lane_type lanes_type __attribute__((vector_size(16)));
+  typedef char bytes_type __attribute__((vector_size(16)));
+  lanes_type lanes;
+  std::memcpy(&lanes, p, 16);
+  lanes_type wanted = lanes_type{} + static_cast<lane_type>(key);
+  auto equal = lanes == wanted;
+  return static_cast<std::uint32_t>(
+      __builtin_ia32_pmovmskb128(reinterpret_cast<bytes_type>(equal)));
+}
+#endif
+
+} // namespace detail
+
+template <typename Key>
+concept IntMapKey = std::integral<Key> && !std::same_as<Key, bool>;
+
+/*
+ * Proxy iterator over the occupied slots of an IntMap, yielding a pair of
+ * references into the key and value arrays.
+ */
+template <typename Map, bool Const>
+class IntMapIterator {
+  template <typename, bool> friend class IntMapIterator;
+
+  using _key_type = typename Map::key_type;
+  using _mapped = std::conditional_t<Const, const typename Map::mapped_type,
+                                     typename Map::mapped_type>;
+  using _map_pointer = std::conditional_t<Const, const Map *, Map *>;
+
+  _map_pointer _map = nullptr;
+  std::size_t _slot = 0;
+
+  void _skip_empty() {
+    while (_slot < _map->bucket_count() && _map->_slot_empty(_slot))
+      ++_slot;
+  }
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::pair<_key_type, typename Map::mapped_type>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const _key_type &, _mapped &>;
+
+  struct pointer {
+    reference ref;
+    reference *operator->() { return &ref; }
+  };
+
+  IntMapIterator() = default;
+  IntMapIterator(_map_pointer map, std::size_t slot) : _map{map}, _slot{slot} {
+    _skip_empty();
+  }
+
+  // iterator to const_iterator
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  IntMapIterator(const IntMapIterator<Map, OtherConst> &other)
+      : _map{other._map}, _slot{other._slot} {}
+
+  reference operator*() const {
+    return {_map->_keys[_slot], _map->_values[_slot]};
+  }
+  pointer operator->() const { return pointer{**this}; }
+
+  std::size_t slot() const { return _slot; }
+
+  IntMapIterator &operator++() {
+    ++_slot;
+    _skip_empty();
+    return *this;
+  }
+  IntMapIterator operator++(int) {
+    IntMapIterator old = *this;
+    ++*this;
+    return old;
+  }
+
+  template <bool RhsConst>
+  bool operator==(const IntMapIterator<Map, RhsConst> &rhs) const {
+    return _slot == rhs._slot;
+  }
+};
+
+/*
+ * Open addressing hash map for integral keys, a drop in for UnorderedMap
+ * when the key is an ID:
+ *
+ *   rwstd::IntMap<uint64_t, Order> orders;
+ *   orders[id].quantity += 1;
+ *
+ * Keys and values live in two separate power of two arrays. An unused slot
+ * holds the key Empty (the largest value of Key unless given), which can
+ * therefore not be inserted. A key's home slot comes from a full avalanche
+ * mixer and collisions probe linearly. For keys of up to 32 bits each probe
+ * step compares 16 bytes of keys against the wanted key and the empty marker
+ * with one vector compare; copies of the first slots are kept past the end of
+ * the key array so such a load never has to wrap. 64 bit keys probe one slot
+ * at a time, which is faster at two keys per vector.
+ *
+ * Erase shifts the rest of the probe run back instead of leaving tombstones,
+ * so lookups never slow down after deletes. erase(pos) can thereby move an
+ * element from the start of the table into the slot just freed, which an
+ * ongoing iteration then visits twice.
+ */
+template <IntMapKey Key, typename T,
+          Key Empty = std::numeric_limits<Key>::max(),
+          typename Allocator = std::allocator<T>>
+class IntMap {
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = Allocator;
+  using iterator = IntMapIterator<IntMap, false>;
+  using const_iterator = IntMapIterator<IntMap, true>;
+
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using key_allocator = typename alloc_traits::template rebind_alloc<Key>;
+  using key_alloc_traits = std::allocator_traits<key_allocator>;
+
+  static constexpr Key empty_key = Empty;
+
+private:
+  friend iterator;
+  friend const_iterator;
+
+  static constexpr std::size_t _group = detail::int_group<Key>;
+  static constexpr std::size_t _min_buckets = 16;
+  static constexpr std::size_t _npos = std::numeric_limits<std::size_t>::max();
+
+  Key *_keys = nullptr;
+  T *_values = nullptr;
+  std::size_t _capacity = 0;
+  std::size_t _mask = 0;
+  std::size_t _size = 0;
+  float cur_load_factor = 0.75f;
+
+  Allocator _value_alloc;
+
+  std::size_t _home(Key key) const {
+    return static_cast<std::size_t>(
+               detail::int_mix(static_cast<std::uint64_t>(key))) &
+           _mask;
+  }
+
+  bool _slot_empty(std::size_t slot) const { return _keys[slot] == Empty; }
+
+  // writes a key and its copy past the end when the slot has one
+  void _set_key(std::size_t slot, Key key) {
+    _keys[slot] = key;
+    if (slot < _group - 1)
+      _keys[_capacity + slot] = key;
+  }
+
+  // both arrays come from the map's allocator, the keys through a rebind
+  // of it; keys are plain integers and need no construct or destroy
+  void _allocate(std::size_t capacity) {
+    key_allocator key_alloc(_value_alloc);
+    Key *keys = key_alloc_traits::allocate(key_alloc, capacity + _group - 1);
+    T *values;
+    try {
+      values = alloc_traits::allocate(_value_alloc, capacity);
+    } catch (...) {
+      key_alloc_traits::deallocate(key_alloc, keys, capacity + _group - 1);
+      throw;
+    }
+    // replaces the arrays without freeing the old ones, and only once both
+    // allocations went through
+    std::fill(keys, keys + capacity + _group - 1, Empty);
+    _keys = keys;
+    _values = values;
+    _capacity = capacity;
+    _mask = capacity - 1;
+  }
+
+  // destroys the elements of a table and frees both its arrays
+  void _free(Key *keys, T *values, std::size_t capacity) {
+    if (keys == nullptr)
+      return;
+    for (std::size_t i = 0; i < capacity; ++i) {
+      if (keys[i] != Empty)
+        alloc_traits::destroy(_value_alloc, values + i);
+    }
+    alloc_traits::deallocate(_value_alloc, values, capacity);
+    key_allocator key_alloc(_value_alloc);
+    key_alloc_traits::deallocate(key_alloc, keys, capacity + _group - 1);
+  }
+
+  void _release() {
+    _free(_keys, _values, _capacity);
+    _keys = nullptr;
+    _values = nullptr;
+  }
+
+  // slot holding key (found) or the empty slot that ends its run
+  std::pair<std::size_t, bool> _probe(Key key) const {
+    std::size_t slot = _home(key);
+#if defined(__SSE2__)
+    if constexpr (detail::int_simd<Key>) {
+      while (true) {
+        // a key only ever sits before the first empty slot of its run, so
+        // any match in the window is the key itself
+        if (std::uint32_t hit = detail::int_match(_keys + slot, key))
+          return {_lane(slot, hit), true};
+        if (std::uint32_t free = detail::int_match(_keys + slot, Empty))
+          return {_lane(slot, free), false};
+        slot = (slot + _group) & _mask;
+      }
+    }
+#endif
+    while (true) {
+      if (_keys[slot] == key)
+        return {slot, true};
+      if (_keys[slot] == Empty)
+        return {slot, false};
+      slot = (slot + 1) & _mask;
+    }
+  }
+
+  std::size_t _lane(std::size_t slot, std::uint32_t mask) const {
+    return (slot +
+            static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(Key)) &
+           _mask;
+  }
+
+  // slot holding key, or _npos
+  std::size_t _find_slot(Key key) const {
+    // a moved from map has no arrays at all
+    if (key == Empty || _size == 0)
+      return _npos;
+    auto [slot, found] = _probe(key);
+    return found ? slot : _npos;
+  }
+
+  void _check_key(Key key) const {
+    if (key == Empty)
+      throw std::invalid_argument(
+          "IntMap: key is reserved as the empty slot marker");
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> _emplace_key(Key key, Args &&...args) {
+    _check_key(key);
+    if (_capacity == 0)
+      rehash(_min_buckets);
+    auto [slot, found] = _probe(key);
+    if (found)
+      return {iterator(this, slot), false};
+    if (static_cast<float>(_size + 1) >
+        static_cast<float>(_capacity) * cur_load_factor) {
+      rehash(_capacity * 2);
+      slot = _probe(key).first;
+    }
+    alloc_traits::construct(_value_alloc, _values + slot,
+                            std::forward<Args>(args)...);
+    _set_key(slot, key);
+    ++_size;
+    return {iterator(this, slot), true};
+  }
+
+  // backward shift: pull later members of the run into the hole at slot
+  void _erase_slot(std::size_t slot) {
+    alloc_traits::destroy(_value_alloc, _values + slot);
+    std::size_t hole = slot;
+    std::size_t next = slot;
+    while (true) {
+      next = (next + 1) & _mask;
+      if (_slot_empty(next))
+        break;
+      std::size_t home = _home(_keys[next]);
+      // the element may move back only if the hole is still on its path
+      if (((next - home) & _mask) >= ((next - hole) & _mask)) {
+        alloc_traits::construct(_value_alloc, _values + hole,
+                                std::move(_values[next]));
+        alloc_traits::destroy(_value_alloc, _values + next);
+        _set_key(hole, _keys[next]);
+        hole = next;
+      }
+    }
+    _set_key(hole, Empty);
+    --_size;
+  }
+
+public:
+  explicit IntMap(size_type num_buckets,
+                  const Allocator &alloc = Allocator())
+      : _value_alloc{alloc} {
+    _allocate(std::bit_ceil(std::max(num_buckets, _min_buckets)));
+  }
+
+  IntMap() : IntMap(_min_buckets) {}
+
+  IntMap(std::initializer_list<value_type> init) : IntMap() {
+    for (const auto &value : init)
+      insert(value);
+  }
+
+  IntMap(const IntMap &other)
+      : cur_load_factor{other.cur_load_factor},
+        _value_alloc{
+            alloc_traits::select_on_container_copy_construction(
+                other._value_alloc)} {
+    _allocate(std::max(other._capacity, _min_buckets));
+    if (other._capacity == 0)
+      return;
+    std::copy(other._keys, other._keys + _capacity + _group - 1, _keys);
+    for (std::size_t i = 0; i < _capacity; ++i) {
+      if (!_slot_empty(i))
+        alloc_traits::construct(_value_alloc, _values + i, other._values[i]);
+    }
+    _size = other._size;
+  }
+
+  IntMap(IntMap &&other) noexcept
+      : _keys{other._keys}, _values{other._values},
+        _capacity{other._capacity}, _mask{other._mask}, _size{other._size},
+        cur_load_factor{other.cur_load_factor},
+        _value_alloc{std::move(other._value_alloc)} {
+    other._keys = nullptr;
+    other._values = nullptr;
+    other._capacity = 0;
+    other._mask = 0;
+    other._size = 0;
+  }
+
+  IntMap &operator=(IntMap copy) {
+    swap(copy);
+    return *this;
+  }
+
+  ~IntMap() { _release(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const noexcept { return _size == 0; }
+
+  size_t size() const noexcept { return _size; }
+
+  size_t bucket_count() const { return _capacity; }
+
+  /*
+   * Modifiers
+   */
+
+  void clear() noexcept {
+    for (std::size_t i = 0; i < _capacity; ++i) {
+      if (!_slot_empty(i))
+        alloc_traits::destroy(_value_alloc, _values + i);
+    }
+    if (_keys != nullptr)
+      std::fill(_keys, _keys + _capacity + _group - 1, Empty);
+    _size = 0;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return _emplace_key(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return _emplace_key(value.first, std::move(value.second));
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    value_type value(std::forward<Args>(args)...);
+    return _emplace_key(value.first, std::move(value.second));
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(Key key, Args &&...args) {
+    return _emplace_key(key, std::forward<Args>(args)...);
+  }
+
+  iterator erase(iterator pos) {
+    if (pos == end())
+      return end();
+    std::size_t slot = pos.slot();
+    _erase_slot(slot);
+    return iterator(this, slot);
+  }
+
+  size_type erase(const Key &key) {
+    std::size_t slot = _find_slot(key);
+    if (slot == _npos)
+      return 0;
+    _erase_slot(slot);
+    return 1;
+  }
+
+  void swap(IntMap &other) noexcept {
+    using std::swap;
+    swap(_keys, other._keys);
+    swap(_values, other._values);
+    swap(_capacity, other._capacity);
+    swap(_mask, other._mask);
+    swap(_size, other._size);
+    swap(cur_load_factor, other.cur_load_factor);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(_value_alloc, other._value_alloc);
+    }
+  }
+
+  /*
+   * Lookup
+   */
+
+  mapped_type &operator[](const Key &key) {
+    return (*_emplace_key(key).first).second;
+  }
+
+  mapped_type &at(const Key &key) {
+    std::size_t slot = _find_slot(key);
+    if (slot == _npos)
+      throw std::out_of_range("IntMap::at: key not found");
+    return _values[slot];
+  }
+
+  const mapped_type &at(const Key &key) const {
+    std::size_t slot = _find_slot(key);
+    if (slot == _npos)
+      throw std::out_of_range("IntMap::at: key not found");
+    return _values[slot];
+  }
+
+  iterator find(const Key &key) {
+    std::size_t slot = _find_slot(key);
+    return slot == _npos ? end() : iterator(this, slot);
+  }
+
+  const_iterator find(const Key &key) const {
+    std::size_t slot = _find_slot(key);
+    return slot == _npos ? end() : const_iterator(this, slot);
+  }
+
+  bool contains(const Key &key) const { return _find_slot(key) != _npos; }
+
+  size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(this, _capacity); }
+  const_iterator end() const noexcept {
+    return const_iterator(this, _capacity);
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  /*
+   * Hash policy
+   */
+
+  // grows to a power of two of at least count buckets, never shrinks
+  void rehash(size_t count) {
+    std::size_t needed = static_cast<std::size_t>(
+        std::ceil(static_cast<float>(_size) / cur_load_factor));
+    std::size_t capacity =
+        std::bit_ceil(std::max({count, needed + 1, _min_buckets}));
+    if (capacity <= _capacity)
+      return;
+
+    Key *old_keys = _keys;
+    T *old_values = _values;
+    std::size_t old_capacity = _capacity;
+    std::size_t old_mask = _mask;
+    _allocate(capacity);
+    // the old table stays whole until every element is in the new one, so
+    // a throwing copy (move_if_noexcept) just drops the new table
+    try {
+      for (std::size_t i = 0; i < old_capacity; ++i) {
+        if (old_keys[i] == Empty)
+          continue;
+        std::size_t slot = _probe(old_keys[i]).first;
+        alloc_traits::construct(_value_alloc, _values + slot,
+                                std::move_if_noexcept(old_values[i]));
+        _set_key(slot, old_keys[i]);
+      }
+    } catch (...) {
+      _release();
+      _keys = old_keys;
+      _values = old_values;
+      _capacity = old_capacity;
+      _mask = old_mask;
+      throw;
+    }
+    _free(old_keys, old_values, old_capacity);
+  }
+
+  float load_factor() const {
+    if (_capacity == 0)
+      return 0.0f;
+    return static_cast<float>(_size) / static_cast<float>(_capacity);
+  }
+
+  float max_load_factor() const noexcept { return cur_load_factor; }
+
+  // linear probing degrades quickly when nearly full, so at most 0.9
+  void max_load_factor(float ml) {
+    if (!(ml > 0.0f))
+      throw std::invalid_argument("IntMap: max load factor must be positive");
+    cur_load_factor = std::min(ml, 0.9f);
+  }
+
+  void reserve(size_type count) {
+    rehash(static_cast<size_t>(
+        std::ceil(static_cast<float>(count) / cur_load_factor)));
+  }
+
+  // bytes held by the key and value arrays
+  size_type memory_usage() const {
+    return (_capacity + _group - 1) * sizeof(Key) + _capacity * sizeof(T);
+  }
+};
+
+} // namespace rwstd
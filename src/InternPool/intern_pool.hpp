@@ -0,0 +1,225 @@
+#pragma once
+
+#include "ConcurrentVector/concurrent_vector.hpp"
+#include "Hash/hash.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace rwstd {
+
+/*
+ * 32 bit handle of an interned string. Two symbols from the same pool are
+ * equal exactly when their strings are, so comparing or hashing one is a
+ * single integer operation. A default constructed symbol is the invalid one.
+ */
+struct Symbol {
+  static constexpr std::uint32_t invalid = ~std::uint32_t{0};
+
+  std::uint32_t id = invalid;
+
+  bool valid() const { return id != invalid; }
+
+  friend bool operator==(Symbol, Symbol) = default;
+  friend std::strong_ordering operator<=>(Symbol, Symbol) = default;
+};
+
+/*
+ * Deduplicating string store. intern() copies a string into an arena the
+ * first time it is seen and returns its Symbol every time; view() turns the
+ * symbol back into a string_view that stays valid, and NUL terminated, for
+ * the life of the pool.
+ *
+ * The pool is split into a power of two number of shards picked by the top
+ * bits of the string's hash, each with its own lock, map and arena, so
+ * threads interning different strings rarely meet. A symbol carries its
+ * shard in the low bits and the shard local index above them; view() takes
+ * no lock. Symbols and views must reach other threads the usual way (the
+ * thread that interned them publishing them), like any other data.
+ */
+class InternPool {
+  // a stored string with its hash, so rehashing and probing never rehash text
+  struct Key {
+    std::string_view text;
+    std::uint64_t hash;
+
+    bool operator==(const Key &other) const {
+      return hash == other.hash && text == other.text;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const {
+      return static_cast<std::size_t>(key.hash);
+    }
+  };
+
+  static constexpr std::size_t _chunk_size = 64 * 1024;
+
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    rwstd::UnorderedMap<Key, std::uint32_t, KeyHash> index;
+    rwstd::ConcurrentVector<std::string_view> strings;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *free = nullptr;
+    std::size_t free_bytes = 0;
+    std::size_t arena_bytes = 0;
+
+    // copies text into the arena, strings above a quarter chunk get their own
+    std::string_view store(std::string_view text) {
+      std::size_t needed = text.size() + 1;
+      if (needed > free_bytes) {
+        std::size_t size = needed > _chunk_size / 4 ? needed : _chunk_size;
+        chunks.push_back(std::make_unique<char[]>(size));
+        arena_bytes += size;
+        if (size == _chunk_size) {
+          free = chunks.back().get();
+          free_bytes = size;
+        } else {
+          char *own = chunks.back().get();
+          std::memcpy(own, text.data(), text.size());
+          own[text.size()] = '\0';
+          return {own, text.size()};
+        }
+      }
+      char *out = free;
+      std::memcpy(out, text.data(), text.size());
+      out[text.size()] = '\0';
+      free += needed;
+      free_bytes -= needed;
+      return {out, text.size()};
+    }
+  };
+
+  std::unique_ptr<Shard[]> _shards;
+  std::size_t _shard_bits;
+  std::uint32_t _max_local;
+
+  static std::uint64_t _hash(std::string_view text) {
+    return hash::hash_bytes(text.data(), text.size());
+  }
+
+  const Shard &_shard_of(std::uint64_t h) const {
+    return _shards[_shard_bits == 0 ? 0 : h >> (64 - _shard_bits)];
+  }
+
+  Shard &_shard_of(std::uint64_t h) {
+    return _shards[_shard_bits == 0 ? 0 : h >> (64 - _shard_bits)];
+  }
+
+  Symbol _symbol(const Shard &shard, std::uint32_t local) const {
+    auto index = static_cast<std::uint32_t>(&shard - _shards.get());
+    return Symbol{(local << _shard_bits) | index};
+  }
+
+public:
+  // shards is rounded up to a power of two, at most 256; one is right for
+  // single threaded use, a few per interning thread for concurrent use
+  explicit InternPool(std::size_t shards = 1) {
+    if (shards == 0 || shards > 256)
+      throw std::invalid_argument("InternPool: shards must be in [1, 256]");
+    std::size_t count = std::bit_ceil(shards);
+    _shard_bits = static_cast<std::size_t>(std::countr_zero(count));
+    _shards = std::make_unique<Shard[]>(count);
+    // the all ones id stays free for Symbol::invalid
+    _max_local = static_cast<std::uint32_t>(
+        (std::uint64_t{1} << (32 - _shard_bits)) - 2);
+  }
+
+  InternPool(const InternPool &) = delete;
+  InternPool &operator=(const InternPool &) = delete;
+
+  /*
+   * Interning
+   */
+
+  Symbol intern(std::string_view text) {
+    std::uint64_t h = _hash(text);
+    Shard &shard = _shard_of(h);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(Key{text, h});
+    if (it != shard.index.end())
+      return _symbol(shard, it->second);
+
+    std::size_t local = shard.strings.size();
+    if (local > _max_local)
+      throw std::length_error("InternPool: shard is full");
+    std::string_view stored = shard.store(text);
+    // the slot is reserved up front and the index insert is the last step
+    // that can throw, so a failure leaves no unindexed string behind
+    if (local == shard.strings.capacity())
+      shard.strings.reserve(local + 1);
+    shard.index.insert({Key{stored, h}, static_cast<std::uint32_t>(local)});
+    shard.strings.push_back(stored);
+    return _symbol(shard, static_cast<std::uint32_t>(local));
+  }
+
+  // the symbol of text if it was interned, without interning it
+  std::optional<Symbol> find(std::string_view text) const {
+    std::uint64_t h = _hash(text);
+    const Shard &shard = _shard_of(h);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(Key{text, h});
+    if (it == shard.index.end())
+      return std::nullopt;
+    return _symbol(shard, it->second);
+  }
+
+  /*
+   * Lookup
+   */
+
+  std::string_view view(Symbol symbol) const {
+    const Shard &shard = _shards[symbol.id & ((1u << _shard_bits) - 1)];
+    return shard.strings[symbol.id >> _shard_bits];
+  }
+
+  std::string_view operator[](Symbol symbol) const { return view(symbol); }
+
+  /*
+   * Capacity
+   */
+
+  std::size_t shard_count() const { return std::size_t{1} << _shard_bits; }
+
+  // distinct strings interned so far
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < shard_count(); ++i)
+      total += _shards[i].strings.size();
+    return total;
+  }
+
+  // arena chunks, the index maps and the symbol tables; takes every lock
+  std::size_t memory_usage() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < shard_count(); ++i) {
+      const Shard &shard = _shards[i];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      total += shard.arena_bytes + shard.index.memory_usage() +
+               shard.strings.capacity() * sizeof(std::string_view);
+    }
+    return total;
+  }
+};
+
+} // namespace rwstd
+
+// symbols are small dense integers, the identity spreads them over buckets
+template <>
+struct std::hash<rwstd::Symbol> {
+  std::size_t operator()(rwstd::Symbol symbol) const noexcept {
+    return symbol.id;
+  }
+};
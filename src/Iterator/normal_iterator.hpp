@@ -1,17 +1,26 @@
 #pragma once
 
+#include <compare>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 
 namespace rwstd {
 /*
  * The goal of this class is to convert a pointer into an iterator - basically
  * just a wrapper
+ *
+ * Over a pointer it is a contiguous iterator (iterator_concept), so a
+ * container handing these out is a std::ranges::contiguous_range:
+ * std::span, std::to_address and the ranges algorithms see through it. An
+ * iterator converts to the const_iterator of the same container, and the
+ * two compare with each other.
  */
 template <typename Iterator, typename Container>
 class NormalIterator {
 protected:
-  // let copmiler auto deduce the tag - cp20 have contiguous range - but i think
-  // this method is for < cpp20
+  // the pre c++20 tags come from the wrapped iterator, iterator_concept
+  // below adds the c++20 one
   typedef std::iterator_traits<Iterator> _traits_type;
   Iterator _iterator;
 
@@ -21,6 +30,9 @@ public:
   typedef typename _traits_type::pointer pointer;
   typedef typename _traits_type::reference reference;
   typedef typename _traits_type::iterator_category iterator_category;
+  typedef std::conditional_t<std::contiguous_iterator<Iterator>,
+                             std::contiguous_iterator_tag, iterator_category>
+      iterator_concept;
 
 public:
   NormalIterator() = default;
@@ -30,13 +42,18 @@ public:
   NormalIterator &
   operator=(const NormalIterator<Iterator, Container> &_i) = default;
 
-  bool operator==(const NormalIterator<Iterator, Container> &rhs) const {
-    return this->_iterator == rhs._iterator;
-  }
+  // iterator -> const_iterator
+  template <typename Other>
+    requires(!std::is_same_v<Other, Iterator> &&
+             std::is_convertible_v<Other, Iterator>)
+  NormalIterator(const NormalIterator<Other, Container> &other)
+      : _iterator{other.base()} {}
+
+  const Iterator &base() const { return _iterator; }
 
   reference operator*() const { return *_iterator; }
 
-  pointer operator->() const { return _iterator; }
+  pointer operator->() const { return std::to_address(_iterator); }
 
   // ++it - pre
   NormalIterator &operator++() {
@@ -69,6 +86,10 @@ public:
     return NormalIterator(_iterator + n);
   }
 
+  friend NormalIterator operator+(difference_type n, const NormalIterator &it) {
+    return it + n;
+  }
+
   NormalIterator &operator+=(difference_type n) {
     this->_iterator += n;
     return *this;
@@ -83,34 +104,23 @@ public:
     return *this;
   }
 
-  difference_type operator-(const NormalIterator &other) const {
-    return this->_iterator - other._iterator;
+  template <typename Other>
+  difference_type
+  operator-(const NormalIterator<Other, Container> &other) const {
+    return this->_iterator - other.base();
   }
 
   reference operator[](difference_type n) const { return _iterator[n]; }
 
-  bool operator==(const NormalIterator &rhs) {
-    return _iterator == rhs._iterator;
-  }
-
-  bool operator!=(const NormalIterator &rhs) {
-    return _iterator != rhs._iterator;
-  }
-
-  bool operator<(const NormalIterator &rhs) {
-    return _iterator < rhs._iterator;
-  }
-
-  bool operator<=(const NormalIterator &rhs) {
-    return _iterator <= rhs._iterator;
-  }
-
-  bool operator>(const NormalIterator &rhs) {
-    return _iterator > rhs._iterator;
+  // comparisons, also between iterator and const_iterator
+  template <typename Other>
+  bool operator==(const NormalIterator<Other, Container> &rhs) const {
+    return _iterator == rhs.base();
   }
 
-  bool operator>=(const NormalIterator &rhs) {
-    return _iterator >= rhs._iterator;
+  template <typename Other>
+  auto operator<=>(const NormalIterator<Other, Container> &rhs) const {
+    return _iterator <=> rhs.base();
   }
 };
 } // namespace rwstd
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "UnorderedMap/unordered_map.hpp"
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+// which entry a full cache gives up
+enum class EvictionPolicy {
+  lru,  // least recently used; every hit moves its entry to the front
+  sieve // SIEVE: a hit only sets a flag, a hand sweeps out unflagged entries
+};
+
+// every entry costs one, so the capacity is an entry count
+struct UnitCost {
+  template <typename Key, typename T>
+  std::size_t operator()(const Key & /*_*/, const T & /*_*/) const {
+    return 1;
+  }
+};
+
+struct CacheStats {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+
+  double hit_rate() const {
+    std::size_t lookups = hits + misses;
+    return lookups == 0 ? 0.0
+                        : static_cast<double>(hits) /
+                              static_cast<double>(lookups);
+  }
+};
+
+/*
+ * Bounded cache over an UnorderedMap whose mapped values carry the recency
+ * links, so an entry is a single map node and no separate list is kept:
+ *
+ *   rwstd::LruCache<std::string, Page> pages(1024);
+ *   if (Page *page = pages.get(url)) return *page;
+ *   pages.put(url, fetch(url));
+ *
+ * The capacity is in units of Cost, called as cost(key, value) when an entry
+ * is stored; with a byte count the cache is bounded by memory rather than by
+ * entries. put evicts until the new entry fits and refuses entries that cost
+ * more than the whole capacity.
+ *
+ * Entries form one list, newest at the front. LRU moves an entry to the front
+ * on every hit and evicts from the back. SIEVE leaves hits in place and only
+ * marks them visited; on eviction a hand walks from the back toward the
+ * front, clearing marks, and evicts the first unmarked entry it meets. Hits
+ * then never write to the list, and one-off keys leave quickly instead of
+ * pushing out the popular ones.
+ *
+ * Entries point into each other, so a cache can be neither copied nor moved.
+ */
+template <typename Key, typename T, EvictionPolicy Policy = EvictionPolicy::lru,
+          typename Cost = UnitCost, typename Hash = std::hash<Key>>
+class Cache {
+  struct Entry {
+    T value;
+    std::size_t cost = 0;
+    const Key *key = nullptr;
+    Entry *prev = nullptr; // toward the front, newer
+    Entry *next = nullptr; // toward the back, older
+    bool visited = false;
+  };
+
+  rwstd::UnorderedMap<Key, Entry, Hash> _map;
+  Entry *_front = nullptr;
+  Entry *_back = nullptr;
+  Entry *_hand = nullptr;
+  std::size_t _capacity;
+  std::size_t _total_cost = 0;
+  Cost _cost;
+  CacheStats _stats;
+
+  void _unlink(Entry *entry) {
+    if (_hand == entry)
+      _hand = entry->prev;
+    (entry->prev ? entry->prev->next : _front) = entry->next;
+    (entry->next ? entry->next->prev : _back) = entry->prev;
+    entry->prev = nullptr;
+    entry->next = nullptr;
+  }
+
+  void _push_front(Entry *entry) {
+    entry->next = _front;
+    (_front ? _front->prev : _back) = entry;
+    _front = entry;
+  }
+
+  // entry the policy gives up next, the list must not be empty
+  Entry *_victim() {
+    if constexpr (Policy == EvictionPolicy::lru) {
+      return _back;
+    } else {
+      Entry *hand = _hand ? _hand : _back;
+      while (hand->visited) {
+        hand->visited = false;
+        hand = hand->prev ? hand->prev : _back;
+      }
+      _hand = hand->prev;
+      return hand;
+    }
+  }
+
+  void _remove(Entry *entry) {
+    _unlink(entry);
+    _total_cost -= entry->cost;
+    _map.erase(*entry->key);
+  }
+
+  void _make_room(std::size_t cost) {
+    while (_front != nullptr && _total_cost + cost > _capacity) {
+      _remove(_victim());
+      ++_stats.evictions;
+    }
+  }
+
+public:
+  explicit Cache(std::size_t capacity, const Cost &cost = Cost())
+      : _capacity{capacity}, _cost{cost} {
+    if (capacity == 0)
+      throw std::invalid_argument("Cache: capacity must be positive");
+  }
+
+  Cache(const Cache &) = delete;
+  Cache &operator=(const Cache &) = delete;
+
+  /*
+   * Lookup
+   */
+
+  // the cached value, counted as a hit or miss and refreshed on a hit
+  T *get(const Key &key) {
+    auto it = _map.find(key);
+    if (it == _map.end()) {
+      ++_stats.misses;
+      return nullptr;
+    }
+    ++_stats.hits;
+    Entry *entry = &it->second;
+    if constexpr (Policy == EvictionPolicy::lru) {
+      if (entry != _front) {
+        _unlink(entry);
+        _push_front(entry);
+      }
+    } else {
+      entry->visited = true;
+    }
+    return &entry->value;
+  }
+
+  // the cached value, without touching recency or the counters
+  const T *peek(const Key &key) const {
+    auto it = _map.find(key);
+    return it == _map.end() ? nullptr : &it->second.value;
+  }
+
+  bool contains(const Key &key) const { return peek(key) != nullptr; }
+
+  /*
+   * Modifiers
+   */
+
+  // stores value under key, evicting as needed; false if it can never fit
+  template <typename V>
+  bool put(const Key &key, V &&value) {
+    std::size_t cost = _cost(key, value);
+    if (cost > _capacity)
+      return false;
+
+    auto it = _map.find(key);
+    if (it != _map.end()) {
+      // assigned first, a throwing assignment leaves the entry linked
+      Entry *entry = &it->second;
+      entry->value = std::forward<V>(value);
+      // out of the list while making room, so it can't evict itself
+      _unlink(entry);
+      _total_cost -= entry->cost;
+      _make_room(cost);
+      entry->cost = cost;
+      _total_cost += cost;
+      _push_front(entry);
+      return true;
+    }
+
+    _make_room(cost);
+    auto [inserted, _] =
+        _map.insert({key, Entry{T(std::forward<V>(value)), cost}});
+    Entry *entry = &inserted->second;
+    entry->key = &inserted->first;
+    _total_cost += cost;
+    _push_front(entry);
+    return true;
+  }
+
+  bool erase(const Key &key) {
+    auto it = _map.find(key);
+    if (it == _map.end())
+      return false;
+    _remove(&it->second);
+    return true;
+  }
+
+  // drops the entry the policy would evict next, false if empty
+  bool evict() {
+    if (_front == nullptr)
+      return false;
+    _remove(_victim());
+    ++_stats.evictions;
+    return true;
+  }
+
+  void clear() {
+    _map.clear();
+    _front = nullptr;
+    _back = nullptr;
+    _hand = nullptr;
+    _total_cost = 0;
+  }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _front == nullptr; }
+
+  std::size_t size() const { return _map.size(); }
+
+  std::size_t capacity() const { return _capacity; }
+
+  // summed cost of the entries held, never above capacity()
+  std::size_t total_cost() const { return _total_cost; }
+
+  /*
+   * Counters
+   */
+
+  const CacheStats &stats() const { return _stats; }
+
+  void reset_stats() { _stats = CacheStats{}; }
+};
+
+template <typename Key, typename T, typename Cost = UnitCost,
+          typename Hash = std::hash<Key>>
+using LruCache = Cache<Key, T, EvictionPolicy::lru, Cost, Hash>;
+
+template <typename Key, typename T, typename Cost = UnitCost,
+          typename Hash = std::hash<Key>>
+using SieveCache = Cache<Key, T, EvictionPolicy::sieve, Cost, Hash>;
+
+} // namespace rwstd
@@ -0,0 +1,479 @@
+#pragma once
+
+#include "Iterator/normal_iterator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rwstd {
+
+enum class MapMode { read_only, read_write };
+
+enum class FlushMode {
+  sync, // msync(MS_SYNC), returns once the data is on disk
+  async // msync(MS_ASYNC), schedules the write back and returns
+};
+
+namespace detail {
+
+/*
+ * On-disk header, one cache line so the payload after it stays 64 byte
+ * aligned. Everything is stored in native byte order, endian_tag catches files
+ * written on a machine with the other one.
+ */
+struct MappedHeader {
+  static constexpr char expected_magic[8] = {'R', 'W', 'S', 'T',
+                                             'D', 'M', 'V', '\0'};
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t native_endian_tag = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian_tag;
+  std::uint64_t element_size;
+  std::uint64_t element_align;
+  std::uint64_t size;
+  std::uint64_t capacity;
+  std::uint64_t checksum;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(MappedHeader) == 64);
+
+// word at a time multiply/rotate mix - not cryptographic, just fast enough to
+// run over multi GB payloads on flush and catch torn or truncated writes
+inline std::uint64_t checksum64(const void *data, std::size_t bytes) {
+  constexpr std::uint64_t k1 = 0x9e3779b97f4a7c15ull;
+  constexpr std::uint64_t k2 = 0xc2b2ae3d27d4eb4full;
+  const auto *p = static_cast<const unsigned char *>(data);
+  std::uint64_t h = k2 ^ bytes;
+  std::size_t i = 0;
+  for (; i + 8 <= bytes; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, p + i, 8);
+    h ^= word * k1;
+    h = ((h << 31) | (h >> 33)) * k2;
+  }
+  std::uint64_t tail = 0;
+  // data may be null for an empty payload
+  if (i < bytes)
+    std::memcpy(&tail, p + i, bytes - i);
+  h ^= tail * k1;
+  h ^= h >> 29;
+  h *= k2;
+  h ^= h >> 32;
+  return h;
+}
+
+} // namespace detail
+
+/*
+ * Vector backed by a memory mapped file:
+ *
+ *   [ MappedHeader (64 bytes) | T T T T ... capacity slots ]
+ *
+ * open() in read_only mode maps the file and hands out the elements in place,
+ * no copy and no parse step, pages fault in on first touch. read_write mode
+ * can also grow the file (ftruncate + remap, pointers are invalidated like
+ * Vector::reserve). flush() writes size and checksum into the header and
+ * msyncs, the destructor flushes read_write mappings.
+ *
+ * Only trivially copyable T, the bytes on disk are the objects.
+ */
+template <typename T>
+class MappedVector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "MappedVector only stores trivially copyable types");
+  static_assert(alignof(T) <= sizeof(detail::MappedHeader),
+                "MappedVector payload is only 64 byte aligned");
+
+public:
+  typedef rwstd::NormalIterator<T *, MappedVector> iterator;
+  typedef rwstd::NormalIterator<const T *, MappedVector> const_iterator;
+
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+private:
+  int _fd = -1;
+  MapMode _mode = MapMode::read_only;
+  std::string _path;
+  void *_map = nullptr;
+  std::size_t _map_bytes = 0;
+  std::size_t _size = 0;
+  std::size_t _capacity = 0;
+
+  static constexpr std::size_t _header_bytes = sizeof(detail::MappedHeader);
+
+  [[noreturn]] void _throw_errno(const char *what) const {
+    throw std::system_error(errno, std::generic_category(),
+                            std::format("MappedVector {}: {}", what, _path));
+  }
+
+  detail::MappedHeader *_header() const {
+    return static_cast<detail::MappedHeader *>(_map);
+  }
+
+  T *_data() const {
+    return reinterpret_cast<T *>(static_cast<std::byte *>(_map) +
+                                 _header_bytes);
+  }
+
+  void _require_writable(const char *what) const {
+    if (_mode != MapMode::read_write) {
+      throw std::logic_error(
+          std::format("MappedVector::{}: {} is mapped read only", what, _path));
+    }
+  }
+
+  void *_mmap(std::size_t bytes) const {
+    int prot = PROT_READ | (_mode == MapMode::read_write ? PROT_WRITE : 0);
+    void *map = ::mmap(nullptr, bytes, prot, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED)
+      _throw_errno("mmap");
+    return map;
+  }
+
+  // file size for capacity elements, as long as off_t can hold it
+  static std::size_t _bytes_for(std::size_t capacity) {
+    constexpr auto max_bytes =
+        static_cast<std::size_t>(std::numeric_limits<off_t>::max());
+    if (capacity > (max_bytes - _header_bytes) / sizeof(T)) {
+      throw std::length_error(
+          std::format("{}: Size is too big for MappedVector", capacity));
+    }
+    return _header_bytes + capacity * sizeof(T);
+  }
+
+  void _map_file(std::size_t bytes) {
+    _map = _mmap(bytes);
+    _map_bytes = bytes;
+  }
+
+  void _unmap() {
+    if (_map != nullptr) {
+      ::munmap(_map, _map_bytes);
+      _map = nullptr;
+      _map_bytes = 0;
+    }
+  }
+
+  void _close() noexcept {
+    if (_map != nullptr && _mode == MapMode::read_write) {
+      try {
+        flush(FlushMode::sync);
+      } catch (...) {
+        // nothing sensible to do from a destructor, the checksum will be
+        // stale and the next open will notice
+      }
+    }
+    _unmap();
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+    _size = 0;
+    _capacity = 0;
+  }
+
+  void _validate_header() {
+    if (_map_bytes < _header_bytes) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} is too small for a header", _path));
+    }
+    const detail::MappedHeader &h = *_header();
+    if (std::memcmp(h.magic, detail::MappedHeader::expected_magic, 8) != 0) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} is not a MappedVector file", _path));
+    }
+    if (h.endian_tag != detail::MappedHeader::native_endian_tag) {
+      throw std::runtime_error(std::format(
+          "MappedVector: {} was written with a different byte order", _path));
+    }
+    if (h.version != detail::MappedHeader::current_version) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} has unsupported version {}", _path,
+                      h.version));
+    }
+    if (h.element_size != sizeof(T) || h.element_align != alignof(T)) {
+      throw std::runtime_error(std::format(
+          "MappedVector: {} holds {} byte elements, expected {}", _path,
+          h.element_size, sizeof(T)));
+    }
+    if (h.size > h.capacity ||
+        h.capacity > (_map_bytes - _header_bytes) / sizeof(T)) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} is truncated", _path));
+    }
+    _size = h.size;
+    _capacity = h.capacity;
+  }
+
+  MappedVector(std::string path, MapMode mode)
+      : _mode{mode}, _path{std::move(path)} {}
+
+public:
+  MappedVector() = default;
+
+  // creates (or truncates) path, room for capacity elements
+  static MappedVector create(const std::string &path,
+                             std::size_t capacity = 0) {
+    std::size_t bytes = _bytes_for(capacity);
+    MappedVector v(path, MapMode::read_write);
+    v._fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (v._fd < 0)
+      v._throw_errno("open");
+
+    if (::ftruncate(v._fd, static_cast<off_t>(bytes)) != 0)
+      v._throw_errno("ftruncate");
+    v._map_file(bytes);
+
+    detail::MappedHeader &h = *v._header();
+    std::memcpy(h.magic, detail::MappedHeader::expected_magic, 8);
+    h.version = detail::MappedHeader::current_version;
+    h.endian_tag = detail::MappedHeader::native_endian_tag;
+    h.element_size = sizeof(T);
+    h.element_align = alignof(T);
+    h.size = 0;
+    h.capacity = capacity;
+    h.checksum = detail::checksum64(nullptr, 0);
+    h.reserved = 0;
+    v._capacity = capacity;
+    return v;
+  }
+
+  // maps an existing file and checks its header only, so open stays O(1);
+  // call verify() to read the whole payload against its checksum
+  static MappedVector open(const std::string &path,
+                           MapMode mode = MapMode::read_only) {
+    MappedVector v(path, mode);
+    int flags = (mode == MapMode::read_write ? O_RDWR : O_RDONLY) | O_CLOEXEC;
+    v._fd = ::open(path.c_str(), flags);
+    if (v._fd < 0)
+      v._throw_errno("open");
+
+    struct stat st;
+    if (::fstat(v._fd, &st) != 0)
+      v._throw_errno("fstat");
+    if (static_cast<std::size_t>(st.st_size) < _header_bytes) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} is too small for a header", path));
+    }
+    v._map_file(static_cast<std::size_t>(st.st_size));
+    try {
+      v._validate_header();
+    } catch (...) {
+      // closing would flush a read_write mapping over the rejected file
+      v._unmap();
+      throw;
+    }
+    return v;
+  }
+
+  // compares the payload against the checksum written by the last flush(),
+  // throws std::runtime_error when they differ
+  void verify() const {
+    if (_map != nullptr &&
+        detail::checksum64(_data(), _size * sizeof(T)) != _header()->checksum) {
+      throw std::runtime_error(
+          std::format("MappedVector: {} failed its checksum", _path));
+    }
+  }
+
+  MappedVector(const MappedVector &) = delete;
+  MappedVector &operator=(const MappedVector &) = delete;
+
+  MappedVector(MappedVector &&other) noexcept
+      : _fd{std::exchange(other._fd, -1)}, _mode{other._mode},
+        _path{std::move(other._path)}, _map{std::exchange(other._map, nullptr)},
+        _map_bytes{std::exchange(other._map_bytes, 0)},
+        _size{std::exchange(other._size, 0)},
+        _capacity{std::exchange(other._capacity, 0)} {}
+
+  MappedVector &operator=(MappedVector &&other) noexcept {
+    if (this != &other) {
+      _close();
+      _fd = std::exchange(other._fd, -1);
+      _mode = other._mode;
+      _path = std::move(other._path);
+      _map = std::exchange(other._map, nullptr);
+      _map_bytes = std::exchange(other._map_bytes, 0);
+      _size = std::exchange(other._size, 0);
+      _capacity = std::exchange(other._capacity, 0);
+    }
+    return *this;
+  }
+
+  ~MappedVector() { _close(); }
+
+  bool is_open() const { return _map != nullptr; }
+
+  MapMode mode() const { return _mode; }
+
+  const std::string &path() const { return _path; }
+
+  // flushes (read_write) and unmaps
+  void close() { _close(); }
+
+  /*
+   * Element access
+   */
+
+  T &at(std::size_t pos) {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "mapped_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return _data()[pos];
+  }
+
+  const T &at(std::size_t pos) const {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "mapped_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return _data()[pos];
+  }
+
+  // writing through these on a read_only mapping faults, like any PROT_READ
+  // page would
+  T &operator[](std::size_t pos) { return _data()[pos]; }
+  const T &operator[](std::size_t pos) const { return _data()[pos]; }
+
+  T &front() { return (*this)[0]; }
+  const T &front() const { return (*this)[0]; }
+
+  T &back() { return (*this)[_size - 1]; }
+  const T &back() const { return (*this)[_size - 1]; }
+
+  T *data() { return _map ? _data() : nullptr; }
+  const T *data() const { return _map ? _data() : nullptr; }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return iterator(data()); }
+  iterator end() { return iterator(data() + _size); }
+
+  const_iterator cbegin() const noexcept { return const_iterator(data()); }
+  const_iterator cend() const noexcept {
+    return const_iterator(data() + _size);
+  }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+
+  std::size_t size() const { return _size; }
+
+  std::size_t capacity() const { return _capacity; }
+
+  // grows the file and remaps it, pointers and iterators are invalidated.
+  // The new mapping is made before the old one goes, so on failure the
+  // vector is left as it was
+  void reserve(std::size_t new_cap) {
+    _require_writable("reserve");
+    if (new_cap <= _capacity)
+      return;
+
+    std::size_t bytes = _bytes_for(new_cap);
+    if (::ftruncate(_fd, static_cast<off_t>(bytes)) != 0)
+      _throw_errno("ftruncate");
+    void *map;
+    try {
+      map = _mmap(bytes);
+    } catch (...) {
+      // best effort, the extra length is harmless if this fails too
+      [[maybe_unused]] int rc =
+          ::ftruncate(_fd, static_cast<off_t>(_map_bytes));
+      throw;
+    }
+    _unmap();
+    _map = map;
+    _map_bytes = bytes;
+
+    _capacity = new_cap;
+    _header()->capacity = new_cap;
+  }
+
+  // hint the kernel to start reading the whole payload in
+  void prefetch() const {
+    if (_map != nullptr)
+      ::madvise(_map, _map_bytes, MADV_WILLNEED);
+  }
+
+  /*
+   * Modifiers - read_write only
+   */
+
+  void push_back(const T &value) {
+    _require_writable("push_back");
+    if (_size == _capacity) {
+      // value may live in the mapping reserve() is about to drop
+      T copy = value;
+      reserve(std::max<std::size_t>(_capacity * 2, 16));
+      _data()[_size] = copy;
+    } else {
+      _data()[_size] = value;
+    }
+    _size++;
+    _header()->size = _size;
+  }
+
+  void pop_back() {
+    _require_writable("pop_back");
+    if (_size == 0)
+      return;
+    --_size;
+    _header()->size = _size;
+  }
+
+  // new elements are value initialised
+  void resize(std::size_t count) {
+    _require_writable("resize");
+    reserve(count);
+    if (count > _size) {
+      std::fill(_data() + _size, _data() + count, T{});
+    }
+    _size = count;
+    _header()->size = _size;
+  }
+
+  void clear() {
+    _require_writable("clear");
+    _size = 0;
+    _header()->size = 0;
+  }
+
+  // refresh the header checksum and write everything back
+  void flush(FlushMode mode = FlushMode::sync) {
+    _require_writable("flush");
+    _header()->size = _size;
+    _header()->checksum = detail::checksum64(_data(), _size * sizeof(T));
+    int flags = mode == FlushMode::sync ? MS_SYNC : MS_ASYNC;
+    if (::msync(_map, _map_bytes, flags) != 0)
+      _throw_errno("msync");
+  }
+};
+} // namespace rwstd
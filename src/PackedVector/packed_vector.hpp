@@ -0,0 +1,582 @@
+#pragma once
+
+#include "Vector/vector.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+// 32 bytes of T, one AVX2 register (two SSE2 ones)
+template <typename T>
+using packed_lanes [[gnu::vector_size(32)]] = T;
+
+/*
+ * Unpacks one block of a BitPackedVector: lane l of the block is a run of
+ * Bits bit fields, read 32 bytes (every lane) at a time. With Bits fixed the
+ * loop unrolls into straight vector shifts, ors and ands.
+ */
+template <typename T, unsigned Bits>
+void packed_unpack(const T *in, T *out) {
+  using lanes = packed_lanes<T>;
+  constexpr unsigned width = std::numeric_limits<T>::digits;
+  constexpr unsigned lane_count = 32 / sizeof(T);
+  constexpr T mask = Bits == width ? ~T{0} : T((T{1} << Bits) - 1);
+#pragma GCC unroll 64
+  for (unsigned k = 0; k < width; ++k) {
+    const unsigned bit = k * Bits;
+    const unsigned word = bit / width;
+    const unsigned shift = bit % width;
+    lanes low;
+    std::memcpy(&low, in + word * lane_count, sizeof(lanes));
+    lanes value = low >> shift;
+    if (shift + Bits > width) {
+      lanes high;
+      std::memcpy(&high, in + (word + 1) * lane_count, sizeof(lanes));
+      value |= high << (width - shift);
+    }
+    value &= mask;
+    std::memcpy(out + k * lane_count, &value, sizeof(lanes));
+  }
+}
+
+template <typename T, std::size_t... Bits>
+constexpr auto packed_kernels(std::index_sequence<Bits...>) {
+  return std::array<void (*)(const T *, T *), sizeof...(Bits)>{
+      &packed_unpack<T, static_cast<unsigned>(Bits + 1)>...};
+}
+
+// w (at most 64) bits at a bit offset, p needs 9 readable bytes from there
+inline std::uint64_t read_bits(const std::uint8_t *p, std::size_t bit,
+                               unsigned w) {
+  static_assert(std::endian::native == std::endian::little);
+  std::uint64_t word;
+  std::memcpy(&word, p + (bit >> 3), sizeof(word));
+  unsigned shift = static_cast<unsigned>(bit & 7);
+  std::uint64_t value = word >> shift;
+  if (shift + w > 64)
+    value |= std::uint64_t{p[(bit >> 3) + 8]} << (64 - shift);
+  return w == 64 ? value : value & ((std::uint64_t{1} << w) - 1);
+}
+
+// ors w bits of value in at a bit offset of zeroed bytes
+inline void write_bits(std::uint8_t *p, std::size_t bit, unsigned w,
+                       std::uint64_t value) {
+  while (w > 0) {
+    unsigned shift = static_cast<unsigned>(bit & 7);
+    unsigned take = std::min(8 - shift, w);
+    p[bit >> 3] |= static_cast<std::uint8_t>(
+        (value & ((1u << take) - 1)) << shift);
+    value >>= take;
+    bit += take;
+    w -= take;
+  }
+}
+
+inline std::uint64_t zigzag(std::uint64_t delta) {
+  return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+inline std::uint64_t unzigzag(std::uint64_t z) {
+  return (z >> 1) ^ (0 - (z & 1));
+}
+
+inline unsigned varint_size(std::uint64_t value) {
+  return static_cast<unsigned>(std::bit_width(value | 1) + 6) / 7;
+}
+
+inline std::uint64_t read_varint(const std::uint8_t *p, std::size_t &pos) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    std::uint8_t byte = p[pos++];
+    value |= std::uint64_t{byte & 0x7fu} << shift;
+    if (byte < 0x80)
+      return value;
+  }
+}
+
+} // namespace detail
+
+/*
+ * Vector of unsigned integers stored in a fixed number of bits each, for
+ * columns whose values are far smaller than their type. Elements live in
+ * blocks of 256: a block is split into 32 byte wide rows of lanes and lane l
+ * holds elements l, l + lanes, l + 2 * lanes, ... back to back, so unpack()
+ * decodes a whole block with one vector shift and mask per 32 bytes of
+ * output. operator[] reads at most two words.
+ *
+ * Elements are values, not references: set() replaces one. A value wider
+ * than bits() throws std::out_of_range.
+ */
+template <std::unsigned_integral T = std::uint32_t>
+class BitPackedVector {
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                "BitPackedVector: T must be a 32 or 64 bit integer");
+
+  static constexpr unsigned _width = std::numeric_limits<T>::digits;
+  static constexpr std::size_t _lanes = 32 / sizeof(T);
+  static constexpr std::size_t _block = _lanes * _width;
+  static constexpr auto _kernels = detail::packed_kernels<T>(
+      std::make_index_sequence<_width>{});
+
+  rwstd::Vector<T> _words;
+  std::size_t _size = 0;
+  unsigned _bits;
+  T _mask;
+
+  struct Position {
+    std::size_t word;
+    unsigned shift;
+  };
+
+  Position _position(std::size_t pos) const {
+    std::size_t in_block = pos % _block;
+    std::size_t bit = (in_block / _lanes) * _bits;
+    return {(pos / _block) * _bits * _lanes + (bit / _width) * _lanes +
+                in_block % _lanes,
+            static_cast<unsigned>(bit % _width)};
+  }
+
+  T _get(std::size_t pos) const {
+    auto [word, shift] = _position(pos);
+    T value = _words[word] >> shift;
+    if (shift + _bits > _width)
+      value |= _words[word + _lanes] << (_width - shift);
+    return value & _mask;
+  }
+
+  void _put(std::size_t pos, T value) {
+    auto [word, shift] = _position(pos);
+    _words[word] = (_words[word] & ~T(_mask << shift)) | T(value << shift);
+    if (shift + _bits > _width) {
+      unsigned spilled = _width - shift;
+      _words[word + _lanes] =
+          (_words[word + _lanes] & ~T(_mask >> spilled)) | T(value >> spilled);
+    }
+  }
+
+  template <typename It>
+  static unsigned _bits_for(It first, It last) {
+    T max = first == last ? T{0} : T(*std::max_element(first, last));
+    return std::max(1u, static_cast<unsigned>(std::bit_width(max)));
+  }
+
+  void _check(T value) const {
+    if (value > _mask)
+      throw std::out_of_range(std::format(
+          "BitPackedVector: {} does not fit in {} bits", value, _bits));
+  }
+
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+
+  class const_iterator {
+    const BitPackedVector *_vec = nullptr;
+    std::size_t _pos = 0;
+
+  public:
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::forward_iterator_tag iterator_category;
+
+    const_iterator() = default;
+    const_iterator(const BitPackedVector *vec, std::size_t pos)
+        : _vec{vec}, _pos{pos} {}
+
+    T operator*() const { return _vec->_get(_pos); }
+
+    const_iterator &operator++() {
+      ++_pos;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++_pos;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return _pos == other._pos;
+    }
+  };
+
+  typedef const_iterator iterator;
+
+  // bits in [1, digits of T]
+  explicit BitPackedVector(unsigned bits) : _bits{bits} {
+    if (bits == 0 || bits > _width)
+      throw std::invalid_argument(std::format(
+          "BitPackedVector: bits must be in [1, {}], got {}", _width, bits));
+    _mask = bits == _width ? ~T{0} : T((T{1} << bits) - 1);
+  }
+
+  // packs a range at the narrowest width that holds its largest value
+  template <std::forward_iterator It>
+  BitPackedVector(It first, It last)
+      : BitPackedVector(_bits_for(first, last)) {
+    for (; first != last; ++first)
+      push_back(static_cast<T>(*first));
+  }
+
+  /*
+   * Element access
+   */
+
+  T operator[](std::size_t pos) const { return _get(pos); }
+
+  T at(std::size_t pos) const {
+    if (pos >= _size)
+      throw std::out_of_range(std::format(
+          "BitPackedVector::at pos: {} >= size(): {}", pos, _size));
+    return _get(pos);
+  }
+
+  void set(std::size_t pos, T value) {
+    _check(value);
+    _put(pos, value);
+  }
+
+  // decodes [first, first + count) into out, whole blocks at a time
+  void unpack(std::size_t first, std::size_t count, T *out) const {
+    std::size_t last = first + count;
+    for (; first < last && first % _block != 0; ++first)
+      *out++ = _get(first);
+    auto kernel = _kernels[_bits - 1];
+    const T *words = _words.data();
+    for (; first + _block <= last; first += _block, out += _block)
+      kernel(words + (first / _block) * _bits * _lanes, out);
+    for (; first < last; ++first)
+      *out++ = _get(first);
+  }
+
+  /*
+   * Iterators
+   */
+
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, _size}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+  std::size_t size() const { return _size; }
+  unsigned bits() const { return _bits; }
+  T max_value() const { return _mask; }
+
+  void reserve(std::size_t n) {
+    _words.reserve((n + _block - 1) / _block * _bits * _lanes);
+  }
+
+  void shrink_to_fit() { _words.shrink_to_fit(); }
+
+  std::size_t memory_usage() const { return _words.capacity() * sizeof(T); }
+
+  /*
+   * Modifiers
+   */
+
+  void push_back(T value) {
+    _check(value);
+    // a new block starts zeroed; its tail stays unused until filled
+    if (_size % _block == 0)
+      _words.insert(_words.cend(), _bits * _lanes, T{0});
+    _put(_size++, value);
+  }
+
+  void clear() {
+    _words.clear();
+    _size = 0;
+  }
+};
+
+/*
+ * Compressed vector of integers for sorted ids, timestamps and other runs
+ * of close values. Elements go into blocks of 128 that store the first value
+ * and then the deltas between neighbours, in whichever of two encodings is
+ * smaller for that block:
+ *
+ *  - frame of reference: the smallest delta once, then every delta minus it
+ *    in a fixed number of bits (zero bits for evenly spaced ids);
+ *  - varint: each delta zigzagged and written in 7 bit groups, for blocks
+ *    with a few outliers that would widen every frame of reference field.
+ *
+ * A skip index of block headers (first value, encoding, payload offset)
+ * bounds operator[] at one block's decode; iteration and unpack() decode
+ * sequentially. The last partial block is kept uncompressed until it fills.
+ * Deltas wrap like unsigned arithmetic, so unsorted input round trips too,
+ * just less compactly.
+ */
+template <std::unsigned_integral T = std::uint64_t>
+class DeltaVector {
+  static_assert(sizeof(T) <= 8, "DeltaVector: T must fit in 64 bits");
+
+  static constexpr std::size_t _block = 128;
+  static constexpr std::uint8_t _varint = 0xff;
+  // read_bits loads 9 bytes from any payload bit
+  static constexpr std::size_t _padding = 9;
+
+  struct Block {
+    std::uint64_t first;
+    std::uint64_t reference;
+    std::size_t offset;
+    std::uint8_t width;
+  };
+
+  rwstd::Vector<Block> _blocks;
+  rwstd::Vector<std::uint8_t> _bytes;
+  std::size_t _payload = 0;
+  std::array<T, _block> _tail;
+  std::size_t _tail_size = 0;
+
+  std::size_t _sealed() const { return _blocks.size() * _block; }
+
+  // compresses the full tail into a block
+  void _seal() {
+    std::uint64_t deltas[_block - 1];
+    std::size_t varint_bytes = 0;
+    // signed minimum and maximum, compared with the sign bit flipped
+    constexpr std::uint64_t sign = std::uint64_t{1} << 63;
+    std::uint64_t min = ~std::uint64_t{0}, max = 0;
+    for (std::size_t k = 0; k + 1 < _block; ++k) {
+      deltas[k] = std::uint64_t{_tail[k + 1]} - std::uint64_t{_tail[k]};
+      varint_bytes += detail::varint_size(detail::zigzag(deltas[k]));
+      std::uint64_t biased = deltas[k] ^ sign;
+      min = std::min(min, biased);
+      max = std::max(max, biased);
+    }
+    auto width = static_cast<std::uint8_t>(std::bit_width(max - min));
+    std::size_t packed_bytes = ((_block - 1) * width + 7) / 8;
+
+    Block block{_tail[0], min ^ sign, _payload, width};
+    std::size_t bytes = packed_bytes;
+    if (varint_bytes < packed_bytes) {
+      block.width = _varint;
+      bytes = varint_bytes;
+    }
+    _bytes.insert(_bytes.cend(), bytes, std::uint8_t{0});
+    std::uint8_t *out = _bytes.data() + _payload;
+    for (std::size_t k = 0; k + 1 < _block; ++k) {
+      if (block.width == _varint) {
+        std::uint64_t z = detail::zigzag(deltas[k]);
+        for (; z >= 0x80; z >>= 7)
+          *out++ = static_cast<std::uint8_t>(z | 0x80);
+        *out++ = static_cast<std::uint8_t>(z);
+      } else {
+        detail::write_bits(out, k * width, width,
+                           deltas[k] - block.reference);
+      }
+    }
+    _payload += bytes;
+    _blocks.push_back(block);
+    _tail_size = 0;
+  }
+
+  // the delta at cursor, advancing it; a bit offset for frame of reference
+  // blocks, a byte offset into the payload for varint ones
+  std::uint64_t _next(const Block &block, std::size_t &cursor) const {
+    const std::uint8_t *bytes = _bytes.data();
+    if (block.width == _varint)
+      return detail::unzigzag(detail::read_varint(bytes, cursor));
+    std::uint64_t packed =
+        detail::read_bits(bytes + block.offset, cursor, block.width);
+    cursor += block.width;
+    return block.reference + packed;
+  }
+
+  std::size_t _cursor(const Block &block) const {
+    return block.width == _varint ? block.offset : 0;
+  }
+
+  // the first count values of a block, one loop per encoding
+  void _decode(const Block &block, std::size_t count, T *out) const {
+    std::uint64_t value = block.first;
+    out[0] = static_cast<T>(value);
+    const std::uint8_t *bytes = _bytes.data();
+    if (block.width == _varint) {
+      std::size_t cursor = block.offset;
+      for (std::size_t k = 1; k < count; ++k) {
+        value += detail::unzigzag(detail::read_varint(bytes, cursor));
+        out[k] = static_cast<T>(value);
+      }
+    } else {
+      const std::uint8_t *payload = bytes + block.offset;
+      for (std::size_t k = 1; k < count; ++k) {
+        value += block.reference +
+                 detail::read_bits(payload, (k - 1) * block.width, block.width);
+        out[k] = static_cast<T>(value);
+      }
+    }
+  }
+
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+
+  class const_iterator {
+    const DeltaVector *_vec = nullptr;
+    std::size_t _pos = 0;
+    std::size_t _cursor = 0;
+    std::uint64_t _value = 0;
+
+    void _load() {
+      if (_pos >= _vec->_sealed()) {
+        if (_pos < _vec->size())
+          _value = _vec->_tail[_pos - _vec->_sealed()];
+      } else if (_pos % _block == 0) {
+        const Block &block = _vec->_blocks[_pos / _block];
+        _value = block.first;
+        _cursor = _vec->_cursor(block);
+      } else {
+        _value += _vec->_next(_vec->_blocks[_pos / _block], _cursor);
+      }
+    }
+
+  public:
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::forward_iterator_tag iterator_category;
+
+    const_iterator() = default;
+    const_iterator(const DeltaVector *vec, std::size_t pos)
+        : _vec{vec}, _pos{pos} {
+      if (_pos == 0)
+        _load();
+    }
+
+    T operator*() const { return static_cast<T>(_value); }
+
+    const_iterator &operator++() {
+      ++_pos;
+      _load();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return _pos == other._pos;
+    }
+  };
+
+  typedef const_iterator iterator;
+
+  DeltaVector() { _bytes.insert(_bytes.cend(), _padding, std::uint8_t{0}); }
+
+  template <std::input_iterator It>
+  DeltaVector(It first, It last) : DeltaVector() {
+    for (; first != last; ++first)
+      push_back(static_cast<T>(*first));
+  }
+
+  /*
+   * Element access
+   */
+
+  // decodes up to pos within its block
+  T operator[](std::size_t pos) const {
+    if (pos >= _sealed())
+      return _tail[pos - _sealed()];
+    const Block &block = _blocks[pos / _block];
+    std::uint64_t value = block.first;
+    std::size_t cursor = _cursor(block);
+    for (std::size_t k = pos % _block; k > 0; --k)
+      value += _next(block, cursor);
+    return static_cast<T>(value);
+  }
+
+  T at(std::size_t pos) const {
+    if (pos >= size())
+      throw std::out_of_range(std::format(
+          "DeltaVector::at pos: {} >= size(): {}", pos, size()));
+    return (*this)[pos];
+  }
+
+  // decodes [first, first + count) into out, a block at a time
+  void unpack(std::size_t first, std::size_t count, T *out) const {
+    std::size_t last = first + count;
+    T buffer[_block];
+    while (first < last && first < _sealed()) {
+      std::size_t start = first % _block;
+      std::size_t take = std::min(_block - start, last - first);
+      const Block &block = _blocks[first / _block];
+      if (start == 0 && take == _block) {
+        _decode(block, _block, out);
+      } else {
+        _decode(block, start + take, buffer);
+        std::copy_n(buffer + start, take, out);
+      }
+      first += take;
+      out += take;
+    }
+    if (first < last)
+      std::copy_n(_tail.data() + (first - _sealed()), last - first, out);
+  }
+
+  /*
+   * Iterators
+   */
+
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return size() == 0; }
+  std::size_t size() const { return _sealed() + _tail_size; }
+  std::size_t block_count() const { return _blocks.size(); }
+
+  void shrink_to_fit() {
+    _blocks.shrink_to_fit();
+    _bytes.shrink_to_fit();
+  }
+
+  std::size_t memory_usage() const {
+    return _bytes.capacity() + _blocks.capacity() * sizeof(Block) +
+           sizeof(_tail);
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void push_back(T value) {
+    _tail[_tail_size++] = value;
+    if (_tail_size == _block)
+      _seal();
+  }
+
+  void clear() {
+    _blocks.clear();
+    _bytes.clear();
+    _bytes.insert(_bytes.cend(), _padding, std::uint8_t{0});
+    _payload = 0;
+    _tail_size = 0;
+  }
+};
+
+} // namespace rwstd
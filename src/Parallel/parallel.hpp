@@ -0,0 +1,388 @@
+#pragma once
+
+#include "ThreadPool/thread_pool.hpp"
+#include "Vector/vector.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace rwstd {
+namespace parallel {
+
+/*
+ * Tuning knobs shared by every algorithm.
+ *
+ * grain_size is the number of elements a single task works on. Leaving it at 0
+ * picks roughly 8 tasks per thread, but never fewer than min_grain_size
+ * elements per task so cheap loops don't drown in scheduling overhead. Raise
+ * min_grain_size for trivial bodies, lower grain_size for expensive ones.
+ */
+struct Config {
+  ThreadPool *pool = nullptr; // nullptr uses ThreadPool::default_pool()
+  std::size_t grain_size = 0;
+  std::size_t min_grain_size = 2048;
+};
+
+namespace detail {
+
+template <typename It>
+concept random_access =
+    std::derived_from<typename std::iterator_traits<It>::iterator_category,
+                      std::random_access_iterator_tag>;
+
+template <typename It>
+It nth(It it, std::size_t n) {
+  return it + static_cast<typename std::iterator_traits<It>::difference_type>(n);
+}
+
+template <typename It>
+std::size_t distance(It first, It last) {
+  return static_cast<std::size_t>(last - first);
+}
+
+inline ThreadPool &pool_of(const Config &config) {
+  return config.pool ? *config.pool : ThreadPool::default_pool();
+}
+
+inline std::size_t grain_for(std::size_t n, ThreadPool &pool,
+                             const Config &config) {
+  if (config.grain_size != 0)
+    return config.grain_size;
+  std::size_t tasks = (pool.size() + 1) * 8;
+  return std::max(std::max(config.min_grain_size, std::size_t{1}),
+                  (n + tasks - 1) / tasks);
+}
+
+// lazy binary splitting: keep the left half, hand the right half to the pool.
+// Thieves take the biggest pieces from the top of our deque.
+template <typename F>
+void split_range(TaskGroup &group, std::size_t lo, std::size_t hi,
+                 std::size_t grain, F &f) {
+  while (hi - lo > grain) {
+    std::size_t mid = lo + (hi - lo) / 2;
+    group.run([&group, &f, mid, hi, grain] {
+      split_range(group, mid, hi, grain, f);
+    });
+    hi = mid;
+  }
+  f(lo, hi);
+}
+
+// calls f(lo, hi) over disjoint pieces of [0, n) no bigger than grain
+template <typename F>
+void for_ranges(std::size_t n, std::size_t grain, ThreadPool &pool, F &&f) {
+  if (n == 0)
+    return;
+  if (n <= grain) {
+    f(std::size_t{0}, n);
+    return;
+  }
+  TaskGroup group(pool);
+  split_range(group, 0, n, grain, f);
+  group.wait();
+}
+
+// fold every grain sized chunk of [first, first + n) on its own, the chunks
+// stay in order so op only has to be associative
+template <typename RandomIt, typename T, typename BinaryOp>
+std::vector<std::optional<T>> chunk_sums(RandomIt first, std::size_t n,
+                                         std::size_t grain, ThreadPool &pool,
+                                         BinaryOp &op) {
+  std::size_t chunks = (n + grain - 1) / grain;
+  std::vector<std::optional<T>> sums(chunks);
+  for_ranges(chunks, 1, pool, [&](std::size_t c_lo, std::size_t c_hi) {
+    for (std::size_t c = c_lo; c < c_hi; ++c) {
+      std::size_t lo = c * grain;
+      std::size_t hi = std::min(n, lo + grain);
+      T acc = *nth(first, lo);
+      for (std::size_t i = lo + 1; i < hi; ++i) {
+        acc = op(std::move(acc), *nth(first, i));
+      }
+      sums[c] = std::move(acc);
+    }
+  });
+  return sums;
+}
+
+// number of elements of a that come before output position k when stably
+// merging a and b (merge path / co-rank search)
+template <typename It, typename Compare>
+std::size_t co_rank(std::size_t k, It a, std::size_t na, It b, std::size_t nb,
+                    Compare &comp) {
+  std::size_t lo = k > nb ? k - nb : 0;
+  std::size_t hi = std::min(k, na);
+  while (lo < hi) {
+    std::size_t i = lo + (hi - lo) / 2;
+    std::size_t j = k - i;
+    if (j > 0 && i < na && !comp(*nth(b, j - 1), *nth(a, i))) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// merges sorted runs of length width pairwise from src into dst. Each output
+// piece of grain elements is an independent task, so even the final merge of
+// two halves runs on every thread. All split points are found before anything
+// is moved, a moved-from element would confuse the other pieces' searches.
+template <typename SrcIt, typename DstIt, typename Compare>
+void merge_round(SrcIt src, DstIt dst, std::size_t n, std::size_t width,
+                 std::size_t grain, ThreadPool &pool, Compare &comp) {
+  struct Piece {
+    std::size_t pair_lo, mid, pair_hi;
+    std::size_t i0, i1; // elements of the left run before/at the piece end
+  };
+
+  std::size_t count = (n + grain - 1) / grain;
+  std::vector<Piece> pieces(count);
+  for_ranges(count, 1, pool, [&](std::size_t p_lo, std::size_t p_hi) {
+    for (std::size_t p = p_lo; p < p_hi; ++p) {
+      Piece &piece = pieces[p];
+      std::size_t out_lo = p * grain;
+      std::size_t out_hi = std::min(n, out_lo + grain);
+      // width is grain * 2^k so a piece never straddles two pairs
+      piece.pair_lo = out_lo / (2 * width) * (2 * width);
+      piece.mid = std::min(n, piece.pair_lo + width);
+      piece.pair_hi = std::min(n, piece.pair_lo + 2 * width);
+
+      SrcIt a = nth(src, piece.pair_lo);
+      SrcIt b = nth(src, piece.mid);
+      std::size_t na = piece.mid - piece.pair_lo;
+      std::size_t nb = piece.pair_hi - piece.mid;
+      piece.i0 = co_rank(out_lo - piece.pair_lo, a, na, b, nb, comp);
+      piece.i1 = co_rank(out_hi - piece.pair_lo, a, na, b, nb, comp);
+    }
+  });
+
+  for_ranges(count, 1, pool, [&](std::size_t p_lo, std::size_t p_hi) {
+    for (std::size_t p = p_lo; p < p_hi; ++p) {
+      const Piece &piece = pieces[p];
+      std::size_t out_lo = p * grain;
+      std::size_t out_hi = std::min(n, out_lo + grain);
+      std::size_t j0 = out_lo - piece.pair_lo - piece.i0;
+      std::size_t j1 = out_hi - piece.pair_lo - piece.i1;
+
+      SrcIt a = nth(src, piece.pair_lo);
+      SrcIt b = nth(src, piece.mid);
+      std::merge(std::make_move_iterator(nth(a, piece.i0)),
+                 std::make_move_iterator(nth(a, piece.i1)),
+                 std::make_move_iterator(nth(b, j0)),
+                 std::make_move_iterator(nth(b, j1)), nth(dst, out_lo), comp);
+    }
+  });
+}
+
+} // namespace detail
+
+/*
+ * for_each
+ */
+
+template <typename RandomIt, typename UnaryFunc>
+  requires detail::random_access<RandomIt>
+void for_each(RandomIt first, RandomIt last, UnaryFunc f,
+              const Config &config = {}) {
+  ThreadPool &pool = detail::pool_of(config);
+  std::size_t n = detail::distance(first, last);
+  detail::for_ranges(n, detail::grain_for(n, pool, config), pool,
+                     [&](std::size_t lo, std::size_t hi) {
+                       for (std::size_t i = lo; i < hi; ++i) {
+                         f(*detail::nth(first, i));
+                       }
+                     });
+}
+
+template <typename T, typename Allocator, typename UnaryFunc>
+void for_each(rwstd::Vector<T, Allocator> &v, UnaryFunc f,
+              const Config &config = {}) {
+  rwstd::parallel::for_each(v.begin(), v.end(), std::move(f), config);
+}
+
+/*
+ * transform
+ */
+
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+  requires detail::random_access<InputIt> && detail::random_access<OutputIt>
+OutputIt transform(InputIt first, InputIt last, OutputIt d_first, UnaryOp op,
+                   const Config &config = {}) {
+  ThreadPool &pool = detail::pool_of(config);
+  std::size_t n = detail::distance(first, last);
+  detail::for_ranges(n, detail::grain_for(n, pool, config), pool,
+                     [&](std::size_t lo, std::size_t hi) {
+                       for (std::size_t i = lo; i < hi; ++i) {
+                         *detail::nth(d_first, i) = op(*detail::nth(first, i));
+                       }
+                     });
+  return detail::nth(d_first, n);
+}
+
+// out has to be at least as big as in, it is not resized
+template <typename T, typename AllocatorIn, typename U, typename AllocatorOut,
+          typename UnaryOp>
+void transform(const rwstd::Vector<T, AllocatorIn> &in,
+               rwstd::Vector<U, AllocatorOut> &out, UnaryOp op,
+               const Config &config = {}) {
+  if (out.size() < in.size()) {
+    throw std::length_error("parallel::transform: output smaller than input");
+  }
+  rwstd::parallel::transform(in.cbegin(), in.cend(), out.begin(), std::move(op),
+                             config);
+}
+
+/*
+ * reduce - op has to be associative, it does not have to be commutative.
+ * With the default grain the grouping depends on the pool size, so results of
+ * non-exact operations (floating point) can differ between pools.
+ */
+
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+  requires detail::random_access<RandomIt>
+T reduce(RandomIt first, RandomIt last, T init, BinaryOp op = {},
+         const Config &config = {}) {
+  ThreadPool &pool = detail::pool_of(config);
+  std::size_t n = detail::distance(first, last);
+  if (n == 0)
+    return init;
+
+  auto sums = detail::chunk_sums<RandomIt, T>(
+      first, n, detail::grain_for(n, pool, config), pool, op);
+  T result = std::move(init);
+  for (auto &sum : sums) {
+    result = op(std::move(result), std::move(*sum));
+  }
+  return result;
+}
+
+template <typename T, typename Allocator, typename U,
+          typename BinaryOp = std::plus<>>
+U reduce(const rwstd::Vector<T, Allocator> &v, U init, BinaryOp op = {},
+         const Config &config = {}) {
+  return rwstd::parallel::reduce(v.cbegin(), v.cend(), std::move(init),
+                                 std::move(op), config);
+}
+
+/*
+ * inclusive_scan - three passes: per chunk sums, a serial scan over the chunk
+ * sums, then every chunk scans again seeded with its offset. d_first may be
+ * first.
+ */
+
+template <typename InputIt, typename OutputIt, typename BinaryOp = std::plus<>>
+  requires detail::random_access<InputIt> && detail::random_access<OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first,
+                        BinaryOp op = {}, const Config &config = {}) {
+  using T = typename std::iterator_traits<InputIt>::value_type;
+
+  ThreadPool &pool = detail::pool_of(config);
+  std::size_t n = detail::distance(first, last);
+  if (n == 0)
+    return d_first;
+  std::size_t grain = detail::grain_for(n, pool, config);
+
+  auto offsets = detail::chunk_sums<InputIt, T>(first, n, grain, pool, op);
+  // turn chunk sums into exclusive offsets, chunk 0 has none
+  std::optional<T> running;
+  for (auto &offset : offsets) {
+    std::optional<T> sum = std::move(offset);
+    offset = running;
+    running = running ? op(std::move(*running), std::move(*sum))
+                      : std::move(*sum);
+  }
+
+  detail::for_ranges(
+      offsets.size(), 1, pool, [&](std::size_t c_lo, std::size_t c_hi) {
+        for (std::size_t c = c_lo; c < c_hi; ++c) {
+          std::size_t lo = c * grain;
+          std::size_t hi = std::min(n, lo + grain);
+          T acc = offsets[c] ? op(*offsets[c], *detail::nth(first, lo))
+                             : T(*detail::nth(first, lo));
+          *detail::nth(d_first, lo) = acc;
+          for (std::size_t i = lo + 1; i < hi; ++i) {
+            acc = op(std::move(acc), *detail::nth(first, i));
+            *detail::nth(d_first, i) = acc;
+          }
+        }
+      });
+  return detail::nth(d_first, n);
+}
+
+// out has to be at least as big as in, it is not resized
+template <typename T, typename AllocatorIn, typename U, typename AllocatorOut,
+          typename BinaryOp = std::plus<>>
+void inclusive_scan(const rwstd::Vector<T, AllocatorIn> &in,
+                    rwstd::Vector<U, AllocatorOut> &out, BinaryOp op = {},
+                    const Config &config = {}) {
+  if (out.size() < in.size()) {
+    throw std::length_error(
+        "parallel::inclusive_scan: output smaller than input");
+  }
+  rwstd::parallel::inclusive_scan(in.cbegin(), in.cend(), out.begin(),
+                                  std::move(op), config);
+}
+
+/*
+ * sort - parallel merge sort. Runs of grain elements are sorted with std::sort,
+ * then merged pairwise, ping-ponging between the range and a scratch buffer.
+ * Every merge round is split by merge path so all threads stay busy until the
+ * end. Stable within a round but not overall (std::sort runs), needs a default
+ * constructible value type for the scratch buffer.
+ */
+
+template <typename RandomIt, typename Compare = std::less<>>
+  requires detail::random_access<RandomIt>
+void sort(RandomIt first, RandomIt last, Compare comp = {},
+          const Config &config = {}) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  ThreadPool &pool = detail::pool_of(config);
+  std::size_t n = detail::distance(first, last);
+  std::size_t grain = detail::grain_for(n, pool, config);
+  if (n <= grain) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  std::size_t runs = (n + grain - 1) / grain;
+  detail::for_ranges(runs, 1, pool, [&](std::size_t r_lo, std::size_t r_hi) {
+    for (std::size_t r = r_lo; r < r_hi; ++r) {
+      std::size_t lo = r * grain;
+      std::size_t hi = std::min(n, lo + grain);
+      std::sort(detail::nth(first, lo), detail::nth(first, hi), comp);
+    }
+  });
+
+  auto buffer = std::make_unique_for_overwrite<T[]>(n);
+  bool in_buffer = false;
+  for (std::size_t width = grain; width < n; width *= 2) {
+    if (in_buffer) {
+      detail::merge_round(buffer.get(), first, n, width, grain, pool, comp);
+    } else {
+      detail::merge_round(first, buffer.get(), n, width, grain, pool, comp);
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    detail::for_ranges(n, grain, pool, [&](std::size_t lo, std::size_t hi) {
+      std::move(buffer.get() + lo, buffer.get() + hi, detail::nth(first, lo));
+    });
+  }
+}
+
+template <typename T, typename Allocator, typename Compare = std::less<>>
+void sort(rwstd::Vector<T, Allocator> &v, Compare comp = {},
+          const Config &config = {}) {
+  rwstd::parallel::sort(v.begin(), v.end(), std::move(comp), config);
+}
+
+} // namespace parallel
+} // namespace rwstd
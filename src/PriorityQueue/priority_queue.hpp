@@ -0,0 +1,401 @@
+#pragma once
+
+#include "Vector/vector.hpp"
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+/*
+ * d-ary heap steps over a raw array. The element being placed is held
+ * aside while a hole moves through the array, and place(i, value) writes an
+ * element into its final slot so IndexedPriorityQueue can track positions.
+ */
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+void heap_sift_up(T *data, std::size_t hole, T value, Compare &comp,
+                  Place place) {
+  while (hole > 0) {
+    std::size_t parent = (hole - 1) / Arity;
+    if (!comp(data[parent], value))
+      break;
+    place(hole, std::move(data[parent]));
+    hole = parent;
+  }
+  place(hole, std::move(value));
+}
+
+// heaps up to this size are assumed to stay in cache between operations
+inline constexpr std::size_t heap_cached_bytes = 1024 * 1024;
+
+// index of the child that belongs highest among first's siblings. Which
+// sibling wins is a coin flip for the branch predictor, so with Select a
+// full node is unrolled and picks the index with a mask. That wins while
+// the heap stays cached; in a bigger one the loads miss, and a predicted
+// branch lets the CPU start loading the next levels before this one's
+// comparisons resolve, which is worth far more than the mispredictions
+template <std::size_t Arity, bool Select, typename T, typename Compare>
+std::size_t heap_best_child(const T *data, std::size_t first, std::size_t size,
+                            Compare &comp) {
+  std::size_t best = first;
+  if (Select && first + Arity <= size) {
+#pragma GCC unroll 16
+    for (std::size_t child = first + 1; child < first + Arity; ++child) {
+      std::size_t take = std::size_t{0} - comp(data[best], data[child]);
+      best ^= (best ^ child) & take;
+    }
+    return best;
+  }
+  std::size_t last = first + Arity < size ? first + Arity : size;
+  for (std::size_t child = first + 1; child < last; ++child) {
+    if (comp(data[best], data[child]))
+      best = child;
+  }
+  return best;
+}
+
+template <std::size_t Arity, bool Select, typename T, typename Compare,
+          typename Place>
+void heap_sift_down_with(T *data, std::size_t size, std::size_t hole, T value,
+                         Compare &comp, Place place) {
+  while (Arity * hole + 1 < size) {
+    std::size_t best =
+        heap_best_child<Arity, Select>(data, Arity * hole + 1, size, comp);
+    if (!comp(value, data[best]))
+      break;
+    place(hole, std::move(data[best]));
+    hole = best;
+  }
+  place(hole, std::move(value));
+}
+
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+void heap_sift_down(T *data, std::size_t size, std::size_t hole, T value,
+                    Compare &comp, Place place) {
+  if (size <= heap_cached_bytes / sizeof(T))
+    heap_sift_down_with<Arity, true>(data, size, hole, std::move(value), comp,
+                                     place);
+  else
+    heap_sift_down_with<Arity, false>(data, size, hole, std::move(value),
+                                      comp, place);
+}
+
+// refills the root after a pop: the hole walks down to a leaf without
+// comparing against value (the old last element, which nearly always
+// belongs low), then value sifts up from there
+template <std::size_t Arity, bool Select, typename T, typename Compare,
+          typename Place>
+void heap_refill_root_with(T *data, std::size_t size, T value, Compare &comp,
+                           Place place) {
+  std::size_t hole = 0;
+  while (Arity * hole + 1 < size) {
+    std::size_t best =
+        heap_best_child<Arity, Select>(data, Arity * hole + 1, size, comp);
+    place(hole, std::move(data[best]));
+    hole = best;
+  }
+  heap_sift_up<Arity>(data, hole, std::move(value), comp, place);
+}
+
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+void heap_refill_root(T *data, std::size_t size, T value, Compare &comp,
+                      Place place) {
+  if (size <= heap_cached_bytes / sizeof(T))
+    heap_refill_root_with<Arity, true>(data, size, std::move(value), comp,
+                                       place);
+  else
+    heap_refill_root_with<Arity, false>(data, size, std::move(value), comp,
+                                        place);
+}
+
+} // namespace detail
+
+/*
+ * Priority queue over a d-ary heap in a Vector. Like std::priority_queue,
+ * top() is the element no other compares above (the largest with the
+ * default std::less). A wider node trades more comparisons per level for
+ * a shallower tree whose children share a cache line: with Arity 4 or 8
+ * and 8 byte elements a node's children are 32 or 64 contiguous bytes, and
+ * a 10M element heap is 12 or 8 levels deep instead of 24.
+ *
+ * The range constructor and push_range build with Floyd's bottom-up
+ * heapify, linear in the number of elements. top() and pop() on an empty
+ * queue are undefined, as with std::priority_queue.
+ */
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class PriorityQueue {
+  static_assert(Arity >= 2, "PriorityQueue: Arity must be at least 2");
+
+public:
+  typedef T value_type;
+  typedef Compare value_compare;
+  typedef std::size_t size_type;
+  static constexpr std::size_t arity = Arity;
+
+private:
+  rwstd::Vector<T> _data;
+  Compare _comp;
+
+  auto _place() {
+    return [data = _data.data()](std::size_t i, T &&value) {
+      data[i] = std::move(value);
+    };
+  }
+
+  void _heapify() {
+    std::size_t n = _data.size();
+    if (n < 2)
+      return;
+    for (std::size_t i = (n - 2) / Arity + 1; i-- > 0;) {
+      T value = std::move(_data[i]);
+      detail::heap_sift_down<Arity>(_data.data(), n, i, std::move(value),
+                                    _comp, _place());
+    }
+  }
+
+public:
+  PriorityQueue() = default;
+
+  explicit PriorityQueue(const Compare &comp) : _comp{comp} {}
+
+  template <std::input_iterator It>
+  PriorityQueue(It first, It last, const Compare &comp = Compare())
+      : _comp{comp} {
+    if constexpr (std::forward_iterator<It>)
+      _data.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    for (; first != last; ++first)
+      _data.push_back(*first);
+    _heapify();
+  }
+
+  /*
+   * Element access
+   */
+
+  const T &top() const { return _data[0]; }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _data.empty(); }
+  std::size_t size() const { return _data.size(); }
+  void reserve(std::size_t n) { _data.reserve(n); }
+
+  /*
+   * Modifiers
+   */
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args &&...args) {
+    _data.emplace_back(std::forward<Args>(args)...);
+    T value = std::move(_data.back());
+    detail::heap_sift_up<Arity>(_data.data(), _data.size() - 1,
+                                std::move(value), _comp, _place());
+  }
+
+  // appends a batch, re-heapifying everything when the batch is at least
+  // as big as the queue and sifting each new element up otherwise
+  template <std::input_iterator It>
+  void push_range(It first, It last) {
+    std::size_t old = _data.size();
+    for (; first != last; ++first)
+      _data.push_back(*first);
+    if (_data.size() - old >= old) {
+      _heapify();
+      return;
+    }
+    for (std::size_t i = old; i < _data.size(); ++i) {
+      T value = std::move(_data[i]);
+      detail::heap_sift_up<Arity>(_data.data(), i, std::move(value), _comp,
+                                  _place());
+    }
+  }
+
+  void pop() {
+    T last = std::move(_data.back());
+    _data.pop_back();
+    if (!_data.empty())
+      detail::heap_refill_root<Arity>(_data.data(), _data.size(),
+                                      std::move(last), _comp, _place());
+  }
+
+  void clear() { _data.clear(); }
+};
+
+/*
+ * PriorityQueue whose elements can be found again: push() returns a handle
+ * that names the element until it leaves the queue, and update(),
+ * decrease_key() and erase() take one. A position table indexed by handle
+ * follows every move inside the heap, so each of them is one sift.
+ *
+ * decrease_key() only moves an element toward the top, the classic
+ * Dijkstra / scheduler operation (a smaller key under std::greater); it
+ * throws std::invalid_argument for a value that would move it down, use
+ * update() for either direction. Handles of elements that left are reused;
+ * operations on a handle not in the queue throw std::out_of_range.
+ */
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class IndexedPriorityQueue {
+  static_assert(Arity >= 2, "IndexedPriorityQueue: Arity must be at least 2");
+
+public:
+  typedef T value_type;
+  typedef Compare value_compare;
+  typedef std::size_t size_type;
+  typedef std::size_t handle_type;
+  static constexpr std::size_t arity = Arity;
+
+private:
+  static constexpr std::size_t _absent = ~std::size_t{0};
+
+  struct Entry {
+    T value;
+    handle_type handle;
+  };
+
+  struct EntryCompare {
+    Compare comp;
+
+    bool operator()(const Entry &a, const Entry &b) const {
+      return comp(a.value, b.value);
+    }
+  };
+
+  rwstd::Vector<Entry> _heap;
+  // heap index of every handle, _absent once its element left
+  rwstd::Vector<std::size_t> _position;
+  rwstd::Vector<handle_type> _free;
+  EntryCompare _comp;
+
+  auto _place() {
+    return [this](std::size_t i, Entry &&entry) {
+      _position[entry.handle] = i;
+      _heap[i] = std::move(entry);
+    };
+  }
+
+  std::size_t _index_of(handle_type handle) const {
+    if (!contains(handle))
+      throw std::out_of_range(std::format(
+          "IndexedPriorityQueue: handle {} is not in the queue", handle));
+    return _position[handle];
+  }
+
+  // puts entry at index i, wherever it belongs from there
+  void _reseat(std::size_t i, Entry entry) {
+    if (i > 0 && _comp(_heap[(i - 1) / Arity], entry))
+      detail::heap_sift_up<Arity>(_heap.data(), i, std::move(entry), _comp,
+                                  _place());
+    else
+      detail::heap_sift_down<Arity>(_heap.data(), _heap.size(), i,
+                                    std::move(entry), _comp, _place());
+  }
+
+  void _release(handle_type handle) {
+    _position[handle] = _absent;
+    _free.push_back(handle);
+  }
+
+public:
+  IndexedPriorityQueue() = default;
+
+  explicit IndexedPriorityQueue(const Compare &comp) : _comp{comp} {}
+
+  /*
+   * Element access
+   */
+
+  const T &top() const { return _heap[0].value; }
+  handle_type top_handle() const { return _heap[0].handle; }
+
+  bool contains(handle_type handle) const {
+    return handle < _position.size() && _position[handle] != _absent;
+  }
+
+  const T &value(handle_type handle) const {
+    return _heap[_index_of(handle)].value;
+  }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _heap.empty(); }
+  std::size_t size() const { return _heap.size(); }
+
+  void reserve(std::size_t n) {
+    _heap.reserve(n);
+    _position.reserve(n);
+  }
+
+  /*
+   * Modifiers
+   */
+
+  handle_type push(T value) {
+    handle_type handle;
+    if (_free.empty()) {
+      handle = _position.size();
+      _position.push_back(_absent);
+    } else {
+      handle = _free.back();
+      _free.pop_back();
+    }
+    _heap.push_back(Entry{std::move(value), handle});
+    Entry entry = std::move(_heap.back());
+    detail::heap_sift_up<Arity>(_heap.data(), _heap.size() - 1,
+                                std::move(entry), _comp, _place());
+    return handle;
+  }
+
+  void pop() {
+    _release(_heap[0].handle);
+    Entry last = std::move(_heap.back());
+    _heap.pop_back();
+    if (!_heap.empty())
+      detail::heap_refill_root<Arity>(_heap.data(), _heap.size(),
+                                      std::move(last), _comp, _place());
+  }
+
+  // moves the element toward the top, throws if value belongs lower
+  void decrease_key(handle_type handle, T value) {
+    std::size_t i = _index_of(handle);
+    if (_comp.comp(value, _heap[i].value))
+      throw std::invalid_argument(
+          "IndexedPriorityQueue::decrease_key: value moves away from the top");
+    detail::heap_sift_up<Arity>(_heap.data(), i,
+                                Entry{std::move(value), handle}, _comp,
+                                _place());
+  }
+
+  void update(handle_type handle, T value) {
+    std::size_t i = _index_of(handle);
+    _reseat(i, Entry{std::move(value), handle});
+  }
+
+  void erase(handle_type handle) {
+    std::size_t i = _index_of(handle);
+    _release(handle);
+    Entry last = std::move(_heap.back());
+    _heap.pop_back();
+    if (i < _heap.size())
+      _reseat(i, std::move(last));
+  }
+
+  void clear() {
+    _heap.clear();
+    _position.clear();
+    _free.clear();
+  }
+};
+
+} // namespace rwstd
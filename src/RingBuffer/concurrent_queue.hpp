@@ -0,0 +1,361 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+// spin a little on a full or empty queue, then give the core away
+struct QueueBackoff {
+  unsigned spins = 0;
+
+  void pause() {
+    if (spins < 64) {
+      ++spins;
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    } else {
+      std::this_thread::yield();
+    }
+  }
+};
+
+} // namespace detail
+
+/*
+ * Bounded wait-free queue between exactly one producer and one consumer
+ * thread. The ring's head (consumer) and tail (producer) sit on their own
+ * cache lines, each next to the owner's cached copy of the other index, so
+ * a push or pop only touches the other side's line when the cached value
+ * says the queue looks full or empty.
+ *
+ * try_push / try_emplace / try_pop never block; push / pop spin and then
+ * yield until they succeed. consume() hands every ready element to a
+ * callback and releases them with one store, for batched consumers.
+ */
+template <typename T, typename Allocator = rwstd::Allocator<T>>
+class SPSCQueue {
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+  typedef T value_type;
+  typedef std::size_t size_type;
+
+private:
+  allocator_type _alloc;
+  T *_data;
+  std::size_t _mask;
+
+  // consumer side
+  alignas(64) std::atomic<std::size_t> _head{0};
+  std::size_t _tail_cache = 0;
+
+  // producer side
+  alignas(64) std::atomic<std::size_t> _tail{0};
+  std::size_t _head_cache = 0;
+
+public:
+  // capacity is rounded up to a power of two
+  explicit SPSCQueue(std::size_t capacity,
+                     const allocator_type &alloc = allocator_type())
+      : _alloc{alloc},
+        _mask{std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1} {
+    _data = alloc_traits::allocate(_alloc, _mask + 1);
+  }
+
+  SPSCQueue(const SPSCQueue &) = delete;
+  SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+  ~SPSCQueue() {
+    std::size_t tail = _tail.load(std::memory_order_relaxed);
+    for (std::size_t i = _head.load(std::memory_order_relaxed); i != tail; ++i)
+      alloc_traits::destroy(_alloc, _data + (i & _mask));
+    alloc_traits::deallocate(_alloc, _data, _mask + 1);
+  }
+
+  /*
+   * Producer
+   */
+
+  template <typename... Args>
+  bool try_emplace(Args &&...args) {
+    std::size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head_cache > _mask) {
+      _head_cache = _head.load(std::memory_order_acquire);
+      if (tail - _head_cache > _mask)
+        return false;
+    }
+    alloc_traits::construct(_alloc, _data + (tail & _mask),
+                            std::forward<Args>(args)...);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // value is left alone when the queue is full
+  bool try_push(const T &value) { return try_emplace(value); }
+  bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+  void push(T value) {
+    for (detail::QueueBackoff backoff; !try_push(std::move(value));)
+      backoff.pause();
+  }
+
+  /*
+   * Consumer
+   */
+
+  std::optional<T> try_pop() {
+    std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail_cache) {
+      _tail_cache = _tail.load(std::memory_order_acquire);
+      if (head == _tail_cache)
+        return std::nullopt;
+    }
+    T *slot = _data + (head & _mask);
+    std::optional<T> value(std::move(*slot));
+    alloc_traits::destroy(_alloc, slot);
+    _head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  T pop() {
+    for (detail::QueueBackoff backoff;; backoff.pause()) {
+      if (std::optional<T> value = try_pop())
+        return std::move(*value);
+    }
+  }
+
+  // calls f(T &) on up to max ready elements in order, then frees their
+  // slots at once; returns how many it took. If f throws, the elements
+  // before are freed and the one it threw on stays at the front
+  template <typename F>
+  std::size_t consume(F f, std::size_t max = ~std::size_t{0}) {
+    std::size_t head = _head.load(std::memory_order_relaxed);
+    _tail_cache = _tail.load(std::memory_order_acquire);
+    std::size_t count = std::min(_tail_cache - head, max);
+    std::size_t i = 0;
+    try {
+      for (; i < count; ++i) {
+        T *slot = _data + ((head + i) & _mask);
+        f(*slot);
+        alloc_traits::destroy(_alloc, slot);
+      }
+    } catch (...) {
+      _head.store(head + i, std::memory_order_release);
+      throw;
+    }
+    _head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /*
+   * Capacity
+   */
+
+  std::size_t capacity() const { return _mask + 1; }
+
+  // exact only while neither side is running
+  std::size_t size_approx() const {
+    std::size_t head = _head.load(std::memory_order_acquire);
+    return _tail.load(std::memory_order_acquire) - head;
+  }
+
+  bool empty() const { return size_approx() == 0; }
+};
+
+/*
+ * Bounded lock-free queue for any number of producers and consumers, after
+ * Dmitry Vyukov's bounded MPMC queue. Every cell carries a sequence number
+ * that says whose turn it is: a producer may fill cell pos & mask once its
+ * sequence equals pos, a consumer may empty it once the sequence is pos + 1,
+ * and emptying sets it to pos + capacity for the next lap. Producers and
+ * consumers contend only on their own position counter (one CAS each), and
+ * those sit on separate cache lines.
+ *
+ * A claimed cell has to be filled, so elements are moved in and out with
+ * T's non-throwing move constructor; try_emplace builds the value first
+ * when its constructor might throw.
+ */
+template <typename T, typename Allocator = rwstd::Allocator<T>>
+class MPMCQueue {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "MPMCQueue needs a noexcept move constructor");
+
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *get() { return std::launder(reinterpret_cast<T *>(storage)); }
+  };
+
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+  typedef T value_type;
+  typedef std::size_t size_type;
+
+private:
+  using cell_alloc_type = typename alloc_traits::template rebind_alloc<Cell>;
+  using cell_alloc_traits =
+      typename alloc_traits::template rebind_traits<Cell>;
+
+  allocator_type _alloc;
+  cell_alloc_type _cell_alloc;
+  Cell *_cells;
+  std::size_t _mask;
+
+  alignas(64) std::atomic<std::size_t> _enqueue{0};
+  alignas(64) std::atomic<std::size_t> _dequeue{0};
+
+  // the cell for the next push, with pos claimed; nullptr when full
+  Cell *_claim_push(std::size_t &pos) {
+    pos = _enqueue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = _cells[pos & _mask];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      auto lag = static_cast<std::ptrdiff_t>(seq - pos);
+      if (lag == 0) {
+        if (_enqueue.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed))
+          return &cell;
+      } else if (lag < 0) {
+        return nullptr;
+      } else {
+        pos = _enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  Cell *_claim_pop(std::size_t &pos) {
+    pos = _dequeue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = _cells[pos & _mask];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      auto lag = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (lag == 0) {
+        if (_dequeue.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed))
+          return &cell;
+      } else if (lag < 0) {
+        return nullptr;
+      } else {
+        pos = _dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+public:
+  // capacity is rounded up to a power of two, at least 2
+  explicit MPMCQueue(std::size_t capacity,
+                     const allocator_type &alloc = allocator_type())
+      : _alloc{alloc}, _cell_alloc{alloc},
+        _mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1} {
+    _cells = cell_alloc_traits::allocate(_cell_alloc, _mask + 1);
+    for (std::size_t i = 0; i <= _mask; ++i) {
+      cell_alloc_traits::construct(_cell_alloc, _cells + i);
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCQueue(const MPMCQueue &) = delete;
+  MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+  ~MPMCQueue() {
+    std::size_t end = _enqueue.load(std::memory_order_relaxed);
+    for (std::size_t i = _dequeue.load(std::memory_order_relaxed); i != end;
+         ++i)
+      alloc_traits::destroy(_alloc, _cells[i & _mask].get());
+    for (std::size_t i = 0; i <= _mask; ++i)
+      cell_alloc_traits::destroy(_cell_alloc, _cells + i);
+    cell_alloc_traits::deallocate(_cell_alloc, _cells, _mask + 1);
+  }
+
+  /*
+   * Producers
+   */
+
+  template <typename... Args>
+  bool try_emplace(Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      std::size_t pos;
+      Cell *cell = _claim_push(pos);
+      if (cell == nullptr)
+        return false;
+      alloc_traits::construct(_alloc, cell->get(),
+                              std::forward<Args>(args)...);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    } else {
+      return try_push(T(std::forward<Args>(args)...));
+    }
+  }
+
+  // value is left alone when the queue is full
+  bool try_push(const T &value) { return try_push(T(value)); }
+
+  bool try_push(T &&value) {
+    std::size_t pos;
+    Cell *cell = _claim_push(pos);
+    if (cell == nullptr)
+      return false;
+    alloc_traits::construct(_alloc, cell->get(), std::move(value));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  void push(T value) {
+    for (detail::QueueBackoff backoff; !try_push(std::move(value));)
+      backoff.pause();
+  }
+
+  /*
+   * Consumers
+   */
+
+  std::optional<T> try_pop() {
+    std::size_t pos;
+    Cell *cell = _claim_pop(pos);
+    if (cell == nullptr)
+      return std::nullopt;
+    std::optional<T> value(std::move(*cell->get()));
+    alloc_traits::destroy(_alloc, cell->get());
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return value;
+  }
+
+  T pop() {
+    for (detail::QueueBackoff backoff;; backoff.pause()) {
+      if (std::optional<T> value = try_pop())
+        return std::move(*value);
+    }
+  }
+
+  /*
+   * Capacity
+   */
+
+  std::size_t capacity() const { return _mask + 1; }
+
+  // a snapshot, claimed cells still being filled or emptied included
+  std::size_t size_approx() const {
+    std::size_t head = _dequeue.load(std::memory_order_acquire);
+    std::size_t tail = _enqueue.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool empty() const { return size_approx() == 0; }
+};
+
+} // namespace rwstd
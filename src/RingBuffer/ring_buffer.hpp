@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rwstd {
+
+/*
+ * Fixed capacity FIFO over one power of two sized buffer. Positions are
+ * free running counters masked into the buffer, so push_back / pop_front
+ * never move elements and full and empty never need a spare slot.
+ *
+ * The live elements are at most two contiguous runs, which spans() hands
+ * out for batched consumption (process both, then pop_front(n)). Not thread
+ * safe; SPSCQueue and MPMCQueue are the concurrent versions.
+ */
+template <typename T, typename Allocator = rwstd::Allocator<T>>
+class RingBuffer {
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  // front to back by position
+  template <bool Const>
+  class RingBufferIterator {
+  public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+    using iterator_category = std::forward_iterator_tag;
+    using ring_pointer =
+        std::conditional_t<Const, const RingBuffer *, RingBuffer *>;
+
+    ring_pointer ring;
+    std::size_t pos;
+
+    RingBufferIterator() : ring{nullptr}, pos{0} {}
+    RingBufferIterator(ring_pointer r, std::size_t p) : ring{r}, pos{p} {}
+
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    RingBufferIterator(const RingBufferIterator<WasConst> &other)
+        : ring{other.ring}, pos{other.pos} {}
+
+    reference operator*() const { return (*ring)[pos]; }
+    pointer operator->() const { return &(*ring)[pos]; }
+
+    RingBufferIterator &operator++() {
+      ++pos;
+      return *this;
+    }
+
+    RingBufferIterator operator++(int) {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    template <bool RhsConst>
+    bool operator==(const RingBufferIterator<RhsConst> &rhs) const {
+      return pos == rhs.pos;
+    }
+  };
+
+  using iterator = RingBufferIterator<false>;
+  using const_iterator = RingBufferIterator<true>;
+
+private:
+  allocator_type _alloc;
+  T *_data;
+  std::size_t _capacity;
+  std::size_t _mask;
+  std::size_t _head = 0;
+  std::size_t _tail = 0;
+
+  T *_slot(std::size_t position) const { return _data + (position & _mask); }
+
+  void _check_full() const {
+    if (full())
+      throw std::length_error(std::format(
+          "RingBuffer: push onto a full buffer of capacity {}", _capacity));
+  }
+
+public:
+  // capacity is rounded up to a power of two
+  explicit RingBuffer(std::size_t capacity,
+                      const allocator_type &alloc = allocator_type())
+      : _alloc{alloc},
+        _capacity{std::bit_ceil(std::max<std::size_t>(capacity, 1))},
+        _mask{_capacity - 1} {
+    _data = alloc_traits::allocate(_alloc, _capacity);
+  }
+
+  RingBuffer(const RingBuffer &other)
+      : RingBuffer(other._capacity,
+                   alloc_traits::select_on_container_copy_construction(
+                       other._alloc)) {
+    for (const T &value : other)
+      push_back(value);
+  }
+
+  RingBuffer(RingBuffer &&other) noexcept
+      : _alloc{other._alloc}, _data{std::exchange(other._data, nullptr)},
+        _capacity{std::exchange(other._capacity, 0)},
+        _mask{other._mask}, _head{std::exchange(other._head, 0)},
+        _tail{std::exchange(other._tail, 0)} {}
+
+  ~RingBuffer() {
+    if (_data == nullptr)
+      return;
+    clear();
+    alloc_traits::deallocate(_alloc, _data, _capacity);
+  }
+
+  RingBuffer &operator=(RingBuffer other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  void swap(RingBuffer &other) noexcept {
+    using std::swap;
+    swap(_data, other._data);
+    swap(_capacity, other._capacity);
+    swap(_mask, other._mask);
+    swap(_head, other._head);
+    swap(_tail, other._tail);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(_alloc, other._alloc);
+    }
+  }
+
+  /*
+   * Element access
+   */
+
+  // pos counts from the front
+  T &operator[](std::size_t pos) { return *_slot(_head + pos); }
+  const T &operator[](std::size_t pos) const { return *_slot(_head + pos); }
+
+  T &at(std::size_t pos) {
+    if (pos >= size())
+      throw std::out_of_range(std::format(
+          "RingBuffer::at pos: {} >= size(): {}", pos, size()));
+    return (*this)[pos];
+  }
+
+  const T &at(std::size_t pos) const {
+    if (pos >= size())
+      throw std::out_of_range(std::format(
+          "RingBuffer::at pos: {} >= size(): {}", pos, size()));
+    return (*this)[pos];
+  }
+
+  T &front() { return (*this)[0]; }
+  const T &front() const { return (*this)[0]; }
+  T &back() { return (*this)[size() - 1]; }
+  const T &back() const { return (*this)[size() - 1]; }
+
+  // the elements front to back as two runs, the second empty unless they
+  // wrap around the end of the buffer
+  std::pair<std::span<T>, std::span<T>> spans() {
+    std::size_t first = _head & _mask;
+    std::size_t run = std::min(size(), _capacity - first);
+    return {{_data + first, run}, {_data, size() - run}};
+  }
+
+  std::pair<std::span<const T>, std::span<const T>> spans() const {
+    auto [a, b] = const_cast<RingBuffer *>(this)->spans();
+    return {a, b};
+  }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, size()}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _head == _tail; }
+  bool full() const { return size() == _capacity; }
+  std::size_t size() const { return _tail - _head; }
+  std::size_t capacity() const { return _capacity; }
+
+  /*
+   * Modifiers
+   */
+
+  // throws std::length_error when full
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  T &emplace_back(Args &&...args) {
+    _check_full();
+    T *slot = _slot(_tail);
+    alloc_traits::construct(_alloc, slot, std::forward<Args>(args)...);
+    ++_tail;
+    return *slot;
+  }
+
+  // false instead of throwing when full
+  bool try_push(const T &value) {
+    if (full())
+      return false;
+    emplace_back(value);
+    return true;
+  }
+
+  bool try_push(T &&value) {
+    if (full())
+      return false;
+    emplace_back(std::move(value));
+    return true;
+  }
+
+  void pop_front() {
+    alloc_traits::destroy(_alloc, _slot(_head));
+    ++_head;
+  }
+
+  // drops the first count elements, count <= size()
+  void pop_front(std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+      alloc_traits::destroy(_alloc, _slot(_head + i));
+    _head += count;
+  }
+
+  void clear() { pop_front(size()); }
+};
+
+} // namespace rwstd
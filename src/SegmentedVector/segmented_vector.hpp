@@ -0,0 +1,403 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <format>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace rwstd {
+
+/*
+ * Vector made of geometrically growing blocks. Block k holds
+ * first_block_size << k elements, so with a block table of 64 pointers the
+ * index -> (block, offset) mapping is a shift, a bit_width and a subtraction:
+ *
+ *   block 0: [0, B)   block 1: [B, 3B)   block 2: [3B, 7B)   ...
+ *
+ * Growing only ever allocates a new block, elements never move. References,
+ * pointers and iterators stay valid until the element itself is erased
+ * (pop_back/clear), and push_back has no O(n) reallocation spike.
+ */
+template <typename T, typename Allocator = rwstd::Allocator<T>>
+class SegmentedVector {
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  // first block holds at least one cache line worth of elements
+  static constexpr std::size_t first_block_shift =
+      std::bit_width(std::max<std::size_t>(1, 64 / sizeof(T))) - 1;
+  static constexpr std::size_t first_block_size = std::size_t{1}
+                                                  << first_block_shift;
+  static constexpr std::size_t max_blocks = 64 - first_block_shift;
+
+  template <bool Const>
+  class SegmentedIterator {
+  public:
+    typedef SegmentedVector::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::conditional_t<Const, const T *, T *> pointer;
+    typedef std::conditional_t<Const, const T &, T &> reference;
+    typedef std::random_access_iterator_tag iterator_category;
+
+  private:
+    using container =
+        std::conditional_t<Const, const SegmentedVector, SegmentedVector>;
+
+    container *_vec = nullptr;
+    std::size_t _idx = 0;
+    // cached position inside the current block, rebuilt on block changes
+    pointer _ptr = nullptr;
+    pointer _block_end = nullptr;
+
+    friend class SegmentedVector;
+
+    SegmentedIterator(container *vec, std::size_t idx) : _vec{vec}, _idx{idx} {
+      _seek();
+    }
+
+    void _seek() {
+      if (_vec == nullptr || _idx >= _vec->_allocated) {
+        _ptr = nullptr;
+        _block_end = nullptr;
+        return;
+      }
+      auto [block, offset] = SegmentedVector::_locate(_idx);
+      _ptr = _vec->_blocks[block] + offset;
+      _block_end = _vec->_blocks[block] + SegmentedVector::_block_size(block);
+    }
+
+  public:
+    SegmentedIterator() = default;
+
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    SegmentedIterator(const SegmentedIterator<WasConst> &other)
+        : _vec{other._vec}, _idx{other._idx}, _ptr{other._ptr},
+          _block_end{other._block_end} {}
+
+    reference operator*() const { return *_ptr; }
+
+    pointer operator->() const { return _ptr; }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    SegmentedIterator &operator++() {
+      ++_idx;
+      if (++_ptr == _block_end)
+        _seek();
+      return *this;
+    }
+
+    SegmentedIterator operator++(int) {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    SegmentedIterator &operator--() {
+      --_idx;
+      _seek();
+      return *this;
+    }
+
+    SegmentedIterator operator--(int) {
+      auto tmp = *this;
+      --(*this);
+      return tmp;
+    }
+
+    SegmentedIterator &operator+=(difference_type n) {
+      _idx = static_cast<std::size_t>(static_cast<difference_type>(_idx) + n);
+      _seek();
+      return *this;
+    }
+
+    SegmentedIterator &operator-=(difference_type n) { return *this += -n; }
+
+    SegmentedIterator operator+(difference_type n) const {
+      auto tmp = *this;
+      return tmp += n;
+    }
+
+    friend SegmentedIterator operator+(difference_type n,
+                                       const SegmentedIterator &it) {
+      return it + n;
+    }
+
+    SegmentedIterator operator-(difference_type n) const {
+      auto tmp = *this;
+      return tmp -= n;
+    }
+
+    difference_type operator-(const SegmentedIterator &other) const {
+      return static_cast<difference_type>(_idx) -
+             static_cast<difference_type>(other._idx);
+    }
+
+    bool operator==(const SegmentedIterator &rhs) const {
+      return _idx == rhs._idx;
+    }
+
+    auto operator<=>(const SegmentedIterator &rhs) const {
+      return _idx <=> rhs._idx;
+    }
+
+    template <bool>
+    friend class SegmentedIterator;
+  };
+
+  typedef SegmentedIterator<false> iterator;
+  typedef SegmentedIterator<true> const_iterator;
+
+private:
+  allocator_type _alloc;
+  T *_blocks[max_blocks] = {};
+  std::size_t _num_blocks = 0;
+  std::size_t _size = 0;
+  std::size_t _allocated = 0; // elements covered by the allocated blocks
+
+  static constexpr std::size_t _block_size(std::size_t block) {
+    return first_block_size << block;
+  }
+
+  // index of the first element stored in block
+  static constexpr std::size_t _block_start(std::size_t block) {
+    return ((std::size_t{1} << block) - 1) << first_block_shift;
+  }
+
+  static constexpr std::pair<std::size_t, std::size_t>
+  _locate(std::size_t pos) {
+    std::size_t block =
+        static_cast<std::size_t>(
+            std::bit_width((pos >> first_block_shift) + 1)) -
+        1;
+    return {block, pos - _block_start(block)};
+  }
+
+  void _add_block() {
+    if (_num_blocks == max_blocks) {
+      throw std::length_error("SegmentedVector: block table is full");
+    }
+    _blocks[_num_blocks] =
+        alloc_traits::allocate(_alloc, _block_size(_num_blocks));
+    _allocated += _block_size(_num_blocks);
+    _num_blocks++;
+  }
+
+  void _release_blocks(std::size_t keep) {
+    while (_num_blocks > keep) {
+      _num_blocks--;
+      _allocated -= _block_size(_num_blocks);
+      alloc_traits::deallocate(_alloc, _blocks[_num_blocks],
+                               _block_size(_num_blocks));
+      _blocks[_num_blocks] = nullptr;
+    }
+  }
+
+  T *_slot(std::size_t pos) const {
+    auto [block, offset] = _locate(pos);
+    return _blocks[block] + offset;
+  }
+
+public:
+  SegmentedVector() noexcept(noexcept(Allocator()))
+      : SegmentedVector(Allocator()) {}
+
+  explicit SegmentedVector(const allocator_type &alloc) noexcept
+      : _alloc{alloc} {}
+
+  explicit SegmentedVector(std::size_t size, const T &value = T(),
+                           const allocator_type &alloc = Allocator())
+      : _alloc{alloc} {
+    reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      push_back(value);
+    }
+  }
+
+  SegmentedVector(std::initializer_list<T> init,
+                  const allocator_type &alloc = Allocator())
+      : _alloc{alloc} {
+    reserve(init.size());
+    for (const T &value : init) {
+      push_back(value);
+    }
+  }
+
+  SegmentedVector(const SegmentedVector &other)
+      : _alloc{alloc_traits::select_on_container_copy_construction(
+            other._alloc)} {
+    reserve(other._size);
+    for (const T &value : other) {
+      push_back(value);
+    }
+  }
+
+  SegmentedVector(SegmentedVector &&other) noexcept
+      : _alloc{std::move(other._alloc)},
+        _num_blocks{std::exchange(other._num_blocks, 0)},
+        _size{std::exchange(other._size, 0)},
+        _allocated{std::exchange(other._allocated, 0)} {
+    std::copy(std::begin(other._blocks), std::end(other._blocks), _blocks);
+    std::fill(std::begin(other._blocks), std::end(other._blocks), nullptr);
+  }
+
+  SegmentedVector &operator=(SegmentedVector other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~SegmentedVector() {
+    clear();
+    _release_blocks(0);
+  }
+
+  void swap(SegmentedVector &other) noexcept {
+    using std::swap;
+    swap(_blocks, other._blocks);
+    swap(_num_blocks, other._num_blocks);
+    swap(_size, other._size);
+    swap(_allocated, other._allocated);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(_alloc, other._alloc);
+    }
+  }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+  /*
+   * Element access
+   */
+
+  T &at(std::size_t pos) {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "segmented_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return *_slot(pos);
+  }
+
+  const T &at(std::size_t pos) const {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "segmented_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return *_slot(pos);
+  }
+
+  T &operator[](std::size_t pos) { return *_slot(pos); }
+  const T &operator[](std::size_t pos) const { return *_slot(pos); }
+
+  T &front() { return (*this)[0]; }
+  const T &front() const { return (*this)[0]; }
+
+  T &back() { return (*this)[_size - 1]; }
+  const T &back() const { return (*this)[_size - 1]; }
+
+  // blocks are contiguous on their own, handy for bulk processing
+  std::size_t block_count() const { return _num_blocks; }
+
+  T *block_data(std::size_t block) { return _blocks[block]; }
+  const T *block_data(std::size_t block) const { return _blocks[block]; }
+
+  std::size_t block_size(std::size_t block) const {
+    if (block + 1 < _num_blocks || _size >= _allocated)
+      return _block_size(block);
+    // last block in use may be partially filled
+    std::size_t start = _block_start(block);
+    return _size > start ? std::min(_size - start, _block_size(block)) : 0;
+  }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, _size); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, _size); }
+
+  const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cend() const noexcept { return const_iterator(this, _size); }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+
+  std::size_t size() const { return _size; }
+
+  std::size_t capacity() const { return _allocated; }
+
+  std::size_t max_size() const {
+    return std::min(alloc_traits::max_size(_alloc),
+                    _block_start(max_blocks - 1));
+  }
+
+  // never moves anything, only allocates the blocks needed to cover new_cap
+  void reserve(size_type new_cap) {
+    if (new_cap > max_size())
+      throw std::length_error(
+          std::format("{}: Size is too big for SegmentedVector", new_cap));
+    while (_allocated < new_cap) {
+      _add_block();
+    }
+  }
+
+  // drops blocks that hold no elements
+  void shrink_to_fit() {
+    std::size_t needed = _size == 0 ? 0 : _locate(_size - 1).first + 1;
+    _release_blocks(needed);
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void clear() noexcept {
+    while (_size > 0) {
+      pop_back();
+    }
+  }
+
+  template <class... Args>
+  T &emplace_back(Args &&...args) {
+    if (_size == _allocated) {
+      _add_block();
+    }
+    T *slot = _slot(_size);
+    alloc_traits::construct(_alloc, slot, std::forward<Args>(args)...);
+    _size++;
+    return *slot;
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() {
+    if (_size == 0)
+      return;
+    alloc_traits::destroy(_alloc, _slot(_size - 1));
+    --_size;
+  }
+};
+} // namespace rwstd
@@ -0,0 +1,620 @@
+#pragma once
+
+#include "UnorderedMap/unordered_map.hpp"
+#include "Vector/vector.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+/*
+ * Binary format for shipping containers between processes. Every object is a
+ * 64 byte Header followed by its payload, padded so the next object starts on
+ * a 64 byte boundary again:
+ *
+ *   Vector<T>:          T[count]
+ *   UnorderedMap<K, V>: uint32_t chain_length[bucket_count]
+ *                       (K, V)[count], packed, bucket by bucket in chain order
+ *
+ * Vector payloads are the elements' bytes, so a Vector inside a mapped or
+ * otherwise in-memory buffer can be used in place (view_vector). Maps keep the
+ * bucket they were in, so loading puts every node straight back into its chain
+ * without hashing. That only holds while both sides agree on Hash, which is
+ * spot checked on load.
+ *
+ * Elements must be trivially copyable. Data written on a machine with the
+ * other byte order is byteswapped on load for arithmetic and enum types and
+ * rejected for everything else.
+ */
+
+namespace rwstd::serialize {
+
+class FormatError : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+enum class Kind : std::uint32_t { vector = 1, unordered_map = 2 };
+
+struct Header {
+  static constexpr char expected_magic[8] = {'R', 'W', 'S', 'T',
+                                             'D', 'S', 'R', '\0'};
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t native_endian_tag = 0x01020304;
+  static constexpr std::size_t alignment = 64;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian_tag;
+  std::uint32_t kind;
+  std::uint32_t flags;
+  std::uint64_t key_size; // element size for vectors
+  std::uint64_t mapped_size;
+  std::uint64_t count;
+  std::uint64_t bucket_count;
+  std::uint32_t max_load_factor; // float bits
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Header) == Header::alignment);
+
+namespace detail {
+
+inline std::size_t padding_for(std::size_t bytes) {
+  return (Header::alignment - bytes % Header::alignment) % Header::alignment;
+}
+
+template <typename T>
+constexpr bool swappable_v =
+    std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template <typename T>
+T byteswap_value(T value) {
+  if constexpr (sizeof(T) == 1) {
+    return value;
+  } else {
+    using Bits = std::conditional_t<
+        sizeof(T) == 2, std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>;
+    static_assert(sizeof(Bits) == sizeof(T));
+    return std::bit_cast<T>(std::byteswap(std::bit_cast<Bits>(value)));
+  }
+}
+
+inline void byteswap_header(Header &h) {
+  h.version = std::byteswap(h.version);
+  h.endian_tag = std::byteswap(h.endian_tag);
+  h.kind = std::byteswap(h.kind);
+  h.flags = std::byteswap(h.flags);
+  h.key_size = std::byteswap(h.key_size);
+  h.mapped_size = std::byteswap(h.mapped_size);
+  h.count = std::byteswap(h.count);
+  h.bucket_count = std::byteswap(h.bucket_count);
+  h.max_load_factor = std::byteswap(h.max_load_factor);
+}
+
+inline Header make_header(Kind kind) {
+  Header h{};
+  std::memcpy(h.magic, Header::expected_magic, 8);
+  h.version = Header::current_version;
+  h.endian_tag = Header::native_endian_tag;
+  h.kind = static_cast<std::uint32_t>(kind);
+  return h;
+}
+
+// returns true if the payload needs byteswapping
+inline bool check_header(Header &h, Kind kind, std::size_t key_size,
+                         std::size_t mapped_size) {
+  if (std::memcmp(h.magic, Header::expected_magic, 8) != 0)
+    throw FormatError("serialize: bad magic, not an rwstd stream");
+
+  bool foreign = false;
+  if (h.endian_tag != Header::native_endian_tag) {
+    if (h.endian_tag != std::byteswap(Header::native_endian_tag))
+      throw FormatError("serialize: corrupt byte order tag");
+    byteswap_header(h);
+    foreign = true;
+  }
+  if (h.version != Header::current_version) {
+    throw FormatError(
+        std::format("serialize: unsupported version {}", h.version));
+  }
+  if (h.kind != static_cast<std::uint32_t>(kind)) {
+    throw FormatError(std::format("serialize: expected kind {}, found {}",
+                                  static_cast<std::uint32_t>(kind), h.kind));
+  }
+  if (h.key_size != key_size || h.mapped_size != mapped_size) {
+    throw FormatError(std::format(
+        "serialize: element size mismatch, stream has {}/{} expected {}/{}",
+        h.key_size, h.mapped_size, key_size, mapped_size));
+  }
+  return foreign;
+}
+
+template <typename Reader>
+Header read_header(Reader &reader) {
+  Header h;
+  reader.read(&h, sizeof(h));
+  return h;
+}
+
+// readers that know how much input is left, like BufferReader
+template <typename Reader>
+concept sized_reader = requires(const Reader &reader) {
+  { reader.remaining() } -> std::convertible_to<std::size_t>;
+};
+
+// count elements of `size` bytes as a byte count; a count from the header
+// is untrusted, so overflow, or more than a sized reader has left, is a
+// FormatError rather than a wrapped size or a huge allocation
+template <typename Reader>
+std::size_t checked_bytes(const Reader &reader, std::uint64_t count,
+                          std::size_t size) {
+  if (size != 0 && count > std::numeric_limits<std::size_t>::max() / size)
+    throw FormatError(std::format("serialize: count {} overflows", count));
+  std::size_t bytes = static_cast<std::size_t>(count) * size;
+  if constexpr (sized_reader<Reader>) {
+    if (bytes > reader.remaining()) {
+      throw FormatError(std::format(
+          "serialize: header claims {} bytes but {} left", bytes,
+          reader.remaining()));
+    }
+  }
+  return bytes;
+}
+
+// reads count elements into out (a Vector or std::vector). A sized reader
+// has vouched for the bytes, so that is one allocation; otherwise out grows
+// a chunk at a time with the input actually read, and a corrupt count runs
+// into truncated input before it can allocate much
+template <typename T, typename Reader, typename Out>
+void read_elements(Reader &reader, std::size_t count, Out &out) {
+  constexpr std::size_t chunk =
+      std::max<std::size_t>(1, (std::size_t{1} << 16) / sizeof(T));
+  std::size_t step = sized_reader<Reader> ? count : chunk;
+  for (std::size_t done = 0; done < count;) {
+    std::size_t n = std::min(step, count - done);
+    out.insert(out.cend(), n, T{});
+    reader.read(&out[done], n * sizeof(T));
+    done += n;
+  }
+}
+
+template <typename Writer>
+void write_padding(Writer &writer, std::size_t payload_bytes) {
+  static constexpr std::byte zeros[Header::alignment] = {};
+  std::size_t pad = padding_for(payload_bytes);
+  if (pad != 0)
+    writer.write(zeros, pad);
+}
+
+} // namespace detail
+
+/*
+ * Writers and readers. Anything with write(const void *, size_t) /
+ * read(void *, size_t) + skip(size_t) works, readers throw FormatError when
+ * the input ends early.
+ */
+
+class FileWriter {
+  std::FILE *_file;
+
+public:
+  explicit FileWriter(std::FILE *file) : _file{file} {}
+
+  void write(const void *data, std::size_t bytes) {
+    if (bytes != 0 && std::fwrite(data, 1, bytes, _file) != bytes) {
+      throw std::system_error(errno, std::generic_category(),
+                              "serialize::FileWriter fwrite");
+    }
+  }
+
+  void flush() { std::fflush(_file); }
+};
+
+class FileReader {
+  std::FILE *_file;
+
+public:
+  explicit FileReader(std::FILE *file) : _file{file} {}
+
+  void read(void *data, std::size_t bytes) {
+    if (bytes != 0 && std::fread(data, 1, bytes, _file) != bytes) {
+      throw FormatError(std::format(
+          "serialize::FileReader: truncated input, wanted {} bytes", bytes));
+    }
+  }
+
+  void skip(std::size_t bytes) {
+    std::byte sink[Header::alignment];
+    while (bytes > 0) {
+      std::size_t n = std::min(bytes, sizeof(sink));
+      read(sink, n);
+      bytes -= n;
+    }
+  }
+};
+
+// buffers small writes, large blocks go straight to write(2)
+class FdWriter {
+  static constexpr std::size_t _buffer_size = 64 * 1024;
+
+  int _fd;
+  std::size_t _used = 0;
+  std::byte _buffer[_buffer_size];
+
+  void _write_all(const std::byte *data, std::size_t bytes) {
+    while (bytes > 0) {
+      ssize_t n = ::write(_fd, data, bytes);
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        throw std::system_error(errno, std::generic_category(),
+                                "serialize::FdWriter write");
+      }
+      data += n;
+      bytes -= static_cast<std::size_t>(n);
+    }
+  }
+
+public:
+  explicit FdWriter(int fd) : _fd{fd} {}
+
+  FdWriter(const FdWriter &) = delete;
+  FdWriter &operator=(const FdWriter &) = delete;
+
+  ~FdWriter() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  void write(const void *data, std::size_t bytes) {
+    const auto *p = static_cast<const std::byte *>(data);
+    if (_used + bytes <= _buffer_size) {
+      std::memcpy(_buffer + _used, p, bytes);
+      _used += bytes;
+      return;
+    }
+    flush();
+    if (bytes >= _buffer_size) {
+      _write_all(p, bytes);
+    } else {
+      std::memcpy(_buffer, p, bytes);
+      _used = bytes;
+    }
+  }
+
+  void flush() {
+    _write_all(_buffer, _used);
+    _used = 0;
+  }
+};
+
+class FdReader {
+  static constexpr std::size_t _buffer_size = 64 * 1024;
+
+  int _fd;
+  std::size_t _pos = 0;
+  std::size_t _end = 0;
+  std::byte _buffer[_buffer_size];
+
+  // reads at least one byte into dst, 0 means end of input
+  std::size_t _read_some(std::byte *dst, std::size_t bytes) {
+    for (;;) {
+      ssize_t n = ::read(_fd, dst, bytes);
+      if (n >= 0)
+        return static_cast<std::size_t>(n);
+      if (errno != EINTR) {
+        throw std::system_error(errno, std::generic_category(),
+                                "serialize::FdReader read");
+      }
+    }
+  }
+
+public:
+  explicit FdReader(int fd) : _fd{fd} {}
+
+  FdReader(const FdReader &) = delete;
+  FdReader &operator=(const FdReader &) = delete;
+
+  void read(void *data, std::size_t bytes) {
+    auto *out = static_cast<std::byte *>(data);
+    std::size_t wanted = bytes;
+    std::size_t buffered = std::min(bytes, _end - _pos);
+    std::memcpy(out, _buffer + _pos, buffered);
+    _pos += buffered;
+    out += buffered;
+    bytes -= buffered;
+
+    while (bytes > 0) {
+      std::size_t n;
+      if (bytes >= _buffer_size) {
+        n = _read_some(out, bytes);
+        out += n;
+        bytes -= n;
+      } else {
+        _pos = 0;
+        _end = n = _read_some(_buffer, _buffer_size);
+        std::size_t take = std::min(bytes, _end);
+        std::memcpy(out, _buffer, take);
+        _pos = take;
+        out += take;
+        bytes -= take;
+      }
+      if (n == 0) {
+        throw FormatError(std::format(
+            "serialize::FdReader: truncated input, wanted {} bytes", wanted));
+      }
+    }
+  }
+
+  void skip(std::size_t bytes) {
+    std::byte sink[Header::alignment];
+    while (bytes > 0) {
+      std::size_t n = std::min(bytes, sizeof(sink));
+      read(sink, n);
+      bytes -= n;
+    }
+  }
+};
+
+// reads from memory that outlives the reader, e.g. a mapped file
+class BufferReader {
+  std::span<const std::byte> _buffer;
+  std::size_t _pos = 0;
+
+public:
+  explicit BufferReader(std::span<const std::byte> buffer) : _buffer{buffer} {}
+
+  const std::byte *current() const { return _buffer.data() + _pos; }
+
+  std::size_t remaining() const { return _buffer.size() - _pos; }
+
+  void skip(std::size_t bytes) {
+    if (bytes > remaining()) {
+      throw FormatError(std::format(
+          "serialize::BufferReader: truncated input, wanted {} bytes but {} "
+          "left",
+          bytes, remaining()));
+    }
+    _pos += bytes;
+  }
+
+  void read(void *data, std::size_t bytes) {
+    const std::byte *from = current();
+    skip(bytes);
+    if (bytes != 0)
+      std::memcpy(data, from, bytes);
+  }
+};
+
+/*
+ * Vector
+ */
+
+template <typename Writer, typename T, typename Allocator>
+void write(Writer &writer, const rwstd::Vector<T, Allocator> &vec) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "serialize only writes trivially copyable elements");
+  Header h = detail::make_header(Kind::vector);
+  h.key_size = sizeof(T);
+  h.count = vec.size();
+  writer.write(&h, sizeof(h));
+
+  std::size_t bytes = vec.size() * sizeof(T);
+  if (bytes != 0)
+    writer.write(&vec[0], bytes);
+  detail::write_padding(writer, bytes);
+}
+
+template <typename T, typename Allocator = rwstd::Allocator<T>,
+          typename Reader>
+rwstd::Vector<T, Allocator> read_vector(Reader &reader) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "serialize only reads trivially copyable elements");
+  Header h = detail::read_header(reader);
+  bool foreign = detail::check_header(h, Kind::vector, sizeof(T), 0);
+  if constexpr (!detail::swappable_v<T>) {
+    if (foreign)
+      throw FormatError("serialize: cannot byteswap this element type");
+  }
+
+  std::size_t bytes = detail::checked_bytes(reader, h.count, sizeof(T));
+  std::size_t count = bytes / sizeof(T);
+  rwstd::Vector<T, Allocator> vec;
+  if constexpr (detail::sized_reader<Reader>)
+    vec.reserve(count);
+  detail::read_elements<T>(reader, count, vec);
+  reader.skip(detail::padding_for(bytes));
+
+  if constexpr (detail::swappable_v<T>) {
+    if (foreign) {
+      for (std::size_t i = 0; i < count; ++i)
+        vec[i] = detail::byteswap_value(vec[i]);
+    }
+  }
+  return vec;
+}
+
+// zero copy: the span points into the reader's buffer, which must be suitably
+// aligned (anything mapped or heap allocated on 64 bytes is)
+template <typename T>
+std::span<const T> view_vector(BufferReader &reader) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "serialize only views trivially copyable elements");
+  Header h = detail::read_header(reader);
+  if (detail::check_header(h, Kind::vector, sizeof(T), 0))
+    throw FormatError("serialize: cannot view a foreign byte order in place");
+
+  std::size_t bytes = detail::checked_bytes(reader, h.count, sizeof(T));
+  std::size_t count = bytes / sizeof(T);
+  const std::byte *payload = reader.current();
+  if (reinterpret_cast<std::uintptr_t>(payload) % alignof(T) != 0)
+    throw FormatError("serialize: buffer is misaligned for in place view");
+  reader.skip(bytes);
+  reader.skip(detail::padding_for(bytes));
+  return {reinterpret_cast<const T *>(payload), count};
+}
+
+/*
+ * UnorderedMap
+ */
+
+struct access {
+  template <typename Writer, typename Map>
+  static void write_map(Writer &writer, const Map &map) {
+    using Key = typename Map::key_type;
+    using T = typename Map::mapped_type;
+    static_assert(std::is_trivially_copyable_v<Key> &&
+                      std::is_trivially_copyable_v<T>,
+                  "serialize only writes trivially copyable elements");
+
+    Header h = detail::make_header(Kind::unordered_map);
+    h.key_size = sizeof(Key);
+    h.mapped_size = sizeof(T);
+    h.count = map._size;
+    h.bucket_count = map.number_of_buckets;
+    h.max_load_factor = std::bit_cast<std::uint32_t>(map.cur_load_factor);
+    writer.write(&h, sizeof(h));
+
+    std::size_t payload = 0;
+    for (std::size_t b = 0; b < map.number_of_buckets; ++b) {
+      std::uint32_t length = 0;
+      for (auto *node = map.buckets[b]; node != nullptr; node = node->next)
+        ++length;
+      writer.write(&length, sizeof(length));
+    }
+    payload += map.number_of_buckets * sizeof(std::uint32_t);
+
+    for (std::size_t b = 0; b < map.number_of_buckets; ++b) {
+      for (auto *node = map.buckets[b]; node != nullptr; node = node->next) {
+        writer.write(&node->value.first, sizeof(Key));
+        writer.write(&node->value.second, sizeof(T));
+      }
+    }
+    payload += map._size * (sizeof(Key) + sizeof(T));
+    detail::write_padding(writer, payload);
+  }
+
+  template <typename Map, typename Reader>
+  static Map read_map(Reader &reader) {
+    using Key = typename Map::key_type;
+    using T = typename Map::mapped_type;
+    static_assert(std::is_trivially_copyable_v<Key> &&
+                      std::is_trivially_copyable_v<T>,
+                  "serialize only reads trivially copyable elements");
+    using node_alloc_traits = typename Map::node_alloc_traits;
+
+    Header h = detail::read_header(reader);
+    bool foreign =
+        detail::check_header(h, Kind::unordered_map, sizeof(Key), sizeof(T));
+    if constexpr (!detail::swappable_v<Key> || !detail::swappable_v<T>) {
+      if (foreign)
+        throw FormatError("serialize: cannot byteswap this element type");
+    }
+    if (h.bucket_count == 0)
+      throw FormatError("serialize: map with zero buckets");
+    // the map divides by it on every insert and rehash
+    float max_load_factor = std::bit_cast<float>(h.max_load_factor);
+    if (!std::isfinite(max_load_factor) || !(max_load_factor > 0.0f)) {
+      throw FormatError(std::format("serialize: bad max load factor {}",
+                                    max_load_factor));
+    }
+
+    std::size_t length_bytes =
+        detail::checked_bytes(reader, h.bucket_count, sizeof(std::uint32_t));
+    std::size_t bucket_count = length_bytes / sizeof(std::uint32_t);
+    // the entries follow the chain lengths
+    std::size_t entry_bytes =
+        detail::checked_bytes(reader, h.count, sizeof(Key) + sizeof(T));
+    std::size_t count = entry_bytes / (sizeof(Key) + sizeof(T));
+    if constexpr (detail::sized_reader<Reader>) {
+      if (entry_bytes > reader.remaining() - length_bytes)
+        throw FormatError("serialize: map entries exceed the input");
+    }
+
+    // the lengths come first, so the bucket array is only allocated once
+    // that much input has really been read
+    std::vector<std::uint32_t> lengths;
+    if constexpr (detail::sized_reader<Reader>)
+      lengths.reserve(bucket_count);
+    detail::read_elements<std::uint32_t>(reader, bucket_count, lengths);
+    Map map(bucket_count);
+    map.cur_load_factor = max_load_factor;
+
+    std::size_t seen = 0;
+    for (std::size_t b = 0; b < bucket_count; ++b) {
+      std::size_t length = foreign ? std::byteswap(lengths[b]) : lengths[b];
+      if (length > count - seen)
+        throw FormatError("serialize: chain lengths exceed element count");
+
+      // rebuild the chain in the order it was written, no hashing
+      auto **tail = &map.buckets[b];
+      for (std::size_t i = 0; i < length; ++i) {
+        Key key;
+        T value;
+        reader.read(&key, sizeof(Key));
+        reader.read(&value, sizeof(T));
+        if constexpr (detail::swappable_v<Key> && detail::swappable_v<T>) {
+          if (foreign) {
+            key = detail::byteswap_value(key);
+            value = detail::byteswap_value(value);
+          }
+        }
+
+        auto *node = node_alloc_traits::allocate(map._node_alloc, 1);
+        node_alloc_traits::construct(map._node_alloc, node, key, value);
+        *tail = node;
+        tail = &node->next;
+        map._size++;
+      }
+      seen += length;
+    }
+    if (seen != count)
+      throw FormatError("serialize: chain lengths do not add up to count");
+
+    // the layout is only valid for the hash it was built with
+    for (std::size_t b = 0; b < bucket_count; ++b) {
+      if (map.buckets[b] != nullptr) {
+        if (map._hash_key(map.buckets[b]->value.first) != b) {
+          throw FormatError(
+              "serialize: bucket layout does not match this hasher");
+        }
+        break;
+      }
+    }
+
+    reader.skip(detail::padding_for(length_bytes + entry_bytes));
+    return map;
+  }
+};
+
+template <typename Writer, typename Key, typename T, typename Hash,
+          typename KeyEqual, typename Allocator>
+void write(Writer &writer,
+           const rwstd::UnorderedMap<Key, T, Hash, KeyEqual, Allocator> &map) {
+  access::write_map(writer, map);
+}
+
+template <typename Map, typename Reader>
+Map read_map(Reader &reader) {
+  return access::read_map<Map>(reader);
+}
+
+} // namespace rwstd::serialize
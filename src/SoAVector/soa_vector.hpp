@@ -0,0 +1,510 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace rwstd {
+
+/*
+ * Structure of arrays vector. Every member type gets its own contiguous column,
+ * all columns live in one allocation and share a single size/capacity:
+ *
+ *   [ T0 T0 T0 ... | pad | T1 T1 T1 ... | pad | T2 ... ]
+ *
+ * Columns start on a 64 byte boundary so column<I>() spans are ready for SIMD
+ * loops. Element access hands out proxies (tuples of references) instead of
+ * real references, the same trick std::views::zip uses.
+ */
+template <typename Allocator, typename... Ts>
+class BasicSoAVector {
+  static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one column");
+  static_assert(std::is_same_v<typename Allocator::value_type, std::byte>,
+                "SoAVector allocates raw bytes, use an allocator of std::byte");
+
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+
+  typedef std::tuple<Ts...> value_type;
+  typedef std::tuple<Ts &...> reference;
+  typedef std::tuple<const Ts &...> const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <std::size_t I>
+  using column_type = std::tuple_element_t<I, value_type>;
+
+  static constexpr std::size_t column_count = sizeof...(Ts);
+  static constexpr std::size_t column_alignment =
+      std::max({std::size_t{64}, alignof(Ts)...});
+
+  template <bool Const>
+  class SoAIterator {
+  public:
+    typedef std::tuple<Ts...> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::conditional_t<Const, std::tuple<const Ts &...>,
+                               std::tuple<Ts &...>>
+        reference;
+    typedef void pointer;
+    // proxies are not real references, so legacy algorithms only get input
+    typedef std::input_iterator_tag iterator_category;
+    typedef std::random_access_iterator_tag iterator_concept;
+
+  private:
+    using container =
+        std::conditional_t<Const, const BasicSoAVector, BasicSoAVector>;
+    container *_vec = nullptr;
+    difference_type _idx = 0;
+
+    friend class BasicSoAVector;
+    SoAIterator(container *vec, difference_type idx) : _vec{vec}, _idx{idx} {}
+
+  public:
+
+    SoAIterator() = default;
+
+    // iterator -> const_iterator
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    SoAIterator(const SoAIterator<WasConst> &other)
+        : _vec{other._vec}, _idx{other._idx} {}
+
+    reference operator*() const {
+      return (*_vec)[static_cast<size_type>(_idx)];
+    }
+
+    reference operator[](difference_type n) const {
+      return (*_vec)[static_cast<size_type>(_idx + n)];
+    }
+
+    SoAIterator &operator++() {
+      ++_idx;
+      return *this;
+    }
+
+    SoAIterator operator++(int) {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    SoAIterator &operator--() {
+      --_idx;
+      return *this;
+    }
+
+    SoAIterator operator--(int) {
+      auto tmp = *this;
+      --(*this);
+      return tmp;
+    }
+
+    SoAIterator &operator+=(difference_type n) {
+      _idx += n;
+      return *this;
+    }
+
+    SoAIterator &operator-=(difference_type n) {
+      _idx -= n;
+      return *this;
+    }
+
+    SoAIterator operator+(difference_type n) const {
+      return SoAIterator(_vec, _idx + n);
+    }
+
+    friend SoAIterator operator+(difference_type n, const SoAIterator &it) {
+      return it + n;
+    }
+
+    SoAIterator operator-(difference_type n) const {
+      return SoAIterator(_vec, _idx - n);
+    }
+
+    difference_type operator-(const SoAIterator &other) const {
+      return _idx - other._idx;
+    }
+
+    bool operator==(const SoAIterator &rhs) const { return _idx == rhs._idx; }
+
+    auto operator<=>(const SoAIterator &rhs) const { return _idx <=> rhs._idx; }
+
+    template <bool>
+    friend class SoAIterator;
+  };
+
+  typedef SoAIterator<false> iterator;
+  typedef SoAIterator<true> const_iterator;
+
+private:
+  allocator_type _alloc;
+  std::byte *_raw = nullptr;
+  std::size_t _raw_bytes = 0;
+  std::tuple<Ts *...> _columns{};
+  std::size_t _size = 0;
+  std::size_t _capacity = 0;
+
+  static constexpr std::size_t _align_up(std::size_t n) {
+    return (n + column_alignment - 1) / column_alignment * column_alignment;
+  }
+
+  // bytes needed for cap rows, including slack to align the first column
+  static constexpr std::size_t _bytes_for(std::size_t cap) {
+    return (_align_up(sizeof(Ts) * cap) + ...) + column_alignment;
+  }
+
+  template <typename T>
+  using rebind_alloc = typename alloc_traits::template rebind_alloc<T>;
+  template <typename T>
+  using rebind_traits = typename alloc_traits::template rebind_traits<T>;
+
+  template <typename T, typename... Args>
+  void _construct(T *p, Args &&...args) {
+    rebind_alloc<T> a(_alloc);
+    rebind_traits<T>::construct(a, p, std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void _destroy(T *p) {
+    rebind_alloc<T> a(_alloc);
+    rebind_traits<T>::destroy(a, p);
+  }
+
+  // carve cap rows worth of columns out of raw
+  static std::tuple<Ts *...> _carve(std::byte *raw, std::size_t raw_bytes,
+                                    std::size_t cap) {
+    void *base = raw;
+    std::size_t space = raw_bytes;
+    std::align(column_alignment, 1, base, space);
+    auto *cursor = static_cast<std::byte *>(base);
+    auto next = [&]<typename T>(std::type_identity<T>) {
+      T *column = reinterpret_cast<T *>(cursor);
+      cursor += _align_up(sizeof(T) * cap);
+      return column;
+    };
+    // braced init keeps the left to right order
+    return std::tuple<Ts *...>{next(std::type_identity<Ts>{})...};
+  }
+
+  template <std::size_t I>
+  void _destroy_rows(const std::tuple<Ts *...> &columns, std::size_t first,
+                     std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      _destroy(std::get<I>(columns) + i);
+    }
+  }
+
+  template <std::size_t... Is>
+  void _destroy_all(std::index_sequence<Is...>) {
+    (_destroy_rows<Is>(_columns, 0, _size), ...);
+  }
+
+  // a moved column cannot be put back if a later one throws, so rows are only
+  // moved when no column can throw doing so, otherwise every copyable column
+  // is copied and the old rows stay intact until the new ones are complete
+  static constexpr bool _move_rows =
+      ((std::is_nothrow_move_constructible_v<Ts> ||
+        !std::is_copy_constructible_v<Ts>) &&
+       ...);
+
+  template <typename T>
+  static decltype(auto) _relocated(T &value) {
+    if constexpr (_move_rows || !std::is_copy_constructible_v<T>)
+      return std::move(value);
+    else
+      return std::as_const(value);
+  }
+
+  // move or copy (see _move_rows) column I into new_columns. On a throw
+  // everything already built in new_columns is destroyed again.
+  template <std::size_t I>
+  void _relocate(std::tuple<Ts *...> &new_columns) {
+    if constexpr (I < column_count) {
+      auto *src = std::get<I>(_columns);
+      auto *dst = std::get<I>(new_columns);
+      std::size_t i = 0;
+      try {
+        for (; i < _size; ++i) {
+          _construct(dst + i, _relocated(src[i]));
+        }
+        _relocate<I + 1>(new_columns);
+      } catch (...) {
+        for (std::size_t j = 0; j < i; ++j) {
+          _destroy(dst + j);
+        }
+        throw;
+      }
+    }
+  }
+
+  // construct row _size column by column, unwinding the finished columns if a
+  // later one throws
+  template <std::size_t I, typename ArgTuple>
+  void _construct_row(ArgTuple &args) {
+    if constexpr (I < column_count) {
+      auto *slot = std::get<I>(_columns) + _size;
+      // args is a tuple of forwarding references, every element is used once
+      _construct(slot, std::get<I>(std::move(args)));
+      try {
+        _construct_row<I + 1>(args);
+      } catch (...) {
+        _destroy(slot);
+        throw;
+      }
+    }
+  }
+
+  template <std::size_t... Is>
+  reference _row(std::size_t pos, std::index_sequence<Is...>) {
+    return reference(std::get<Is>(_columns)[pos]...);
+  }
+
+  template <std::size_t... Is>
+  const_reference _row(std::size_t pos, std::index_sequence<Is...>) const {
+    return const_reference(std::get<Is>(_columns)[pos]...);
+  }
+
+  template <std::size_t... Is>
+  void _copy_rows(const BasicSoAVector &other, std::index_sequence<Is...>) {
+    for (std::size_t i = 0; i < other._size; ++i) {
+      emplace_back(std::get<Is>(other._columns)[i]...);
+    }
+  }
+
+  void _release() {
+    if (_raw == nullptr)
+      return;
+    _destroy_all(std::index_sequence_for<Ts...>{});
+    alloc_traits::deallocate(_alloc, _raw, _raw_bytes);
+    _raw = nullptr;
+    _raw_bytes = 0;
+    _columns = {};
+    _size = 0;
+    _capacity = 0;
+  }
+
+public:
+  BasicSoAVector() noexcept(noexcept(Allocator()))
+      : BasicSoAVector(Allocator()) {}
+
+  explicit BasicSoAVector(const allocator_type &alloc) noexcept
+      : _alloc{alloc} {}
+
+  BasicSoAVector(std::initializer_list<value_type> init,
+                 const allocator_type &alloc = Allocator())
+      : _alloc{alloc} {
+    reserve(init.size());
+    for (const auto &row : init) {
+      push_back(row);
+    }
+  }
+
+  BasicSoAVector(const BasicSoAVector &other)
+      : _alloc{alloc_traits::select_on_container_copy_construction(
+            other._alloc)} {
+    reserve(other._size);
+    _copy_rows(other, std::index_sequence_for<Ts...>{});
+  }
+
+  BasicSoAVector(BasicSoAVector &&other) noexcept
+      : _alloc{std::move(other._alloc)},
+        _raw{std::exchange(other._raw, nullptr)},
+        _raw_bytes{std::exchange(other._raw_bytes, 0)},
+        _columns{std::exchange(other._columns, {})},
+        _size{std::exchange(other._size, 0)},
+        _capacity{std::exchange(other._capacity, 0)} {}
+
+  BasicSoAVector &operator=(BasicSoAVector other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~BasicSoAVector() { _release(); }
+
+  void swap(BasicSoAVector &other) noexcept {
+    using std::swap;
+    swap(_raw, other._raw);
+    swap(_raw_bytes, other._raw_bytes);
+    swap(_columns, other._columns);
+    swap(_size, other._size);
+    swap(_capacity, other._capacity);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(_alloc, other._alloc);
+    }
+  }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+  /*
+   * Element access
+   */
+
+  reference operator[](std::size_t pos) {
+    return _row(pos, std::index_sequence_for<Ts...>{});
+  }
+
+  const_reference operator[](std::size_t pos) const {
+    return _row(pos, std::index_sequence_for<Ts...>{});
+  }
+
+  reference at(std::size_t pos) {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "soa_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return (*this)[pos];
+  }
+
+  const_reference at(std::size_t pos) const {
+    if (pos >= _size) {
+      throw std::out_of_range(std::format(
+          "soa_vector::range_check pos: {} >= size(): {}", pos, _size));
+    }
+    return (*this)[pos];
+  }
+
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+
+  reference back() { return (*this)[_size - 1]; }
+  const_reference back() const { return (*this)[_size - 1]; }
+
+  /*
+   * Columns - contiguous, 64 byte aligned, valid until the next reallocation
+   */
+
+  template <std::size_t I>
+  std::span<column_type<I>> column() {
+    return std::span<column_type<I>>(std::get<I>(_columns), _size);
+  }
+
+  template <std::size_t I>
+  std::span<const column_type<I>> column() const {
+    return std::span<const column_type<I>>(std::get<I>(_columns), _size);
+  }
+
+  template <std::size_t I>
+  column_type<I> *data() {
+    return std::get<I>(_columns);
+  }
+
+  template <std::size_t I>
+  const column_type<I> *data() const {
+    return std::get<I>(_columns);
+  }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, static_cast<difference_type>(_size)); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const {
+    return const_iterator(this, static_cast<difference_type>(_size));
+  }
+
+  const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cend() const noexcept {
+    return const_iterator(this, static_cast<difference_type>(_size));
+  }
+
+  /*
+   * Capacity
+   */
+
+  bool empty() const { return _size == 0; }
+
+  std::size_t size() const { return _size; }
+
+  std::size_t capacity() const { return _capacity; }
+
+  std::size_t max_size() const {
+    return alloc_traits::max_size(_alloc) / (sizeof(Ts) + ...);
+  }
+
+  void reserve(size_type new_cap) {
+    if (new_cap <= _capacity)
+      return;
+    if (new_cap >= max_size())
+      throw std::length_error(
+          std::format("{}: Size is too big for SoAVector", new_cap));
+
+    std::size_t new_bytes = _bytes_for(new_cap);
+    std::byte *new_raw = alloc_traits::allocate(_alloc, new_bytes);
+    auto new_columns = _carve(new_raw, new_bytes, new_cap);
+
+    try {
+      _relocate<0>(new_columns);
+    } catch (...) {
+      alloc_traits::deallocate(_alloc, new_raw, new_bytes);
+      throw;
+    }
+
+    std::size_t size = _size;
+    _release();
+
+    _raw = new_raw;
+    _raw_bytes = new_bytes;
+    _columns = new_columns;
+    _size = size;
+    _capacity = new_cap;
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void clear() noexcept {
+    _destroy_all(std::index_sequence_for<Ts...>{});
+    _size = 0;
+  }
+
+  // one argument per column
+  template <typename... Args>
+    requires(sizeof...(Args) == sizeof...(Ts))
+  reference emplace_back(Args &&...args) {
+    if (_size == _capacity) {
+      reserve(std::max<std::size_t>(2, _capacity * 2));
+    }
+    auto forwarded = std::forward_as_tuple(std::forward<Args>(args)...);
+    _construct_row<0>(forwarded);
+    _size++;
+    return back();
+  }
+
+  void push_back(const value_type &row) {
+    std::apply([this](const Ts &...fields) { emplace_back(fields...); }, row);
+  }
+
+  void push_back(value_type &&row) {
+    std::apply([this](Ts &...fields) { emplace_back(std::move(fields)...); },
+               row);
+  }
+
+  void pop_back() {
+    if (_size == 0)
+      return;
+    --_size;
+    std::apply([this](Ts *...columns) { (_destroy(columns + _size), ...); },
+               _columns);
+  }
+};
+
+template <typename... Ts>
+using SoAVector = BasicSoAVector<rwstd::Allocator<std::byte>, Ts...>;
+
+} // namespace rwstd
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace rwstd {
+
+namespace detail {
+
+constexpr std::uint64_t static_mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+// two independent multiplies and a fold - weaker than static_mix, but the
+// perfect hash search only needs the key set at hand to spread, and a bad
+// seed is simply retried
+constexpr std::uint64_t static_fold(std::uint64_t a, std::uint64_t b) {
+  std::uint64_t h = a * 0x9e3779b97f4a7c15ull + b * 0xc2b2ae3d27d4eb4full;
+  return h ^ (h >> 29);
+}
+
+// little endian loads, byte by byte during constant evaluation; a big
+// endian host swaps at run time so lookups hash like the table was built
+constexpr std::uint64_t static_load(const char *p, std::size_t bytes) {
+  if consteval {
+    std::uint64_t word = 0;
+    for (std::size_t j = 0; j < bytes; ++j)
+      word |= std::uint64_t{static_cast<unsigned char>(p[j])} << (8 * j);
+    return word;
+  } else {
+    if (bytes == 8) {
+      std::uint64_t word;
+      std::memcpy(&word, p, 8);
+      if constexpr (std::endian::native == std::endian::big)
+        word = std::byteswap(word);
+      return word;
+    }
+    std::uint32_t word;
+    std::memcpy(&word, p, 4);
+    if constexpr (std::endian::native == std::endian::big)
+      word = std::byteswap(word);
+    return word;
+  }
+}
+
+// short keys (the common case for fixed tables) are two overlapping loads
+constexpr std::uint64_t static_hash(std::string_view s, std::uint64_t seed) {
+  const char *p = s.data();
+  std::size_t n = s.size();
+  seed ^= n * 0xff51afd7ed558ccdull;
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (n > 16) {
+    // full 16 byte blocks, then the last 16 bytes (overlapping if need be)
+    const char *last = p + n - 16;
+    for (; p < last; p += 16)
+      seed = static_fold(static_load(p, 8) ^ seed, static_load(p + 8, 8));
+    a = static_load(last, 8);
+    b = static_load(last + 8, 8);
+  } else if (n >= 8) {
+    a = static_load(p, 8);
+    b = static_load(p + n - 8, 8);
+  } else if (n >= 4) {
+    a = static_load(p, 4);
+    b = static_load(p + n - 4, 4);
+  } else if (n > 0) {
+    a = std::uint64_t{static_cast<unsigned char>(p[0])} << 16 |
+        std::uint64_t{static_cast<unsigned char>(p[n / 2])} << 8 |
+        std::uint64_t{static_cast<unsigned char>(p[n - 1])};
+  }
+  return static_fold(a ^ seed, b ^ (seed >> 32));
+}
+
+template <typename Key>
+  requires std::integral<Key> || std::is_enum_v<Key>
+constexpr std::uint64_t static_hash(Key key, std::uint64_t seed) {
+  if constexpr (std::is_enum_v<Key>) {
+    return static_fold(
+        static_cast<std::uint64_t>(std::to_underlying(key)) ^ seed, seed);
+  } else {
+    return static_fold(static_cast<std::uint64_t>(key) ^ seed, seed);
+  }
+}
+
+constexpr std::uint64_t static_reduce(std::uint64_t h, std::uint64_t range) {
+  return ((h >> 32) * range) >> 32;
+}
+
+} // namespace detail
+
+template <typename Key>
+concept StaticMapKey = std::same_as<Key, std::string_view> ||
+                       std::integral<Key> || std::is_enum_v<Key>;
+
+/*
+ * Fixed key set map whose perfect hash is searched during constant
+ * evaluation:
+ *
+ *   constexpr auto methods = rwstd::make_static_map<std::string_view, int>(
+ *       {{"GET", 1}, {"PUT", 2}, {"POST", 3}});
+ *   static_assert(methods.at("PUT") == 2);
+ *
+ * Keys are split into buckets of about four; each bucket gets a pilot that
+ * moves its keys to free slots of a power of two table (at most 2/3 full), so
+ * a lookup is one hash of the key, a pilot and slot load, and a single key
+ * compare. Entries stay in definition order for iteration. Duplicate keys
+ * fail to compile.
+ */
+template <StaticMapKey Key, typename T, std::size_t N>
+class StaticMap {
+  static_assert(N > 0, "StaticMap needs at least one entry");
+
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = std::size_t;
+  using const_iterator = const value_type *;
+  using iterator = const_iterator;
+
+  static constexpr std::size_t bucket_count = N / 4 + 1;
+  static constexpr std::size_t table_size = std::bit_ceil(N + N / 2 + 1);
+
+private:
+  // smallest index type that still has room for the empty marker
+  using _index_type = std::conditional_t<
+      (N < 0xff), std::uint8_t,
+      std::conditional_t<(N < 0xffff), std::uint16_t, std::uint32_t>>;
+  static constexpr _index_type _empty = static_cast<_index_type>(N);
+
+  static constexpr std::size_t _max_pilot_tries = std::size_t{1} << 16;
+  static constexpr std::uint64_t _max_seeds = 16;
+
+  std::array<value_type, N> _items{};
+  // per bucket displacement, stored pre-mixed so a lookup needs one multiply
+  std::array<std::uint64_t, bucket_count> _pilots{};
+  std::array<_index_type, table_size> _slots{};
+  std::uint64_t _seed = 0;
+
+  static constexpr int _table_bits = std::countr_zero(table_size);
+
+  static constexpr std::size_t _slot_of(std::uint64_t h,
+                                        std::uint64_t displacement) {
+    if constexpr (_table_bits == 0) {
+      return 0;
+    } else {
+      return static_cast<std::size_t>(((h ^ displacement) *
+                                       0x9e3779b97f4a7c15ull) >>
+                                      (64 - _table_bits));
+    }
+  }
+
+  constexpr bool _try_build(std::uint64_t seed) {
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::size_t, N> bucket_of{};
+    std::array<std::size_t, bucket_count + 1> start{};
+    for (std::size_t i = 0; i < N; ++i) {
+      hashes[i] = detail::static_hash(_items[i].first, seed);
+      bucket_of[i] = static_cast<std::size_t>(
+          detail::static_reduce(hashes[i], bucket_count));
+      start[bucket_of[i] + 1]++;
+    }
+    for (std::size_t b = 0; b < bucket_count; ++b)
+      start[b + 1] += start[b];
+
+    // item indices grouped by bucket
+    std::array<std::size_t, N> members{};
+    {
+      std::array<std::size_t, bucket_count + 1> fill = start;
+      for (std::size_t i = 0; i < N; ++i)
+        members[fill[bucket_of[i]]++] = i;
+    }
+
+    // biggest buckets first, while the table is still empty
+    std::array<std::size_t, bucket_count> order{};
+    for (std::size_t b = 0; b < bucket_count; ++b)
+      order[b] = b;
+    auto size_of = [&](std::size_t b) { return start[b + 1] - start[b]; };
+    std::sort(order.begin(), order.end(), [&](std::size_t l, std::size_t r) {
+      return size_of(l) != size_of(r) ? size_of(l) > size_of(r) : l < r;
+    });
+
+    _slots.fill(_empty);
+    for (std::size_t b : order) {
+      if (size_of(b) == 0)
+        break;
+      bool placed = false;
+      for (std::size_t pilot = 0; pilot < _max_pilot_tries && !placed;
+           ++pilot) {
+        std::uint64_t p64 = detail::static_mix(pilot + 1);
+        std::size_t k = start[b];
+        for (; k < start[b + 1]; ++k) {
+          std::size_t slot = _slot_of(hashes[members[k]], p64);
+          if (_slots[slot] != _empty)
+            break;
+          _slots[slot] = static_cast<_index_type>(members[k]);
+        }
+        placed = k == start[b + 1];
+        if (placed) {
+          _pilots[b] = p64;
+        } else {
+          // undo the keys of this bucket that did fit
+          for (std::size_t u = start[b]; u < k; ++u)
+            _slots[_slot_of(hashes[members[u]], p64)] = _empty;
+        }
+      }
+      if (!placed)
+        return false;
+    }
+    _seed = seed;
+    return true;
+  }
+
+  static constexpr bool _equal(const Key &a, const Key &b) { return a == b; }
+
+public:
+  consteval explicit StaticMap(const std::array<value_type, N> &items)
+      : _items{items} {
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = i + 1; j < N; ++j) {
+        if (_equal(_items[i].first, _items[j].first))
+          throw std::invalid_argument("StaticMap: duplicate key");
+      }
+    }
+    for (std::uint64_t attempt = 0; attempt < _max_seeds; ++attempt) {
+      if (_try_build(detail::static_mix(attempt + 1)))
+        return;
+    }
+    throw std::invalid_argument("StaticMap: no perfect hash found");
+  }
+
+  consteval explicit StaticMap(const value_type (&items)[N])
+      : StaticMap(std::to_array(items)) {}
+
+  /*
+   * Lookup
+   */
+
+  constexpr const_iterator find(const Key &key) const {
+    std::uint64_t h = detail::static_hash(key, _seed);
+    std::uint64_t displacement = _pilots[static_cast<std::size_t>(
+        detail::static_reduce(h, bucket_count))];
+    _index_type idx = _slots[_slot_of(h, displacement)];
+    if (idx != _empty && _equal(_items[idx].first, key))
+      return _items.data() + idx;
+    return end();
+  }
+
+  constexpr bool contains(const Key &key) const { return find(key) != end(); }
+
+  constexpr size_type count(const Key &key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  constexpr const T &at(const Key &key) const {
+    const_iterator it = find(key);
+    if (it == end())
+      throw std::out_of_range("StaticMap::at: key not found");
+    return it->second;
+  }
+
+  // mapped value, or fallback when the key is absent
+  constexpr T value_or(const Key &key, T fallback) const {
+    const_iterator it = find(key);
+    return it == end() ? fallback : it->second;
+  }
+
+  /*
+   * Iterators - definition order
+   */
+
+  constexpr const_iterator begin() const { return _items.data(); }
+  constexpr const_iterator end() const { return _items.data() + N; }
+
+  constexpr const_iterator cbegin() const { return begin(); }
+  constexpr const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  constexpr bool empty() const { return false; }
+
+  constexpr size_type size() const { return N; }
+};
+
+template <StaticMapKey Key, typename T, std::size_t N>
+consteval StaticMap<Key, T, N>
+make_static_map(const std::pair<Key, T> (&items)[N]) {
+  return StaticMap<Key, T, N>(items);
+}
+
+template <StaticMapKey Key, typename T, std::size_t N>
+consteval StaticMap<Key, T, N>
+make_static_map(const std::array<std::pair<Key, T>, N> &items) {
+  return StaticMap<Key, T, N>(items);
+}
+
+} // namespace rwstd
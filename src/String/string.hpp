@@ -0,0 +1,489 @@
+#pragma once
+
+#include "Allocator/allocator.hpp"
+#include "Hash/hash.hpp"
+#include "Iterator/normal_iterator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace rwstd {
+
+namespace detail {
+
+// lazily filled, 0 means not computed yet; relaxed atomics so concurrent
+// readers of one const string don't race on the fill
+struct StringHashCache {
+  mutable std::atomic<std::size_t> value{0};
+
+  StringHashCache() = default;
+  StringHashCache(const StringHashCache &other)
+      : value{other.value.load(std::memory_order_relaxed)} {}
+  StringHashCache &operator=(const StringHashCache &other) {
+    value.store(other.value.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    return *this;
+  }
+};
+
+struct NoStringHashCache {};
+
+} // namespace detail
+
+/*
+ * 24 byte string with the small string optimization: up to 23 chars live
+ * inline, the last byte holding 23 - size, which doubles as the terminator
+ * when all 23 are used. Longer strings keep {pointer, size, capacity} in
+ * the same bytes with the top bit of the capacity (the last byte on a little
+ * endian machine) marking them as heap allocated.
+ *
+ * Inline strings keep their unused bytes zeroed, so two of them are equal
+ * exactly when their 24 bytes are; otherwise equality checks the size and
+ * the first eight bytes before falling back to memcmp. With CacheHash the
+ * hash is computed once and kept until the string is modified, making
+ * rehashes free and letting unequal hashes short-circuit equality. Any
+ * non-const access (operator[], data(), begin(), ...) counts as a
+ * modification.
+ */
+template <typename Allocator = rwstd::Allocator<char>, bool CacheHash = false>
+class BasicString {
+  static_assert(std::endian::native == std::endian::little,
+                "BasicString: the heap flag overlaps the capacity's top byte");
+
+public:
+  using alloc_traits = std::allocator_traits<Allocator>;
+  typedef Allocator allocator_type;
+  typedef char value_type;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef char &reference;
+  typedef const char &const_reference;
+  typedef char *pointer;
+  typedef const char *const_pointer;
+  typedef rwstd::NormalIterator<char *, BasicString> iterator;
+  typedef rwstd::NormalIterator<const char *, BasicString> const_iterator;
+
+  static constexpr size_type small_capacity = 23;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  static constexpr unsigned char _heap_flag = 0x80;
+  static constexpr size_type _capacity_mask = (size_type{1} << 56) - 1;
+
+  alignas(8) char _rep[24];
+  [[no_unique_address]] allocator_type _alloc;
+  [[no_unique_address]] std::conditional_t<CacheHash, detail::StringHashCache,
+                                           detail::NoStringHashCache>
+      _hash;
+
+  bool _is_heap() const {
+    return static_cast<unsigned char>(_rep[23]) & _heap_flag;
+  }
+
+  char *_heap_data() const {
+    char *data;
+    std::memcpy(&data, _rep, sizeof(data));
+    return data;
+  }
+
+  size_type _heap_size() const {
+    size_type size;
+    std::memcpy(&size, _rep + 8, sizeof(size));
+    return size;
+  }
+
+  size_type _heap_capacity() const {
+    size_type word;
+    std::memcpy(&word, _rep + 16, sizeof(word));
+    return word & _capacity_mask;
+  }
+
+  void _set_heap(char *data, size_type size, size_type capacity) {
+    size_type word = capacity | (size_type{_heap_flag} << 56);
+    std::memcpy(_rep, &data, sizeof(data));
+    std::memcpy(_rep + 8, &size, sizeof(size));
+    std::memcpy(_rep + 16, &word, sizeof(word));
+  }
+
+  // bytes past the end of an inline string are already zero
+  void _set_size(size_type size) {
+    if (_is_heap()) {
+      std::memcpy(_rep + 8, &size, sizeof(size));
+      _heap_data()[size] = '\0';
+    } else {
+      _rep[23] = static_cast<char>(small_capacity - size);
+    }
+  }
+
+  void _set_empty() {
+    std::memset(_rep, 0, sizeof(_rep));
+    _rep[23] = static_cast<char>(small_capacity);
+  }
+
+  void _invalidate() {
+    if constexpr (CacheHash)
+      _hash.value.store(0, std::memory_order_relaxed);
+  }
+
+  char *_allocate(size_type capacity) {
+    if (capacity > _capacity_mask - 1)
+      throw std::length_error("BasicString: too long");
+    return alloc_traits::allocate(_alloc, capacity + 1);
+  }
+
+  void _release() {
+    if (_is_heap())
+      alloc_traits::deallocate(_alloc, _heap_data(), _heap_capacity() + 1);
+  }
+
+  void _init(const char *s, size_type n) {
+    if (n <= small_capacity) {
+      _set_empty();
+      std::memcpy(_rep, s, n);
+      _set_size(n);
+    } else {
+      char *data = _allocate(n);
+      std::memcpy(data, s, n);
+      data[n] = '\0';
+      _set_heap(data, n, n);
+    }
+  }
+
+  // moves the contents to a heap buffer of the given capacity; s, if given,
+  // is appended on the way so it may point into the old buffer
+  void _reallocate(size_type capacity, const char *s = nullptr,
+                   size_type n = 0) {
+    size_type size = this->size();
+    char *data = _allocate(capacity);
+    std::memcpy(data, this->data(), size);
+    if (n != 0)
+      std::memcpy(data + size, s, n);
+    data[size + n] = '\0';
+    _release();
+    _set_heap(data, size + n, capacity);
+  }
+
+  size_type _grown(size_type needed) const {
+    return std::max(needed, capacity() * 2);
+  }
+
+  // equal sizes, compares the bytes starting with the first word
+  static bool _same_bytes(const char *a, const char *b, size_type n) {
+    if (n >= 8) {
+      std::uint64_t wa;
+      std::uint64_t wb;
+      std::memcpy(&wa, a, 8);
+      std::memcpy(&wb, b, 8);
+      return wa == wb && std::memcmp(a + 8, b + 8, n - 8) == 0;
+    }
+    return std::memcmp(a, b, n) == 0;
+  }
+
+public:
+  BasicString() noexcept(noexcept(Allocator())) : BasicString(Allocator()) {}
+
+  explicit BasicString(const allocator_type &alloc) noexcept : _alloc{alloc} {
+    _set_empty();
+  }
+
+  BasicString(const char *s, size_type n,
+              const allocator_type &alloc = Allocator())
+      : _alloc{alloc} {
+    _init(s, n);
+  }
+
+  BasicString(const char *s, const allocator_type &alloc = Allocator())
+      : BasicString(s, std::strlen(s), alloc) {}
+
+  explicit BasicString(std::string_view view,
+                       const allocator_type &alloc = Allocator())
+      : BasicString(view.data(), view.size(), alloc) {}
+
+  BasicString(size_type n, char c, const allocator_type &alloc = Allocator())
+      : BasicString(alloc) {
+    resize(n, c);
+  }
+
+  BasicString(const BasicString &other)
+      : _alloc{alloc_traits::select_on_container_copy_construction(
+            other._alloc)},
+        _hash{other._hash} {
+    if (other._is_heap())
+      _init(other.data(), other.size());
+    else
+      std::memcpy(_rep, other._rep, sizeof(_rep));
+  }
+
+  BasicString(BasicString &&other) noexcept
+      : _alloc{std::move(other._alloc)}, _hash{other._hash} {
+    std::memcpy(_rep, other._rep, sizeof(_rep));
+    other._set_empty();
+    other._invalidate();
+  }
+
+  BasicString &operator=(BasicString other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~BasicString() { _release(); }
+
+  void swap(BasicString &other) noexcept {
+    char tmp[sizeof(_rep)];
+    std::memcpy(tmp, _rep, sizeof(_rep));
+    std::memcpy(_rep, other._rep, sizeof(_rep));
+    std::memcpy(other._rep, tmp, sizeof(_rep));
+    std::swap(_alloc, other._alloc);
+    std::swap(_hash, other._hash);
+  }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+  /*
+   * Element access
+   */
+
+  const char *data() const noexcept {
+    return _is_heap() ? _heap_data() : _rep;
+  }
+
+  char *data() noexcept {
+    _invalidate();
+    return _is_heap() ? _heap_data() : _rep;
+  }
+
+  const char *c_str() const noexcept { return data(); }
+
+  char &operator[](size_type pos) { return data()[pos]; }
+  const char &operator[](size_type pos) const { return data()[pos]; }
+
+  char &at(size_type pos) {
+    if (pos >= size())
+      throw std::out_of_range("BasicString: index out of range");
+    return data()[pos];
+  }
+
+  const char &at(size_type pos) const {
+    if (pos >= size())
+      throw std::out_of_range("BasicString: index out of range");
+    return data()[pos];
+  }
+
+  char &front() { return data()[0]; }
+  const char &front() const { return data()[0]; }
+  char &back() { return data()[size() - 1]; }
+  const char &back() const { return data()[size() - 1]; }
+
+  std::string_view view() const noexcept { return {data(), size()}; }
+
+  operator std::string_view() const noexcept { return view(); }
+
+  /*
+   * Iterators
+   */
+
+  iterator begin() { return iterator(data()); }
+  iterator end() { return iterator(data() + size()); }
+  const_iterator begin() const { return const_iterator(data()); }
+  const_iterator end() const { return const_iterator(data() + size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  /*
+   * Capacity
+   */
+
+  size_type size() const noexcept {
+    return _is_heap() ? _heap_size()
+                      : small_capacity - static_cast<unsigned char>(_rep[23]);
+  }
+
+  size_type length() const noexcept { return size(); }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type capacity() const noexcept {
+    return _is_heap() ? _heap_capacity() : small_capacity;
+  }
+
+  // true while the characters live inside the object
+  bool is_inline() const noexcept { return !_is_heap(); }
+
+  void reserve(size_type capacity) {
+    if (capacity > this->capacity())
+      _reallocate(capacity);
+  }
+
+  // back inline if it fits, else down to an exact heap buffer
+  void shrink_to_fit() {
+    if (!_is_heap())
+      return;
+    size_type size = _heap_size();
+    if (size <= small_capacity) {
+      char *heap = _heap_data();
+      size_type capacity = _heap_capacity();
+      _set_empty();
+      std::memcpy(_rep, heap, size);
+      _set_size(size);
+      alloc_traits::deallocate(_alloc, heap, capacity + 1);
+    } else if (size < _heap_capacity()) {
+      _reallocate(size);
+    }
+  }
+
+  /*
+   * Modifiers
+   */
+
+  void clear() noexcept { resize(0); }
+
+  BasicString &append(const char *s, size_type n) {
+    _invalidate();
+    size_type size = this->size();
+    if (size + n > capacity()) {
+      _reallocate(_grown(size + n), s, n);
+      return *this;
+    }
+    std::memmove(data() + size, s, n);
+    _set_size(size + n);
+    return *this;
+  }
+
+  BasicString &append(std::string_view view) {
+    return append(view.data(), view.size());
+  }
+
+  BasicString &operator+=(std::string_view view) { return append(view); }
+
+  BasicString &operator+=(char c) {
+    push_back(c);
+    return *this;
+  }
+
+  void push_back(char c) {
+    _invalidate();
+    size_type size = this->size();
+    if (size == capacity())
+      _reallocate(_grown(size + 1));
+    data()[size] = c;
+    _set_size(size + 1);
+  }
+
+  void pop_back() { resize(size() - 1); }
+
+  void resize(size_type n, char c = '\0') {
+    _invalidate();
+    size_type size = this->size();
+    if (n > size) {
+      if (n > capacity())
+        _reallocate(_grown(n));
+      std::memset(data() + size, c, n - size);
+    } else if (!_is_heap()) {
+      std::memset(_rep + n, 0, size - n);
+    }
+    _set_size(n);
+  }
+
+  friend BasicString operator+(BasicString lhs, std::string_view rhs) {
+    lhs.append(rhs);
+    return lhs;
+  }
+
+  /*
+   * Hashing and comparison
+   */
+
+  // rwstd::hash::hash_bytes of the characters, the same value
+  // rwstd::hash::Hash gives a std::string with these contents
+  std::size_t hash() const noexcept {
+    if constexpr (CacheHash) {
+      std::size_t h = _hash.value.load(std::memory_order_relaxed);
+      if (h == 0) {
+        h = static_cast<std::size_t>(hash::hash_bytes(data(), size()));
+        _hash.value.store(h, std::memory_order_relaxed);
+      }
+      return h;
+    } else {
+      return static_cast<std::size_t>(hash::hash_bytes(data(), size()));
+    }
+  }
+
+  friend bool operator==(const BasicString &a, const BasicString &b) noexcept {
+    if (!a._is_heap() && !b._is_heap())
+      return std::memcmp(a._rep, b._rep, sizeof(_rep)) == 0;
+    if constexpr (CacheHash) {
+      std::size_t ha = a._hash.value.load(std::memory_order_relaxed);
+      std::size_t hb = b._hash.value.load(std::memory_order_relaxed);
+      if (ha != 0 && hb != 0 && ha != hb)
+        return false;
+    }
+    size_type n = a.size();
+    return n == b.size() && _same_bytes(a.data(), b.data(), n);
+  }
+
+  friend bool operator==(const BasicString &a, std::string_view b) noexcept {
+    size_type n = a.size();
+    return n == b.size() && _same_bytes(a.data(), b.data(), n);
+  }
+
+  friend bool operator==(const BasicString &a, const char *b) noexcept {
+    return a == std::string_view(b);
+  }
+
+  friend std::strong_ordering operator<=>(const BasicString &a,
+                                          const BasicString &b) noexcept {
+    return a.view() <=> b.view();
+  }
+
+  friend std::strong_ordering operator<=>(const BasicString &a,
+                                          std::string_view b) noexcept {
+    return a.view() <=> b;
+  }
+
+  friend std::strong_ordering operator<=>(const BasicString &a,
+                                          const char *b) noexcept {
+    return a.view() <=> std::string_view(b);
+  }
+};
+
+using String = BasicString<>;
+using HashedString = BasicString<rwstd::Allocator<char>, true>;
+
+/*
+ * Transparent hash for maps keyed by BasicString: strings use their own
+ * (possibly cached) hash, string_view, std::string and const char * hash
+ * the same characters to the same value, so paired with std::equal_to<>
+ * they can be looked up without building a key.
+ */
+struct StringHash {
+  using is_transparent = void;
+
+  template <typename Allocator, bool CacheHash>
+  std::size_t
+  operator()(const BasicString<Allocator, CacheHash> &s) const noexcept {
+    return s.hash();
+  }
+
+  std::size_t operator()(std::string_view view) const noexcept {
+    return static_cast<std::size_t>(hash::hash_bytes(view.data(), view.size()));
+  }
+};
+
+} // namespace rwstd
+
+template <typename Allocator, bool CacheHash>
+struct std::hash<rwstd::BasicString<Allocator, CacheHash>> {
+  std::size_t
+  operator()(const rwstd::BasicString<Allocator, CacheHash> &s) const noexcept {
+    return s.hash();
+  }
+};
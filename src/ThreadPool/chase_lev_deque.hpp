@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace rwstd {
+
+/*
+ * Chase-Lev work stealing deque (the C11 formulation from Le, Pop, Cohen and
+ * Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+ * Models").
+ *
+ * Only the owning thread may call push/pop, which work on the bottom end like
+ * a stack. Any thread may call steal, which takes from the top end. T has to be
+ * trivially copyable since slots are read racily - in practice it is a pointer
+ * to a task.
+ */
+template <typename T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ChaseLevDeque only stores trivially copyable values");
+
+private:
+  struct Array {
+    std::int64_t capacity;
+    std::int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+
+    explicit Array(std::int64_t cap)
+        : capacity{cap}, mask{cap - 1},
+          slots{new std::atomic<T>[static_cast<std::size_t>(cap)]} {}
+
+    T get(std::int64_t i) const {
+      return slots[static_cast<std::size_t>(i & mask)].load(
+          std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t i, T value) {
+      slots[static_cast<std::size_t>(i & mask)].store(
+          value, std::memory_order_relaxed);
+    }
+  };
+
+  // top and bottom are hammered by different threads, keep them apart
+  alignas(64) std::atomic<std::int64_t> _top{0};
+  alignas(64) std::atomic<std::int64_t> _bottom{0};
+  alignas(64) std::atomic<Array *> _array;
+
+  // thieves may still be reading an old array after we grow, so old arrays are
+  // only released when the deque itself goes away
+  std::vector<std::unique_ptr<Array>> _arrays;
+
+  Array *_grow(Array *old, std::int64_t bottom, std::int64_t top) {
+    auto bigger = std::make_unique<Array>(old->capacity * 2);
+    for (std::int64_t i = top; i < bottom; ++i) {
+      bigger->put(i, old->get(i));
+    }
+    Array *raw = bigger.get();
+    _arrays.push_back(std::move(bigger));
+    _array.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+public:
+  // capacity is rounded up to a power of two
+  explicit ChaseLevDeque(std::size_t capacity = 256) {
+    std::size_t cap = 1;
+    while (cap < capacity)
+      cap <<= 1;
+    _arrays.push_back(std::make_unique<Array>(static_cast<std::int64_t>(cap)));
+    _array.store(_arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  ChaseLevDeque(const ChaseLevDeque &) = delete;
+  ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+  // owner only
+  void push(T value) {
+    std::int64_t b = _bottom.load(std::memory_order_relaxed);
+    std::int64_t t = _top.load(std::memory_order_acquire);
+    Array *a = _array.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = _grow(a, b, t);
+    }
+    a->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // owner only
+  std::optional<T> pop() {
+    std::int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    Array *a = _array.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = _top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // already empty
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    std::optional<T> value = a->get(b);
+    if (t == b) {
+      // last element - race the thieves for it
+      if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        value = std::nullopt;
+      }
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  // any thread
+  std::optional<T> steal() {
+    std::int64_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = _bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+      return std::nullopt;
+
+    Array *a = _array.load(std::memory_order_acquire);
+    T value = a->get(t);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      // lost against another thief or the owner
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // only a snapshot when other threads are active
+  std::size_t size() const {
+    std::int64_t b = _bottom.load(std::memory_order_relaxed);
+    std::int64_t t = _top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  std::size_t capacity() const {
+    return static_cast<std::size_t>(
+        _array.load(std::memory_order_relaxed)->capacity);
+  }
+};
+} // namespace rwstd
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "ThreadPool/chase_lev_deque.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rwstd {
+
+namespace detail {
+struct PoolTask {
+  virtual ~PoolTask() = default;
+  virtual void run() = 0;
+};
+
+template <typename F>
+struct PoolTaskImpl final : PoolTask {
+  F fn;
+
+  template <typename G>
+  explicit PoolTaskImpl(G &&g) : fn{std::forward<G>(g)} {}
+
+  void run() override { fn(); }
+};
+} // namespace detail
+
+/*
+ * Work stealing thread pool.
+ *
+ * Every worker owns a ChaseLevDeque. Tasks submitted from a worker go to the
+ * bottom of its own deque (LIFO, cache friendly for fork-join), tasks submitted
+ * from outside go to a shared injection queue. Idle workers first drain their
+ * own deque, then the injection queue, then steal from the top of a random
+ * victim's deque before finally going to sleep.
+ *
+ * Threads blocked in TaskGroup::wait help run tasks, so a pool of n workers
+ * gives n + 1 way parallelism to a waiting caller. A pool with zero workers is
+ * valid - everything then runs on the waiting thread.
+ */
+class ThreadPool {
+private:
+  struct Worker {
+    ChaseLevDeque<detail::PoolTask *> deque;
+    std::thread thread;
+  };
+
+  std::vector<std::unique_ptr<Worker>> _workers;
+
+  std::mutex _inject_mutex;
+  std::deque<detail::PoolTask *> _injected;
+  std::atomic<std::size_t> _injected_count{0};
+
+  // sleeping protocol: a worker snapshots _epoch before looking for work and
+  // only sleeps while it is unchanged, every push bumps it
+  std::mutex _sleep_mutex;
+  std::condition_variable _sleep_cv;
+  std::atomic<std::uint64_t> _epoch{0};
+  std::atomic<std::size_t> _sleeping{0};
+  std::atomic<bool> _stop{false};
+
+  inline static thread_local ThreadPool *_tls_pool = nullptr;
+  inline static thread_local std::size_t _tls_index = 0;
+
+  static constexpr std::size_t _spins_before_sleep = 64;
+
+  static std::size_t _random_index(std::size_t bound) {
+    // xorshift, one state per thread
+    thread_local std::uint64_t state =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) |
+        0x9e3779b97f4a7c15ull;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<std::size_t>(state % bound);
+  }
+
+  void _notify() {
+    _epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_seq_cst) > 0) {
+      std::lock_guard<std::mutex> lock(_sleep_mutex);
+      _sleep_cv.notify_one();
+    }
+  }
+
+  void _push(detail::PoolTask *task) {
+    if (_tls_pool == this) {
+      _workers[_tls_index]->deque.push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(_inject_mutex);
+      _injected.push_back(task);
+      _injected_count.fetch_add(1, std::memory_order_release);
+    }
+    _notify();
+  }
+
+  detail::PoolTask *_find_task() {
+    bool is_worker = _tls_pool == this;
+    if (is_worker) {
+      if (auto task = _workers[_tls_index]->deque.pop())
+        return *task;
+    }
+
+    if (_injected_count.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> lock(_inject_mutex);
+      if (!_injected.empty()) {
+        detail::PoolTask *task = _injected.front();
+        _injected.pop_front();
+        _injected_count.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+      }
+    }
+
+    std::size_t n = _workers.size();
+    if (n == 0)
+      return nullptr;
+    std::size_t start = _random_index(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      std::size_t victim = (start + i) % n;
+      if (is_worker && victim == _tls_index)
+        continue;
+      if (auto task = _workers[victim]->deque.steal())
+        return *task;
+    }
+    return nullptr;
+  }
+
+  // exceptions escaping a plain submitted task terminate, same as std::thread
+  static void _run(detail::PoolTask *task) noexcept {
+    std::unique_ptr<detail::PoolTask> owned{task};
+    owned->run();
+  }
+
+  void _worker_loop(std::size_t index) {
+    _tls_pool = this;
+    _tls_index = index;
+
+    std::size_t idle_spins = 0;
+    while (true) {
+      std::uint64_t seen = _epoch.load(std::memory_order_seq_cst);
+      if (detail::PoolTask *task = _find_task()) {
+        _run(task);
+        idle_spins = 0;
+        continue;
+      }
+
+      if (_stop.load(std::memory_order_acquire))
+        break;
+
+      if (++idle_spins < _spins_before_sleep) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(_sleep_mutex);
+      _sleeping.fetch_add(1, std::memory_order_seq_cst);
+      _sleep_cv.wait(lock, [&] {
+        return _stop.load(std::memory_order_acquire) ||
+               _epoch.load(std::memory_order_seq_cst) != seen;
+      });
+      _sleeping.fetch_sub(1, std::memory_order_seq_cst);
+      idle_spins = 0;
+    }
+
+    _tls_pool = nullptr;
+  }
+
+public:
+  explicit ThreadPool(std::size_t num_threads) {
+    _workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      _workers.push_back(std::make_unique<Worker>());
+    }
+    // start only once every deque exists, workers steal from each other
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      _workers[i]->thread = std::thread([this, i] { _worker_loop(i); });
+    }
+  }
+
+  ThreadPool()
+      : ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1) {}
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(_sleep_mutex);
+      _stop.store(true, std::memory_order_release);
+    }
+    _sleep_cv.notify_all();
+    for (auto &worker : _workers) {
+      worker->thread.join();
+    }
+
+    // anything pushed after the workers left still has to run, a TaskGroup
+    // could be waiting on it
+    while (detail::PoolTask *task = _find_task()) {
+      _run(task);
+    }
+  }
+
+  // shared pool sized so workers plus the waiting caller fill the machine
+  static ThreadPool &default_pool() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  // number of worker threads, not counting helping callers
+  std::size_t size() const noexcept { return _workers.size(); }
+
+  template <typename F>
+  void submit(F &&f) {
+    auto task = std::make_unique<detail::PoolTaskImpl<std::decay_t<F>>>(
+        std::forward<F>(f));
+    _push(task.get());
+    // a worker owns it now, and may already have run and deleted it
+    task.release();
+  }
+
+  template <typename F>
+  auto async(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    std::packaged_task<R()> task(std::forward<F>(f));
+    auto future = task.get_future();
+    submit(std::move(task));
+    return future;
+  }
+
+  // run one pending task on the calling thread, false if none was found
+  bool try_run_one() {
+    detail::PoolTask *task = _find_task();
+    if (task == nullptr)
+      return false;
+    _run(task);
+    return true;
+  }
+};
+
+/*
+ * Fork-join helper on top of ThreadPool. run() spawns a task, wait() blocks
+ * until all spawned tasks (including ones spawned by them) are done, running
+ * pool tasks on the calling thread in the meantime. The first exception thrown
+ * by a task is rethrown from wait().
+ */
+class TaskGroup {
+private:
+  ThreadPool &_pool;
+  std::atomic<std::size_t> _pending{0};
+  std::atomic<bool> _failed{false};
+  std::exception_ptr _error;
+
+  void _wait_for_pending() {
+    while (_pending.load(std::memory_order_acquire) != 0) {
+      if (!_pool.try_run_one())
+        std::this_thread::yield();
+    }
+  }
+
+public:
+  explicit TaskGroup(ThreadPool &pool) : _pool{pool} {}
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  // tasks hold a pointer to the group, never let them outlive it
+  ~TaskGroup() { _wait_for_pending(); }
+
+  template <typename F>
+  void run(F &&f) {
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    // a task that never got queued must not keep wait() spinning
+    try {
+      _pool.submit([this, fn = std::forward<F>(f)]() mutable {
+        try {
+          fn();
+        } catch (...) {
+          if (!_failed.exchange(true, std::memory_order_acq_rel)) {
+            _error = std::current_exception();
+          }
+        }
+        _pending.fetch_sub(1, std::memory_order_release);
+      });
+    } catch (...) {
+      _pending.fetch_sub(1, std::memory_order_release);
+      throw;
+    }
+  }
+
+  void wait() {
+    _wait_for_pending();
+    if (_error) {
+      std::exception_ptr error = std::exchange(_error, nullptr);
+      _failed.store(false, std::memory_order_relaxed);
+      std::rethrow_exception(error);
+    }
+  }
+};
+} // namespace rwstd
@@ -1,14 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace rwstd {
 
+namespace serialize {
+struct access;
+} // namespace serialize
+
 template <typename Key, typename T, typename Hash = std::hash<Key>,
           typename KeyEqual = std::equal_to<Key>,
           typename Allocator = std::allocator<std::pair<const Key, T>>>
@@ -37,21 +49,31 @@ private:
   };
 
 public:
+  template <bool Const>
   class UnorderedMapForwardIterator {
   public:
     using value_type = UnorderedMap::value_type;
     using difference_type = UnorderedMap::difference_type;
-    using pointer = UnorderedMap::value_type *;
-    using reference = UnorderedMap::reference;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<Const, const value_type &, value_type &>;
     using iterator_category = std::forward_iterator_tag;
+    using map_pointer =
+        std::conditional_t<Const, const UnorderedMap *, UnorderedMap *>;
 
     Node *node;
-    UnorderedMap *map;
+    map_pointer map;
 
     UnorderedMapForwardIterator() : node{nullptr}, map{nullptr} {}
-    UnorderedMapForwardIterator(Node *cur_node, UnorderedMap *cur_map)
+    UnorderedMapForwardIterator(Node *cur_node, map_pointer cur_map)
         : node{cur_node}, map{cur_map} {}
 
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    UnorderedMapForwardIterator(
+        const UnorderedMapForwardIterator<WasConst> &other)
+        : node{other.node}, map{other.map} {}
+
     reference operator*() const { return node->value; }
     pointer operator->() const { return &(node->value); }
 
@@ -65,6 +87,7 @@ public:
       for (size_t i = idx + 1; i < map->bucket_count(); ++i) {
         if (map->buckets[i] != nullptr) {
           node = map->buckets[i];
+          break;
         }
       }
       return *this;
@@ -76,26 +99,98 @@ public:
       return tmp;
     }
 
-    bool operator==(const UnorderedMapForwardIterator &rhs) {
+    template <bool RhsConst>
+    bool operator==(const UnorderedMapForwardIterator<RhsConst> &rhs) const {
       return node == rhs.node;
     }
+  };
+
+  using iterator = UnorderedMapForwardIterator<false>;
+  using const_iterator = UnorderedMapForwardIterator<true>;
+
+  // walks a single bucket's chain
+  template <bool Const>
+  class UnorderedMapLocalIterator {
+  public:
+    using value_type = UnorderedMap::value_type;
+    using difference_type = UnorderedMap::difference_type;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<Const, const value_type &, value_type &>;
+    using iterator_category = std::forward_iterator_tag;
+
+    Node *node;
+
+    UnorderedMapLocalIterator() : node{nullptr} {}
+    explicit UnorderedMapLocalIterator(Node *cur_node) : node{cur_node} {}
+
+    template <bool WasConst>
+      requires(Const && !WasConst)
+    UnorderedMapLocalIterator(const UnorderedMapLocalIterator<WasConst> &other)
+        : node{other.node} {}
+
+    reference operator*() const { return node->value; }
+    pointer operator->() const { return &(node->value); }
+
+    UnorderedMapLocalIterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    UnorderedMapLocalIterator operator++(int) {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+    }
 
-    bool operator!=(const UnorderedMapForwardIterator &rhs) {
-      return node != rhs.node;
+    template <bool RhsConst>
+    bool operator==(const UnorderedMapLocalIterator<RhsConst> &rhs) const {
+      return node == rhs.node;
     }
   };
 
-  using iterator = UnorderedMapForwardIterator;
-  using const_iterator = const UnorderedMapForwardIterator;
+  using local_iterator = UnorderedMapLocalIterator<false>;
+  using const_local_iterator = UnorderedMapLocalIterator<true>;
+
+  // a run of whole buckets, see split()
+  using range = std::ranges::subrange<iterator>;
+  using const_range = std::ranges::subrange<const_iterator>;
+
+#if defined(RWSTD_CONTAINER_STATS)
+  // built with RWSTD_CONTAINER_STATS (the CONTAINER_STATS cmake option),
+  // counted per instance and not carried over by copies, moves or swaps
+  struct stats_type {
+    size_t rehashes = 0;
+    // key searches by find, insert and emplace, and the nodes they compared
+    size_t lookups = 0;
+    size_t probes = 0;
+    // chain_lengths[i]: buckets holding i nodes, the last one i or more
+    std::array<size_t, 8> chain_lengths{};
+
+    double probes_per_lookup() const {
+      return lookups == 0 ? 0.0
+                          : static_cast<double>(probes) /
+                                static_cast<double>(lookups);
+    }
+  };
+#endif
 
 private:
   using node_alloc_type =
       std::allocator_traits<Allocator>::template rebind_alloc<Node>;
   using node_alloc_traits =
       std::allocator_traits<Allocator>::template rebind_traits<Node>;
+  using bucket_alloc_type =
+      std::allocator_traits<Allocator>::template rebind_alloc<Node *>;
+  using bucket_alloc_traits =
+      std::allocator_traits<Allocator>::template rebind_traits<Node *>;
 
   size_t _size = 0;
   float cur_load_factor = 1.0f;
+  // erase(key) shrinks the bucket array below this load, 0 never shrinks
+  float cur_min_load_factor = 0.0f;
+  // shrinking stops here, the bucket count of a default constructed map
+  static constexpr size_t _min_bucket_count = 11;
 
   Node **buckets;
   size_t number_of_buckets;
@@ -105,11 +200,87 @@ private:
   Allocator _value_alloc;
   node_alloc_type _node_alloc;
 
+#if defined(RWSTD_CONTAINER_STATS)
+  // lookups on a const map count too; concurrent readers may lose counts
+  // (load and store, no read-modify-write) but do not race
+  struct Counters {
+    std::atomic<size_t> rehashes{0};
+    std::atomic<size_t> lookups{0};
+    std::atomic<size_t> probes{0};
+  };
+  mutable Counters _counters;
+
+  static void _bump(std::atomic<size_t> &counter, size_t by = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + by,
+                  std::memory_order_relaxed);
+  }
+#endif
+
+  // reads and writes the bucket layout directly
+  friend struct serialize::access;
+
 private:
-  // initialise to nullptr
-  void _init_buckets() { buckets = new Node *[number_of_buckets](); }
+  // first bucket of each of k runs holding about the same number of
+  // occupied buckets, plus number_of_buckets at the end
+  std::vector<size_t> _split_points(size_t k) const {
+    if (k == 0)
+      throw std::invalid_argument("UnorderedMap: split into zero ranges");
+    size_t occupied = 0;
+    for (size_t i = 0; i < number_of_buckets; ++i)
+      occupied += buckets[i] != nullptr;
+
+    std::vector<size_t> points(k + 1, number_of_buckets);
+    size_t seen = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < number_of_buckets && next < k; ++i) {
+      if (buckets[i] == nullptr)
+        continue;
+      // bucket i opens every run whose share of occupied buckets starts here,
+      // rounding up leaves the empty runs at the end
+      while (next < k && (occupied * next + k - 1) / k <= seen)
+        points[next++] = i;
+      ++seen;
+    }
+    return points;
+  }
+
+  // the bucket array comes from the allocator too, all nullptr
+  Node **_allocate_buckets(size_t count) {
+    bucket_alloc_type alloc(_node_alloc);
+    Node **array = bucket_alloc_traits::allocate(alloc, count);
+    std::fill_n(array, count, nullptr);
+    return array;
+  }
+
+  void _deallocate_buckets(Node **array, size_t count) {
+    if (array == nullptr)
+      return;
+    bucket_alloc_type alloc(_node_alloc);
+    bucket_alloc_traits::deallocate(alloc, array, count);
+  }
 
-  size_t _hash_key(const Key &key) { return _hash(key) % number_of_buckets; }
+  void _init_buckets() { buckets = _allocate_buckets(number_of_buckets); }
+
+  // the node holding key in bucket idx, or nullptr
+  template <typename K>
+  Node *_find_in_bucket(size_t idx, const K &key) const {
+    Node *current = buckets[idx];
+#if defined(RWSTD_CONTAINER_STATS)
+    size_t probes = 0;
+    while (current && (++probes, !_equal(current->value.first, key)))
+      current = current->next;
+    _bump(_counters.lookups);
+    _bump(_counters.probes, probes);
+#else
+    while (current && !_equal(current->value.first, key))
+      current = current->next;
+#endif
+    return current;
+  }
+
+  size_t _hash_key(const Key &key) const {
+    return _hash(key) % number_of_buckets;
+  }
 
   template <typename Forward>
   void _insert_helper(Forward &&value) {
@@ -131,12 +302,50 @@ private:
     _size++;
   }
 
+  // down to half the maximum load, so the map has to grow twofold or shrink
+  // fourfold (at a minimum of max / 8) before its buckets change again;
+  // does nothing while the minimum is 0, the default
+  void _shrink_if_sparse() {
+    if (cur_min_load_factor <= 0.0f || number_of_buckets <= _min_bucket_count)
+      return;
+    if (static_cast<float>(_size) >=
+        static_cast<float>(number_of_buckets) * cur_min_load_factor)
+      return;
+    rehash(static_cast<size_t>(
+        std::ceil(static_cast<float>(_size) * 2.0f / cur_load_factor)));
+  }
+
+  // runs f(0) .. f(threads - 1), f(0) on the calling thread; the first
+  // exception is rethrown once every thread has finished
+  template <typename F>
+  static void _run_on_threads(size_t threads, F &&f) {
+    std::vector<std::exception_ptr> errors(threads);
+    auto guarded = [&](size_t t) {
+      try {
+        f(t);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t)
+      workers.emplace_back(guarded, t);
+    guarded(0);
+    for (auto &worker : workers)
+      worker.join();
+    for (auto &error : errors) {
+      if (error)
+        std::rethrow_exception(error);
+    }
+  }
+
 public:
   explicit UnorderedMap(size_type num_buckets, const Hash &hash = Hash(),
                         const key_equal &equal = key_equal(),
                         const Allocator &alloc = Allocator())
       : number_of_buckets{num_buckets}, _equal{equal}, _hash{hash},
-        _value_alloc{alloc} {
+        _value_alloc{alloc}, _node_alloc{alloc} {
     _init_buckets();
   }
 
@@ -150,12 +359,14 @@ public:
   }
 
   UnorderedMap(const UnorderedMap &other)
-      : _value_alloc{std::allocator_traits<
-            Allocator>::select_on_container_copy_construction()},
-        _node_alloc{std::allocator_traits<
-            node_alloc_type>::select_on_container_copy_construction()},
+      : cur_load_factor{other.cur_load_factor},
+        cur_min_load_factor{other.cur_min_load_factor},
         number_of_buckets{other.number_of_buckets}, _equal{other._equal},
-        _hash{other._hash} {
+        _hash{other._hash},
+        _value_alloc{alloc_traits::select_on_container_copy_construction(
+            other._value_alloc)},
+        _node_alloc{node_alloc_traits::select_on_container_copy_construction(
+            other._node_alloc)} {
     _init_buckets();
     for (size_t i = 0; i < other.number_of_buckets; ++i) {
       Node *current_bucket = other.buckets[i];
@@ -167,11 +378,12 @@ public:
   }
 
   UnorderedMap(UnorderedMap &&other) noexcept
-      : _value_alloc{std::move(other._value_alloc)},
-        _node_alloc{std::move(other._node_alloc)},
+      : _size{other._size}, cur_load_factor{other.cur_load_factor},
+        cur_min_load_factor{other.cur_min_load_factor}, buckets{other.buckets},
         number_of_buckets{other.number_of_buckets},
         _equal{std::move(other._equal)}, _hash{std::move(other._hash)},
-        buckets{other.buckets} {
+        _value_alloc{std::move(other._value_alloc)},
+        _node_alloc{std::move(other._node_alloc)} {
     other.buckets = nullptr;
     other.number_of_buckets = 0;
     other._size = 0;
@@ -184,7 +396,7 @@ public:
 
   ~UnorderedMap() {
     clear();
-    delete[] buckets;
+    _deallocate_buckets(buckets, number_of_buckets);
   }
 
   void clear() noexcept {
@@ -211,13 +423,8 @@ public:
 
   std::pair<iterator, bool> insert(const value_type &value) {
     size_t idx = _hash_key(value.first);
-    Node *current_bucket = buckets[idx];
-    while (current_bucket) {
-      if (_equal(current_bucket->value.first, value.first)) {
-        return {iterator(current_bucket), false};
-      }
-      current_bucket = current_bucket->next;
-    }
+    if (Node *found = _find_in_bucket(idx, value.first))
+      return {iterator(found, this), false};
 
     if (static_cast<float>(_size + 1) >
         static_cast<float>(number_of_buckets) * cur_load_factor) {
@@ -232,13 +439,8 @@ public:
 
   std::pair<iterator, bool> insert(value_type &&value) {
     size_t idx = _hash_key(value.first);
-    Node *current_bucket = buckets[idx];
-    while (current_bucket) {
-      if (_equal(current_bucket->value.first, value.first)) {
-        return {iterator(current_bucket, this), false};
-      }
-      current_bucket = current_bucket->next;
-    }
+    if (Node *found = _find_in_bucket(idx, value.first))
+      return {iterator(found, this), false};
 
     if (static_cast<float>(_size + 1) >
         static_cast<float>(number_of_buckets) * cur_load_factor) {
@@ -251,6 +453,109 @@ public:
     return {iterator{inserted_node, this}, true};
   }
 
+  /*
+   * Inserts [first, last) using up to `threads` threads (0 picks one per
+   * core). The bucket array is sized for every element up front, then
+   *   1. every thread hashes a slice of the input and counts how many of its
+   *      elements fall into each of `threads` contiguous bucket ranges,
+   *   2. a prefix sum over those counts lets every thread scatter the input
+   *      positions of its slice into one array grouped by bucket range,
+   *   3. thread t links the elements of bucket range t; no other thread
+   *      touches those buckets, so no locks are needed.
+   * Positions keep their input order inside a range, so as with insert()
+   * keys already in the map stay and otherwise the first occurrence wins.
+   *
+   * With more than one thread the allocator is called concurrently. If an
+   * element's construction throws, the elements linked so far stay.
+   */
+  template <std::random_access_iterator It>
+  void bulk_build(It first, It last, size_t threads = 0) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (threads == 0)
+      threads = std::max(std::thread::hardware_concurrency(), 1u);
+    // below a few thousand elements per thread spawning costs more than it
+    // saves
+    threads = std::clamp<size_t>(n / 4096, 1, threads);
+    reserve(_size + n);
+
+    if (threads == 1) {
+      for (It it = first; it != last; ++it)
+        emplace(*it);
+      return;
+    }
+
+    const size_t slice = (n + threads - 1) / threads;
+    std::vector<size_t> bucket_of(n);
+    // counts[t * threads + r]: elements of slice t that land in range r
+    std::vector<size_t> counts(threads * threads);
+    const size_t range_width = (number_of_buckets + threads - 1) / threads;
+    auto range_of = [range_width](size_t bucket) {
+      return bucket / range_width;
+    };
+
+    _run_on_threads(threads, [&](size_t t) {
+      size_t *count = &counts[t * threads];
+      for (size_t i = t * slice, end = std::min(n, i + slice); i < end; ++i) {
+        bucket_of[i] =
+            _hash_key((*(first + static_cast<difference_type>(i))).first);
+        ++count[range_of(bucket_of[i])];
+      }
+    });
+
+    // range r takes the slices' shares in slice order, ranges back to back
+    std::vector<size_t> range_begin(threads + 1);
+    size_t offset = 0;
+    for (size_t r = 0; r < threads; ++r) {
+      range_begin[r] = offset;
+      for (size_t t = 0; t < threads; ++t) {
+        size_t count = counts[t * threads + r];
+        counts[t * threads + r] = offset;
+        offset += count;
+      }
+    }
+    range_begin[threads] = offset;
+
+    std::vector<size_t> order(n);
+    _run_on_threads(threads, [&](size_t t) {
+      size_t *next = &counts[t * threads];
+      for (size_t i = t * slice, end = std::min(n, i + slice); i < end; ++i)
+        order[next[range_of(bucket_of[i])]++] = i;
+    });
+
+    std::vector<size_t> linked(threads);
+    try {
+      _run_on_threads(threads, [&](size_t r) {
+        for (size_t k = range_begin[r]; k < range_begin[r + 1]; ++k) {
+          size_t i = order[k];
+          auto &&value = *(first + static_cast<difference_type>(i));
+          Node **head = &buckets[bucket_of[i]];
+          Node *current = *head;
+          while (current && !_equal(current->value.first, value.first))
+            current = current->next;
+          if (current)
+            continue;
+
+          Node *node = node_alloc_traits::allocate(_node_alloc, 1);
+          try {
+            node_alloc_traits::construct(_node_alloc, node, value);
+          } catch (...) {
+            node_alloc_traits::deallocate(_node_alloc, node, 1);
+            throw;
+          }
+          node->next = *head;
+          *head = node;
+          ++linked[r];
+        }
+      });
+    } catch (...) {
+      for (size_t count : linked)
+        _size += count;
+      throw;
+    }
+    for (size_t count : linked)
+      _size += count;
+  }
+
   template <class... Args>
   std::pair<iterator, bool> emplace(Args &&...args) {
     Node *newNode = node_alloc_traits::allocate(_node_alloc, 1);
@@ -265,14 +570,10 @@ public:
 
     const key_type &key = newNode->value.first;
     size_t idx = _hash_key(key);
-    Node *current = buckets[idx];
-    while (current) {
-      if (_equal(current->value.first, newNode->value.first)) {
-        node_alloc_traits::destroy(_node_alloc, newNode);
-        node_alloc_traits::deallocate(_node_alloc, newNode, 1);
-        return {iterator(current, this), false};
-      }
-      current = current->next;
+    if (Node *found = _find_in_bucket(idx, key)) {
+      node_alloc_traits::destroy(_node_alloc, newNode);
+      node_alloc_traits::deallocate(_node_alloc, newNode, 1);
+      return {iterator(found, this), false};
     }
 
     if (static_cast<float>(_size + 1) >
@@ -287,6 +588,7 @@ public:
     return {iterator{newNode, this}, true};
   }
 
+  // never shrinks, the returned iterator stays valid for erase loops
   iterator erase(iterator pos) {
     if (pos == end())
       return end();
@@ -325,6 +627,7 @@ public:
         node_alloc_traits::deallocate(_node_alloc, cur_node, 1);
 
         _size--;
+        _shrink_if_sparse();
         return 1;
       }
 
@@ -341,13 +644,14 @@ public:
     swap(other._hash, this->_hash);
     swap(other._size, this->_size);
     swap(other.cur_load_factor, this->cur_load_factor);
+    swap(other.cur_min_load_factor, this->cur_min_load_factor);
 
-    if constexpr (alloc_traits::propogate_on_container_swap::value) {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
       swap(other._value_alloc, this->_value_alloc);
     }
 
-    if constexpr (node_alloc_traits::propogate_on_container_swap::value) {
-      swap(other._node_alloc, this->_value_alloc);
+    if constexpr (node_alloc_traits::propagate_on_container_swap::value) {
+      swap(other._node_alloc, this->_node_alloc);
     }
   }
 
@@ -358,35 +662,55 @@ public:
   }
 
   iterator find(const Key &key) {
-    size_t bucket_idx = _hash_key(key);
-    Node *current_bucket = buckets[bucket_idx];
+    Node *found = _find_in_bucket(_hash_key(key), key);
+    return found ? iterator(found, this) : end();
+  }
 
-    while (current_bucket) {
-      if (!_equal((current_bucket->value).first, key)) {
-        current_bucket = current_bucket->next;
-        continue;
-      }
-      return iterator(current_bucket, this);
-    }
+  const_iterator find(const Key &key) const {
+    Node *found = _find_in_bucket(_hash_key(key), key);
+    return found ? const_iterator(found, this) : end();
+  }
 
-    return end();
+  // heterogeneous lookup, e.g. a string_view into a map keyed by strings;
+  // needs Hash and KeyEqual to declare is_transparent
+  template <typename K>
+    requires requires {
+      typename Hash::is_transparent;
+      typename KeyEqual::is_transparent;
+    }
+  iterator find(const K &key) {
+    Node *found = _find_in_bucket(_hash(key) % number_of_buckets, key);
+    return found ? iterator(found, this) : end();
   }
 
-  const_iterator find(const Key &key) const {
-    size_t bucket_idx = _hash_key(key);
-    Node *current_bucket = buckets[bucket_idx];
+  template <typename K>
+    requires requires {
+      typename Hash::is_transparent;
+      typename KeyEqual::is_transparent;
+    }
+  const_iterator find(const K &key) const {
+    Node *found = _find_in_bucket(_hash(key) % number_of_buckets, key);
+    return found ? const_iterator(found, this) : end();
+  }
 
-    while (current_bucket) {
-      if (!_equal((current_bucket->value).first, key)) {
-        current_bucket = current_bucket->next;
-        continue;
-      }
-      return const_iterator(current_bucket);
+  iterator begin() noexcept {
+    for (size_t i = 0; i < number_of_buckets; ++i) {
+      if (buckets[i] != nullptr)
+        return iterator(buckets[i], this);
     }
+    return end();
+  }
 
+  const_iterator begin() const noexcept {
+    for (size_t i = 0; i < number_of_buckets; ++i) {
+      if (buckets[i] != nullptr)
+        return const_iterator(buckets[i], this);
+    }
     return end();
   }
 
+  const_iterator cbegin() const noexcept { return begin(); }
+
   iterator end() noexcept { return iterator(nullptr, nullptr); }
 
   const_iterator end() const noexcept {
@@ -397,22 +721,80 @@ public:
     return const_iterator(nullptr, nullptr);
   }
 
+  /*
+   * Bucket interface
+   */
+
+  size_type bucket(const Key &key) const { return _hash_key(key); }
+
+  size_type bucket_size(size_type n) const {
+    size_type count = 0;
+    for (Node *node = buckets[n]; node != nullptr; node = node->next)
+      ++count;
+    return count;
+  }
+
+  local_iterator begin(size_type n) { return local_iterator(buckets[n]); }
+  local_iterator end(size_type) { return local_iterator(); }
+  const_local_iterator begin(size_type n) const {
+    return const_local_iterator(buckets[n]);
+  }
+  const_local_iterator end(size_type) const { return const_local_iterator(); }
+  const_local_iterator cbegin(size_type n) const { return begin(n); }
+  const_local_iterator cend(size_type n) const { return end(n); }
+
+  /*
+   * Divides the map into k ranges of whole buckets for parallel traversal;
+   * every element is in exactly one of them and the last ones are empty when
+   * the map is small. The cuts balance occupied buckets rather than buckets,
+   * so maps whose keys cluster in part of the bucket array (sequential keys
+   * under an identity hash, a drained map that never shrank) still split
+   * evenly, at the cost of one pass over the bucket array but none over the
+   * nodes. With a reasonable hash that tracks the node count closely. Any
+   * insert or erase invalidates the ranges.
+   */
+  std::vector<range> split(size_type k) {
+    std::vector<size_t> points = _split_points(k);
+    std::vector<range> ranges;
+    ranges.reserve(k);
+    for (size_t j = 0; j < k; ++j) {
+      auto at = [&](size_t i) {
+        return i == number_of_buckets ? end() : iterator(buckets[i], this);
+      };
+      ranges.emplace_back(at(points[j]), at(points[j + 1]));
+    }
+    return ranges;
+  }
+
+  std::vector<const_range> split(size_type k) const {
+    std::vector<size_t> points = _split_points(k);
+    std::vector<const_range> ranges;
+    ranges.reserve(k);
+    for (size_t j = 0; j < k; ++j) {
+      auto at = [&](size_t i) {
+        return i == number_of_buckets ? end()
+                                      : const_iterator(buckets[i], this);
+      };
+      ranges.emplace_back(at(points[j]), at(points[j + 1]));
+    }
+    return ranges;
+  }
+
+  // sets the bucket count to count, or to what the elements need at the
+  // maximum load if that is more; unlike reserve this may shrink
   void rehash(size_t count) {
-    // A better implementation would find the smallest prime greater than count
-    if (count <= number_of_buckets)
+    size_t min_buckets = static_cast<size_t>(
+        std::ceil(static_cast<float>(_size) / cur_load_factor));
+    count = std::max({count, min_buckets, _min_bucket_count});
+    if (count == number_of_buckets)
       return;
 
-    size_t min_buckets =
-        (size_t)std::ceil(static_cast<float>(_size) / cur_load_factor);
-    if (count < min_buckets)
-      return;
+    Node **new_buckets = _allocate_buckets(count);
 
     // update for hash_key to work
     size_t old_num_buckets = number_of_buckets;
     number_of_buckets = count;
 
-    Node **new_buckets = new Node *[count]();
-
     for (size_t i = 0; i < old_num_buckets; i++) {
       Node *current_bucket = buckets[i];
       while (current_bucket) {
@@ -426,16 +808,19 @@ public:
       }
     }
 
-    delete[] buckets;
+    _deallocate_buckets(buckets, old_num_buckets);
 
     buckets = new_buckets;
+#if defined(RWSTD_CONTAINER_STATS)
+    _bump(_counters.rehashes);
+#endif
   }
 
   float load_factor() const {
     auto num_buckets = bucket_count();
     if (num_buckets == 0)
       return 0.0f;
-    return static_cast<float>(size()) / num_buckets;
+    return static_cast<float>(size()) / static_cast<float>(num_buckets);
   }
 
   float max_load_factor() const noexcept { return cur_load_factor; }
@@ -443,7 +828,48 @@ public:
   void max_load_factor(float ml) { cur_load_factor = ml; }
 
   void reserve(size_type count) {
-    rehash(std::ceil(static_cast<float>(count) / cur_load_factor));
+    size_t needed = static_cast<size_t>(
+        std::ceil(static_cast<float>(count) / cur_load_factor));
+    if (needed > number_of_buckets)
+      rehash(needed);
+  }
+
+  float min_load_factor() const noexcept { return cur_min_load_factor; }
+
+  // enables shrinking on erase(key) but not erase(iterator), kept below
+  // max_load_factor() / 4
+  void min_load_factor(float ml) {
+    cur_min_load_factor = std::min(ml, cur_load_factor / 4.0f);
+  }
+
+  void shrink_to_fit() { rehash(0); }
+
+  // bucket array plus nodes, allocator overhead not included
+  size_type memory_usage() const {
+    return number_of_buckets * sizeof(Node *) + _size * sizeof(Node);
+  }
+
+#if defined(RWSTD_CONTAINER_STATS)
+  // the counters so far, plus chain lengths from a walk over every bucket
+  stats_type stats() const {
+    stats_type stats;
+    stats.rehashes = _counters.rehashes.load(std::memory_order_relaxed);
+    stats.lookups = _counters.lookups.load(std::memory_order_relaxed);
+    stats.probes = _counters.probes.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < number_of_buckets; ++i) {
+      size_t length = 0;
+      for (Node *node = buckets[i]; node != nullptr; node = node->next)
+        ++length;
+      ++stats.chain_lengths[std::min(length, stats.chain_lengths.size() - 1)];
+    }
+    return stats;
+  }
+
+  void reset_stats() {
+    _counters.rehashes.store(0, std::memory_order_relaxed);
+    _counters.lookups.store(0, std::memory_order_relaxed);
+    _counters.probes.store(0, std::memory_order_relaxed);
   }
+#endif
 };
 } // namespace rwstd
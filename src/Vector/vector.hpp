@@ -26,11 +26,32 @@ public:
   typedef iterator::reference reference;
   typedef const value_type &const_reference;
 
+#if defined(RWSTD_CONTAINER_STATS)
+  // built with RWSTD_CONTAINER_STATS (the CONTAINER_STATS cmake option),
+  // counted per instance and not carried over by copies, moves or swaps
+  struct stats_type {
+    // buffers replaced by reserve, growth or shrink_to_fit
+    size_t reallocations = 0;
+    // elements moved (or copied, without a noexcept move) into them
+    size_t moved_elements = 0;
+  };
+#endif
+
 private:
   allocator_type _alloc;
   T *_data;
   size_t _size;
   size_t _capacity;
+#if defined(RWSTD_CONTAINER_STATS)
+  stats_type _stats;
+#endif
+
+  void _count_reallocation() {
+#if defined(RWSTD_CONTAINER_STATS)
+    ++_stats.reallocations;
+    _stats.moved_elements += _size;
+#endif
+  }
 
 public:
   Vector() noexcept(noexcept(Allocator())) : Vector(Allocator()) {}
@@ -40,7 +61,8 @@ public:
   }
 
   explicit Vector(size_t size, const allocator_type &alloc = Allocator())
-      : _alloc{alloc}, _size{size}, _capacity(size * 2) {
+      : _alloc{alloc}, _size{size},
+        _capacity(std::max<size_t>(size * 2, 2)) {
     _data = _alloc.allocate(_capacity);
     for (size_t i = 0; i < _size; ++i) {
       alloc_traits::construct(_alloc, _data + i, T{});
@@ -49,7 +71,8 @@ public:
 
   explicit Vector(size_t size, const T &value,
                   const allocator_type &alloc = Allocator())
-      : _alloc{alloc}, _size(size), _capacity(size * 2) {
+      : _alloc{alloc}, _size(size),
+        _capacity(std::max<size_t>(size * 2, 2)) {
     _data = _alloc.allocate(_capacity);
     for (size_t i = 0; i < _size; ++i) {
       alloc_traits::construct(_alloc, _data + i, T{value});
@@ -69,31 +92,41 @@ public:
     std::copy(other._data, other._data + other._size, _data);
   }
 
-  Vector(Vector &&other) : Vector(other._size, other._alloc) {
-    _data = other._data;
-    other._data = nullptr;
-    other._size = 0;
+  // leaves other empty with the usual two element buffer
+  Vector(Vector &&other) : Vector(other._alloc) { swap(other); }
+
+  ~Vector() {
+    if (_data == nullptr)
+      return;
+    for (size_t i = 0; i < _size; ++i) {
+      alloc_traits::destroy(_alloc, _data + i);
+    }
+    alloc_traits::deallocate(_alloc, _data, _capacity);
   }
 
   Vector &operator=(const Vector &other) {
-    _size = other._size;
-    _capacity = other._capacity;
-    _alloc = other._alloc;
-    _data = _alloc.allocate(_capacity);
-    std::copy(other._data, other._data + other._size, _data);
+    if (this != &other) {
+      Vector copy(other);
+      swap(copy);
+    }
     return *this;
   }
 
   Vector &operator=(Vector &&other) noexcept {
-    _size = other._size;
-    _capacity = other._capacity;
-    _alloc = other._alloc;
-    _data = other._data;
-    other._data = nullptr;
-    other._size = 0;
+    swap(other);
     return *this;
   }
 
+  void swap(Vector &other) noexcept {
+    using std::swap;
+    swap(_data, other._data);
+    swap(_size, other._size);
+    swap(_capacity, other._capacity);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(_alloc, other._alloc);
+    }
+  }
+
   Vector &operator=(std::initializer_list<T> init) {
     this->insert(this->cbegin(), init);
     return this;
@@ -138,6 +171,10 @@ public:
 
   iterator end() { return iterator(_data + _size); }
 
+  const_iterator begin() const noexcept { return const_iterator(_data); }
+
+  const_iterator end() const noexcept { return const_iterator(_data + _size); }
+
   const_iterator cbegin() const noexcept { return const_iterator(_data); }
 
   const_iterator cend() const noexcept { return const_iterator(_data + _size); }
@@ -153,6 +190,11 @@ public:
 
   size_t capacity() const { return _capacity; }
 
+#if defined(RWSTD_CONTAINER_STATS)
+  const stats_type &stats() const { return _stats; }
+  void reset_stats() { _stats = stats_type{}; }
+#endif
+
   void reserve(size_type new_cap) {
     if (new_cap <= _capacity)
       return;
@@ -182,6 +224,7 @@ public:
 
     alloc_traits::deallocate(_alloc, _data, _capacity);
 
+    _count_reallocation();
     _data = new_data;
     _capacity = new_cap;
   }
@@ -203,7 +246,7 @@ public:
     size_t i = 0;
     try {
       for (; i < _size; ++i) {
-        alloc_traits::construct(_alloc, new_data,
+        alloc_traits::construct(_alloc, new_data + i,
                                 std::move_if_noexcept(*(_data + i)));
       }
     } catch (...) {
@@ -218,8 +261,9 @@ public:
       alloc_traits::destroy(_alloc, _data + i);
     }
 
-    alloc_traits::deallocate(_alloc, _data, _size);
+    alloc_traits::deallocate(_alloc, _data, _capacity);
 
+    _count_reallocation();
     _data = new_data;
     _capacity = _size;
   }
@@ -233,7 +277,7 @@ public:
     for (size_t i = 0; i < _size; ++i) {
       alloc_traits::destroy(_alloc, _data + i);
     }
-    alloc_traits::deallocate(_alloc, _data, _size);
+    alloc_traits::deallocate(_alloc, _data, _capacity);
 
     _data = new_data;
     _size = 0;
@@ -0,0 +1,157 @@
+#include "BitVector/bit_vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<bool> random_bits(size_t size, double density, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::bernoulli_distribution bit(density);
+  std::vector<bool> bits(size);
+  for (size_t i = 0; i < size; ++i) {
+    bits[i] = bit(rng);
+  }
+  return bits;
+}
+
+rwstd::BitVector make(const std::vector<bool> &bits) {
+  rwstd::BitVector out;
+  for (bool b : bits) {
+    out.push_back(b);
+  }
+  return out;
+}
+
+size_t naive_count(const std::vector<bool> &bits) {
+  size_t count = 0;
+  for (bool b : bits) {
+    count += b;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(BitVectorTest, ElementsAndResize) {
+  rwstd::BitVector bits(70);
+  EXPECT_EQ(bits.size(), 70);
+  EXPECT_TRUE(bits.none());
+  bits.set(3);
+  bits.set(69);
+  bits.flip(64);
+  EXPECT_TRUE(bits[3] && bits[64] && bits.at(69));
+  bits.reset(64);
+  EXPECT_FALSE(bits[64]);
+  EXPECT_EQ(bits.count(), 2);
+  EXPECT_THROW(bits.at(70), std::out_of_range);
+
+  // new bits take the fill value, old spare bits included
+  bits.resize(200, true);
+  EXPECT_EQ(bits.count(), 2 + 130);
+  EXPECT_FALSE(bits[68]);
+  EXPECT_TRUE(bits[70] && bits[199]);
+  bits.resize(100);
+  EXPECT_EQ(bits.count(), 2 + 30);
+  bits.flip();
+  EXPECT_EQ(bits.count(), 100 - 32);
+  bits.fill(true);
+  EXPECT_TRUE(bits.all());
+
+  size_t seen = 0;
+  for (bool b : bits) {
+    EXPECT_TRUE(b);
+    ++seen;
+  }
+  EXPECT_EQ(seen, 100);
+
+  bits.clear();
+  EXPECT_TRUE(bits.empty());
+  EXPECT_EQ(bits.find_first(), 0);
+}
+
+TEST(BitVectorTest, BulkOperations) {
+  // odd size, so every operation has a partial last word and lane group
+  const size_t size = 10007;
+  auto a_bits = random_bits(size, 0.5, 1);
+  auto b_bits = random_bits(size, 0.3, 2);
+  rwstd::BitVector a = make(a_bits);
+  rwstd::BitVector b = make(b_bits);
+  EXPECT_EQ(a.count(), naive_count(a_bits));
+
+  rwstd::BitVector and_bits = a & b;
+  rwstd::BitVector or_bits = a | b;
+  rwstd::BitVector xor_bits = a ^ b;
+  rwstd::BitVector not_bits = ~a;
+  rwstd::BitVector minus = a;
+  minus.and_not(b);
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(and_bits[i], a_bits[i] && b_bits[i]);
+    ASSERT_EQ(or_bits[i], a_bits[i] || b_bits[i]);
+    ASSERT_EQ(xor_bits[i], a_bits[i] != b_bits[i]);
+    ASSERT_EQ(not_bits[i], !a_bits[i]);
+    ASSERT_EQ(minus[i], a_bits[i] && !b_bits[i]);
+  }
+  EXPECT_EQ(not_bits.count(), size - a.count());
+  EXPECT_EQ((a ^ a).count(), 0);
+  EXPECT_TRUE((a | not_bits).all());
+  EXPECT_EQ(~not_bits, a);
+
+  rwstd::BitVector shorter(size - 1);
+  EXPECT_THROW(a &= shorter, std::invalid_argument);
+}
+
+TEST(BitVectorTest, FindAndForEach) {
+  rwstd::BitVector bits(5000);
+  EXPECT_EQ(bits.find_first(), 5000);
+  std::vector<size_t> expected = {0, 63, 64, 700, 4095, 4999};
+  for (size_t pos : expected) {
+    bits.set(pos);
+  }
+  std::vector<size_t> found;
+  for (size_t pos = bits.find_first(); pos < bits.size();
+       pos = bits.find_next(pos)) {
+    found.push_back(pos);
+  }
+  EXPECT_EQ(found, expected);
+
+  found.clear();
+  bits.for_each_set([&](size_t pos) { found.push_back(pos); });
+  EXPECT_EQ(found, expected);
+  EXPECT_EQ(bits.find_next(4999), 5000);
+}
+
+TEST(BitVectorTest, RankAndSelect) {
+  const size_t size = 300001;
+  for (double density : {0.0, 0.001, 0.5, 0.97, 1.0}) {
+    auto plain = random_bits(size, density, 3);
+    // a dense run inside a sparse stretch, so samples land unevenly
+    for (size_t i = 100000; i < 120000 && density < 0.5; ++i) {
+      plain[i] = true;
+    }
+    rwstd::BitVector bits = make(plain);
+    EXPECT_THROW(bits.rank(0), std::logic_error);
+
+    size_t plain_bytes = bits.memory_usage();
+    bits.build_index();
+    EXPECT_LT(bits.memory_usage() - plain_bytes, plain_bytes / 20);
+
+    size_t ones = 0;
+    for (size_t pos = 0; pos <= size; ++pos) {
+      ASSERT_EQ(bits.rank(pos), ones) << "density " << density;
+      if (pos < size && plain[pos]) {
+        ASSERT_EQ(bits.select(ones), pos) << "density " << density;
+        ++ones;
+      }
+    }
+    EXPECT_EQ(bits.count(), ones);
+    EXPECT_EQ(bits.select(ones), size);
+
+    // any change drops the index
+    bits.set(0);
+    EXPECT_FALSE(bits.has_index());
+    EXPECT_THROW(bits.select(0), std::logic_error);
+  }
+}
@@ -0,0 +1,136 @@
+#include "BloomFilter/bloom_filter.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace {
+
+// share of never inserted keys the filter lets through
+double measured_fpr(const rwstd::BloomFilter<uint64_t> &filter,
+                    uint64_t first_absent, size_t probes) {
+  size_t passed = 0;
+  for (uint64_t key = first_absent; key < first_absent + probes; ++key) {
+    passed += filter.contains(key);
+  }
+  return static_cast<double>(passed) / static_cast<double>(probes);
+}
+
+} // namespace
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+  rwstd::BloomFilter<std::string> filter(1000);
+  for (int i = 0; i < 1000; ++i) {
+    filter.insert("key" + std::to_string(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(filter.contains("key" + std::to_string(i)));
+  }
+  EXPECT_EQ(filter.inserted(), 1000);
+}
+
+TEST(BloomFilterTest, FalsePositiveRateNearTarget) {
+  for (double target : {0.05, 0.01, 0.001}) {
+    rwstd::BloomFilter<uint64_t> filter(100000, target);
+    for (uint64_t key = 0; key < 100000; ++key) {
+      filter.insert(key);
+    }
+    double fpr = measured_fpr(filter, 1 << 30, 1000000);
+    EXPECT_LT(fpr, target * 1.2) << target;
+    EXPECT_GT(fpr, target / 4) << target;
+  }
+}
+
+TEST(BloomFilterTest, OverfilledFilterDegrades) {
+  rwstd::BloomFilter<uint64_t> filter(1000, 0.01);
+  for (uint64_t key = 0; key < 10000; ++key) {
+    filter.insert(key);
+  }
+  EXPECT_GT(measured_fpr(filter, 1 << 30, 100000), 0.1);
+
+  filter.clear();
+  EXPECT_EQ(filter.inserted(), 0);
+  EXPECT_FALSE(filter.contains(1));
+}
+
+TEST(BloomFilterTest, SizingAndCopies) {
+  rwstd::BloomFilter<int> filter(1 << 20, 0.01);
+  // about twelve bits per key at 1%
+  double bits = static_cast<double>(filter.memory_usage() * 8) / (1 << 20);
+  EXPECT_GT(bits, 10.0);
+  EXPECT_LT(bits, 14.0);
+  EXPECT_EQ(filter.memory_usage(), filter.block_count() * 32);
+
+  filter.insert(42);
+  auto copy = filter;
+  copy.insert(43);
+  EXPECT_TRUE(copy.contains(42));
+  EXPECT_TRUE(copy.contains(43));
+
+  EXPECT_THROW((rwstd::BloomFilter<int>(10, 0.0)), std::invalid_argument);
+  EXPECT_THROW((rwstd::BloomFilter<int>(10, 1.0)), std::invalid_argument);
+}
+
+TEST(BloomFilterTest, MovedFromIsEmptyAndUsable) {
+  rwstd::BloomFilter<int> filter(1000);
+  filter.insert(7);
+  auto moved = std::move(filter);
+  EXPECT_TRUE(moved.contains(7));
+
+  EXPECT_EQ(filter.block_count(), 0);
+  EXPECT_EQ(filter.inserted(), 0);
+  EXPECT_FALSE(filter.contains(7));
+  filter.clear();
+  auto copy = filter;
+  EXPECT_FALSE(copy.contains(7));
+  filter.insert(8);
+  EXPECT_TRUE(filter.contains(8));
+  EXPECT_EQ(filter.block_count(), 1);
+}
+
+TEST(FilteredMapTest, BehavesLikeTheMap) {
+  rwstd::FilteredMap<uint64_t, int> map;
+  std::mt19937_64 rng(5);
+  for (int i = 0; i < 20000; ++i) {
+    map.insert({rng() >> 1, i});
+  }
+  map[7] = 70;
+  EXPECT_EQ(map.size(), 20001);
+
+  rng.seed(5);
+  for (int i = 0; i < 20000; ++i) {
+    auto it = map.find(rng() >> 1);
+    ASSERT_TRUE(it != map.end());
+    EXPECT_EQ(it->second, i);
+  }
+  EXPECT_EQ(map.find(7)->second, 70);
+  EXPECT_FALSE(map.contains(uint64_t{1} << 63));
+
+  // the filter follows the map through every rehash
+  EXPECT_GE(map.filter().block_count() * 256,
+            static_cast<size_t>(static_cast<double>(map.size()) * 9.6));
+}
+
+TEST(FilteredMapTest, EraseAndRebuild) {
+  rwstd::FilteredMap<int, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    map.insert({i, i});
+  }
+  for (int i = 0; i < 600; ++i) {
+    EXPECT_EQ(map.erase(i), 1);
+  }
+  EXPECT_EQ(map.erase(5), 0);
+  EXPECT_EQ(map.size(), 400);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(map.contains(i), i >= 600);
+  }
+  // the erased keys were dropped from the filter by a rebuild
+  EXPECT_LT(map.filter().inserted(), 1000);
+
+  map.reserve(100000);
+  EXPECT_TRUE(map.contains(999));
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(999));
+}
@@ -0,0 +1,193 @@
+#include "ConcurrentVector/concurrent_vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ConcurrentVectorTest : public testing::Test {
+protected:
+  rwstd::ConcurrentVector<int> v0;
+  rwstd::ConcurrentVector<std::string> strings;
+};
+
+TEST_F(ConcurrentVectorTest, InitialState) {
+  EXPECT_EQ(v0.size(), 0);
+  EXPECT_TRUE(v0.empty());
+  EXPECT_EQ(v0.capacity(), 0);
+  EXPECT_EQ(v0.try_get(0), nullptr);
+}
+
+TEST_F(ConcurrentVectorTest, SingleThreaded) {
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(v0.push_back(i), static_cast<size_t>(i));
+  }
+  EXPECT_EQ(v0.size(), 1000);
+  EXPECT_EQ(v0[999], 999);
+  EXPECT_EQ(v0.at(10), 10);
+  EXPECT_THROW(v0.at(1000), std::out_of_range);
+
+  int *first = &v0[0];
+  size_t start = v0.grow_by(5000, 7);
+  EXPECT_EQ(start, 1000);
+  EXPECT_EQ(first, &v0[0]);
+  EXPECT_EQ(v0[5999], 7);
+
+  std::vector<int> more = {1, 2, 3};
+  start = v0.grow_by(more.begin(), more.end());
+  EXPECT_EQ(v0[start + 2], 3);
+
+  EXPECT_EQ(std::count(v0.cbegin() + 1000, v0.cbegin() + 6000, 7), 5000);
+
+  auto copy = v0;
+  EXPECT_EQ(copy.size(), v0.size());
+  EXPECT_EQ(copy[5], 5);
+
+  v0.clear();
+  EXPECT_TRUE(v0.empty());
+}
+
+TEST_F(ConcurrentVectorTest, NonTrivialElements) {
+  size_t idx = strings.emplace_back(20, 'x');
+  EXPECT_EQ(strings[idx], std::string(20, 'x'));
+  strings.push_back("hello");
+  EXPECT_EQ(*strings.try_get(1), "hello");
+
+  auto moved = std::move(strings);
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_EQ(strings.size(), 0);
+}
+
+// run under -DSANITIZE_THREAD=ON to have ThreadSanitizer check it
+TEST_F(ConcurrentVectorTest, ConcurrentProducersAndReaders) {
+  constexpr int producers = 8;
+  constexpr int per_producer = 20000;
+
+  std::atomic<bool> done{false};
+  std::atomic<long> observed{0};
+
+  // readers only look at slots through try_get, which synchronises with the
+  // producer that published them
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire)) {
+        size_t n = strings.size();
+        for (size_t i = 0; i < n; i += 97) {
+          if (const std::string *s = strings.try_get(i)) {
+            observed.fetch_add(static_cast<long>(s->size()),
+                               std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < per_producer; ++i) {
+        std::string value = std::to_string(p) + ":" + std::to_string(i);
+        if (i % 100 == 0) {
+          size_t first = strings.grow_by(3, value);
+          // our own slots are readable right away
+          EXPECT_EQ(strings[first + 2], value);
+        } else {
+          size_t idx = strings.push_back(value);
+          EXPECT_EQ(strings[idx], value);
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  done.store(true, std::memory_order_release);
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  size_t grows = per_producer / 100;
+  EXPECT_EQ(strings.size(), producers * (per_producer + 2 * grows));
+
+  // every value shows up exactly once (three times for grow_by ones)
+  std::vector<std::string> all(strings.cbegin(), strings.cend());
+  std::sort(all.begin(), all.end());
+  for (int p = 0; p < producers; ++p) {
+    for (int i = 0; i < per_producer; ++i) {
+      std::string value = std::to_string(p) + ":" + std::to_string(i);
+      auto range = std::equal_range(all.begin(), all.end(), value);
+      EXPECT_EQ(range.second - range.first, i % 100 == 0 ? 3 : 1) << value;
+    }
+  }
+}
+
+TEST_F(ConcurrentVectorTest, ConcurrentReserveAndPush) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      v0.reserve(static_cast<size_t>(1000 * (t + 1)));
+      for (int i = 0; i < 5000; ++i) {
+        v0.push_back(1);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(v0.size(), 20000);
+  EXPECT_EQ(std::count(v0.cbegin(), v0.cend(), 1), 20000);
+}
+
+namespace {
+// throws when constructed from a negative value
+struct Picky {
+  int value;
+  explicit Picky(int v) : value{v} {
+    if (v < 0) {
+      throw std::invalid_argument("negative");
+    }
+  }
+  Picky(const Picky &other) : Picky(other.value) {}
+};
+} // namespace
+
+TEST(ConcurrentVectorThrowTest, ThrowingConstructorLeavesHole) {
+  rwstd::ConcurrentVector<Picky> v;
+  v.emplace_back(1);
+  EXPECT_THROW(v.emplace_back(-1), std::invalid_argument);
+  v.emplace_back(2);
+  std::vector<Picky> batch{Picky(3), Picky(4)};
+  batch[1].value = -4;
+  // 3 goes in, -4 and the rest of the run stay unpublished
+  EXPECT_THROW(v.grow_by(batch.begin(), batch.end()), std::invalid_argument);
+  v.emplace_back(5);
+
+  EXPECT_EQ(v.size(), 6);
+  EXPECT_EQ(v.try_get(1), nullptr);
+  EXPECT_EQ(v.try_get(4), nullptr);
+  EXPECT_THROW(v.at(1), std::out_of_range);
+  EXPECT_EQ(v[3].value, 3);
+
+  // iteration only sees the published elements
+  std::vector<int> seen;
+  for (const Picky &p : v) {
+    seen.push_back(p.value);
+  }
+  EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 5}));
+  EXPECT_EQ(v.cend() - v.cbegin(), 4);
+  EXPECT_EQ((v.cbegin() + 2)->value, 3);
+  EXPECT_EQ((v.cend() - 1)->value, 5);
+
+  rwstd::ConcurrentVector<Picky> copy(v);
+  EXPECT_EQ(copy.size(), 4);
+  v.clear();
+  EXPECT_EQ(v.cend() - v.cbegin(), 0);
+
+  // a claim that cannot fit is taken back
+  EXPECT_THROW(v.grow_by(v.max_size() + 1, Picky(0)), std::length_error);
+  EXPECT_THROW(copy.grow_by(copy.max_size() - 2, Picky(0)), std::length_error);
+  EXPECT_EQ(copy.size(), 4);
+}
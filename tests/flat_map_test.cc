@@ -0,0 +1,274 @@
+#include "FlatMap/flat_map.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// copies throw once the shared budget runs out, and so do moves unless
+// NothrowMove
+inline int copies_left = 1000;
+
+template <bool NothrowMove>
+struct Fragile {
+  int value = 0;
+
+  Fragile(int v) : value{v} {}
+  Fragile(const Fragile &other) : value{other.value} {
+    if (copies_left-- <= 0)
+      throw std::runtime_error("copy");
+  }
+  Fragile(Fragile &&other) noexcept(NothrowMove) : value{other.value} {
+    if constexpr (!NothrowMove) {
+      if (copies_left-- <= 0)
+        throw std::runtime_error("move");
+    }
+  }
+  Fragile &operator=(const Fragile &) = default;
+  Fragile &operator=(Fragile &&) = default;
+
+  bool operator<(const Fragile &rhs) const { return value < rhs.value; }
+};
+
+template <typename Map>
+void check_entries(const Map &map, std::vector<int> expected) {
+  using F = typename Map::key_type;
+  ASSERT_EQ(map.size(), expected.size());
+  std::size_t i = 0;
+  for (const auto &[key, value] : map) {
+    EXPECT_EQ(key.value, expected[i]);
+    EXPECT_EQ(value.value, expected[i] * 10);
+    ++i;
+  }
+  for (int key : expected) {
+    ASSERT_TRUE(map.contains(F(key)));
+  }
+}
+
+// throws at every copy in turn until there is budget enough to get through;
+// a failed attempt must leave the map as it was
+template <typename Map>
+void check_throwing_inserts() {
+  using F = typename Map::key_type;
+  Map map;
+  map.insert({F(1), F(10)});
+  map.insert({F(3), F(30)});
+
+  // point inserts shift by moving, like Vector::insert they only promise
+  // this much for types that move without throwing
+  if constexpr (std::is_nothrow_move_constructible_v<F>) {
+    std::pair<F, F> entry(F(2), F(20));
+    for (int budget = 0; budget < 100; ++budget) {
+      copies_left = budget;
+      try {
+        map.insert(entry);
+        break;
+      } catch (const std::runtime_error &) {
+        copies_left = 1000;
+        check_entries(map, {1, 3});
+      }
+    }
+    copies_left = 1000;
+    check_entries(map, {1, 2, 3});
+    map.erase(F(2));
+  }
+
+  std::vector<std::pair<F, F>> batch;
+  batch.emplace_back(F(0), F(0));
+  batch.emplace_back(F(2), F(20));
+  batch.emplace_back(F(5), F(50));
+  for (int budget = 0; budget < 100; ++budget) {
+    copies_left = budget;
+    try {
+      map.insert_range(batch);
+      break;
+    } catch (const std::runtime_error &) {
+      copies_left = 1000;
+      check_entries(map, {1, 3});
+    }
+  }
+  copies_left = 1000;
+  check_entries(map, {0, 1, 2, 3, 5});
+}
+
+} // namespace
+
+template <typename Map>
+class FlatMapTest : public testing::Test {};
+
+using Layouts =
+    testing::Types<rwstd::FlatMap<int, std::string>,
+                   rwstd::EytzingerFlatMap<int, std::string>>;
+TYPED_TEST_SUITE(FlatMapTest, Layouts);
+
+TYPED_TEST(FlatMapTest, InsertAndFind) {
+  TypeParam map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(1), map.end());
+
+  EXPECT_TRUE(map.insert({5, "five"}).second);
+  EXPECT_TRUE(map.insert({1, "one"}).second);
+  EXPECT_TRUE(map.insert({9, "nine"}).second);
+  auto [it, inserted] = map.insert({5, "FIVE"});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, "five");
+
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(map.at(1), "one");
+  EXPECT_TRUE(map.contains(9));
+  EXPECT_EQ(map.count(4), 0);
+  EXPECT_THROW(map.at(4), std::out_of_range);
+
+  map[4] = "four";
+  map[5] += "!";
+  EXPECT_EQ(map.at(4), "four");
+  EXPECT_EQ(map.at(5), "five!");
+
+  map.insert_or_assign(1, "uno");
+  EXPECT_EQ(map.at(1), "uno");
+}
+
+TYPED_TEST(FlatMapTest, SortedIteration) {
+  TypeParam map = {{3, "c"}, {1, "a"}, {2, "b"}};
+  std::string order;
+  for (auto [key, value] : map) {
+    order += std::to_string(key) + value;
+  }
+  EXPECT_EQ(order, "1a2b3c");
+
+  // keys and values are separate sorted arrays
+  EXPECT_EQ(map.keys()[0], 1);
+  EXPECT_EQ(map.values()[2], "c");
+}
+
+TYPED_TEST(FlatMapTest, InsertRangeMerges) {
+  TypeParam map = {{2, "old"}, {4, "old"}};
+  std::vector<std::pair<int, std::string>> batch = {
+      {5, "new"}, {4, "new"}, {1, "new"}, {5, "dup"}, {3, "new"}};
+  map.insert_range(batch);
+
+  ASSERT_EQ(map.size(), 5);
+  // existing entries are kept, the first of a duplicated key wins
+  EXPECT_EQ(map.at(4), "old");
+  EXPECT_EQ(map.at(5), "new");
+  int expected = 1;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    EXPECT_EQ(it->first, expected++);
+  }
+}
+
+TYPED_TEST(FlatMapTest, Erase) {
+  TypeParam map = {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}};
+  EXPECT_EQ(map.erase(2), 1);
+  EXPECT_EQ(map.erase(2), 0);
+  auto next = map.erase(map.find(3));
+  EXPECT_EQ(next->first, 4);
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_FALSE(map.contains(3));
+  EXPECT_EQ(map.at(4), "d");
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(1));
+}
+
+TYPED_TEST(FlatMapTest, Bounds) {
+  TypeParam map = {{10, "a"}, {20, "b"}, {30, "c"}};
+  EXPECT_EQ(map.lower_bound(20)->first, 20);
+  EXPECT_EQ(map.upper_bound(20)->first, 30);
+  EXPECT_EQ(map.lower_bound(15)->first, 20);
+  EXPECT_EQ(map.lower_bound(5), map.begin());
+  EXPECT_EQ(map.lower_bound(31), map.end());
+  EXPECT_EQ(map.upper_bound(30), map.end());
+
+  // a range scan is a walk between two bounds
+  std::string scanned;
+  for (auto it = map.lower_bound(11); it != map.upper_bound(30); ++it) {
+    scanned += it->second;
+  }
+  EXPECT_EQ(scanned, "bc");
+}
+
+TYPED_TEST(FlatMapTest, MatchesStdMap) {
+  std::mt19937 rng(17);
+  // every size up to 300 covers complete and partial last tree levels
+  for (int n = 0; n <= 300; ++n) {
+    std::map<int, std::string> reference;
+    std::vector<std::pair<int, std::string>> batch;
+    for (int i = 0; i < n; ++i) {
+      int key = static_cast<int>(rng() % 1000);
+      batch.push_back({key, std::to_string(i)});
+      reference.insert({key, std::to_string(i)});
+    }
+    TypeParam map;
+    map.insert_range(batch);
+    ASSERT_EQ(map.size(), reference.size());
+    for (int key = -1; key <= 1001; ++key) {
+      auto expected = reference.lower_bound(key);
+      auto it = map.lower_bound(key);
+      if (expected == reference.end()) {
+        ASSERT_EQ(it, map.end()) << n << " " << key;
+        continue;
+      }
+      ASSERT_EQ(it->first, expected->first) << n << " " << key;
+      ASSERT_EQ(it->second, expected->second);
+      ASSERT_EQ(map.contains(key), reference.contains(key));
+    }
+  }
+}
+
+TEST(FlatMapCompareTest, CustomComparator) {
+  rwstd::EytzingerFlatMap<std::string, int, std::greater<std::string>> map;
+  map.insert_range(std::vector<std::pair<std::string, int>>{
+      {"apple", 1}, {"cherry", 3}, {"banana", 2}});
+  EXPECT_EQ(map.begin()->first, "cherry");
+  EXPECT_EQ(map.lower_bound("b")->first, "apple");
+  EXPECT_EQ(map.at("banana"), 2);
+}
+
+TEST(FlatMapCompareTest, CopyAndMove) {
+  rwstd::FlatMap<uint64_t, uint64_t> map = {{1, 10}, {2, 20}};
+  auto copy = map;
+  copy[3] = 30;
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(copy.size(), 3);
+
+  auto moved = std::move(copy);
+  EXPECT_EQ(moved.at(3), 30);
+}
+
+TEST(FlatMapThrowTest, FailedInsertsLeaveTheMapAlone) {
+  using Safe = Fragile<true>;
+  using Unsafe = Fragile<false>;
+  check_throwing_inserts<rwstd::FlatMap<Safe, Safe>>();
+  check_throwing_inserts<rwstd::EytzingerFlatMap<Safe, Safe>>();
+  check_throwing_inserts<rwstd::FlatMap<Unsafe, Unsafe>>();
+  check_throwing_inserts<rwstd::EytzingerFlatMap<Unsafe, Unsafe>>();
+}
+
+TEST(FlatMapThrowTest, TreeBuildFailureFallsBackToSortedKeys) {
+  using F = Fragile<true>;
+  rwstd::EytzingerFlatMap<F, F> map;
+  for (int i = 0; i < 20; ++i) {
+    map.insert({F(i), F(i * 10)});
+  }
+  // the key and value copies of the insert succeed, copying the keys into
+  // the tree runs out
+  std::pair<F, F> entry(F(20), F(200));
+  copies_left = 2 + 5;
+  EXPECT_TRUE(map.insert(entry).second);
+  copies_left = 1000;
+  std::vector<int> expected;
+  for (int i = 0; i <= 20; ++i) {
+    expected.push_back(i);
+  }
+  check_entries(map, expected);
+  EXPECT_FALSE(map.contains(F(21)));
+}
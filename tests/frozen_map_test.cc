@@ -0,0 +1,233 @@
+#include "FrozenMap/frozen_map.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct BytesWriter {
+  std::vector<std::byte> bytes;
+
+  void write(const void *data, std::size_t n) {
+    const auto *p = static_cast<const std::byte *>(data);
+    bytes.insert(bytes.end(), p, p + n);
+  }
+};
+
+struct HalfHash {
+  std::size_t operator()(uint64_t key) const {
+    return static_cast<std::size_t>(key / 2);
+  }
+};
+
+struct Route {
+  uint32_t port;
+  uint16_t weight;
+};
+
+} // namespace
+
+class FrozenMapTest : public testing::Test {
+protected:
+  FrozenMapTest() {
+    std::mt19937_64 rng(42);
+    while (source.size() < 10000) {
+      uint64_t key = rng();
+      source.insert({key, key ^ 0xabcdef});
+    }
+  }
+
+  rwstd::UnorderedMap<uint64_t, uint64_t> source;
+};
+
+TEST_F(FrozenMapTest, BuildFromUnorderedMap) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  EXPECT_EQ(frozen.size(), 10000);
+  EXPECT_FALSE(frozen.empty());
+
+  for (auto &[key, value] : source) {
+    auto it = frozen.find(key);
+    ASSERT_NE(it, frozen.end());
+    EXPECT_EQ(it->first, key);
+    EXPECT_EQ(it->second, value);
+    EXPECT_EQ(frozen.at(key), value);
+  }
+}
+
+TEST_F(FrozenMapTest, MissingKeys) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  std::mt19937_64 rng(7);
+  int misses = 0;
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t key = rng();
+    if (source.find(key) != source.end())
+      continue;
+    EXPECT_FALSE(frozen.contains(key));
+    EXPECT_EQ(frozen.count(key), 0);
+    ++misses;
+  }
+  EXPECT_GT(misses, 0);
+  EXPECT_THROW(frozen.at(uint64_t{12345}), std::out_of_range);
+}
+
+TEST_F(FrozenMapTest, EverySlotUsedOnce) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  std::vector<uint64_t> keys;
+  for (const auto &entry : frozen) {
+    keys.push_back(entry.first);
+  }
+  std::vector<uint64_t> expected;
+  for (auto &[key, value] : source) {
+    expected.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(keys, expected);
+}
+
+TEST_F(FrozenMapTest, CompactFootprint) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  double bytes_per_key = static_cast<double>(frozen.memory_usage()) / 10000.0;
+  // 16 bytes of payload, pilots and remap add about one byte on top
+  EXPECT_LT(bytes_per_key, 18.0);
+}
+
+TEST(FrozenMapBuildTest, Empty) {
+  rwstd::UnorderedMap<int, int> empty;
+  auto frozen = rwstd::FrozenMap<int, int>::build(empty);
+  EXPECT_TRUE(frozen.empty());
+  EXPECT_EQ(frozen.find(3), frozen.end());
+  EXPECT_EQ(frozen.begin(), frozen.end());
+
+  rwstd::FrozenMap<int, int> defaulted;
+  EXPECT_FALSE(defaulted.contains(1));
+}
+
+TEST(FrozenMapBuildTest, SingleAndSmall) {
+  for (int n = 1; n < 64; ++n) {
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < n; ++i) {
+      pairs.push_back({i * 13, i});
+    }
+    auto frozen =
+        rwstd::FrozenMap<int, int>::build(pairs.begin(), pairs.end());
+    ASSERT_EQ(frozen.size(), static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+      ASSERT_TRUE(frozen.contains(i * 13)) << n;
+      EXPECT_EQ(frozen.at(i * 13), i);
+    }
+    EXPECT_FALSE(frozen.contains(1));
+  }
+}
+
+TEST(FrozenMapBuildTest, StructValues) {
+  std::vector<std::pair<uint32_t, Route>> pairs;
+  for (uint32_t i = 0; i < 500; ++i) {
+    pairs.push_back({i, Route{8000 + i, static_cast<uint16_t>(i % 7)}});
+  }
+  auto frozen =
+      rwstd::FrozenMap<uint32_t, Route>::build(pairs.begin(), pairs.end());
+  EXPECT_EQ(frozen.at(123).port, 8123);
+  EXPECT_EQ(frozen.at(123).weight, 123 % 7);
+}
+
+TEST(FrozenMapBuildTest, DuplicateKey) {
+  std::vector<std::pair<int, int>> pairs = {{1, 1}, {2, 2}, {1, 3}};
+  EXPECT_THROW(
+      (rwstd::FrozenMap<int, int>::build(pairs.begin(), pairs.end())),
+      std::invalid_argument);
+}
+
+TEST(FrozenMapBuildTest, InseparableHashes) {
+  // 4 and 5 hash the same, no pilot can split them
+  std::vector<std::pair<uint64_t, int>> pairs = {{4, 1}, {5, 2}, {8, 3}};
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, int, HalfHash>::build(pairs.begin(),
+                                                                 pairs.end())),
+               std::invalid_argument);
+}
+
+TEST_F(FrozenMapTest, ViewImageInPlace) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  BytesWriter writer;
+  frozen.write(writer);
+  EXPECT_EQ(writer.bytes.size(), frozen.memory_usage());
+
+  auto view = rwstd::FrozenMap<uint64_t, uint64_t>::view(writer.bytes);
+  EXPECT_EQ(view.size(), frozen.size());
+  for (auto &[key, value] : source) {
+    ASSERT_TRUE(view.contains(key));
+    EXPECT_EQ(view.at(key), value);
+  }
+  // entries are read straight out of the buffer
+  EXPECT_GE(reinterpret_cast<const std::byte *>(view.begin()),
+            writer.bytes.data());
+  EXPECT_LT(reinterpret_cast<const std::byte *>(view.begin()),
+            writer.bytes.data() + writer.bytes.size());
+}
+
+TEST_F(FrozenMapTest, OpenFromFile) {
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("rwstd_frozen_" + std::to_string(::getpid())))
+                         .string();
+  {
+    auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+    BytesWriter writer;
+    frozen.write(writer);
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fwrite(writer.bytes.data(), 1, writer.bytes.size(), f);
+    std::fclose(f);
+  }
+
+  auto mapped = rwstd::FrozenMap<uint64_t, uint64_t>::open(path);
+  EXPECT_EQ(mapped.size(), 10000);
+  for (auto &[key, value] : source) {
+    EXPECT_EQ(mapped.at(key), value);
+  }
+
+  // moving keeps the mapping alive
+  auto moved = std::move(mapped);
+  EXPECT_EQ(moved.size(), 10000);
+  EXPECT_TRUE(mapped.empty());
+  std::filesystem::remove(path);
+}
+
+TEST_F(FrozenMapTest, RejectsBadImages) {
+  auto frozen = rwstd::FrozenMap<uint64_t, uint64_t>::build(source);
+  BytesWriter writer;
+  frozen.write(writer);
+
+  auto truncated = std::span<const std::byte>(writer.bytes).first(
+      writer.bytes.size() - 8);
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, uint64_t>::view(truncated)),
+               std::runtime_error);
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, uint32_t>::view(writer.bytes)),
+               std::runtime_error);
+
+  // a remap entry pointing past the entries
+  rwstd::detail::FrozenHeader header;
+  std::memcpy(&header, writer.bytes.data(), sizeof(header));
+  ASSERT_GT(header.table_size, header.size);
+  std::vector<std::byte> bad_remap = writer.bytes;
+  uint32_t past_end = static_cast<uint32_t>(header.size);
+  std::memcpy(bad_remap.data() + sizeof(header) +
+                  rwstd::detail::frozen_align(header.bucket_count * 4),
+              &past_end, sizeof(past_end));
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, uint64_t>::view(bad_remap)),
+               std::runtime_error);
+
+  std::vector<std::byte> garbage(256, std::byte{1});
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, uint64_t>::view(garbage)),
+               std::runtime_error);
+  EXPECT_THROW((rwstd::FrozenMap<uint64_t, uint64_t>::open(
+                   "/nonexistent/rwstd_frozen")),
+               std::system_error);
+}
@@ -0,0 +1,225 @@
+#include "Hash/hash.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using rwstd::hash::Hash;
+using rwstd::hash::hash_bytes;
+
+/*
+ * SMHasher style avalanche: flipping any input bit should flip every output
+ * bit half the time. Returns the worst |p - 0.5| over up to 64 input bits
+ * spread over the key and all 64 output bits.
+ */
+template <typename H>
+double worst_avalanche_bias(const H &hash, size_t len, size_t samples) {
+  std::mt19937_64 rng(len);
+  size_t bits = len * 8;
+  size_t step = std::max<size_t>(1, bits / 64);
+  std::vector<size_t> flipped_bits;
+  for (size_t bit = 0; bit < bits; bit += step)
+    flipped_bits.push_back(bit);
+
+  std::vector<size_t> flips(flipped_bits.size() * 64);
+  std::vector<unsigned char> key(len);
+  for (size_t s = 0; s < samples; ++s) {
+    for (auto &byte : key)
+      byte = static_cast<unsigned char>(rng());
+    uint64_t base = hash(key.data(), len);
+    for (size_t i = 0; i < flipped_bits.size(); ++i) {
+      size_t bit = flipped_bits[i];
+      key[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+      uint64_t diff = base ^ hash(key.data(), len);
+      key[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+      for (size_t out = 0; out < 64; ++out)
+        flips[i * 64 + out] += (diff >> out) & 1;
+    }
+  }
+  double worst = 0;
+  for (size_t count : flips) {
+    double p = static_cast<double>(count) / static_cast<double>(samples);
+    worst = std::max(worst, std::abs(p - 0.5));
+  }
+  return worst;
+}
+
+// chi-square of n keys over 1024 buckets picked by the low bits
+template <typename H>
+double chi_square(const H &hasher, uint64_t stride) {
+  constexpr size_t buckets = 1024;
+  constexpr size_t n = buckets * 64;
+  std::vector<size_t> counts(buckets);
+  for (uint64_t i = 0; i < n; ++i)
+    ++counts[hasher(i * stride) % buckets];
+  double expected = static_cast<double>(n) / buckets;
+  double chi = 0;
+  for (size_t count : counts) {
+    double d = static_cast<double>(count) - expected;
+    chi += d * d / expected;
+  }
+  return chi;
+}
+
+} // namespace
+
+TEST(HashTest, Avalanche) {
+  // 1000 samples: one standard deviation of p is 0.016
+  auto bytes = [](const unsigned char *key, size_t len) {
+    return hash_bytes(key, len);
+  };
+  for (size_t len : {4u, 8u, 13u, 16u, 40u, 100u, 300u, 1000u, 3000u}) {
+    EXPECT_LT(worst_avalanche_bias(bytes, len, 1000), 0.08) << len;
+  }
+  auto integer = [](const unsigned char *key, size_t) {
+    uint64_t value;
+    std::memcpy(&value, key, sizeof(value));
+    return rwstd::hash::hash_int(value);
+  };
+  EXPECT_LT(worst_avalanche_bias(integer, 8, 1000), 0.08);
+}
+
+TEST(HashTest, IntegersSpreadOverBuckets) {
+  // 1023 degrees of freedom, 1300 is six standard deviations out
+  Hash<uint64_t> hasher;
+  for (uint64_t stride : {1ull, 2ull, 1024ull, 1ull << 32}) {
+    EXPECT_LT(chi_square(hasher, stride), 1300.0) << stride;
+  }
+  // the identity std::hash piles strided keys into one bucket
+  EXPECT_GT(chi_square(std::hash<uint64_t>{}, 1024), 1e6);
+}
+
+TEST(HashTest, NoCollisionsOnSparseKeys) {
+  // every 64 bit key with at most two bits set
+  std::set<uint64_t> seen;
+  size_t keys = 0;
+  Hash<uint64_t> hasher;
+  for (int i = -1; i < 64; ++i) {
+    for (int j = i + 1; j < 64; ++j) {
+      uint64_t key = (i < 0 ? 0 : uint64_t{1} << i) | (uint64_t{1} << j);
+      seen.insert(hasher(key));
+      ++keys;
+    }
+  }
+  EXPECT_EQ(seen.size(), keys);
+
+  // about n^2 / 2^33 = 4.7 collisions expected in the low 32 bits
+  std::vector<uint64_t> full;
+  std::vector<uint32_t> low;
+  Hash<std::string> strings;
+  for (int i = 0; i < 200000; ++i) {
+    uint64_t h = strings("key" + std::to_string(i));
+    full.push_back(h);
+    low.push_back(static_cast<uint32_t>(h));
+  }
+  std::sort(full.begin(), full.end());
+  std::sort(low.begin(), low.end());
+  EXPECT_EQ(std::unique(full.begin(), full.end()), full.end());
+  EXPECT_LT(low.end() - std::unique(low.begin(), low.end()), 20);
+}
+
+TEST(HashTest, EveryLengthAndAlignment) {
+  std::mt19937_64 rng(9);
+  std::vector<unsigned char> buffer(2100);
+  for (auto &byte : buffer)
+    byte = static_cast<unsigned char>(rng());
+
+  // prefixes of one buffer cover every code path and must all differ
+  std::set<uint64_t> seen;
+  for (size_t len = 0; len <= 2048; ++len) {
+    uint64_t h = hash_bytes(buffer.data(), len);
+    seen.insert(h);
+    // the same bytes at another address hash the same
+    std::vector<unsigned char> shifted(len + 7);
+    std::copy_n(buffer.begin(), len, shifted.begin() + 3);
+    ASSERT_EQ(hash_bytes(shifted.data() + 3, len), h) << len;
+  }
+  EXPECT_EQ(seen.size(), 2049);
+
+  // swapping two 64 byte stripes of a long input changes the hash
+  std::vector<unsigned char> swapped(buffer);
+  std::swap_ranges(swapped.begin(), swapped.begin() + 64,
+                   swapped.begin() + 64);
+  EXPECT_NE(hash_bytes(swapped.data(), 2048), hash_bytes(buffer.data(), 2048));
+}
+
+TEST(HashTest, SeedsChangeEveryPath) {
+  std::string key(3000, 'x');
+  for (size_t len : {0u, 3u, 8u, 30u, 100u, 3000u}) {
+    EXPECT_NE(hash_bytes(key.data(), len, 1), hash_bytes(key.data(), len, 2))
+        << len;
+  }
+  rwstd::hash::SeededHash<std::string> a;
+  rwstd::hash::SeededHash<std::string> b;
+  EXPECT_NE(a.seed, b.seed);
+  EXPECT_NE(a("flood"), b("flood"));
+  auto copy = a;
+  EXPECT_EQ(copy("flood"), a("flood"));
+  EXPECT_EQ(rwstd::hash::SeededHash<int>(7)(1),
+            rwstd::hash::SeededHash<int>(7)(1));
+}
+
+TEST(HashTest, HasherCombinesParts) {
+  using rwstd::hash::Hasher;
+  EXPECT_NE(Hasher().add(1).add(2).finish(), Hasher().add(2).add(1).finish());
+  EXPECT_NE(Hasher().add("ab").add("c").finish(),
+            Hasher().add("a").add("bc").finish());
+  EXPECT_EQ(Hasher().add(std::make_pair(1, std::string("x"))).finish(),
+            Hasher().add(1).add("x").finish());
+  EXPECT_EQ(Hash<double>{}(0.0), Hash<double>{}(-0.0));
+  EXPECT_NE(Hash<double>{}(1.0), Hash<double>{}(2.0));
+  EXPECT_NE(Hash<std::vector<int>>{}({1, 2}),
+            Hash<std::vector<int>>{}({1, 2, 0}));
+
+  using Key = std::tuple<int, std::string, double>;
+  EXPECT_EQ(Hash<Key>{}(Key{1, "a", 2.5}), Hash<Key>{}(Key{1, "a", 2.5}));
+  EXPECT_NE(Hash<Key>{}(Key{1, "a", 2.5}), Hash<Key>{}(Key{1, "b", 2.5}));
+
+  // heterogeneous string lookups hash alike
+  Hash<std::string> strings;
+  EXPECT_EQ(strings(std::string("abc")), strings(std::string_view("abc")));
+  EXPECT_EQ(strings(std::string("abc")), strings("abc"));
+}
+
+TEST(HashTest, PlugsIntoUnorderedMap) {
+  using Point = std::pair<int, int>;
+  rwstd::UnorderedMap<Point, int, Hash<Point>> grid;
+  for (int x = 0; x < 100; ++x) {
+    for (int y = 0; y < 100; ++y) {
+      grid.insert({{x, y}, x * 100 + y});
+    }
+  }
+  EXPECT_EQ(grid.size(), 10000);
+  EXPECT_EQ(grid.find({42, 7})->second, 4207);
+
+  rwstd::UnorderedMap<std::string, int, rwstd::hash::SeededHash<std::string>>
+      words;
+  words.insert({"alpha", 1});
+  words.insert({"beta", 2});
+  auto copy = words;
+  EXPECT_EQ(copy.find("beta")->second, 2);
+}
+
+TEST(HashTest, TransparentStringsAgree) {
+  std::string text = "transparent lookup";
+  for (std::uint64_t seed : {std::uint64_t{0}, std::uint64_t{12345}}) {
+    Hash<std::string> hash{seed};
+    std::size_t expected = hash(text);
+    EXPECT_EQ(hash(std::string_view(text)), expected);
+    EXPECT_EQ(hash(text.c_str()), expected);
+    const char *literal = "transparent lookup";
+    EXPECT_EQ(hash(literal), expected);
+  }
+}
@@ -0,0 +1,237 @@
+#include "Allocator/tracking_allocator.hpp"
+#include "IntMap/int_map.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+TEST(IntMapTest, InsertFindErase) {
+  rwstd::IntMap<uint64_t, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.find(1) == map.end());
+
+  EXPECT_TRUE(map.insert({1, "one"}).second);
+  EXPECT_TRUE(map.insert({2, "two"}).second);
+  auto [it, inserted] = map.insert({1, "uno"});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, "one");
+  EXPECT_EQ(map.size(), 2);
+
+  map[3] = "three";
+  map[3] += "!";
+  EXPECT_EQ(map.at(3), "three!");
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ(map.count(4), 0);
+  EXPECT_THROW(map.at(4), std::out_of_range);
+
+  EXPECT_EQ(map.erase(2), 1);
+  EXPECT_EQ(map.erase(2), 0);
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(map.size(), 2);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.contains(1));
+}
+
+TEST(IntMapTest, EmptyKeyIsReserved) {
+  rwstd::IntMap<uint32_t, int> map;
+  EXPECT_THROW(map.insert({UINT32_MAX, 1}), std::invalid_argument);
+  EXPECT_FALSE(map.contains(UINT32_MAX));
+
+  // a different marker frees up the largest key
+  rwstd::IntMap<uint32_t, int, 0> zero_empty;
+  zero_empty[UINT32_MAX] = 5;
+  EXPECT_EQ(zero_empty.at(UINT32_MAX), 5);
+  EXPECT_THROW(zero_empty[0], std::invalid_argument);
+}
+
+TEST(IntMapTest, GrowsUnderLoad) {
+  rwstd::IntMap<uint32_t, uint32_t> map;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    map[i] = i * 3;
+  }
+  EXPECT_EQ(map.size(), 100000);
+  EXPECT_LE(map.load_factor(), map.max_load_factor());
+  for (uint32_t i = 0; i < 100000; ++i) {
+    ASSERT_EQ(map.at(i), i * 3);
+  }
+  EXPECT_FALSE(map.contains(100000));
+}
+
+// random inserts and erases checked against std::unordered_map, in a table
+// small enough that runs wrap around the end often
+template <typename Key>
+void check_against_reference(uint32_t seed) {
+  rwstd::IntMap<Key, int> map;
+  std::unordered_map<Key, int> reference;
+  std::mt19937 rng(seed);
+  for (int step = 0; step < 20000; ++step) {
+    Key key = static_cast<Key>(rng() % 200);
+    if (rng() % 3 == 0) {
+      ASSERT_EQ(map.erase(key), reference.erase(key));
+    } else {
+      map[key] = step;
+      reference[key] = step;
+    }
+    ASSERT_EQ(map.size(), reference.size());
+  }
+  for (Key key = 0; key < 200; ++key) {
+    auto expected = reference.find(key);
+    if (expected == reference.end()) {
+      ASSERT_FALSE(map.contains(key)) << +key;
+    } else {
+      ASSERT_EQ(map.at(key), expected->second) << +key;
+    }
+  }
+}
+
+TEST(IntMapTest, MatchesStdUnorderedMap) {
+  check_against_reference<uint64_t>(1);
+  check_against_reference<uint32_t>(2);
+  check_against_reference<uint16_t>(3);
+  check_against_reference<int32_t>(4);
+}
+
+TEST(IntMapTest, Iteration) {
+  rwstd::IntMap<int64_t, int> map = {{-5, 1}, {0, 2}, {7, 3}};
+  int sum = 0;
+  size_t visited = 0;
+  for (auto [key, value] : map) {
+    sum += value;
+    ++visited;
+  }
+  EXPECT_EQ(visited, 3);
+  EXPECT_EQ(sum, 6);
+
+  const auto &view = map;
+  for (auto it = view.begin(); it != view.end(); ++it) {
+    EXPECT_EQ(view.at(it->first), it->second);
+  }
+
+  // erase through iterators until empty
+  auto it = map.begin();
+  while (it != map.end()) {
+    it = map.erase(it);
+  }
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(IntMapTest, CopyMoveSwap) {
+  rwstd::IntMap<uint32_t, std::string> map = {{1, "a"}, {2, "b"}};
+  auto copy = map;
+  copy[3] = "c";
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(copy.size(), 3);
+
+  auto moved = std::move(copy);
+  EXPECT_EQ(moved.at(3), "c");
+
+  map.swap(moved);
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(moved.size(), 2);
+
+  moved = map;
+  EXPECT_EQ(moved.at(3), "c");
+
+  // the moved from map is empty and usable again
+  auto taken = std::move(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(moved.find(3), moved.end());
+  EXPECT_EQ(moved.count(3), 0);
+  EXPECT_EQ(moved.erase(3), 0);
+  auto copy_of_empty = moved;
+  EXPECT_TRUE(copy_of_empty.empty());
+  moved.clear();
+  moved[4] = "d";
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_EQ(moved.at(4), "d");
+  copy_of_empty[5] = "e";
+  EXPECT_EQ(copy_of_empty.at(5), "e");
+  EXPECT_EQ(taken.size(), 3);
+}
+
+TEST(IntMapTest, ReserveAndRehash) {
+  rwstd::IntMap<uint64_t, uint64_t> map;
+  map.reserve(1000);
+  size_t buckets = map.bucket_count();
+  EXPECT_GE(static_cast<float>(buckets) * map.max_load_factor(), 1000.0f);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    map[i << 32] = i;
+  }
+  EXPECT_EQ(map.bucket_count(), buckets);
+
+  // never shrinks below what the elements need
+  map.rehash(1);
+  EXPECT_EQ(map.bucket_count(), buckets);
+  EXPECT_EQ(map.at(uint64_t{999} << 32), 999);
+  EXPECT_EQ(map.memory_usage(),
+            (buckets + 1) * sizeof(uint64_t) + buckets * sizeof(uint64_t));
+}
+
+TEST(IntMapTest, KeysGoThroughTheAllocator) {
+  rwstd::AllocationStats stats;
+  using Alloc = rwstd::TrackingAllocator<uint64_t>;
+  {
+    rwstd::IntMap<uint32_t, uint64_t, UINT32_MAX, Alloc> map(64, Alloc(stats));
+    for (uint32_t i = 0; i < 1000; ++i) {
+      map[i] = i;
+    }
+    EXPECT_EQ(stats.snapshot().live_bytes, map.memory_usage());
+  }
+  EXPECT_EQ(stats.snapshot().live_bytes, 0u);
+}
+
+TEST(IntMapTest, LoadFactorMustBePositive) {
+  rwstd::IntMap<uint32_t, int> map;
+  EXPECT_THROW(map.max_load_factor(0.0f), std::invalid_argument);
+  EXPECT_THROW(map.max_load_factor(-0.5f), std::invalid_argument);
+  EXPECT_THROW(map.max_load_factor(std::nanf("")), std::invalid_argument);
+  EXPECT_EQ(map.max_load_factor(), 0.75f);
+  map.max_load_factor(0.5f);
+  EXPECT_EQ(map.max_load_factor(), 0.5f);
+}
+
+namespace {
+
+// copying throws once the budget runs out, and moving may throw, so rehash
+// has to copy
+struct Fragile {
+  static inline int copies_left = 1000;
+  int value = 0;
+
+  Fragile(int v) : value{v} {}
+  Fragile(const Fragile &other) : value{other.value} {
+    if (copies_left-- <= 0)
+      throw std::runtime_error("copy");
+  }
+  Fragile(Fragile &&other) : Fragile(std::as_const(other)) {}
+};
+
+} // namespace
+
+TEST(IntMapTest, ThrowingRehashKeepsTheTable) {
+  rwstd::IntMap<uint32_t, Fragile> map;
+  uint32_t n = 0;
+  while (static_cast<float>(n + 1) <=
+         static_cast<float>(map.bucket_count()) * map.max_load_factor()) {
+    map.try_emplace(n, static_cast<int>(n));
+    ++n;
+  }
+  size_t buckets = map.bucket_count();
+
+  Fragile::copies_left = 3;
+  EXPECT_THROW(map.rehash(buckets * 4), std::runtime_error);
+  Fragile::copies_left = 1000;
+  EXPECT_EQ(map.bucket_count(), buckets);
+  EXPECT_EQ(map.size(), n);
+  for (uint32_t i = 0; i < n; ++i) {
+    EXPECT_EQ(map.at(i).value, static_cast<int>(i));
+  }
+  map.rehash(buckets * 4);
+  EXPECT_EQ(map.at(0).value, 0);
+}
@@ -0,0 +1,148 @@
+#include "InternPool/intern_pool.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// operator new fails once this many allocations succeeded, -1 never fails
+int allocations_left = -1;
+
+} // namespace
+
+// the aligned forms are left to the library, so they do the actual work
+constexpr std::align_val_t plain_alignment{alignof(std::max_align_t)};
+
+void *operator new(std::size_t size) {
+  if (allocations_left == 0)
+    throw std::bad_alloc();
+  if (allocations_left > 0)
+    --allocations_left;
+  return ::operator new(size, plain_alignment);
+}
+
+void operator delete(void *p) noexcept {
+  ::operator delete(p, plain_alignment);
+}
+
+void operator delete(void *p, std::size_t /*_*/) noexcept {
+  ::operator delete(p, plain_alignment);
+}
+
+TEST(InternPoolTest, Deduplicates) {
+  rwstd::InternPool pool;
+  rwstd::Symbol a = pool.intern("env:prod");
+  rwstd::Symbol b = pool.intern(std::string("env:") + "prod");
+  rwstd::Symbol c = pool.intern("env:dev");
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(pool.size(), 2);
+  EXPECT_EQ(pool.view(a), "env:prod");
+  EXPECT_EQ(pool[c], "env:dev");
+  EXPECT_STREQ(pool.view(a).data(), "env:prod");
+
+  rwstd::Symbol empty = pool.intern("");
+  EXPECT_EQ(pool.view(empty), "");
+  EXPECT_EQ(pool.intern(""), empty);
+  EXPECT_FALSE(rwstd::Symbol{}.valid());
+  EXPECT_TRUE(empty.valid());
+}
+
+TEST(InternPoolTest, FindDoesNotIntern) {
+  rwstd::InternPool pool(4);
+  EXPECT_FALSE(pool.find("missing").has_value());
+  EXPECT_EQ(pool.size(), 0);
+  rwstd::Symbol s = pool.intern("present");
+  EXPECT_EQ(pool.find("present"), s);
+  EXPECT_THROW(rwstd::InternPool(0), std::invalid_argument);
+  EXPECT_EQ(rwstd::InternPool(5).shard_count(), 8);
+}
+
+TEST(InternPoolTest, ViewsStayValid) {
+  rwstd::InternPool pool;
+  std::string_view first = pool.view(pool.intern("first"));
+  std::string big(100000, 'x');
+  std::vector<rwstd::Symbol> symbols;
+  for (int i = 0; i < 50000; ++i) {
+    symbols.push_back(pool.intern("tag:" + std::to_string(i)));
+  }
+  rwstd::Symbol big_symbol = pool.intern(big);
+  EXPECT_EQ(first, "first");
+  EXPECT_EQ(pool.view(big_symbol), big);
+  for (int i = 0; i < 50000; ++i) {
+    ASSERT_EQ(pool.view(symbols[static_cast<size_t>(i)]),
+              "tag:" + std::to_string(i));
+  }
+  // about a hundred bytes a string, the index node being most of it
+  EXPECT_LT(pool.memory_usage(), size_t{8} << 20);
+}
+
+TEST(InternPoolTest, ConcurrentInterning) {
+  rwstd::InternPool pool(16);
+  constexpr int threads = 4;
+  constexpr int per_thread = 20000;
+  std::vector<std::vector<rwstd::Symbol>> seen(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&pool, &seen, t] {
+      // every thread interns the same strings, in a different order
+      for (int i = 0; i < per_thread; ++i) {
+        int n = (i * (2 * t + 1)) % per_thread;
+        seen[static_cast<size_t>(t)].push_back(
+            pool.intern("label-" + std::to_string(n)));
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(pool.size(), per_thread);
+  for (int t = 0; t < threads; ++t) {
+    for (int i = 0; i < per_thread; ++i) {
+      int n = (i * (2 * t + 1)) % per_thread;
+      rwstd::Symbol s = seen[static_cast<size_t>(t)][static_cast<size_t>(i)];
+      ASSERT_EQ(pool.view(s), "label-" + std::to_string(n));
+      ASSERT_EQ(pool.find("label-" + std::to_string(n)), s);
+    }
+  }
+}
+
+TEST(InternPoolTest, SymbolKeyedMap) {
+  rwstd::InternPool pool;
+  rwstd::UnorderedMap<rwstd::Symbol, int> counts;
+  for (const char *tag : {"a", "b", "a", "c", "a", "b"}) {
+    ++counts[pool.intern(tag)];
+  }
+  EXPECT_EQ(counts.size(), 3);
+  EXPECT_EQ(counts[pool.intern("a")], 3);
+  EXPECT_EQ(counts[*pool.find("b")], 2);
+}
+
+TEST(InternPoolThrowTest, FailedInternLeavesNoDuplicate) {
+  rwstd::InternPool clean;
+  rwstd::Symbol expected = clean.intern("env:prod");
+
+  // fail each allocation of the first intern in turn, then let it through
+  for (int budget = 0; budget < 100; ++budget) {
+    rwstd::InternPool pool;
+    allocations_left = budget;
+    bool threw = false;
+    try {
+      pool.intern("env:prod");
+    } catch (const std::bad_alloc &) {
+      threw = true;
+    }
+    allocations_left = -1;
+
+    EXPECT_EQ(pool.intern("env:prod"), expected);
+    EXPECT_EQ(pool.size(), 1);
+    if (!threw)
+      break;
+  }
+}
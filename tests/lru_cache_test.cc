@@ -0,0 +1,196 @@
+#include "LruCache/lru_cache.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct LengthCost {
+  std::size_t operator()(int /*_*/, const std::string &value) const {
+    return value.size();
+  }
+};
+
+// assigning a negative number throws
+struct Checked {
+  int value;
+
+  explicit Checked(int v) : value{v} {}
+  Checked &operator=(int v) {
+    if (v < 0)
+      throw std::invalid_argument("negative");
+    value = v;
+    return *this;
+  }
+};
+
+} // namespace
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  rwstd::LruCache<int, std::string> cache(3);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+  EXPECT_EQ(cache.size(), 3);
+
+  // touching 1 leaves 2 as the oldest
+  ASSERT_NE(cache.get(1), nullptr);
+  cache.put(4, "d");
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_TRUE(cache.contains(1));
+  EXPECT_TRUE(cache.contains(3));
+  EXPECT_EQ(*cache.get(4), "d");
+  EXPECT_EQ(cache.stats().evictions, 1);
+}
+
+TEST(LruCacheTest, UpdateRefreshes) {
+  rwstd::LruCache<int, std::string> cache(2);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(1, "A");
+  cache.put(3, "c");
+  EXPECT_EQ(*cache.peek(1), "A");
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(LruCacheTest, Counters) {
+  rwstd::LruCache<int, int> cache(2);
+  cache.put(1, 10);
+  EXPECT_EQ(cache.get(2), nullptr);
+  EXPECT_EQ(*cache.get(1), 10);
+  EXPECT_EQ(*cache.get(1), 10);
+  // peek is invisible to the counters
+  cache.peek(3);
+
+  EXPECT_EQ(cache.stats().hits, 2);
+  EXPECT_EQ(cache.stats().misses, 1);
+  EXPECT_DOUBLE_EQ(cache.stats().hit_rate(), 2.0 / 3.0);
+
+  cache.reset_stats();
+  EXPECT_EQ(cache.stats().hits, 0);
+}
+
+TEST(LruCacheTest, CostBoundedCapacity) {
+  rwstd::LruCache<int, std::string, LengthCost> cache(10);
+  EXPECT_TRUE(cache.put(1, "aaaa"));
+  EXPECT_TRUE(cache.put(2, "bbbb"));
+  EXPECT_EQ(cache.total_cost(), 8);
+
+  // six bytes only fit once both older entries are gone
+  EXPECT_TRUE(cache.put(3, "cccccc"));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_FALSE(cache.contains(1));
+  EXPECT_EQ(cache.total_cost(), 10);
+
+  // growing an entry in place evicts the others, never itself
+  EXPECT_TRUE(cache.put(3, "cccccccccc"));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.total_cost(), 10);
+
+  EXPECT_FALSE(cache.put(4, "too long to ever fit"));
+  EXPECT_FALSE(cache.contains(4));
+  EXPECT_TRUE(cache.contains(3));
+}
+
+TEST(LruCacheTest, EraseEvictClear) {
+  rwstd::LruCache<int, int> cache(4);
+  for (int i = 0; i < 4; ++i) {
+    cache.put(i, i);
+  }
+  EXPECT_TRUE(cache.erase(2));
+  EXPECT_FALSE(cache.erase(2));
+  EXPECT_TRUE(cache.evict());
+  EXPECT_FALSE(cache.contains(0));
+  EXPECT_EQ(cache.size(), 2);
+
+  cache.clear();
+  EXPECT_TRUE(cache.empty());
+  EXPECT_FALSE(cache.evict());
+  cache.put(7, 7);
+  EXPECT_EQ(*cache.get(7), 7);
+
+  EXPECT_THROW((rwstd::LruCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(LruCacheThrowTest, FailedUpdateKeepsTheEntry) {
+  rwstd::LruCache<int, Checked> cache(3);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  EXPECT_THROW(cache.put(1, -1), std::invalid_argument);
+  EXPECT_EQ(cache.peek(1)->value, 1);
+  EXPECT_EQ(cache.total_cost(), 2);
+
+  // every entry is still reachable by eviction
+  EXPECT_TRUE(cache.evict());
+  EXPECT_TRUE(cache.evict());
+  EXPECT_FALSE(cache.evict());
+  EXPECT_TRUE(cache.empty());
+}
+
+TEST(SieveCacheTest, KeepsVisitedEntries) {
+  rwstd::SieveCache<int, int> cache(3);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.put(3, 3);
+
+  // 1 is the oldest but was visited, so the hand passes it and takes 2
+  cache.get(1);
+  cache.put(4, 4);
+  EXPECT_TRUE(cache.contains(1));
+  EXPECT_FALSE(cache.contains(2));
+
+  // the hand carries on from where it stopped: 3 is unvisited
+  cache.put(5, 5);
+  EXPECT_FALSE(cache.contains(3));
+  EXPECT_TRUE(cache.contains(1));
+
+  // all visited: one full sweep clears the marks, then the oldest goes
+  cache.get(1);
+  cache.get(4);
+  cache.get(5);
+  cache.put(6, 6);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_TRUE(cache.contains(6));
+}
+
+TEST(SieveCacheTest, EraseUnderTheHand) {
+  rwstd::SieveCache<int, int> cache(3);
+  for (int i = 0; i < 3; ++i) {
+    cache.put(i, i);
+  }
+  cache.put(3, 3); // evicts 0, the hand now rests on 1
+  EXPECT_TRUE(cache.erase(1));
+  cache.put(4, 4);
+  cache.put(5, 5);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_TRUE(cache.contains(5));
+}
+
+TEST(SieveCacheTest, RandomWorkloadStaysConsistent) {
+  rwstd::SieveCache<int, int> sieve(64);
+  rwstd::LruCache<int, int> lru(64);
+  std::mt19937 rng(3);
+  for (int step = 0; step < 50000; ++step) {
+    int key = static_cast<int>(rng() % 256);
+    switch (rng() % 4) {
+    case 0:
+      sieve.erase(key);
+      lru.erase(key);
+      break;
+    default:
+      if (int *value = sieve.get(key))
+        ASSERT_EQ(*value, key);
+      else
+        sieve.put(key, key);
+      if (int *value = lru.get(key))
+        ASSERT_EQ(*value, key);
+      else
+        lru.put(key, key);
+    }
+    ASSERT_LE(sieve.size(), 64);
+    ASSERT_LE(lru.size(), 64);
+  }
+  EXPECT_EQ(sieve.total_cost(), sieve.size());
+}
@@ -0,0 +1,234 @@
+#include "MappedVector/mapped_vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <unistd.h>
+
+class MappedVectorTest : public testing::Test {
+protected:
+  MappedVectorTest() {
+    const auto *info = testing::UnitTest::GetInstance()->current_test_info();
+    path = (std::filesystem::temp_directory_path() /
+            (std::string("rwstd_mapped_") + info->name() + "_" +
+             std::to_string(::getpid())))
+               .string();
+  }
+
+  ~MappedVectorTest() override { std::filesystem::remove(path); }
+
+  void write_numbers(std::size_t n) {
+    auto v = rwstd::MappedVector<uint64_t>::create(path);
+    for (uint64_t i = 0; i < n; ++i) {
+      v.push_back(i * 3);
+    }
+  }
+
+  std::string path;
+};
+
+struct Point {
+  double x;
+  double y;
+  int32_t id;
+};
+
+TEST_F(MappedVectorTest, CreateIsEmpty) {
+  auto v = rwstd::MappedVector<int>::create(path, 8);
+  EXPECT_TRUE(v.is_open());
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.size(), 0);
+  EXPECT_EQ(v.capacity(), 8);
+  EXPECT_EQ(std::filesystem::file_size(path), 64 + 8 * sizeof(int));
+}
+
+TEST_F(MappedVectorTest, EmptyVerifies) {
+  {
+    auto v = rwstd::MappedVector<int>::create(path);
+  }
+  auto v = rwstd::MappedVector<int>::open(path);
+  EXPECT_NO_THROW(v.verify());
+}
+
+TEST_F(MappedVectorTest, PayloadIsAligned) {
+  auto v = rwstd::MappedVector<Point>::create(path, 4);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(v.data()) % 64, 0);
+}
+
+TEST_F(MappedVectorTest, RoundTrip) {
+  write_numbers(1000);
+
+  auto v = rwstd::MappedVector<uint64_t>::open(path);
+  EXPECT_EQ(v.mode(), rwstd::MapMode::read_only);
+  ASSERT_EQ(v.size(), 1000);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(v[i], i * 3);
+  }
+  EXPECT_EQ(v.front(), 0);
+  EXPECT_EQ(v.back(), 999 * 3);
+  EXPECT_NO_THROW(v.verify());
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), uint64_t{0}),
+            uint64_t{3} * 999 * 1000 / 2);
+}
+
+TEST_F(MappedVectorTest, StructElements) {
+  {
+    auto v = rwstd::MappedVector<Point>::create(path);
+    for (int32_t i = 0; i < 100; ++i) {
+      v.push_back(Point{i * 0.5, i * 2.0, i});
+    }
+  }
+  auto v = rwstd::MappedVector<Point>::open(path);
+  ASSERT_EQ(v.size(), 100);
+  EXPECT_EQ(v[42].id, 42);
+  EXPECT_DOUBLE_EQ(v[42].x, 21.0);
+  EXPECT_DOUBLE_EQ(v[42].y, 84.0);
+}
+
+TEST_F(MappedVectorTest, GrowthKeepsContents) {
+  auto v = rwstd::MappedVector<uint64_t>::create(path, 2);
+  for (uint64_t i = 0; i < 10000; ++i) {
+    v.push_back(i);
+  }
+  EXPECT_GE(v.capacity(), 10000);
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(v[i], i);
+  }
+  EXPECT_GE(std::filesystem::file_size(path), 64 + 10000 * sizeof(uint64_t));
+}
+
+TEST_F(MappedVectorTest, PushBackOwnElementWhileGrowing) {
+  auto v = rwstd::MappedVector<uint64_t>::create(path, 1);
+  v.push_back(42);
+  // the argument points into the mapping that growing replaces
+  for (int i = 0; i < 20; ++i) {
+    v.push_back(v[0]);
+  }
+  EXPECT_EQ(std::count(v.begin(), v.end(), 42), 21);
+}
+
+TEST_F(MappedVectorTest, ReadWriteReopenAppends) {
+  write_numbers(10);
+  {
+    auto v = rwstd::MappedVector<uint64_t>::open(path, rwstd::MapMode::read_write);
+    v[0] = 7;
+    v.push_back(100);
+  }
+  auto v = rwstd::MappedVector<uint64_t>::open(path);
+  ASSERT_EQ(v.size(), 11);
+  EXPECT_EQ(v[0], 7);
+  EXPECT_EQ(v[10], 100);
+}
+
+TEST_F(MappedVectorTest, ResizeAndClear) {
+  auto v = rwstd::MappedVector<int>::create(path);
+  v.resize(5);
+  EXPECT_EQ(v.size(), 5);
+  for (int x : v) {
+    EXPECT_EQ(x, 0);
+  }
+  v.pop_back();
+  EXPECT_EQ(v.size(), 4);
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  v.flush();
+
+  auto r = rwstd::MappedVector<int>::open(path);
+  EXPECT_TRUE(r.empty());
+}
+
+TEST_F(MappedVectorTest, AtChecksRange) {
+  write_numbers(3);
+  auto v = rwstd::MappedVector<uint64_t>::open(path);
+  EXPECT_EQ(v.at(2), 6);
+  EXPECT_THROW(v.at(3), std::out_of_range);
+}
+
+TEST_F(MappedVectorTest, ReadOnlyRejectsWrites) {
+  write_numbers(3);
+  auto v = rwstd::MappedVector<uint64_t>::open(path);
+  EXPECT_THROW(v.push_back(1), std::logic_error);
+  EXPECT_THROW(v.reserve(100), std::logic_error);
+  EXPECT_THROW(v.flush(), std::logic_error);
+  EXPECT_EQ(v.size(), 3);
+}
+
+TEST_F(MappedVectorTest, ElementSizeMismatch) {
+  write_numbers(3);
+  EXPECT_THROW(rwstd::MappedVector<uint32_t>::open(path), std::runtime_error);
+}
+
+TEST_F(MappedVectorTest, RejectedOpenLeavesFileAlone) {
+  write_numbers(3);
+  auto read_file = [&] {
+    std::ifstream f(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), {});
+  };
+  std::string before = read_file();
+  EXPECT_THROW(
+      rwstd::MappedVector<uint32_t>::open(path, rwstd::MapMode::read_write),
+      std::runtime_error);
+  EXPECT_EQ(read_file(), before);
+  EXPECT_EQ(rwstd::MappedVector<uint64_t>::open(path).size(), 3);
+}
+
+TEST_F(MappedVectorTest, CapacityTooBig) {
+  constexpr std::size_t huge = ~std::size_t{0} / 4;
+  EXPECT_THROW(rwstd::MappedVector<uint64_t>::create(path, huge),
+               std::length_error);
+  auto v = rwstd::MappedVector<uint64_t>::create(path, 4);
+  EXPECT_THROW(v.reserve(huge), std::length_error);
+  EXPECT_EQ(v.capacity(), 4);
+}
+
+TEST_F(MappedVectorTest, ChecksumCatchesCorruption) {
+  write_numbers(100);
+  {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(64 + 8 * 50);
+    f.put('\x7f');
+  }
+  // open only looks at the header, verify reads the payload
+  auto v = rwstd::MappedVector<uint64_t>::open(path);
+  EXPECT_EQ(v.size(), 100);
+  EXPECT_THROW(v.verify(), std::runtime_error);
+}
+
+TEST_F(MappedVectorTest, TruncatedFile) {
+  write_numbers(100);
+  std::filesystem::resize_file(path, 64 + 8 * 10);
+  EXPECT_THROW(rwstd::MappedVector<uint64_t>::open(path), std::runtime_error);
+
+  std::filesystem::resize_file(path, 10);
+  EXPECT_THROW(rwstd::MappedVector<uint64_t>::open(path), std::runtime_error);
+}
+
+TEST_F(MappedVectorTest, NotAMappedVectorFile) {
+  {
+    std::ofstream f(path, std::ios::binary);
+    f << std::string(256, 'x');
+  }
+  EXPECT_THROW(rwstd::MappedVector<uint64_t>::open(path), std::runtime_error);
+}
+
+TEST_F(MappedVectorTest, MissingFile) {
+  EXPECT_THROW(rwstd::MappedVector<uint64_t>::open(path), std::system_error);
+}
+
+TEST_F(MappedVectorTest, MoveTransfersMapping) {
+  write_numbers(5);
+  auto a = rwstd::MappedVector<uint64_t>::open(path);
+  auto b = std::move(a);
+  EXPECT_FALSE(a.is_open());
+  EXPECT_TRUE(b.is_open());
+  EXPECT_EQ(b.size(), 5);
+  EXPECT_EQ(b[4], 12);
+
+  b.close();
+  EXPECT_FALSE(b.is_open());
+  EXPECT_EQ(b.size(), 0);
+}
@@ -0,0 +1,152 @@
+#include "PackedVector/packed_vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+static_assert(std::forward_iterator<rwstd::BitPackedVector<>::const_iterator>);
+static_assert(std::forward_iterator<rwstd::DeltaVector<>::const_iterator>);
+
+// every access path agrees with the plain values
+template <typename Packed, typename T>
+void expect_matches(const Packed &packed, const std::vector<T> &expected) {
+  ASSERT_EQ(packed.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(packed[i], expected[i]) << "at " << i;
+  }
+  size_t i = 0;
+  for (T value : packed) {
+    ASSERT_EQ(value, expected[i++]);
+  }
+  EXPECT_EQ(i, expected.size());
+
+  std::vector<T> out(expected.size());
+  packed.unpack(0, out.size(), out.data());
+  EXPECT_EQ(out, expected);
+  // a range starting and ending mid block
+  if (expected.size() > 10) {
+    std::vector<T> middle(expected.size() - 10);
+    packed.unpack(3, middle.size(), middle.data());
+    EXPECT_TRUE(
+        std::equal(middle.begin(), middle.end(), expected.begin() + 3));
+  }
+}
+
+template <typename T>
+void round_trip_every_width() {
+  std::mt19937_64 rng(std::numeric_limits<T>::digits);
+  for (unsigned bits = 1; bits <= std::numeric_limits<T>::digits; ++bits) {
+    rwstd::BitPackedVector<T> packed(bits);
+    std::vector<T> expected;
+    for (size_t i = 0; i < 1000; ++i) {
+      auto value = static_cast<T>(rng() & packed.max_value());
+      packed.push_back(value);
+      expected.push_back(value);
+    }
+    expect_matches(packed, expected);
+
+    // set keeps neighbours, including across a word boundary
+    for (size_t i = 0; i < expected.size(); i += 7) {
+      expected[i] = static_cast<T>(packed.max_value() - expected[i]);
+      packed.set(i, expected[i]);
+    }
+    expect_matches(packed, expected);
+  }
+}
+
+} // namespace
+
+TEST(BitPackedVectorTest, RoundTripsEveryWidth) {
+  round_trip_every_width<uint32_t>();
+  round_trip_every_width<uint64_t>();
+}
+
+TEST(BitPackedVectorTest, WidthAndLimits) {
+  std::vector<uint32_t> values = {3, 0, 17, 9, 1000};
+  rwstd::BitPackedVector<uint32_t> packed(values.begin(), values.end());
+  EXPECT_EQ(packed.bits(), 10);
+  expect_matches(packed, values);
+  EXPECT_THROW(packed.push_back(1024), std::out_of_range);
+  EXPECT_THROW(packed.set(0, 5000), std::out_of_range);
+  EXPECT_THROW(packed.at(5), std::out_of_range);
+
+  EXPECT_THROW(rwstd::BitPackedVector<uint32_t>(0), std::invalid_argument);
+  EXPECT_THROW(rwstd::BitPackedVector<uint32_t>(33), std::invalid_argument);
+
+  // a million 5 bit values take 5 bits each, plus at most one block
+  rwstd::BitPackedVector<uint64_t> small(5);
+  small.reserve(1000000);
+  for (uint64_t i = 0; i < 1000000; ++i) {
+    small.push_back(i % 32);
+  }
+  EXPECT_LE(small.memory_usage(), 1000000 * 5 / 8 + 256 * 5 / 8);
+  EXPECT_EQ(small[999999], 999999 % 32);
+
+  small.clear();
+  EXPECT_TRUE(small.empty());
+  small.push_back(31);
+  EXPECT_EQ(small[0], 31);
+}
+
+TEST(DeltaVectorTest, SortedIdsCompress) {
+  std::mt19937_64 rng(7);
+  std::vector<uint64_t> ids;
+  uint64_t id = 1ull << 40;
+  for (size_t i = 0; i < 100000; ++i) {
+    id += 1 + rng() % 100;
+    ids.push_back(id);
+  }
+  rwstd::DeltaVector<uint64_t> packed(ids.begin(), ids.end());
+  expect_matches(packed, ids);
+  // gaps under 128 take 7 bits next to 64
+  packed.shrink_to_fit();
+  EXPECT_LT(packed.memory_usage(), ids.size() * 8 / 6);
+
+  // consecutive ids need no payload at all
+  rwstd::DeltaVector<uint32_t> dense;
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    dense.push_back(500 + i);
+    expected.push_back(500 + i);
+  }
+  expect_matches(dense, expected);
+  dense.shrink_to_fit();
+  EXPECT_LT(dense.memory_usage(), expected.size() * 4 / 10);
+}
+
+TEST(DeltaVectorTest, RoundTripsAnyInput) {
+  std::mt19937_64 rng(3);
+  std::vector<uint64_t> values;
+  for (size_t i = 0; i < 20000; ++i) {
+    switch (i / 1000 % 4) {
+    case 0: // full range noise
+      values.push_back(rng());
+      break;
+    case 1: // decreasing
+      values.push_back(~i * 3);
+      break;
+    case 2: // sorted with a rare outlier, favours varint
+      values.push_back(i * 10 + (rng() % 64 == 0 ? 1ull << 50 : 0));
+      break;
+    default: // extremes next to each other
+      values.push_back(i % 2 ? std::numeric_limits<uint64_t>::max() : 0);
+    }
+  }
+  values.push_back(42); // a partial last block
+  rwstd::DeltaVector<uint64_t> packed(values.begin(), values.end());
+  EXPECT_EQ(packed.block_count(), values.size() / 128);
+  expect_matches(packed, values);
+  EXPECT_THROW(packed.at(values.size()), std::out_of_range);
+
+  packed.clear();
+  EXPECT_TRUE(packed.empty());
+  EXPECT_TRUE(packed.begin() == packed.end());
+  packed.push_back(9);
+  EXPECT_EQ(packed.at(0), 9);
+}
@@ -0,0 +1,118 @@
+#include "Parallel/parallel.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+class ParallelTest : public testing::Test {
+protected:
+  ParallelTest() : pool(3) {
+    // small grains so even the test sizes split into many tasks
+    config.pool = &pool;
+    config.grain_size = 97;
+
+    std::mt19937 rng(7);
+    for (size_t i = 0; i < 10000; ++i) {
+      values.push_back(static_cast<int>(rng() % 1000));
+    }
+  }
+
+  rwstd::ThreadPool pool;
+  rwstd::parallel::Config config;
+  rwstd::Vector<int> values;
+};
+
+TEST_F(ParallelTest, ForEach) {
+  rwstd::parallel::for_each(values, [](int &x) { x *= 2; }, config);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i] % 2, 0);
+  }
+
+  std::vector<int> plain(5000, 1);
+  rwstd::parallel::for_each(plain.begin(), plain.end(), [](int &x) { ++x; },
+                            config);
+  EXPECT_EQ(std::count(plain.begin(), plain.end(), 2), 5000);
+}
+
+TEST_F(ParallelTest, Transform) {
+  rwstd::Vector<long> out(values.size());
+  rwstd::parallel::transform(
+      values, out, [](int x) { return static_cast<long>(x) * x; }, config);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(out[i], static_cast<long>(values[i]) * values[i]);
+  }
+
+  rwstd::Vector<long> too_small(3);
+  EXPECT_THROW(rwstd::parallel::transform(
+                   values, too_small, [](int x) { return long{x}; }, config),
+               std::length_error);
+}
+
+TEST_F(ParallelTest, Reduce) {
+  long expected = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    expected += values[i];
+  }
+  EXPECT_EQ(rwstd::parallel::reduce(values, 0L, std::plus<>{}, config),
+            expected);
+
+  // order is kept, op only needs to be associative
+  std::vector<std::string> words;
+  std::string concat;
+  for (int i = 0; i < 500; ++i) {
+    words.push_back(std::to_string(i));
+    concat += words.back();
+  }
+  EXPECT_EQ(rwstd::parallel::reduce(words.begin(), words.end(), std::string{},
+                                    std::plus<>{}, config),
+            concat);
+
+  rwstd::Vector<int> empty;
+  EXPECT_EQ(rwstd::parallel::reduce(empty, 5), 5);
+}
+
+TEST_F(ParallelTest, InclusiveScan) {
+  rwstd::Vector<int> out(values.size());
+  rwstd::parallel::inclusive_scan(values, out, std::plus<>{}, config);
+
+  std::vector<int> expected(values.size());
+  std::inclusive_scan(values.cbegin(), values.cend(), expected.begin());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(out[i], expected[i]);
+  }
+
+  // in place
+  rwstd::parallel::inclusive_scan(values.begin(), values.end(), values.begin(),
+                                  std::plus<>{}, config);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], expected[i]);
+  }
+}
+
+TEST_F(ParallelTest, Sort) {
+  std::vector<int> expected(values.cbegin(), values.cend());
+  std::sort(expected.begin(), expected.end());
+
+  rwstd::parallel::sort(values, std::less<>{}, config);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], expected[i]);
+  }
+
+  // odd number of runs and a descending comparator
+  std::vector<std::string> words;
+  for (int i = 0; i < 1234; ++i) {
+    words.push_back(std::to_string((i * 7919) % 1234));
+  }
+  std::vector<std::string> sorted_words = words;
+  std::sort(sorted_words.begin(), sorted_words.end(), std::greater<>{});
+  rwstd::parallel::sort(words.begin(), words.end(), std::greater<>{}, config);
+  EXPECT_EQ(words, sorted_words);
+}
+
+TEST_F(ParallelTest, DefaultPool) {
+  std::vector<double> big(1 << 16, 1.0);
+  EXPECT_EQ(rwstd::parallel::reduce(big.begin(), big.end(), 0.0),
+            static_cast<double>(big.size()));
+}
@@ -0,0 +1,151 @@
+#include "PriorityQueue/priority_queue.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST(PriorityQueueTest, PopsInOrderForEveryArity) {
+  std::mt19937_64 rng(7);
+  std::vector<int> values(5000);
+  for (auto &v : values) {
+    v = static_cast<int>(rng() % 1000);
+  }
+  std::vector<int> sorted = values;
+  std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+
+  auto drain = [](auto &queue) {
+    std::vector<int> out;
+    while (!queue.empty()) {
+      out.push_back(queue.top());
+      queue.pop();
+    }
+    return out;
+  };
+
+  rwstd::PriorityQueue<int, std::less<int>, 2> binary;
+  rwstd::PriorityQueue<int, std::less<int>, 4> quad;
+  rwstd::PriorityQueue<int, std::less<int>, 8> oct;
+  for (int v : values) {
+    binary.push(v);
+    quad.push(v);
+    oct.push(v);
+  }
+  EXPECT_EQ(quad.size(), values.size());
+  EXPECT_EQ(drain(binary), sorted);
+  EXPECT_EQ(drain(quad), sorted);
+  EXPECT_EQ(drain(oct), sorted);
+
+  // heapify from a range, then batches big and small
+  rwstd::PriorityQueue<int, std::less<int>, 8> built(values.begin(),
+                                                     values.end());
+  EXPECT_EQ(drain(built), sorted);
+  rwstd::PriorityQueue<int, std::greater<int>, 4> min_queue;
+  min_queue.push_range(values.begin(), values.begin() + 3000);
+  min_queue.push_range(values.begin() + 3000, values.end());
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(drain(min_queue), sorted);
+}
+
+TEST(PriorityQueueTest, MoveOnlyElements) {
+  rwstd::PriorityQueue<std::unique_ptr<int>,
+                       std::function<bool(const std::unique_ptr<int> &,
+                                          const std::unique_ptr<int> &)>,
+                       4>
+      queue([](const auto &a, const auto &b) { return *a < *b; });
+  for (int i : {3, 9, 1, 7, 5}) {
+    queue.push(std::make_unique<int>(i));
+  }
+  queue.emplace(std::make_unique<int>(8));
+  EXPECT_EQ(*queue.top(), 9);
+  queue.pop();
+  EXPECT_EQ(*queue.top(), 8);
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(IndexedPriorityQueueTest, DecreaseKeyUpdateAndErase) {
+  rwstd::IndexedPriorityQueue<int, std::greater<int>, 4> queue;
+  auto a = queue.push(50);
+  auto b = queue.push(40);
+  auto c = queue.push(30);
+  auto d = queue.push(20);
+  EXPECT_EQ(queue.top(), 20);
+  EXPECT_EQ(queue.top_handle(), d);
+
+  queue.decrease_key(a, 10);
+  EXPECT_EQ(queue.top_handle(), a);
+  EXPECT_EQ(queue.value(a), 10);
+  EXPECT_THROW(queue.decrease_key(b, 45), std::invalid_argument);
+
+  queue.update(a, 35);
+  EXPECT_EQ(queue.top_handle(), d);
+  queue.erase(c);
+  EXPECT_FALSE(queue.contains(c));
+  EXPECT_THROW(queue.erase(c), std::out_of_range);
+  EXPECT_THROW(queue.value(99), std::out_of_range);
+
+  std::vector<int> order;
+  while (!queue.empty()) {
+    order.push_back(queue.top());
+    queue.pop();
+  }
+  EXPECT_EQ(order, (std::vector<int>{20, 35, 40}));
+  EXPECT_FALSE(queue.contains(a));
+
+  // handles are reused once their element left
+  auto e = queue.push(1);
+  EXPECT_LT(e, 4);
+  EXPECT_EQ(queue.value(e), 1);
+}
+
+TEST(IndexedPriorityQueueTest, MatchesAReferenceUnderRandomOperations) {
+  std::mt19937_64 rng(11);
+  rwstd::IndexedPriorityQueue<uint64_t, std::greater<uint64_t>, 8> queue;
+  // value of every live handle, the reference
+  std::vector<std::pair<size_t, uint64_t>> live;
+  for (int step = 0; step < 20000; ++step) {
+    uint64_t op = rng() % 5;
+    uint64_t value = rng() % 100000;
+    if (op <= 1 || live.empty()) {
+      live.emplace_back(queue.push(value), value);
+    } else {
+      size_t pick = rng() % live.size();
+      auto &[handle, current] = live[pick];
+      if (op == 2) {
+        uint64_t lower = current == 0 ? 0 : value % current;
+        queue.decrease_key(handle, lower);
+        current = lower;
+      } else if (op == 3) {
+        queue.update(handle, value);
+        current = value;
+      } else {
+        queue.erase(handle);
+        live.erase(live.begin() + static_cast<std::ptrdiff_t>(pick));
+      }
+    }
+    ASSERT_EQ(queue.size(), live.size());
+    if (!live.empty() && step % 16 == 0) {
+      auto least = std::min_element(
+          live.begin(), live.end(),
+          [](const auto &x, const auto &y) { return x.second < y.second; });
+      ASSERT_EQ(queue.top(), least->second);
+      ASSERT_EQ(queue.value(queue.top_handle()), least->second);
+    }
+  }
+
+  std::vector<uint64_t> expected;
+  for (const auto &[handle, value] : live) {
+    expected.push_back(value);
+  }
+  std::sort(expected.begin(), expected.end());
+  std::vector<uint64_t> drained;
+  while (!queue.empty()) {
+    drained.push_back(queue.top());
+    queue.pop();
+  }
+  EXPECT_EQ(drained, expected);
+}
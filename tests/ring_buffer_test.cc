@@ -0,0 +1,212 @@
+#include "RingBuffer/concurrent_queue.hpp"
+#include "RingBuffer/ring_buffer.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// counts live allocations, to check every queue goes through Allocator
+inline std::atomic<long> live_allocations{0};
+
+template <typename T>
+struct CountingAllocator {
+  typedef T value_type;
+
+  CountingAllocator() = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    ++live_allocations;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *p, size_t n) {
+    --live_allocations;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  friend bool operator==(const CountingAllocator &, const CountingAllocator &) {
+    return true;
+  }
+};
+
+} // namespace
+
+TEST(RingBufferTest, WrapsAround) {
+  rwstd::RingBuffer<std::string> ring(3);
+  EXPECT_EQ(ring.capacity(), 4);
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 3; ++i) {
+      ring.push_back(std::to_string(round * 3 + i));
+    }
+    EXPECT_EQ(ring.front(), std::to_string(round * 3));
+    EXPECT_EQ(ring.back(), std::to_string(round * 3 + 2));
+    EXPECT_EQ(ring.at(1), std::to_string(round * 3 + 1));
+    ring.pop_front();
+    ring.pop_front(2);
+    EXPECT_TRUE(ring.empty());
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    ring.emplace_back(size_t{10}, static_cast<char>('a' + i));
+  }
+  EXPECT_TRUE(ring.full());
+  EXPECT_THROW(ring.push_back("x"), std::length_error);
+  EXPECT_FALSE(ring.try_push("x"));
+  EXPECT_THROW(ring.at(4), std::out_of_range);
+
+  rwstd::RingBuffer<std::string> copy = ring;
+  ring.clear();
+  std::string joined;
+  for (const auto &s : copy) {
+    joined += s[0];
+  }
+  EXPECT_EQ(joined, "abcd");
+}
+
+TEST(RingBufferTest, SpansCoverTheElementsInOrder) {
+  rwstd::RingBuffer<int> ring(8);
+  // leaves the head at slot 5, so six elements wrap
+  for (int i = 0; i < 5; ++i) {
+    ring.push_back(-1);
+  }
+  ring.pop_front(5);
+  for (int i = 0; i < 6; ++i) {
+    ring.push_back(i);
+  }
+  auto [first, second] = ring.spans();
+  EXPECT_EQ(first.size(), 3);
+  EXPECT_EQ(second.size(), 3);
+  std::vector<int> seen(first.begin(), first.end());
+  seen.insert(seen.end(), second.begin(), second.end());
+  EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+  // consume a batch, what is left no longer wraps
+  ring.pop_front(first.size());
+  auto [rest, none] = std::as_const(ring).spans();
+  EXPECT_EQ(std::vector<int>(rest.begin(), rest.end()),
+            (std::vector<int>{3, 4, 5}));
+  EXPECT_TRUE(none.empty());
+}
+
+TEST(SPSCQueueTest, PassesItemsInOrder) {
+  constexpr int count = 200000;
+  {
+    using Item = std::unique_ptr<int>;
+    rwstd::SPSCQueue<Item, CountingAllocator<Item>> queue(64);
+    EXPECT_EQ(live_allocations, 1);
+    std::thread producer([&] {
+      for (int i = 0; i < count; ++i) {
+        queue.push(std::make_unique<int>(i));
+      }
+    });
+    int expected = 0;
+    while (expected < count) {
+      if (expected % 2 == 0) {
+        ASSERT_EQ(*queue.pop(), expected);
+        ++expected;
+      } else {
+        queue.consume([&](std::unique_ptr<int> &value) {
+          ASSERT_EQ(*value, expected);
+          ++expected;
+        });
+      }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_pop());
+
+    // elements left behind are destroyed with the queue
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_TRUE(queue.try_push(std::make_unique<int>(i)));
+    }
+  }
+  EXPECT_EQ(live_allocations, 0);
+}
+
+TEST(SPSCQueueTest, ConsumeThrowKeepsTheRest) {
+  {
+    using Item = std::unique_ptr<int>;
+    rwstd::SPSCQueue<Item, CountingAllocator<Item>> queue(8);
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_TRUE(queue.try_push(std::make_unique<int>(i)));
+    }
+    std::vector<int> seen;
+    auto take = [&](Item &value) {
+      if (*value == 2)
+        throw std::runtime_error("stop");
+      seen.push_back(*value);
+    };
+    EXPECT_THROW(queue.consume(take), std::runtime_error);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1}));
+    // 0 and 1 are gone, 2 is still at the front
+    EXPECT_EQ(queue.size_approx(), 3);
+    EXPECT_EQ(*queue.pop(), 2);
+    EXPECT_EQ(queue.consume(take), 2);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 3, 4}));
+  }
+  EXPECT_EQ(live_allocations, 0);
+}
+
+TEST(MPMCQueueTest, FullAndEmpty) {
+  rwstd::MPMCQueue<std::string> queue(3);
+  EXPECT_EQ(queue.capacity(), 4);
+  EXPECT_FALSE(queue.try_pop());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.try_emplace(size_t{20}, static_cast<char>('a' + i)));
+  }
+  std::string rejected = "kept";
+  EXPECT_FALSE(queue.try_push(std::move(rejected)));
+  EXPECT_EQ(rejected, "kept");
+  EXPECT_EQ(queue.size_approx(), 4);
+  EXPECT_EQ(*queue.try_pop(), std::string(20, 'a'));
+  EXPECT_TRUE(queue.try_push(rejected));
+  EXPECT_EQ(queue.pop()[0], 'b');
+}
+
+TEST(MPMCQueueTest, ManyProducersAndConsumers) {
+  constexpr uint64_t per_producer = 50000;
+  constexpr unsigned producers = 4;
+  constexpr unsigned consumers = 4;
+  {
+    rwstd::MPMCQueue<uint64_t, CountingAllocator<uint64_t>> queue(128);
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> popped{0};
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; ++p) {
+      threads.emplace_back([&, p] {
+        for (uint64_t i = 0; i < per_producer; ++i) {
+          queue.push(p * per_producer + i);
+        }
+      });
+    }
+    for (unsigned c = 0; c < consumers; ++c) {
+      threads.emplace_back([&] {
+        while (popped.load() < producers * per_producer) {
+          if (auto value = queue.try_pop()) {
+            sum += *value;
+            ++popped;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    uint64_t n = producers * per_producer;
+    EXPECT_EQ(popped, n);
+    EXPECT_EQ(sum, n * (n - 1) / 2);
+    EXPECT_TRUE(queue.empty());
+  }
+  EXPECT_EQ(live_allocations, 0);
+}
@@ -0,0 +1,122 @@
+#include "SegmentedVector/segmented_vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+class SegmentedVectorTest : public testing::Test {
+protected:
+  SegmentedVectorTest() {
+    for (int i = 0; i < 1000; ++i) {
+      v1.push_back(i);
+    }
+  }
+
+  rwstd::SegmentedVector<int> v0;
+  rwstd::SegmentedVector<int> v1;
+};
+
+TEST_F(SegmentedVectorTest, InitialState) {
+  EXPECT_EQ(v0.size(), 0);
+  EXPECT_EQ(v0.capacity(), 0);
+  EXPECT_TRUE(v0.empty());
+
+  EXPECT_EQ(v1.size(), 1000);
+  EXPECT_GE(v1.capacity(), 1000);
+  // geometric blocks, so only a handful of them
+  EXPECT_LE(v1.block_count(), 8);
+}
+
+TEST_F(SegmentedVectorTest, ElementAccess) {
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(v1[static_cast<size_t>(i)], i);
+  }
+  EXPECT_EQ(v1.front(), 0);
+  EXPECT_EQ(v1.back(), 999);
+  EXPECT_EQ(v1.at(500), 500);
+  EXPECT_THROW(v1.at(1000), std::out_of_range);
+}
+
+TEST_F(SegmentedVectorTest, ReferencesStayValidOnGrowth) {
+  rwstd::SegmentedVector<std::string> strings;
+  strings.push_back("first");
+  std::string *first = &strings[0];
+  const char *first_chars = strings[0].data();
+
+  for (int i = 0; i < 100000; ++i) {
+    strings.emplace_back(std::to_string(i));
+  }
+  EXPECT_EQ(first, &strings[0]);
+  EXPECT_EQ(first_chars, strings[0].data());
+  EXPECT_EQ(*first, "first");
+  EXPECT_EQ(strings.back(), "99999");
+}
+
+TEST_F(SegmentedVectorTest, BlocksCoverEveryElement) {
+  size_t total = 0;
+  for (size_t b = 0; b < v1.block_count(); ++b) {
+    const int *block = v1.block_data(b);
+    for (size_t i = 0; i < v1.block_size(b); ++i) {
+      EXPECT_EQ(block[i], static_cast<int>(total + i));
+    }
+    total += v1.block_size(b);
+  }
+  EXPECT_EQ(total, v1.size());
+}
+
+TEST_F(SegmentedVectorTest, Iterators) {
+  EXPECT_EQ(v1.end() - v1.begin(), 1000);
+  EXPECT_EQ(std::accumulate(v1.cbegin(), v1.cend(), 0), 999 * 1000 / 2);
+  EXPECT_EQ(*(v1.begin() + 700), 700);
+  EXPECT_EQ(v1.begin()[123], 123);
+  EXPECT_EQ(*(v1.end() - 1), 999);
+
+  auto it = v1.end();
+  --it;
+  EXPECT_EQ(*it, 999);
+
+  std::reverse(v1.begin(), v1.end());
+  EXPECT_EQ(v1.front(), 999);
+  std::sort(v1.begin(), v1.end());
+  EXPECT_TRUE(std::is_sorted(v1.cbegin(), v1.cend()));
+  EXPECT_EQ(v1[10], 10);
+
+  rwstd::SegmentedVector<int>::const_iterator cit = v1.begin();
+  EXPECT_TRUE(cit < v1.cend());
+}
+
+TEST_F(SegmentedVectorTest, Modifiers) {
+  v1.pop_back();
+  EXPECT_EQ(v1.size(), 999);
+  EXPECT_EQ(v1.back(), 998);
+
+  size_t capacity = v1.capacity();
+  v1.clear();
+  EXPECT_TRUE(v1.empty());
+  EXPECT_EQ(v1.capacity(), capacity);
+
+  v1.shrink_to_fit();
+  EXPECT_EQ(v1.capacity(), 0);
+
+  v0.reserve(100);
+  EXPECT_GE(v0.capacity(), 100);
+  v0.push_back(7);
+  EXPECT_EQ(v0[0], 7);
+}
+
+TEST_F(SegmentedVectorTest, CopyAndMove) {
+  auto copy = v1;
+  copy[0] = 42;
+  EXPECT_EQ(v1[0], 0);
+  EXPECT_EQ(copy.size(), 1000);
+
+  int *stable = &v1[999];
+  auto moved = std::move(v1);
+  EXPECT_EQ(&moved[999], stable);
+  EXPECT_EQ(v1.size(), 0);
+
+  v0 = {1, 2, 3};
+  EXPECT_EQ(v0.size(), 3);
+  EXPECT_EQ(v0[2], 3);
+}
@@ -0,0 +1,381 @@
+#include "Serialize/serialize.hpp"
+#include <gtest/gtest.h>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// any type with write(const void *, size_t) is a writer
+struct BytesWriter {
+  std::vector<std::byte> bytes;
+
+  void write(const void *data, std::size_t n) {
+    const auto *p = static_cast<const std::byte *>(data);
+    bytes.insert(bytes.end(), p, p + n);
+  }
+};
+
+struct Point {
+  double x;
+  double y;
+};
+
+struct OtherHash {
+  std::size_t operator()(int key) const {
+    return static_cast<std::size_t>(key) * 31 + 7;
+  }
+};
+
+rwstd::Vector<uint64_t> make_vector(uint64_t n) {
+  rwstd::Vector<uint64_t> v;
+  for (uint64_t i = 0; i < n; ++i) {
+    v.push_back(i * i);
+  }
+  return v;
+}
+
+} // namespace
+
+TEST(SerializeTest, VectorRoundTripFile) {
+  auto v = make_vector(1000);
+  std::FILE *f = std::tmpfile();
+  ASSERT_NE(f, nullptr);
+  rwstd::serialize::FileWriter writer(f);
+  rwstd::serialize::write(writer, v);
+  writer.flush();
+
+  std::rewind(f);
+  rwstd::serialize::FileReader reader(f);
+  auto loaded = rwstd::serialize::read_vector<uint64_t>(reader);
+  std::fclose(f);
+
+  ASSERT_EQ(loaded.size(), 1000);
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(loaded[i], v[i]);
+  }
+}
+
+TEST(SerializeTest, VectorRoundTripFd) {
+  // big enough to bypass the writer's buffer
+  auto v = make_vector(100000);
+  std::FILE *f = std::tmpfile();
+  ASSERT_NE(f, nullptr);
+  int fd = fileno(f);
+  {
+    rwstd::serialize::FdWriter writer(fd);
+    rwstd::serialize::write(writer, make_vector(3));
+    rwstd::serialize::write(writer, v);
+  }
+
+  ASSERT_EQ(::lseek(fd, 0, SEEK_SET), 0);
+  rwstd::serialize::FdReader reader(fd);
+  auto small = rwstd::serialize::read_vector<uint64_t>(reader);
+  auto loaded = rwstd::serialize::read_vector<uint64_t>(reader);
+  std::fclose(f);
+
+  ASSERT_EQ(small.size(), 3);
+  EXPECT_EQ(small[2], 4);
+  ASSERT_EQ(loaded.size(), 100000);
+  for (size_t i = 0; i < loaded.size(); i += 997) {
+    EXPECT_EQ(loaded[i], v[i]);
+  }
+}
+
+TEST(SerializeTest, EmptyVector) {
+  BytesWriter writer;
+  rwstd::serialize::write(writer, rwstd::Vector<int>());
+  EXPECT_EQ(writer.bytes.size(), sizeof(rwstd::serialize::Header));
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  auto loaded = rwstd::serialize::read_vector<int>(reader);
+  EXPECT_TRUE(loaded.empty());
+  EXPECT_EQ(reader.remaining(), 0);
+  loaded.push_back(3);
+  EXPECT_EQ(loaded[0], 3);
+}
+
+TEST(SerializeTest, ViewInPlace) {
+  rwstd::Vector<Point> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(Point{i * 1.0, i * 2.0});
+  }
+  BytesWriter writer;
+  rwstd::serialize::write(writer, v);
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  auto view = rwstd::serialize::view_vector<Point>(reader);
+  ASSERT_EQ(view.size(), 10);
+  EXPECT_DOUBLE_EQ(view[7].y, 14.0);
+  // no copy, the span points into the buffer
+  EXPECT_EQ(reinterpret_cast<const std::byte *>(view.data()),
+            writer.bytes.data() + sizeof(rwstd::serialize::Header));
+}
+
+TEST(SerializeTest, ObjectsStayAligned) {
+  rwstd::Vector<char> chars;
+  chars.push_back('a');
+  chars.push_back('b');
+  chars.push_back('c');
+
+  BytesWriter writer;
+  rwstd::serialize::write(writer, chars);
+  rwstd::serialize::write(writer, make_vector(5));
+  EXPECT_EQ(writer.bytes.size() % 64, 0);
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  auto first = rwstd::serialize::view_vector<char>(reader);
+  auto second = rwstd::serialize::view_vector<uint64_t>(reader);
+  ASSERT_EQ(first.size(), 3);
+  EXPECT_EQ(first[2], 'c');
+  ASSERT_EQ(second.size(), 5);
+  EXPECT_EQ(second[4], 16);
+  EXPECT_EQ(
+      (reinterpret_cast<const std::byte *>(second.data()) - writer.bytes.data()) %
+          64,
+      0);
+}
+
+TEST(SerializeTest, MapRoundTrip) {
+  rwstd::UnorderedMap<int, double> map;
+  for (int i = 0; i < 1000; ++i) {
+    map.insert({i * 7, i * 0.25});
+  }
+
+  BytesWriter writer;
+  rwstd::serialize::write(writer, map);
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  auto loaded =
+      rwstd::serialize::read_map<rwstd::UnorderedMap<int, double>>(reader);
+
+  EXPECT_EQ(loaded.size(), map.size());
+  EXPECT_EQ(loaded.bucket_count(), map.bucket_count());
+  EXPECT_EQ(loaded.max_load_factor(), map.max_load_factor());
+  for (int i = 0; i < 1000; ++i) {
+    auto it = loaded.find(i * 7);
+    ASSERT_TRUE(it != loaded.end());
+    EXPECT_EQ(it->second, i * 0.25);
+  }
+  EXPECT_TRUE(loaded.find(3) == loaded.end());
+
+  // still a normal map afterwards
+  loaded.insert({-1, 1.0});
+  EXPECT_EQ(loaded.size(), 1001);
+  EXPECT_EQ(loaded.erase(0), 1);
+  EXPECT_EQ(loaded.size(), 1000);
+}
+
+TEST(SerializeTest, MapRoundTripFd) {
+  rwstd::UnorderedMap<uint64_t, uint32_t> map;
+  for (uint32_t i = 0; i < 50000; ++i) {
+    map.insert({uint64_t{i} << 20, i});
+  }
+  std::FILE *f = std::tmpfile();
+  ASSERT_NE(f, nullptr);
+  int fd = fileno(f);
+  {
+    rwstd::serialize::FdWriter writer(fd);
+    rwstd::serialize::write(writer, map);
+  }
+  ASSERT_EQ(::lseek(fd, 0, SEEK_SET), 0);
+  rwstd::serialize::FdReader reader(fd);
+  auto loaded =
+      rwstd::serialize::read_map<rwstd::UnorderedMap<uint64_t, uint32_t>>(
+          reader);
+  std::fclose(f);
+
+  ASSERT_EQ(loaded.size(), 50000);
+  for (uint32_t i = 0; i < 50000; i += 101) {
+    EXPECT_EQ(loaded[uint64_t{i} << 20], i);
+  }
+}
+
+TEST(SerializeTest, MapHashMismatch) {
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 1; i < 100; ++i) {
+    map.insert({i, i});
+  }
+  BytesWriter writer;
+  rwstd::serialize::write(writer, map);
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  using Other = rwstd::UnorderedMap<int, int, OtherHash>;
+  EXPECT_THROW(rwstd::serialize::read_map<Other>(reader),
+               rwstd::serialize::FormatError);
+}
+
+TEST(SerializeTest, Truncation) {
+  BytesWriter writer;
+  rwstd::serialize::write(writer, make_vector(100));
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 0; i < 100; ++i) {
+    map.insert({i, -i});
+  }
+  BytesWriter map_writer;
+  rwstd::serialize::write(map_writer, map);
+
+  for (size_t len = 0; len < writer.bytes.size(); len += 13) {
+    rwstd::serialize::BufferReader reader(
+        std::span(writer.bytes.data(), len));
+    EXPECT_THROW(rwstd::serialize::read_vector<uint64_t>(reader),
+                 rwstd::serialize::FormatError);
+  }
+  for (size_t len = 0; len < map_writer.bytes.size(); len += 13) {
+    rwstd::serialize::BufferReader reader(
+        std::span(map_writer.bytes.data(), len));
+    EXPECT_THROW(
+        (rwstd::serialize::read_map<rwstd::UnorderedMap<int, int>>(reader)),
+        rwstd::serialize::FormatError);
+  }
+
+  std::FILE *f = std::tmpfile();
+  ASSERT_NE(f, nullptr);
+  std::fwrite(writer.bytes.data(), 1, writer.bytes.size() / 2, f);
+  std::rewind(f);
+  rwstd::serialize::FileReader file_reader(f);
+  EXPECT_THROW(rwstd::serialize::read_vector<uint64_t>(file_reader),
+               rwstd::serialize::FormatError);
+  std::fclose(f);
+}
+
+// counts in the header are checked against overflow and the input before
+// anything is allocated for them
+TEST(SerializeTest, CorruptCountsRejected) {
+  auto patched = [](std::vector<std::byte> bytes, uint64_t count,
+                    uint64_t bucket_count) {
+    rwstd::serialize::Header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    h.count = count;
+    if (bucket_count != 0) {
+      h.bucket_count = bucket_count;
+    }
+    std::memcpy(bytes.data(), &h, sizeof(h));
+    return bytes;
+  };
+  auto read_from_file = [](const std::vector<std::byte> &bytes, auto read) {
+    std::FILE *f = std::tmpfile();
+    ASSERT_NE(f, nullptr);
+    std::fwrite(bytes.data(), 1, bytes.size(), f);
+    std::rewind(f);
+    rwstd::serialize::FileReader reader(f);
+    EXPECT_THROW(read(reader), rwstd::serialize::FormatError);
+    std::fclose(f);
+  };
+
+  BytesWriter writer;
+  rwstd::serialize::write(writer, make_vector(8));
+  // 2^61 * 8 bytes wraps to 0
+  for (uint64_t count : {uint64_t{1} << 61, uint64_t{9}, uint64_t{1} << 40}) {
+    auto bytes = patched(writer.bytes, count, 0);
+    rwstd::serialize::BufferReader view_reader(bytes);
+    EXPECT_THROW(rwstd::serialize::view_vector<uint64_t>(view_reader),
+                 rwstd::serialize::FormatError);
+    rwstd::serialize::BufferReader reader(bytes);
+    EXPECT_THROW(rwstd::serialize::read_vector<uint64_t>(reader),
+                 rwstd::serialize::FormatError);
+    read_from_file(bytes, [](auto &r) {
+      return rwstd::serialize::read_vector<uint64_t>(r);
+    });
+  }
+
+  using Map = rwstd::UnorderedMap<int, int>;
+  Map map;
+  for (int i = 0; i < 20; ++i) {
+    map.insert({i, i});
+  }
+  BytesWriter map_writer;
+  rwstd::serialize::write(map_writer, map);
+  for (auto [count, buckets] : {std::pair{uint64_t{20}, uint64_t{1} << 40},
+                                std::pair{uint64_t{1} << 62, uint64_t{0}},
+                                std::pair{uint64_t{1} << 30, uint64_t{0}}}) {
+    auto bytes = patched(map_writer.bytes, count, buckets);
+    rwstd::serialize::BufferReader reader(bytes);
+    EXPECT_THROW(rwstd::serialize::read_map<Map>(reader),
+                 rwstd::serialize::FormatError);
+    read_from_file(bytes,
+                   [](auto &r) { return rwstd::serialize::read_map<Map>(r); });
+  }
+
+  // so is the load factor the map divides by
+  for (float factor : {0.0f, -1.0f, std::numeric_limits<float>::quiet_NaN(),
+                       std::numeric_limits<float>::infinity()}) {
+    auto bytes = map_writer.bytes;
+    rwstd::serialize::Header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    h.max_load_factor = std::bit_cast<uint32_t>(factor);
+    std::memcpy(bytes.data(), &h, sizeof(h));
+    rwstd::serialize::BufferReader reader(bytes);
+    EXPECT_THROW(rwstd::serialize::read_map<Map>(reader),
+                 rwstd::serialize::FormatError);
+  }
+}
+
+TEST(SerializeTest, WrongTypeRejected) {
+  BytesWriter writer;
+  rwstd::serialize::write(writer, make_vector(4));
+
+  rwstd::serialize::BufferReader narrow(writer.bytes);
+  EXPECT_THROW(rwstd::serialize::read_vector<uint32_t>(narrow),
+               rwstd::serialize::FormatError);
+
+  rwstd::serialize::BufferReader as_map(writer.bytes);
+  EXPECT_THROW(
+      (rwstd::serialize::read_map<rwstd::UnorderedMap<uint64_t, uint64_t>>(
+          as_map)),
+      rwstd::serialize::FormatError);
+
+  std::vector<std::byte> garbage(128, std::byte{0x5a});
+  rwstd::serialize::BufferReader bad(garbage);
+  EXPECT_THROW(rwstd::serialize::read_vector<uint64_t>(bad),
+               rwstd::serialize::FormatError);
+}
+
+// a stream written on a machine with the other byte order
+TEST(SerializeTest, ForeignEndianness) {
+  rwstd::Vector<uint32_t> v;
+  for (uint32_t i = 0; i < 20; ++i) {
+    v.push_back(0x01000000u + i);
+  }
+  BytesWriter writer;
+  rwstd::serialize::write(writer, v);
+
+  rwstd::serialize::Header h;
+  std::memcpy(&h, writer.bytes.data(), sizeof(h));
+  rwstd::serialize::detail::byteswap_header(h);
+  std::memcpy(writer.bytes.data(), &h, sizeof(h));
+  for (size_t i = 0; i < v.size(); ++i) {
+    uint32_t swapped = std::byteswap(v[i]);
+    std::memcpy(writer.bytes.data() + sizeof(h) + i * 4, &swapped, 4);
+  }
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  auto loaded = rwstd::serialize::read_vector<uint32_t>(reader);
+  ASSERT_EQ(loaded.size(), 20);
+  for (size_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(loaded[i], v[i]);
+  }
+
+  // cannot hand out foreign bytes in place
+  rwstd::serialize::BufferReader view_reader(writer.bytes);
+  EXPECT_THROW(rwstd::serialize::view_vector<uint32_t>(view_reader),
+               rwstd::serialize::FormatError);
+}
+
+TEST(SerializeTest, ForeignEndiannessStructRejected) {
+  rwstd::Vector<Point> v;
+  v.push_back(Point{1, 2});
+  BytesWriter writer;
+  rwstd::serialize::write(writer, v);
+
+  rwstd::serialize::Header h;
+  std::memcpy(&h, writer.bytes.data(), sizeof(h));
+  rwstd::serialize::detail::byteswap_header(h);
+  std::memcpy(writer.bytes.data(), &h, sizeof(h));
+
+  rwstd::serialize::BufferReader reader(writer.bytes);
+  EXPECT_THROW(rwstd::serialize::read_vector<Point>(reader),
+               rwstd::serialize::FormatError);
+}
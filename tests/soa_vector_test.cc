@@ -0,0 +1,144 @@
+#include "SoAVector/soa_vector.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+// copying throws once the budget runs out, moving may throw too
+struct Fragile {
+  static inline int copies_left = 1000;
+  int value = 0;
+
+  Fragile(int v) : value{v} {}
+  Fragile(const Fragile &other) : value{other.value} {
+    if (copies_left-- <= 0)
+      throw std::runtime_error("copy");
+  }
+  Fragile(Fragile &&other) : Fragile(std::as_const(other)) {}
+};
+
+} // namespace
+
+class SoAVectorTest : public testing::Test {
+protected:
+  SoAVectorTest() {
+    v1.push_back({1, 1.5, "one"});
+    v1.push_back(std::make_tuple(2, 2.5, std::string("two")));
+    v1.emplace_back(3, 3.5, "three");
+  }
+
+  rwstd::SoAVector<int, double> v0;
+  rwstd::SoAVector<int, double, std::string> v1;
+};
+
+TEST_F(SoAVectorTest, InitialState) {
+  EXPECT_EQ(v0.size(), 0);
+  EXPECT_TRUE(v0.empty());
+
+  EXPECT_EQ(v1.size(), 3);
+  EXPECT_GE(v1.capacity(), 3);
+}
+
+TEST_F(SoAVectorTest, ElementAccess) {
+  auto [id, weight, name] = v1[1];
+  EXPECT_EQ(id, 2);
+  EXPECT_EQ(weight, 2.5);
+  EXPECT_EQ(name, "two");
+
+  // proxies write through to the columns
+  std::get<0>(v1[1]) = 20;
+  name = "TWO";
+  EXPECT_EQ(v1.column<0>()[1], 20);
+  EXPECT_EQ(v1.column<2>()[1], "TWO");
+
+  EXPECT_EQ(std::get<2>(v1.front()), "one");
+  EXPECT_EQ(std::get<2>(v1.back()), "three");
+  EXPECT_THROW(v1.at(3), std::out_of_range);
+}
+
+TEST_F(SoAVectorTest, ColumnsAreContiguousAndAligned) {
+  for (int i = 0; i < 1000; ++i) {
+    v0.emplace_back(i, i * 0.5);
+  }
+  auto ids = v0.column<0>();
+  auto weights = v0.column<1>();
+  EXPECT_EQ(ids.size(), 1000);
+  EXPECT_EQ(weights.size(), 1000);
+  EXPECT_EQ(std::accumulate(ids.begin(), ids.end(), 0), 999 * 1000 / 2);
+  EXPECT_EQ(weights[10], 5.0);
+
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ids.data()) % 64, 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(weights.data()) % 64, 0);
+}
+
+TEST_F(SoAVectorTest, Iterators) {
+  int expected_id = 1;
+  for (auto [id, weight, name] : v1) {
+    EXPECT_EQ(id, expected_id);
+    EXPECT_EQ(weight, expected_id + 0.5);
+    weight = 0.0;
+    ++expected_id;
+  }
+  EXPECT_EQ(v1.column<1>()[2], 0.0);
+
+  const auto &cv = v1;
+  EXPECT_EQ(cv.end() - cv.begin(), 3);
+  rwstd::SoAVector<int, double, std::string>::const_iterator it = v1.begin();
+  EXPECT_EQ(std::get<0>(it[2]), 3);
+  EXPECT_TRUE(it < cv.end());
+  EXPECT_EQ(std::count_if(v1.begin(), v1.end(),
+                          [](auto row) { return std::get<0>(row) > 1; }),
+            2);
+}
+
+TEST_F(SoAVectorTest, GrowthKeepsValues) {
+  for (int i = 0; i < 100; ++i) {
+    v1.emplace_back(i, 0.0, std::string(30, static_cast<char>('a' + i % 26)));
+  }
+  EXPECT_EQ(v1.size(), 103);
+  EXPECT_EQ(std::get<2>(v1[0]), "one");
+  EXPECT_EQ(std::get<2>(v1[102]), std::string(30, static_cast<char>('a' + 99 % 26)));
+
+  v1.pop_back();
+  EXPECT_EQ(v1.size(), 102);
+  v1.clear();
+  EXPECT_TRUE(v1.empty());
+}
+
+TEST_F(SoAVectorTest, CopyAndMove) {
+  auto copy = v1;
+  std::get<2>(copy[0]) = "changed";
+  EXPECT_EQ(std::get<2>(v1[0]), "one");
+  EXPECT_EQ(copy.size(), 3);
+
+  auto moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 3);
+  EXPECT_EQ(std::get<2>(moved[0]), "changed");
+  EXPECT_EQ(copy.size(), 0);
+
+  v0 = {{1, 1.0}, {2, 2.0}};
+  EXPECT_EQ(v0.size(), 2);
+  EXPECT_EQ(std::get<1>(v0[1]), 2.0);
+}
+
+TEST(SoAVectorThrowTest, GrowthKeepsEveryColumnOnThrow) {
+  rwstd::SoAVector<std::string, Fragile> v;
+  v.reserve(4);
+  for (int i = 0; i < 4; ++i) {
+    v.emplace_back(std::string(30, 'x'), i);
+  }
+  // the string column relocates first, it must not be moved out of
+  Fragile::copies_left = 2;
+  EXPECT_THROW(v.reserve(100), std::runtime_error);
+  Fragile::copies_left = 1000;
+  EXPECT_EQ(v.capacity(), 4);
+  for (std::size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(std::get<0>(v[i]), std::string(30, 'x'));
+    EXPECT_EQ(std::get<1>(v[i]).value, static_cast<int>(i));
+  }
+}
@@ -0,0 +1,165 @@
+#include "StaticMap/static_map.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace {
+
+enum class Opcode : uint8_t { nop, load, store, add, jump };
+
+constexpr auto methods = rwstd::make_static_map<std::string_view, int>({
+    {"GET", 1},
+    {"HEAD", 2},
+    {"POST", 3},
+    {"PUT", 4},
+    {"DELETE", 5},
+    {"CONNECT", 6},
+    {"OPTIONS", 7},
+    {"TRACE", 8},
+    {"PATCH", 9},
+});
+
+constexpr auto opcode_names = rwstd::make_static_map<Opcode, std::string_view>({
+    {Opcode::nop, "nop"},
+    {Opcode::load, "load"},
+    {Opcode::store, "store"},
+    {Opcode::add, "add"},
+    {Opcode::jump, "jump"},
+});
+
+constexpr auto sparse = rwstd::make_static_map<int64_t, int>({
+    {-7, 0},
+    {0, 1},
+    {1000000007, 2},
+    {int64_t{1} << 40, 3},
+    {42, 4},
+});
+
+// 300 generated keys, a table bigger than any hand written one
+constexpr auto generated_items = [] {
+  std::array<std::pair<uint32_t, uint32_t>, 300> items{};
+  for (uint32_t i = 0; i < 300; ++i) {
+    items[i] = {i * 2654435761u, i};
+  }
+  return items;
+}();
+constexpr auto generated = rwstd::make_static_map(generated_items);
+
+// prefixes of every length from 0 to 40, hits each path of the string hash
+constexpr char text[] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEF";
+constexpr auto prefix_items = [] {
+  std::array<std::pair<std::string_view, size_t>, 41> items{};
+  for (size_t i = 0; i < items.size(); ++i) {
+    items[i] = {std::string_view(text, i), i};
+  }
+  return items;
+}();
+constexpr auto prefixes = rwstd::make_static_map(prefix_items);
+
+} // namespace
+
+// everything is available during constant evaluation
+static_assert(methods.size() == 9);
+static_assert(methods.at("PATCH") == 9);
+static_assert(methods.contains("GET"));
+static_assert(!methods.contains("get"));
+static_assert(methods.value_or("BREW", -1) == -1);
+static_assert(opcode_names.at(Opcode::store) == "store");
+static_assert(sparse.at(int64_t{1} << 40) == 3);
+static_assert(generated.at(299 * 2654435761u) == 299);
+
+TEST(StaticMapTest, StringKeys) {
+  EXPECT_EQ(methods.at("GET"), 1);
+  EXPECT_EQ(methods.at("DELETE"), 5);
+
+  // lookups with runtime strings
+  std::string key = "OPT";
+  key += "IONS";
+  EXPECT_EQ(methods.at(key), 7);
+  EXPECT_EQ(methods.count(key), 1);
+
+  EXPECT_EQ(methods.find("PUTS"), methods.end());
+  EXPECT_EQ(methods.find(""), methods.end());
+  EXPECT_FALSE(methods.contains("GETT"));
+  EXPECT_THROW(methods.at("BREW"), std::out_of_range);
+}
+
+TEST(StaticMapTest, EveryKeyFound) {
+  for (const auto &[key, value] : methods) {
+    auto it = methods.find(key);
+    ASSERT_NE(it, methods.end());
+    EXPECT_EQ(it->second, value);
+  }
+  for (const auto &[key, value] : generated) {
+    EXPECT_EQ(generated.at(key), value);
+  }
+}
+
+TEST(StaticMapTest, KeysOfEveryLength) {
+  std::string key;
+  for (size_t i = 0; i <= 40; ++i) {
+    EXPECT_EQ(prefixes.at(key), i);
+    std::string other = key + "!";
+    EXPECT_FALSE(prefixes.contains(other));
+    key += text[i];
+  }
+}
+
+// the table is hashed at compile time and probed at run time, which loads
+// words through memcpy, so both have to agree on every byte order
+TEST(StaticMapTest, CompileTimeAndRuntimeHashesAgree) {
+  static constexpr std::string_view sample =
+      "0123456789abcdefghijklmnopqrstuvwxyz!";
+  constexpr auto at_compile_time = [] {
+    std::array<uint64_t, sample.size() + 1> hashes{};
+    for (size_t n = 0; n <= sample.size(); ++n) {
+      hashes[n] = rwstd::detail::static_hash(sample.substr(0, n), 42);
+    }
+    return hashes;
+  }();
+  for (size_t n = 0; n <= sample.size(); ++n) {
+    std::string key(sample.substr(0, n));
+    EXPECT_EQ(rwstd::detail::static_hash(key, 42), at_compile_time[n]) << n;
+  }
+}
+
+TEST(StaticMapTest, MissesOnGeneratedKeys) {
+  for (uint32_t i = 0; i < 300; ++i) {
+    EXPECT_FALSE(generated.contains(i * 2654435761u + 1));
+  }
+}
+
+TEST(StaticMapTest, IntegralAndEnumKeys) {
+  EXPECT_EQ(sparse.at(-7), 0);
+  EXPECT_EQ(sparse.at(42), 4);
+  EXPECT_FALSE(sparse.contains(43));
+
+  EXPECT_EQ(opcode_names.at(Opcode::jump), "jump");
+  EXPECT_EQ(opcode_names.value_or(static_cast<Opcode>(9), "?"), "?");
+}
+
+TEST(StaticMapTest, DefinitionOrder) {
+  std::string order;
+  for (const auto &entry : opcode_names) {
+    order += entry.second;
+    order += ' ';
+  }
+  EXPECT_EQ(order, "nop load store add jump ");
+}
+
+TEST(StaticMapTest, SingleEntry) {
+  constexpr auto one = rwstd::make_static_map<std::string_view, int>({{"x", 1}});
+  static_assert(one.at("x") == 1);
+  EXPECT_FALSE(one.contains("y"));
+  EXPECT_EQ(one.size(), 1);
+}
+
+TEST(StaticMapTest, NoRuntimeState) {
+  // the whole table is a literal type with no pointers to the heap
+  static_assert(std::is_trivially_destructible_v<decltype(methods)>);
+  EXPECT_LE(sizeof(methods), 512u);
+}
@@ -0,0 +1,159 @@
+#include "String/string.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include <gtest/gtest.h>
+#include <compare>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+TEST(StringTest, SmallAndHeap) {
+  static_assert(sizeof(rwstd::String) == 24);
+
+  rwstd::String empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_STREQ(empty.c_str(), "");
+  EXPECT_EQ(empty.capacity(), 23);
+
+  rwstd::String small("hello, world");
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_EQ(small.size(), 12);
+  EXPECT_EQ(small.view(), "hello, world");
+
+  // 23 chars still fit, the size byte doubles as the terminator
+  rwstd::String full(std::string_view("abcdefghijklmnopqrstuvw"));
+  EXPECT_TRUE(full.is_inline());
+  EXPECT_STREQ(full.c_str(), "abcdefghijklmnopqrstuvw");
+
+  rwstd::String big(std::string(100, 'x'));
+  EXPECT_FALSE(big.is_inline());
+  EXPECT_EQ(big.size(), 100);
+  EXPECT_EQ(big[99], 'x');
+  EXPECT_EQ(big.c_str()[100], '\0');
+  EXPECT_THROW(big.at(100), std::out_of_range);
+}
+
+TEST(StringTest, GrowAndShrink) {
+  rwstd::String s;
+  std::string expected;
+  for (int i = 0; i < 200; ++i) {
+    char c = static_cast<char>('a' + i % 26);
+    s.push_back(c);
+    expected.push_back(c);
+    ASSERT_EQ(s.view(), expected);
+    ASSERT_EQ(s.is_inline(), s.size() <= 23);
+  }
+
+  // appending a piece of itself across a reallocation
+  s.append(s.view().substr(0, 10));
+  expected.append(expected.substr(0, 10));
+  EXPECT_EQ(s.view(), expected);
+
+  s.resize(5);
+  EXPECT_EQ(s.view(), "abcde");
+  EXPECT_FALSE(s.is_inline());
+  s.shrink_to_fit();
+  EXPECT_TRUE(s.is_inline());
+  EXPECT_EQ(s.view(), "abcde");
+  EXPECT_EQ(s, rwstd::String("abcde"));
+
+  s.resize(8, '!');
+  EXPECT_EQ(s.view(), "abcde!!!");
+  s.pop_back();
+  s += "?";
+  s += '.';
+  EXPECT_EQ(s.view(), "abcde!!?.");
+  s.clear();
+  EXPECT_TRUE(s.empty());
+
+  s.reserve(1000);
+  EXPECT_GE(s.capacity(), 1000);
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s + "tail", "tail");
+}
+
+TEST(StringTest, CopyMoveAndSwap) {
+  rwstd::String small("short");
+  rwstd::String big(std::string(40, 'b'));
+
+  rwstd::String small_copy = small;
+  rwstd::String big_copy = big;
+  EXPECT_EQ(small_copy, small);
+  EXPECT_EQ(big_copy, big);
+  EXPECT_NE(big_copy.data(), big.data());
+
+  rwstd::String moved = std::move(big);
+  EXPECT_EQ(moved, big_copy);
+  EXPECT_TRUE(big.empty());
+
+  small_copy.swap(moved);
+  EXPECT_EQ(small_copy, big_copy);
+  EXPECT_EQ(moved, small);
+
+  moved = small_copy;
+  EXPECT_EQ(moved, big_copy);
+  moved = "again";
+  EXPECT_EQ(moved, "again");
+}
+
+TEST(StringTest, Comparison) {
+  rwstd::String a("apple");
+  rwstd::String b("apricot");
+  EXPECT_LT(a, b);
+  EXPECT_EQ(a <=> rwstd::String("apple"), std::strong_ordering::equal);
+  EXPECT_EQ(a, std::string_view("apple"));
+  EXPECT_NE(a, "apples");
+
+  // same size and first word, differing late
+  rwstd::String long_a(std::string(30, 'z') + "a");
+  rwstd::String long_b(std::string(30, 'z') + "b");
+  EXPECT_NE(long_a, long_b);
+  EXPECT_EQ(long_a, rwstd::String(std::string(30, 'z') + "a"));
+
+  // a heap string that shrank compares equal to an inline one
+  rwstd::String shrunk(std::string(40, 'q'));
+  shrunk.resize(3);
+  EXPECT_EQ(shrunk, rwstd::String("qqq"));
+}
+
+TEST(StringTest, Hashing) {
+  rwstd::String s("key");
+  EXPECT_EQ(s.hash(), rwstd::hash::Hash<std::string>{}("key"));
+  EXPECT_EQ(std::hash<rwstd::String>{}(s), s.hash());
+  EXPECT_EQ(rwstd::StringHash{}(std::string_view("key")), s.hash());
+
+  rwstd::HashedString h(std::string(50, 'h'));
+  size_t before = h.hash();
+  EXPECT_EQ(before, rwstd::String(std::string(50, 'h')).hash());
+  h.push_back('!');
+  EXPECT_NE(h.hash(), before);
+  h[0] = 'x';
+  EXPECT_EQ(h.hash(), rwstd::String(h.view()).hash());
+
+  rwstd::HashedString other(h.view());
+  other.back() = '?';
+  EXPECT_NE(h, other);
+  other.back() = '!';
+  EXPECT_EQ(h, other);
+}
+
+TEST(StringTest, TransparentMapLookup) {
+  rwstd::UnorderedMap<rwstd::String, int, rwstd::StringHash,
+                      std::equal_to<>>
+      map;
+  for (int i = 0; i < 1000; ++i) {
+    map.insert({rwstd::String(std::string_view("key" + std::to_string(i))), i});
+  }
+  EXPECT_EQ(map.find(std::string_view("key42"))->second, 42);
+  EXPECT_EQ(map.find("key999")->second, 999);
+  EXPECT_EQ(map.find(std::string("key7"))->second, 7);
+  EXPECT_TRUE(map.find("nope") == map.end());
+  EXPECT_EQ(map.find(rwstd::String("key1"))->second, 1);
+
+  // the default std::hash specialization works too
+  rwstd::UnorderedMap<rwstd::HashedString, int> plain;
+  plain.insert({"a", 1});
+  plain["b"] = 2;
+  EXPECT_EQ(plain.find("b")->second, 2);
+}
@@ -0,0 +1,152 @@
+#include "ThreadPool/thread_pool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ChaseLevDequeTest, OwnerIsLifoThiefIsFifo) {
+  rwstd::ChaseLevDeque<int *> deque(2);
+  int values[5] = {0, 1, 2, 3, 4};
+  for (int &v : values) {
+    deque.push(&v);
+  }
+  // grew past the initial capacity
+  EXPECT_EQ(deque.size(), 5);
+  EXPECT_GE(deque.capacity(), 5);
+
+  EXPECT_EQ(*deque.pop(), &values[4]);
+  EXPECT_EQ(*deque.steal(), &values[0]);
+  EXPECT_EQ(*deque.pop(), &values[3]);
+  EXPECT_EQ(*deque.steal(), &values[1]);
+  EXPECT_EQ(*deque.pop(), &values[2]);
+  EXPECT_FALSE(deque.pop().has_value());
+  EXPECT_FALSE(deque.steal().has_value());
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(ChaseLevDequeTest, ConcurrentStealsSeeEveryItemOnce) {
+  constexpr size_t count = 100000;
+  rwstd::ChaseLevDeque<size_t *> deque;
+  std::vector<size_t> items(count);
+  std::vector<std::atomic<int>> seen(count);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; ++t) {
+    thieves.emplace_back([&] {
+      while (!done.load() || !deque.empty()) {
+        if (auto item = deque.steal()) {
+          seen[**item].fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    items[i] = i;
+    deque.push(&items[i]);
+    if (i % 3 == 0) {
+      if (auto item = deque.pop()) {
+        seen[**item].fetch_add(1);
+      }
+    }
+  }
+  while (auto item = deque.pop()) {
+    seen[**item].fetch_add(1);
+  }
+  done.store(true);
+  for (auto &thief : thieves) {
+    thief.join();
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(seen[i].load(), 1) << "item " << i;
+  }
+}
+
+TEST(ThreadPoolTest, SubmitAndAsync) {
+  rwstd::ThreadPool pool(3);
+  EXPECT_EQ(pool.size(), 3);
+
+  std::atomic<int> counter{0};
+  {
+    rwstd::TaskGroup group(pool);
+    for (int i = 0; i < 1000; ++i) {
+      group.run([&] { counter.fetch_add(1); });
+    }
+    group.wait();
+  }
+  EXPECT_EQ(counter.load(), 1000);
+
+  auto future = pool.async([] { return 42; });
+  EXPECT_EQ(future.get(), 42);
+}
+
+TEST(ThreadPoolTest, ZeroWorkersRunsOnWaitingThread) {
+  rwstd::ThreadPool pool(0);
+  rwstd::TaskGroup group(pool);
+  auto caller = std::this_thread::get_id();
+  bool same_thread = false;
+  group.run([&] { same_thread = std::this_thread::get_id() == caller; });
+  group.wait();
+  EXPECT_TRUE(same_thread);
+}
+
+TEST(ThreadPoolTest, NestedTaskGroups) {
+  rwstd::ThreadPool pool(4);
+  std::atomic<int> leaves{0};
+
+  rwstd::TaskGroup outer(pool);
+  for (int i = 0; i < 16; ++i) {
+    outer.run([&] {
+      rwstd::TaskGroup inner(pool);
+      for (int j = 0; j < 16; ++j) {
+        inner.run([&] { leaves.fetch_add(1); });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(leaves.load(), 256);
+}
+
+namespace {
+
+// a task whose copy throws, so it can't even be queued
+struct Uncopyable {
+  void operator()() const {}
+  Uncopyable() = default;
+  Uncopyable(const Uncopyable & /*_*/) {
+    throw std::runtime_error("copy");
+  }
+};
+
+} // namespace
+
+TEST(ThreadPoolTest, TaskGroupSurvivesAFailedRun) {
+  rwstd::ThreadPool pool(2);
+  rwstd::TaskGroup group(pool);
+  std::atomic<int> finished{0};
+  group.run([&] { finished.fetch_add(1); });
+  Uncopyable task;
+  EXPECT_THROW(group.run(task), std::runtime_error);
+  group.run([&] { finished.fetch_add(1); });
+  group.wait();
+  EXPECT_EQ(finished.load(), 2);
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrows) {
+  rwstd::ThreadPool pool(2);
+  rwstd::TaskGroup group(pool);
+  std::atomic<int> finished{0};
+  for (int i = 0; i < 10; ++i) {
+    group.run([&, i] {
+      if (i == 5)
+        throw std::runtime_error("boom");
+      finished.fetch_add(1);
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(finished.load(), 9);
+}
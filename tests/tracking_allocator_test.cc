@@ -0,0 +1,153 @@
+#include "Allocator/tracking_allocator.hpp"
+#include "UnorderedMap/unordered_map.hpp"
+#include "Vector/vector.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(TrackingAllocatorTest, CountsBytesAndSizes) {
+  rwstd::AllocationStats stats;
+  rwstd::TrackingAllocator<int> alloc(stats);
+  int *small = alloc.allocate(10);
+  int *large = alloc.allocate(1000);
+
+  auto snap = stats.snapshot();
+  EXPECT_EQ(snap.allocations, 2u);
+  EXPECT_EQ(snap.bytes_allocated, 4040u);
+  EXPECT_EQ(snap.live_bytes, 4040u);
+  EXPECT_EQ(snap.live_allocations(), 2u);
+  // 40 bytes in [32, 64), 4000 in [2048, 4096)
+  EXPECT_EQ(snap.size_histogram[6], 1u);
+  EXPECT_EQ(snap.size_histogram[12], 1u);
+
+  // rebinds report to the same stats
+  rwstd::TrackingAllocator<double> rebound(alloc);
+  EXPECT_EQ(&rebound.stats(), &stats);
+  EXPECT_TRUE(rebound == alloc);
+  EXPECT_FALSE(rwstd::TrackingAllocator<int>() == alloc);
+
+  alloc.deallocate(small, 10);
+  alloc.deallocate(large, 1000);
+  snap = stats.snapshot();
+  EXPECT_EQ(snap.deallocations, 2u);
+  EXPECT_EQ(snap.bytes_deallocated, 4040u);
+  EXPECT_EQ(snap.live_bytes, 0u);
+  EXPECT_EQ(snap.peak_bytes, 4040u);
+
+  std::map<std::string, uint64_t> exported;
+  snap.for_each([&](std::string_view name, uint64_t value) {
+    exported.emplace(name, value);
+  });
+  EXPECT_EQ(exported.size(), 6 + rwstd::AllocationSnapshot::histogram_size);
+  EXPECT_EQ(exported["allocations"], 2u);
+  EXPECT_EQ(exported["bytes_le_63"], 1u);
+  EXPECT_EQ(exported["bytes_le_4095"], 1u);
+  EXPECT_EQ(exported["bytes_le_inf"], 0u);
+}
+
+TEST(TrackingAllocatorTest, ThreadsAddUpAndPeakIsKept) {
+  rwstd::AllocationStats stats;
+  // more threads than shards, so some share the last one
+  constexpr int threads = 40;
+  constexpr int rounds = 2000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&stats] {
+      rwstd::TrackingAllocator<uint64_t> alloc(stats);
+      for (int i = 0; i < rounds; ++i) {
+        uint64_t *p = alloc.allocate(4);
+        alloc.deallocate(p, 4);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // a big block is flushed at once, so the peak sees it exactly
+  rwstd::TrackingAllocator<char> alloc(stats);
+  char *big = alloc.allocate(1 << 20);
+  alloc.deallocate(big, 1 << 20);
+
+  auto snap = stats.snapshot();
+  EXPECT_EQ(snap.allocations, uint64_t{threads * rounds + 1});
+  EXPECT_EQ(snap.deallocations, snap.allocations);
+  EXPECT_EQ(snap.bytes_allocated, uint64_t{threads * rounds * 32 + (1 << 20)});
+  EXPECT_EQ(snap.live_bytes, 0u);
+  EXPECT_GE(snap.peak_bytes, uint64_t{1 << 20});
+  EXPECT_EQ(std::accumulate(snap.size_histogram.begin(),
+                            snap.size_histogram.end(), uint64_t{0}),
+            snap.allocations);
+}
+
+TEST(TrackingAllocatorTest, VectorReallocationStats) {
+  rwstd::AllocationStats stats;
+  using Alloc = rwstd::TrackingAllocator<int>;
+  {
+    rwstd::Vector<int, Alloc> vec{Alloc(stats)};
+    for (int i = 0; i < 100; ++i) {
+      vec.push_back(i);
+    }
+    // 2 -> 4 -> ... -> 128, moving every element each time
+    EXPECT_EQ(vec.stats().reallocations, 6u);
+    EXPECT_EQ(vec.stats().moved_elements, 2u + 4 + 8 + 16 + 32 + 64);
+    EXPECT_EQ(stats.snapshot().live_bytes, 128 * sizeof(int));
+
+    vec.shrink_to_fit();
+    EXPECT_EQ(vec.stats().reallocations, 7u);
+    EXPECT_EQ(vec.stats().moved_elements, 226u);
+    EXPECT_EQ(stats.snapshot().live_bytes, 100 * sizeof(int));
+
+    vec.reset_stats();
+    vec.reserve(50);
+    EXPECT_EQ(vec.stats().reallocations, 0u);
+  }
+  auto snap = stats.snapshot();
+  EXPECT_EQ(snap.allocations, 8u);
+  EXPECT_EQ(snap.live_bytes, 0u);
+  // shrink_to_fit held 128 and 100 ints at once
+  EXPECT_EQ(snap.peak_bytes, (128 + 100) * sizeof(int));
+}
+
+TEST(TrackingAllocatorTest, UnorderedMapStats) {
+  rwstd::AllocationStats stats;
+  using Alloc = rwstd::TrackingAllocator<std::pair<const int, int>>;
+  using Map =
+      rwstd::UnorderedMap<int, int, std::hash<int>, std::equal_to<int>, Alloc>;
+  {
+    Map map(11, std::hash<int>(), std::equal_to<int>(), Alloc(stats));
+    for (int i = 0; i < 100; ++i) {
+      map.insert({i, i});
+    }
+    // 11 -> 22 -> 44 -> 88 -> 176 buckets
+    EXPECT_EQ(map.stats().rehashes, 4u);
+    EXPECT_EQ(map.stats().lookups, 100u);
+
+    map.reset_stats();
+    for (int i = 0; i < 200; ++i) {
+      map.find(i);
+    }
+    auto map_stats = map.stats();
+    EXPECT_EQ(map_stats.lookups, 200u);
+    // std::hash<int> is the identity: a hit is one probe, a miss lands in
+    // an empty bucket, or for 176 and up in one of the first 24
+    EXPECT_EQ(map_stats.probes, 124u);
+    EXPECT_DOUBLE_EQ(map_stats.probes_per_lookup(), 0.62);
+    EXPECT_EQ(map_stats.chain_lengths[0], 76u);
+    EXPECT_EQ(map_stats.chain_lengths[1], 100u);
+
+    // nodes and the bucket array both come from the allocator
+    EXPECT_EQ(stats.snapshot().live_bytes,
+              176 * sizeof(void *) + 100 * (sizeof(std::pair<int, int>) +
+                                            sizeof(void *)));
+  }
+  auto snap = stats.snapshot();
+  EXPECT_EQ(snap.allocations, 5u + 100u);
+  EXPECT_EQ(snap.live_bytes, 0u);
+}
@@ -1,5 +1,11 @@
 #include "unordered_map.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 class UnorderedMapTest : public testing::Test {
 protected:
@@ -27,3 +33,256 @@ TEST_F(UnorderedMapTest, InitialState) {
   v1.erase(it);
   EXPECT_EQ(v1.size(), 1);
 }
+
+TEST(UnorderedMapIterationTest, VisitsEveryElementOnce) {
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 0; i < 500; ++i) {
+    map.insert({i, i * 2});
+  }
+
+  int count = 0;
+  long sum = 0;
+  for (auto &[key, value] : map) {
+    EXPECT_EQ(value, key * 2);
+    sum += key;
+    ++count;
+  }
+  EXPECT_EQ(count, 500);
+  EXPECT_EQ(sum, 499 * 500 / 2);
+
+  const auto &cmap = map;
+  count = 0;
+  for (auto it = cmap.begin(); it != cmap.end(); ++it) {
+    ++count;
+  }
+  EXPECT_EQ(count, 500);
+}
+
+TEST(UnorderedMapIterationTest, EmptyMap) {
+  rwstd::UnorderedMap<int, int> map;
+  EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(UnorderedMapShrinkTest, NoShrinkByDefault) {
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 0; i < 10000; ++i) {
+    map.insert({i, i});
+  }
+  size_t buckets = map.bucket_count();
+  for (int i = 0; i < 10000; ++i) {
+    map.erase(i);
+  }
+  EXPECT_EQ(map.bucket_count(), buckets);
+  EXPECT_EQ(map.min_load_factor(), 0.0f);
+}
+
+TEST(UnorderedMapShrinkTest, ShrinksOnEraseWithHysteresis) {
+  rwstd::UnorderedMap<int, int> map;
+  map.min_load_factor(0.125f);
+  for (int i = 0; i < 10000; ++i) {
+    map.insert({i, i});
+  }
+  size_t peak = map.bucket_count();
+
+  for (int i = 0; i < 9900; ++i) {
+    map.erase(i);
+  }
+  EXPECT_LT(map.bucket_count(), peak / 8);
+  EXPECT_GE(map.load_factor(), map.min_load_factor());
+  for (int i = 9900; i < 10000; ++i) {
+    ASSERT_EQ(map.find(i)->second, i);
+  }
+
+  // right after a shrink the load is half the maximum, so neither one more
+  // insert nor one more erase resizes again
+  size_t settled = map.bucket_count();
+  map.insert({-1, -1});
+  map.erase(-1);
+  map.erase(9999);
+  EXPECT_EQ(map.bucket_count(), settled);
+
+  // the policy only ever asks for at most a quarter of the maximum load
+  map.min_load_factor(0.9f);
+  EXPECT_EQ(map.min_load_factor(), 0.25f);
+}
+
+TEST(UnorderedMapShrinkTest, EraseByIteratorNeverShrinks) {
+  rwstd::UnorderedMap<int, int> map;
+  map.min_load_factor(0.125f);
+  for (int i = 0; i < 10000; ++i) {
+    map.insert({i, i});
+  }
+  size_t peak = map.bucket_count();
+
+  // an erase loop over the whole map has to visit every element once
+  size_t erased = 0;
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 100 != 0) {
+      it = map.erase(it);
+      ++erased;
+    } else {
+      ++it;
+    }
+  }
+  EXPECT_EQ(erased, 9900u);
+  EXPECT_EQ(map.size(), 100u);
+  EXPECT_EQ(map.bucket_count(), peak);
+
+  // the next erase by key catches up
+  map.erase(0);
+  EXPECT_LT(map.bucket_count(), peak / 8);
+}
+
+TEST(UnorderedMapShrinkTest, ShrinkToFitAndRehash) {
+  rwstd::UnorderedMap<int, int> map;
+  map.reserve(100000);
+  size_t reserved = map.bucket_count();
+  map.reserve(10);
+  EXPECT_EQ(map.bucket_count(), reserved);
+
+  for (int i = 0; i < 1000; ++i) {
+    map.insert({i, i});
+  }
+  map.shrink_to_fit();
+  EXPECT_EQ(map.bucket_count(), 1000);
+  EXPECT_EQ(map.size(), 1000);
+
+  // rehash can't go below what the elements need
+  map.rehash(5);
+  EXPECT_EQ(map.bucket_count(), 1000);
+  map.rehash(4096);
+  EXPECT_EQ(map.bucket_count(), 4096);
+  EXPECT_EQ(map.find(999)->second, 999);
+
+  map.clear();
+  map.shrink_to_fit();
+  EXPECT_EQ(map.bucket_count(), 11);
+}
+
+TEST(UnorderedMapShrinkTest, MemoryUsage) {
+  rwstd::UnorderedMap<int, int> map;
+  size_t empty_bytes = map.memory_usage();
+  EXPECT_EQ(empty_bytes, map.bucket_count() * sizeof(void *));
+  map.insert({1, 1});
+  EXPECT_GT(map.memory_usage(), empty_bytes);
+
+  auto copy = map;
+  EXPECT_EQ(copy.memory_usage(), map.memory_usage());
+  EXPECT_EQ(copy.find(1)->second, 1);
+}
+
+TEST(UnorderedMapBulkBuildTest, MatchesSequentialInsert) {
+  std::vector<std::pair<int, int>> input;
+  for (int i = 0; i < 100000; ++i) {
+    // every key shows up twice, the first copy carries value i
+    input.push_back({(i * 7919) % 50000, i});
+  }
+
+  rwstd::UnorderedMap<int, int> expected;
+  for (const auto &entry : input) {
+    expected.insert(entry);
+  }
+
+  for (size_t threads : {1u, 2u, 3u, 8u}) {
+    rwstd::UnorderedMap<int, int> map;
+    map.bulk_build(input.begin(), input.end(), threads);
+    ASSERT_EQ(map.size(), expected.size()) << threads;
+    EXPECT_GE(map.bucket_count(), input.size()) << threads;
+    size_t visited = 0;
+    for (const auto &entry : map) {
+      EXPECT_EQ(expected.find(entry.first)->second, entry.second) << threads;
+      ++visited;
+    }
+    EXPECT_EQ(visited, expected.size()) << threads;
+  }
+}
+
+TEST(UnorderedMapBulkBuildTest, KeepsExistingKeys) {
+  rwstd::UnorderedMap<std::string, int> map;
+  map.insert({"key0", -1});
+  std::vector<std::pair<std::string, int>> input;
+  for (int i = 0; i < 20000; ++i) {
+    input.push_back({"key" + std::to_string(i), i});
+  }
+  map.bulk_build(input.begin(), input.end(), 4);
+  EXPECT_EQ(map.size(), 20000);
+  EXPECT_EQ(map.find("key0")->second, -1);
+  EXPECT_EQ(map.find("key19999")->second, 19999);
+
+  // small inputs and the default thread count
+  std::vector<std::pair<std::string, int>> few{{"a", 1}, {"a", 2}};
+  map.bulk_build(few.begin(), few.end());
+  EXPECT_EQ(map.size(), 20001);
+  EXPECT_EQ(map.find("a")->second, 1);
+  map.bulk_build(few.end(), few.end(), 2);
+  EXPECT_EQ(map.size(), 20001);
+}
+
+TEST(UnorderedMapBucketTest, LocalIterators) {
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 0; i < 500; ++i) {
+    map.insert({i, i * 2});
+  }
+  size_t total = 0;
+  for (size_t n = 0; n < map.bucket_count(); ++n) {
+    size_t in_bucket = 0;
+    for (auto it = map.begin(n); it != map.end(n); ++it) {
+      EXPECT_EQ(map.bucket(it->first), n);
+      EXPECT_EQ(it->second, it->first * 2);
+      ++in_bucket;
+    }
+    EXPECT_EQ(map.bucket_size(n), in_bucket);
+    total += in_bucket;
+  }
+  EXPECT_EQ(total, map.size());
+
+  const auto &view = map;
+  size_t n = view.bucket(42);
+  auto it = view.cbegin(n);
+  while (it != view.cend(n) && it->first != 42) {
+    ++it;
+  }
+  ASSERT_TRUE(it != view.cend(n));
+  EXPECT_EQ(it->second, 84);
+}
+
+TEST(UnorderedMapBucketTest, SplitCoversEveryElementOnce) {
+  rwstd::UnorderedMap<int, int> map;
+  for (int i = 0; i < 10000; ++i) {
+    map.insert({i * 31, i});
+  }
+  for (size_t k : {1u, 3u, 8u, 64u}) {
+    auto ranges = map.split(k);
+    ASSERT_EQ(ranges.size(), k);
+    std::vector<int> seen(10000);
+    for (auto &range : ranges) {
+      for (auto &entry : range) {
+        ++seen[static_cast<size_t>(entry.second)];
+      }
+    }
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), 1), 10000) << k;
+  }
+
+  // more ranges than elements, the rest come back empty
+  rwstd::UnorderedMap<int, int> small;
+  small.insert({1, 1});
+  auto ranges = std::as_const(small).split(4);
+  EXPECT_EQ(std::ranges::distance(ranges[0]), 1);
+  EXPECT_TRUE(ranges[3].empty());
+  rwstd::UnorderedMap<int, int> empty;
+  EXPECT_TRUE(empty.split(2)[0].empty());
+  EXPECT_THROW(small.split(0), std::invalid_argument);
+}
+
+TEST(UnorderedMapBucketTest, SplitBalancesClusteredKeys) {
+  // std::hash<int> is the identity, so these fill the first tenth of the
+  // bucket array and an even split by bucket count would give one range all
+  rwstd::UnorderedMap<int, int> map;
+  map.reserve(100000);
+  for (int i = 0; i < 10000; ++i) {
+    map.insert({i, i});
+  }
+  for (auto &range : map.split(4)) {
+    EXPECT_EQ(std::ranges::distance(range), 2500);
+  }
+}
@@ -1,5 +1,19 @@
 #include "Vector/vector.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <vector>
+
+static_assert(std::contiguous_iterator<rwstd::Vector<int>::iterator>);
+static_assert(std::contiguous_iterator<rwstd::Vector<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<rwstd::Vector<int>>);
+static_assert(std::ranges::contiguous_range<const rwstd::Vector<int>>);
+static_assert(std::ranges::sized_range<rwstd::Vector<int>>);
+// an rvalue Vector owns its elements, algorithms must not hand out
+// iterators into it
+static_assert(!std::ranges::borrowed_range<rwstd::Vector<int>>);
 
 class VectorTest : public testing::Test {
 protected:
@@ -112,3 +126,77 @@ TEST_F(VectorTest, InsertModifier) {
       temp.insert(temp.cend(), nothing.cbegin(), nothing.cend());
   EXPECT_EQ(temp.end(), first_ele_inserted_itr);
 }
+
+TEST_F(VectorTest, CopyMoveAndSwap) {
+  rwstd::Vector<int> a = {1, 2, 3};
+  rwstd::Vector<int> b(a);
+  b.push_back(4);
+  EXPECT_EQ(a.size(), 3);
+  EXPECT_EQ(b.size(), 4);
+
+  rwstd::Vector<int> c(std::move(b));
+  EXPECT_EQ(c.size(), 4);
+  EXPECT_EQ(c.back(), 4);
+  // moved from vectors are empty but still usable
+  EXPECT_TRUE(b.empty());
+  b.push_back(7);
+  EXPECT_EQ(b.front(), 7);
+
+  a = c;
+  EXPECT_EQ(a.size(), 4);
+  a = std::move(b);
+  EXPECT_EQ(a.size(), 1);
+  EXPECT_EQ(a[0], 7);
+
+  a.swap(c);
+  EXPECT_EQ(a.size(), 4);
+  EXPECT_EQ(c.size(), 1);
+
+  a.reserve(64);
+  a.shrink_to_fit();
+  EXPECT_EQ(a.capacity(), 4);
+  EXPECT_EQ(a[3], 4);
+}
+
+TEST_F(VectorTest, AssignEmptyThenPush) {
+  rwstd::Vector<int> a, b;
+  a = b;
+  EXPECT_GE(a.capacity(), 2);
+  a.push_back(1);
+  a.insert(a.cend(), 3, 2);
+  EXPECT_EQ(a.size(), 4);
+  EXPECT_EQ(a[3], 2);
+
+  rwstd::Vector<int> sized(0);
+  sized.push_back(5);
+  EXPECT_EQ(sized.front(), 5);
+}
+
+TEST_F(VectorTest, ContiguousRange) {
+  rwstd::Vector<int> v = {5, 1, 4, 2, 3};
+  const rwstd::Vector<int> &cv = v;
+
+  std::span<int> whole(v);
+  std::span<const int> read_only(cv);
+  EXPECT_EQ(whole.data(), v.data());
+  EXPECT_EQ(read_only.size(), 5);
+  EXPECT_EQ(std::to_address(cv.begin() + 2), v.data() + 2);
+
+  // iterators convert to and compare with const_iterators
+  rwstd::Vector<int>::const_iterator it = v.begin();
+  EXPECT_EQ(it, cv.begin());
+  EXPECT_TRUE(v.begin() < cv.end());
+  EXPECT_EQ(cv.end() - v.begin(), 5);
+
+  std::ranges::sort(v);
+  EXPECT_TRUE(std::ranges::is_sorted(cv));
+  rwstd::Vector<int> copy(5, 0);
+  std::ranges::copy(cv, copy.begin());
+  std::ranges::fill(whole.subspan(3), 9);
+  EXPECT_EQ(copy[4], 5);
+  EXPECT_EQ(v[3], 9);
+
+  auto evens = cv | std::views::filter([](int x) { return x % 2 == 0; });
+  std::vector<int> seen(evens.begin(), evens.end());
+  EXPECT_EQ(seen, (std::vector<int>{2}));
+}